@@ -0,0 +1,139 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+#include "common/util.h"
+
+#ifdef SCUMMVM_NEON
+
+#include "audio/mixbus.h"
+
+#include <arm_neon.h>
+
+#if !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("neon"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("fpu=neon")
+#endif
+
+#endif // !defined(__aarch64__) && !defined(__ARM_NEON)
+
+namespace Audio {
+
+void MixBus::accumulateStereoNEON(float *dst, const int16 *src, uint frames, float gainL, float gainR) {
+	const float gains[4] = { gainL, gainR, gainL, gainR };
+	const float32x4_t gain = vld1q_f32(gains);
+
+	uint i = 0;
+	for (; i + 4 <= frames; i += 4) {
+		const int16x8_t in = vld1q_s16(src);
+		const float32x4_t lo = vcvtq_f32_s32(vmovl_s16(vget_low_s16(in)));
+		const float32x4_t hi = vcvtq_f32_s32(vmovl_s16(vget_high_s16(in)));
+		vst1q_f32(dst, vmlaq_f32(vld1q_f32(dst), lo, gain));
+		vst1q_f32(dst + 4, vmlaq_f32(vld1q_f32(dst + 4), hi, gain));
+		dst += 8;
+		src += 8;
+	}
+
+	accumulateStereoGeneric(dst, src, frames - i, gainL, gainR);
+}
+
+void MixBus::accumulateMonoToStereoNEON(float *dst, const int16 *src, uint frames, float gainL, float gainR) {
+	const float gains[4] = { gainL, gainR, gainL, gainR };
+	const float32x4_t gain = vld1q_f32(gains);
+
+	uint i = 0;
+	for (; i + 4 <= frames; i += 4) {
+		const float32x4_t in = vcvtq_f32_s32(vmovl_s16(vld1_s16(src)));
+		const float32x4x2_t pairs = vzipq_f32(in, in);
+		vst1q_f32(dst, vmlaq_f32(vld1q_f32(dst), pairs.val[0], gain));
+		vst1q_f32(dst + 4, vmlaq_f32(vld1q_f32(dst + 4), pairs.val[1], gain));
+		dst += 8;
+		src += 4;
+	}
+
+	accumulateMonoToStereoGeneric(dst, src, frames - i, gainL, gainR);
+}
+
+void MixBus::accumulateMonoNEON(float *dst, const int16 *src, uint samples, float gain) {
+	const float32x4_t gain4 = vdupq_n_f32(gain);
+
+	uint i = 0;
+	for (; i + 8 <= samples; i += 8) {
+		const int16x8_t in = vld1q_s16(src + i);
+		const float32x4_t lo = vcvtq_f32_s32(vmovl_s16(vget_low_s16(in)));
+		const float32x4_t hi = vcvtq_f32_s32(vmovl_s16(vget_high_s16(in)));
+		vst1q_f32(dst + i, vmlaq_f32(vld1q_f32(dst + i), lo, gain4));
+		vst1q_f32(dst + i + 4, vmlaq_f32(vld1q_f32(dst + i + 4), hi, gain4));
+	}
+
+	accumulateMonoGeneric(dst + i, src + i, samples - i, gain);
+}
+
+float MixBus::peakNEON(const float *src, uint samples) {
+	float32x4_t max4 = vdupq_n_f32(0.0f);
+
+	uint i = 0;
+	for (; i + 4 <= samples; i += 4)
+		max4 = vmaxq_f32(max4, vabsq_f32(vld1q_f32(src + i)));
+
+	float32x2_t max2 = vmax_f32(vget_low_f32(max4), vget_high_f32(max4));
+	max2 = vpmax_f32(max2, max2);
+
+	return MAX(vget_lane_f32(max2, 0), peakGeneric(src + i, samples - i));
+}
+
+void MixBus::outputNEON(int16 *dst, const float *src, uint samples, float gain) {
+	const float32x4_t gain4 = vdupq_n_f32(gain);
+	const float32x4_t minValue = vdupq_n_f32(-32768.0f);
+	const float32x4_t maxValue = vdupq_n_f32(32767.0f);
+	// Adding and subtracting 1.5 * 2^23 rounds to nearest even, the
+	// conversion instruction available everywhere truncates
+	const float32x4_t magic = vdupq_n_f32(12582912.0f);
+
+	uint i = 0;
+	for (; i + 8 <= samples; i += 8) {
+		float32x4_t lo = vminq_f32(vmaxq_f32(vmulq_f32(vld1q_f32(src + i), gain4), minValue), maxValue);
+		float32x4_t hi = vminq_f32(vmaxq_f32(vmulq_f32(vld1q_f32(src + i + 4), gain4), minValue), maxValue);
+		lo = vsubq_f32(vaddq_f32(lo, magic), magic);
+		hi = vsubq_f32(vaddq_f32(hi, magic), magic);
+		vst1q_s16(dst + i, vcombine_s16(vqmovn_s32(vcvtq_s32_f32(lo)), vqmovn_s32(vcvtq_s32_f32(hi))));
+	}
+
+	outputGeneric(dst + i, src + i, samples - i, gain);
+}
+
+} // End of namespace Audio
+
+#if !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif // !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#endif // SCUMMVM_NEON
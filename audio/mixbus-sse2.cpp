@@ -0,0 +1,135 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+#include "common/util.h"
+
+#include "audio/mixbus.h"
+
+#include <emmintrin.h>
+
+#if !defined(__x86_64__)
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("sse2"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("sse2")
+#endif
+
+#endif // !defined(__x86_64__)
+
+namespace Audio {
+
+// Sign extend four 16-bit samples to floats
+static FORCEINLINE __m128 sse2_lowToFloat(__m128i samples) {
+	return _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(samples, samples), 16));
+}
+
+static FORCEINLINE __m128 sse2_highToFloat(__m128i samples) {
+	return _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(samples, samples), 16));
+}
+
+void MixBus::accumulateStereoSSE2(float *dst, const int16 *src, uint frames, float gainL, float gainR) {
+	const __m128 gain = _mm_setr_ps(gainL, gainR, gainL, gainR);
+
+	uint i = 0;
+	for (; i + 4 <= frames; i += 4) {
+		const __m128i in = _mm_loadu_si128((const __m128i *)src);
+		_mm_storeu_ps(dst, _mm_add_ps(_mm_loadu_ps(dst), _mm_mul_ps(sse2_lowToFloat(in), gain)));
+		_mm_storeu_ps(dst + 4, _mm_add_ps(_mm_loadu_ps(dst + 4), _mm_mul_ps(sse2_highToFloat(in), gain)));
+		dst += 8;
+		src += 8;
+	}
+
+	accumulateStereoGeneric(dst, src, frames - i, gainL, gainR);
+}
+
+void MixBus::accumulateMonoToStereoSSE2(float *dst, const int16 *src, uint frames, float gainL, float gainR) {
+	const __m128 gain = _mm_setr_ps(gainL, gainR, gainL, gainR);
+
+	uint i = 0;
+	for (; i + 4 <= frames; i += 4) {
+		const __m128 in = sse2_lowToFloat(_mm_loadl_epi64((const __m128i *)src));
+		_mm_storeu_ps(dst, _mm_add_ps(_mm_loadu_ps(dst), _mm_mul_ps(_mm_unpacklo_ps(in, in), gain)));
+		_mm_storeu_ps(dst + 4, _mm_add_ps(_mm_loadu_ps(dst + 4), _mm_mul_ps(_mm_unpackhi_ps(in, in), gain)));
+		dst += 8;
+		src += 4;
+	}
+
+	accumulateMonoToStereoGeneric(dst, src, frames - i, gainL, gainR);
+}
+
+void MixBus::accumulateMonoSSE2(float *dst, const int16 *src, uint samples, float gain) {
+	const __m128 gain4 = _mm_set1_ps(gain);
+
+	uint i = 0;
+	for (; i + 8 <= samples; i += 8) {
+		const __m128i in = _mm_loadu_si128((const __m128i *)(src + i));
+		_mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), _mm_mul_ps(sse2_lowToFloat(in), gain4)));
+		_mm_storeu_ps(dst + i + 4, _mm_add_ps(_mm_loadu_ps(dst + i + 4), _mm_mul_ps(sse2_highToFloat(in), gain4)));
+	}
+
+	accumulateMonoGeneric(dst + i, src + i, samples - i, gain);
+}
+
+float MixBus::peakSSE2(const float *src, uint samples) {
+	const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+	__m128 max4 = _mm_setzero_ps();
+
+	uint i = 0;
+	for (; i + 4 <= samples; i += 4)
+		max4 = _mm_max_ps(max4, _mm_and_ps(_mm_loadu_ps(src + i), absMask));
+
+	max4 = _mm_max_ps(max4, _mm_shuffle_ps(max4, max4, _MM_SHUFFLE(1, 0, 3, 2)));
+	max4 = _mm_max_ps(max4, _mm_shuffle_ps(max4, max4, _MM_SHUFFLE(2, 3, 0, 1)));
+
+	return MAX(_mm_cvtss_f32(max4), peakGeneric(src + i, samples - i));
+}
+
+void MixBus::outputSSE2(int16 *dst, const float *src, uint samples, float gain) {
+	const __m128 gain4 = _mm_set1_ps(gain);
+	const __m128 minValue = _mm_set1_ps(-32768.0f);
+	const __m128 maxValue = _mm_set1_ps(32767.0f);
+
+	uint i = 0;
+	for (; i + 8 <= samples; i += 8) {
+		// Clip first, the conversion of large values yields 0x80000000.
+		// The conversion rounds to nearest even, like the generic code.
+		const __m128 lo = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(src + i), gain4), minValue), maxValue);
+		const __m128 hi = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(src + i + 4), gain4), minValue), maxValue);
+		_mm_storeu_si128((__m128i *)(dst + i), _mm_packs_epi32(_mm_cvtps_epi32(lo), _mm_cvtps_epi32(hi)));
+	}
+
+	outputGeneric(dst + i, src + i, samples - i, gain);
+}
+
+} // End of namespace Audio
+
+#if !defined(__x86_64__)
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif // !defined(__x86_64__)
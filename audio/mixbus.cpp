@@ -0,0 +1,105 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/system.h"
+#include "common/util.h"
+
+#include "audio/mixbus.h"
+
+namespace Audio {
+
+MixBus::AccumulateStereoFunc MixBus::accumulateStereo = nullptr;
+MixBus::AccumulateMonoToStereoFunc MixBus::accumulateMonoToStereo = nullptr;
+MixBus::AccumulateMonoFunc MixBus::accumulateMono = nullptr;
+MixBus::PeakFunc MixBus::peak = nullptr;
+MixBus::OutputFunc MixBus::output = nullptr;
+
+void MixBus::selectKernels() {
+	if (accumulateStereo && accumulateMonoToStereo && accumulateMono && peak && output)
+		return;
+
+	accumulateStereo = accumulateStereoGeneric;
+	accumulateMonoToStereo = accumulateMonoToStereoGeneric;
+	accumulateMono = accumulateMonoGeneric;
+	peak = peakGeneric;
+	output = outputGeneric;
+	if (!g_system)
+		return;
+#ifdef SCUMMVM_NEON
+	if (g_system->hasFeature(OSystem::kFeatureCpuNEON)) {
+		accumulateStereo = accumulateStereoNEON;
+		accumulateMonoToStereo = accumulateMonoToStereoNEON;
+		accumulateMono = accumulateMonoNEON;
+		peak = peakNEON;
+		output = outputNEON;
+	}
+#endif
+#ifdef SCUMMVM_SSE2
+	if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) {
+		accumulateStereo = accumulateStereoSSE2;
+		accumulateMonoToStereo = accumulateMonoToStereoSSE2;
+		accumulateMono = accumulateMonoSSE2;
+		peak = peakSSE2;
+		output = outputSSE2;
+	}
+#endif
+}
+
+void MixBus::accumulateStereoGeneric(float *dst, const int16 *src, uint frames, float gainL, float gainR) {
+	for (uint i = 0; i < frames; i++) {
+		dst[0] += src[0] * gainL;
+		dst[1] += src[1] * gainR;
+		dst += 2;
+		src += 2;
+	}
+}
+
+void MixBus::accumulateMonoToStereoGeneric(float *dst, const int16 *src, uint frames, float gainL, float gainR) {
+	for (uint i = 0; i < frames; i++) {
+		dst[0] += *src * gainL;
+		dst[1] += *src * gainR;
+		dst += 2;
+		src++;
+	}
+}
+
+void MixBus::accumulateMonoGeneric(float *dst, const int16 *src, uint samples, float gain) {
+	for (uint i = 0; i < samples; i++)
+		dst[i] += src[i] * gain;
+}
+
+float MixBus::peakGeneric(const float *src, uint samples) {
+	float result = 0.0f;
+	for (uint i = 0; i < samples; i++)
+		result = MAX(result, fabsf(src[i]));
+	return result;
+}
+
+void MixBus::outputGeneric(int16 *dst, const float *src, uint samples, float gain) {
+	for (uint i = 0; i < samples; i++) {
+		// Clip before converting, large values do not fit into an int.
+		// lrintf rounds to nearest even, like the SIMD conversions.
+		const float sample = CLIP(src[i] * gain, -32768.0f, 32767.0f);
+		dst[i] = (int16)lrintf(sample);
+	}
+}
+
+} // End of namespace Audio
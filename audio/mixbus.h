@@ -0,0 +1,85 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AUDIO_MIXBUS_H
+#define AUDIO_MIXBUS_H
+
+#include "common/scummsys.h"
+
+namespace Audio {
+
+/**
+ * Kernels working on the float mix bus of the mixer. The bus holds
+ * samples in 16-bit units (full scale is 32768.0), so that unclipped mixes
+ * convert back to exactly the samples the 16-bit mixer produced.
+ *
+ * The kernels come in SIMD variants which are selected at runtime
+ * according to the CPU features. None of them needs aligned buffers.
+ */
+class MixBus {
+public:
+	/** dst[2 * i] += src[2 * i] * gainL, dst[2 * i + 1] += src[2 * i + 1] * gainR */
+	typedef void (*AccumulateStereoFunc)(float *dst, const int16 *src, uint frames, float gainL, float gainR);
+	/** dst[2 * i] += src[i] * gainL, dst[2 * i + 1] += src[i] * gainR */
+	typedef void (*AccumulateMonoToStereoFunc)(float *dst, const int16 *src, uint frames, float gainL, float gainR);
+	/** dst[i] += src[i] * gain */
+	typedef void (*AccumulateMonoFunc)(float *dst, const int16 *src, uint samples, float gain);
+	/** The largest absolute value of the samples */
+	typedef float (*PeakFunc)(const float *src, uint samples);
+	/** dst[i] = src[i] * gain, rounded and saturated to 16 bits */
+	typedef void (*OutputFunc)(int16 *dst, const float *src, uint samples, float gain);
+
+	static AccumulateStereoFunc accumulateStereo;
+	static AccumulateMonoToStereoFunc accumulateMonoToStereo;
+	static AccumulateMonoFunc accumulateMono;
+	static PeakFunc peak;
+	static OutputFunc output;
+
+	/**
+	 * Select the fastest kernels supported by the CPU, unless they have
+	 * been selected already.
+	 */
+	static void selectKernels();
+
+	static void accumulateStereoGeneric(float *dst, const int16 *src, uint frames, float gainL, float gainR);
+	static void accumulateMonoToStereoGeneric(float *dst, const int16 *src, uint frames, float gainL, float gainR);
+	static void accumulateMonoGeneric(float *dst, const int16 *src, uint samples, float gain);
+	static float peakGeneric(const float *src, uint samples);
+	static void outputGeneric(int16 *dst, const float *src, uint samples, float gain);
+#ifdef SCUMMVM_NEON
+	static void accumulateStereoNEON(float *dst, const int16 *src, uint frames, float gainL, float gainR);
+	static void accumulateMonoToStereoNEON(float *dst, const int16 *src, uint frames, float gainL, float gainR);
+	static void accumulateMonoNEON(float *dst, const int16 *src, uint samples, float gain);
+	static float peakNEON(const float *src, uint samples);
+	static void outputNEON(int16 *dst, const float *src, uint samples, float gain);
+#endif
+#ifdef SCUMMVM_SSE2
+	static void accumulateStereoSSE2(float *dst, const int16 *src, uint frames, float gainL, float gainR);
+	static void accumulateMonoToStereoSSE2(float *dst, const int16 *src, uint frames, float gainL, float gainR);
+	static void accumulateMonoSSE2(float *dst, const int16 *src, uint samples, float gain);
+	static float peakSSE2(const float *src, uint samples);
+	static void outputSSE2(int16 *dst, const float *src, uint samples, float gain);
+#endif
+};
+
+} // End of namespace Audio
+
+#endif
@@ -25,6 +25,7 @@
 #include "common/textconsole.h"
 
 #include "audio/mixer_intern.h"
+#include "audio/mixbus.h"
 #include "audio/rate.h"
 #include "audio/audiostream.h"
 #include "audio/timestamp.h"
@@ -42,7 +43,7 @@ namespace Audio {
  */
 class Channel {
 public:
-	Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream, DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent);
+	Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream, DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent, RateConverterQuality quality);
 	~Channel();
 
 	/**
@@ -50,11 +51,10 @@ public:
 	 *
 	 * @param data buffer where to mix the data
 	 * @param len  number of sample *pairs*. So a value of
-	 *             10 means that the buffer contains twice 10 sample, each
-	 *             16 bits, for a total of 40 bytes.
+	 *             10 means that the buffer contains twice 10 samples.
 	 * @return number of sample pairs processed (which can still be silence!)
 	 */
-	int mix(int16 *data, uint len);
+	int mix(float *data, uint len);
 
 	/**
 	 * Queries whether the channel is still playing or not.
@@ -163,10 +163,12 @@ public:
 	void resetRate();
 
 	/**
-	 * Notifies the channel that the global sound type
-	 * volume settings changed.
+	 * Sets the volume of the channel's sound type, which is 0 when
+	 * the type is muted.
+	 *
+	 * @param typeVolume new sound type volume
 	 */
-	void notifyGlobalVolChange() { updateChannelVolumes(); }
+	void setTypeVolume(int typeVolume);
 
 	/**
 	 * Queries how long the channel has been playing.
@@ -203,6 +205,7 @@ private:
 	int _id;
 
 	byte _volume;
+	int _typeVolume;
 	int8 _balance;
 	uint8 _faderL;
 	uint8 _faderR;
@@ -226,18 +229,52 @@ private:
 #pragma mark --- Mixer ---
 #pragma mark -
 
+/**
+ * The limiter reduces the gain of the mix so that its peaks stay within
+ * 16 bits, instead of clipping them. Mixes which do not clip pass through
+ * unchanged.
+ */
+enum {
+	kLimiterReleaseTime = 100, ///< Milliseconds to recover from a gain of 0
+	kLimiterRampFrames = 32    ///< Frames mixed with the same gain while the gain changes
+};
+
+static const float kLimiterCeiling = 32767.0f;
+
+/**
+ * The float bus is allocated up front, so that the audio callback never
+ * allocates memory. It holds at least this many frames, or as many as the
+ * backend said it would ask for at once. Larger requests are mixed in parts.
+ */
+enum {
+	kMinBusFrames = 4096
+};
+
+MixerImpl::ChannelBlock::ChannelBlock() {
+	for (int i = 0; i != CHANNELS_PER_BLOCK; i++)
+		channels[i] = nullptr;
+}
+
 MixerImpl::MixerImpl(uint sampleRate, bool stereo, uint outBufSize)
-	: _mutex(), _sampleRate(sampleRate), _stereo(stereo), _outBufSize(outBufSize), _mixerReady(false), _handleSeed(0), _soundTypeSettings() {
+	: _mutex(), _sampleRate(sampleRate), _stereo(stereo), _outBufSize(outBufSize), _mixerReady(false), _handleSeed(0), _soundTypeSettings(),
+	  _maxChannels(MAX_CHANNELS), _rateConverterQuality(kRateConverterLinear), _numSlots(CHANNELS_PER_BLOCK), _limiterGain(1.0f) {
 
 	assert(sampleRate > 0);
 
-	for (int i = 0; i != NUM_CHANNELS; i++)
-		_channels[i] = nullptr;
+	MixBus::selectKernels();
+
+	_mixBuffer.resize(MAX<uint>(outBufSize, kMinBusFrames) * (stereo ? 2 : 1));
+
+	_blocks[0] = new ChannelBlock();
+	for (int i = 1; i != MAX_CHANNEL_BLOCKS; i++)
+		_blocks[i] = nullptr;
 }
 
 MixerImpl::~MixerImpl() {
-	for (int i = 0; i != NUM_CHANNELS; i++)
-		delete _channels[i];
+	for (uint i = 0; i != _numSlots; i++)
+		delete channel(i);
+	for (int i = 0; i != MAX_CHANNEL_BLOCKS; i++)
+		delete _blocks[i];
 }
 
 void MixerImpl::setReady(bool ready) {
@@ -258,24 +295,68 @@ uint MixerImpl::getOutputBufSize() const {
 	return _outBufSize;
 }
 
-void MixerImpl::insertChannel(SoundHandle *handle, Channel *chan) {
-	int index = -1;
-	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] == nullptr) {
-			index = i;
-			break;
-		}
+void MixerImpl::setMaxChannels(uint maxChannels) {
+	Common::StackLock lock(_mutex);
+	_maxChannels = CLIP<uint>(maxChannels, 1, MAX_CHANNELS);
+}
+
+void MixerImpl::setRateConverterQuality(RateConverterQuality quality) {
+	Common::StackLock lock(_mutex);
+	_rateConverterQuality = quality;
+}
+
+Channel *MixerImpl::findChannel(SoundHandle handle) {
+	// The getters call this without locking the mutex, like they always
+	// did. Blocks are never freed while the mixer exists, so checking the
+	// block instead of _numSlots is safe even while a block is added.
+	const uint index = handle._val % MAX_CHANNELS;
+	const ChannelBlock *block = _blocks[index / CHANNELS_PER_BLOCK];
+	if (!block)
+		return nullptr;
+
+	Channel *chan = block->channels[index % CHANNELS_PER_BLOCK];
+	if (!chan || chan->getHandle()._val != handle._val)
+		return nullptr;
+	return chan;
+}
+
+int MixerImpl::allocateSlot() {
+	const uint numSlots = MIN<uint>(_numSlots, _maxChannels);
+	for (uint i = 0; i != numSlots; i++) {
+		if (!channel(i))
+			return i;
+	}
+
+	if (numSlots == _numSlots && numSlots < _maxChannels) {
+		_blocks[numSlots / CHANNELS_PER_BLOCK] = new ChannelBlock();
+		_numSlots = numSlots + CHANNELS_PER_BLOCK;
+		return numSlots;
 	}
+
+	return -1;
+}
+
+void MixerImpl::updateTypeVolume(SoundType type) {
+	const SoundTypeSettings &settings = _soundTypeSettings[type];
+	for (uint i = 0; i != _numSlots; ++i) {
+		Channel *chan = channel(i);
+		if (chan && chan->getType() == type)
+			chan->setTypeVolume(settings.mute ? 0 : settings.volume);
+	}
+}
+
+void MixerImpl::insertChannel(SoundHandle *handle, Channel *chan) {
+	const int index = allocateSlot();
 	if (index == -1) {
 		warning("MixerImpl::out of mixer slots");
 		delete chan;
 		return;
 	}
 
-	_channels[index] = chan;
+	channel(index) = chan;
 
 	SoundHandle chanHandle;
-	chanHandle._val = index + (_handleSeed * NUM_CHANNELS);
+	chanHandle._val = index + (_handleSeed * MAX_CHANNELS);
 
 	chan->setHandle(chanHandle);
 	_handleSeed++;
@@ -303,8 +384,8 @@ void MixerImpl::playStream(
 
 	// Prevent duplicate sounds
 	if (id != -1) {
-		for (int i = 0; i != NUM_CHANNELS; i++)
-			if (_channels[i] != nullptr && _channels[i]->getId() == id) {
+		for (uint i = 0; i != _numSlots; i++)
+			if (channel(i) != nullptr && channel(i)->getId() == id) {
 				// Delete the stream if were asked to auto-dispose it.
 				// Note: This could cause trouble if the client code does not
 				// yet expect the stream to be gone. The primary example to
@@ -322,7 +403,9 @@ void MixerImpl::playStream(
 #endif
 
 	// Create the channel
-	Channel *chan = new Channel(this, type, stream, autofreeStream, reverseStereo, id, permanent);
+	Channel *chan = new Channel(this, type, stream, autofreeStream, reverseStereo, id, permanent, _rateConverterQuality);
+	const SoundTypeSettings &settings = _soundTypeSettings[type];
+	chan->setTypeVolume(settings.mute ? 0 : settings.volume);
 	chan->setVolume(volume);
 	chan->setBalance(balance);
 	insertChannel(handle, chan);
@@ -338,9 +421,6 @@ int MixerImpl::mixCallback(byte *samples, uint len) {
 	// Since the mixer callback has been called, the mixer must be ready...
 	_mixerReady = true;
 
-	//  zero the buf
-	memset(buf, 0, len);
-
 	// we store 16-bit samples
 	if (_stereo) {
 		assert(len % 4 == 0);
@@ -350,40 +430,91 @@ int MixerImpl::mixCallback(byte *samples, uint len) {
 		len >>= 1;
 	}
 
+	const uint channels = _stereo ? 2 : 1;
+	const uint busFrames = _mixBuffer.size() / channels;
+	int res = 0;
+	for (uint done = 0; done < len; done += busFrames)
+		res += mixFrames(buf + done * channels, MIN(len - done, busFrames));
+
+	return res;
+}
+
+int MixerImpl::mixFrames(int16 *dst, uint frames) {
+	float *bus = _mixBuffer.data();
+	memset(bus, 0, frames * (_stereo ? 2 : 1) * sizeof(float));
+
 	// mix all channels
 	int res = 0, tmp;
-	for (int i = 0; i != NUM_CHANNELS; i++)
-		if (_channels[i]) {
-			if (_channels[i]->isFinished()) {
-				delete _channels[i];
-				_channels[i] = nullptr;
-			} else if (!_channels[i]->isPaused()) {
-				tmp = _channels[i]->mix(buf, len);
+	for (uint i = 0; i != _numSlots; i++) {
+		Channel *&chan = channel(i);
+		if (chan) {
+			if (chan->isFinished()) {
+				delete chan;
+				chan = nullptr;
+			} else if (!chan->isPaused()) {
+				tmp = chan->mix(bus, frames);
 
 				if (tmp > res)
 					res = tmp;
 			}
 		}
+	}
+
+	outputMix(dst, bus, frames);
 
 	return res;
 }
 
+void MixerImpl::outputMix(int16 *dst, const float *src, uint frames) {
+	const uint channels = _stereo ? 2 : 1;
+
+	// The whole block is known in advance, so the gain can be lowered
+	// before its loudest sample. It recovers linearly over
+	// kLimiterReleaseTime, ramping the gain in small steps.
+	const float peak = MixBus::peak(src, frames * channels);
+	const float maxGain = (peak > kLimiterCeiling) ? kLimiterCeiling / peak : 1.0f;
+	const float release = (float)frames * 1000 / (_sampleRate * kLimiterReleaseTime);
+
+	if (maxGain <= _limiterGain) {
+		_limiterGain = maxGain;
+		MixBus::output(dst, src, frames * channels, _limiterGain);
+	} else {
+		const float target = MIN(maxGain, _limiterGain + release);
+		const uint steps = MAX<uint>((frames + kLimiterRampFrames - 1) / kLimiterRampFrames, 1);
+		const float stepGain = (target - _limiterGain) / steps;
+
+		for (uint i = 0; i < frames; i += kLimiterRampFrames) {
+			const uint count = MIN<uint>(frames - i, kLimiterRampFrames);
+			_limiterGain = MIN(_limiterGain + stepGain, target);
+			MixBus::output(dst + i * channels, src + i * channels, count * channels, _limiterGain);
+		}
+		_limiterGain = target;
+	}
+
+#ifdef OUTPUT_UNSIGNED_AUDIO
+	for (uint i = 0; i < frames * channels; i++)
+		dst[i] ^= 0x8000;
+#endif
+}
+
 void MixerImpl::stopAll() {
 	Common::StackLock lock(_mutex);
-	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != nullptr && !_channels[i]->isPermanent()) {
-			delete _channels[i];
-			_channels[i] = nullptr;
+	for (uint i = 0; i != _numSlots; i++) {
+		Channel *&chan = channel(i);
+		if (chan != nullptr && !chan->isPermanent()) {
+			delete chan;
+			chan = nullptr;
 		}
 	}
 }
 
 void MixerImpl::stopID(int id) {
 	Common::StackLock lock(_mutex);
-	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != nullptr && _channels[i]->getId() == id) {
-			delete _channels[i];
-			_channels[i] = nullptr;
+	for (uint i = 0; i != _numSlots; i++) {
+		Channel *&chan = channel(i);
+		if (chan != nullptr && chan->getId() == id) {
+			delete chan;
+			chan = nullptr;
 		}
 	}
 }
@@ -392,22 +523,20 @@ void MixerImpl::stopHandle(SoundHandle handle) {
 	Common::StackLock lock(_mutex);
 
 	// Simply ignore stop requests for handles of sounds that already terminated
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	if (!findChannel(handle))
 		return;
 
-	delete _channels[index];
-	_channels[index] = nullptr;
+	Channel *&chan = channel(handle._val % MAX_CHANNELS);
+	delete chan;
+	chan = nullptr;
 }
 
 void MixerImpl::muteSoundType(SoundType type, bool mute) {
 	assert(0 <= (int)type && (int)type < ARRAYSIZE(_soundTypeSettings));
-	_soundTypeSettings[type].mute = mute;
 
-	for (int i = 0; i != NUM_CHANNELS; ++i) {
-		if (_channels[i] && _channels[i]->getType() == type)
-			_channels[i]->notifyGlobalVolChange();
-	}
+	Common::StackLock lock(_mutex);
+	_soundTypeSettings[type].mute = mute;
+	updateTypeVolume(type);
 }
 
 bool MixerImpl::isSoundTypeMuted(SoundType type) const {
@@ -418,101 +547,74 @@ bool MixerImpl::isSoundTypeMuted(SoundType type) const {
 void MixerImpl::setChannelVolume(SoundHandle handle, byte volume) {
 	Common::StackLock lock(_mutex);
 
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return;
-
-	_channels[index]->setVolume(volume);
+	Channel *chan = findChannel(handle);
+	if (chan)
+		chan->setVolume(volume);
 }
 
 byte MixerImpl::getChannelVolume(SoundHandle handle) {
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return 0;
-
-	return _channels[index]->getVolume();
+	Channel *chan = findChannel(handle);
+	return chan ? chan->getVolume() : 0;
 }
 
 void MixerImpl::setChannelBalance(SoundHandle handle, int8 balance) {
 	Common::StackLock lock(_mutex);
 
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return;
-
-	_channels[index]->setBalance(balance);
+	Channel *chan = findChannel(handle);
+	if (chan)
+		chan->setBalance(balance);
 }
 
 int8 MixerImpl::getChannelBalance(SoundHandle handle) {
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return 0;
-
-	return _channels[index]->getBalance();
+	Channel *chan = findChannel(handle);
+	return chan ? chan->getBalance() : 0;
 }
 
 void MixerImpl::setChannelFaderL(SoundHandle handle, uint8 faderL) {
 	Common::StackLock lock(_mutex);
 
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return;
-
-	_channels[index]->setFaderL(faderL);
+	Channel *chan = findChannel(handle);
+	if (chan)
+		chan->setFaderL(faderL);
 }
 
 uint8 MixerImpl::getChannelFaderL(SoundHandle handle) {
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return 0;
-
-	return _channels[index]->getFaderL();
+	Channel *chan = findChannel(handle);
+	return chan ? chan->getFaderL() : 0;
 }
 
 void MixerImpl::setChannelFaderR(SoundHandle handle, uint8 faderR) {
 	Common::StackLock lock(_mutex);
 
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return;
-
-	_channels[index]->setFaderR(faderR);
+	Channel *chan = findChannel(handle);
+	if (chan)
+		chan->setFaderR(faderR);
 }
 
 uint8 MixerImpl::getChannelFaderR(SoundHandle handle) {
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return 0;
-
-	return _channels[index]->getFaderR();
+	Channel *chan = findChannel(handle);
+	return chan ? chan->getFaderR() : 0;
 }
 
 void MixerImpl::setChannelRate(SoundHandle handle, uint32 rate) {
 	Common::StackLock lock(_mutex);
 
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return;
-
-	_channels[index]->setRate(rate);
+	Channel *chan = findChannel(handle);
+	if (chan)
+		chan->setRate(rate);
 }
 
 uint32 MixerImpl::getChannelRate(SoundHandle handle) {
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return 0;
-
-	return _channels[index]->getRate();
+	Channel *chan = findChannel(handle);
+	return chan ? chan->getRate() : 0;
 }
 
 void MixerImpl::resetChannelRate(SoundHandle handle) {
 	Common::StackLock lock(_mutex);
 
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return;
-
-	_channels[index]->resetRate();
+	Channel *chan = findChannel(handle);
+	if (chan)
+		chan->resetRate();
 }
 
 uint32 MixerImpl::getSoundElapsedTime(SoundHandle handle) {
@@ -522,37 +624,35 @@ uint32 MixerImpl::getSoundElapsedTime(SoundHandle handle) {
 Timestamp MixerImpl::getElapsedTime(SoundHandle handle) {
 	Common::StackLock lock(_mutex);
 
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	Channel *chan = findChannel(handle);
+	if (!chan)
 		return Timestamp(0, _sampleRate);
 
-	return _channels[index]->getElapsedTime();
+	return chan->getElapsedTime();
 }
 
 void MixerImpl::loopChannel(SoundHandle handle) {
 	Common::StackLock lock(_mutex);
 
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return;
-
-	_channels[index]->loop();
+	Channel *chan = findChannel(handle);
+	if (chan)
+		chan->loop();
 }
 
 void MixerImpl::pauseAll(bool paused) {
 	Common::StackLock lock(_mutex);
-	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != nullptr) {
-			_channels[i]->pause(paused);
+	for (uint i = 0; i != _numSlots; i++) {
+		if (channel(i) != nullptr) {
+			channel(i)->pause(paused);
 		}
 	}
 }
 
 void MixerImpl::pauseID(int id, bool paused) {
 	Common::StackLock lock(_mutex);
-	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != nullptr && _channels[i]->getId() == id) {
-			_channels[i]->pause(paused);
+	for (uint i = 0; i != _numSlots; i++) {
+		if (channel(i) != nullptr && channel(i)->getId() == id) {
+			channel(i)->pause(paused);
 			return;
 		}
 	}
@@ -562,11 +662,9 @@ void MixerImpl::pauseHandle(SoundHandle handle, bool paused) {
 	Common::StackLock lock(_mutex);
 
 	// Simply ignore (un)pause requests for sounds that already terminated
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return;
-
-	_channels[index]->pause(paused);
+	Channel *chan = findChannel(handle);
+	if (chan)
+		chan->pause(paused);
 }
 
 bool MixerImpl::isSoundIDActive(int id) {
@@ -576,18 +674,16 @@ bool MixerImpl::isSoundIDActive(int id) {
 	g_eventRec.updateSubsystems();
 #endif
 
-	for (int i = 0; i != NUM_CHANNELS; i++)
-		if (_channels[i] && _channels[i]->getId() == id)
+	for (uint i = 0; i != _numSlots; i++)
+		if (channel(i) && channel(i)->getId() == id)
 			return true;
 	return false;
 }
 
 int MixerImpl::getSoundID(SoundHandle handle) {
 	Common::StackLock lock(_mutex);
-	const int index = handle._val % NUM_CHANNELS;
-	if (_channels[index] && _channels[index]->getHandle()._val == handle._val)
-		return _channels[index]->getId();
-	return 0;
+	Channel *chan = findChannel(handle);
+	return chan ? chan->getId() : 0;
 }
 
 bool MixerImpl::isSoundHandleActive(SoundHandle handle) {
@@ -597,14 +693,13 @@ bool MixerImpl::isSoundHandleActive(SoundHandle handle) {
 	g_eventRec.updateSubsystems();
 #endif
 
-	const int index = handle._val % NUM_CHANNELS;
-	return _channels[index] && _channels[index]->getHandle()._val == handle._val;
+	return findChannel(handle) != nullptr;
 }
 
 bool MixerImpl::hasActiveChannelOfType(SoundType type) {
 	Common::StackLock lock(_mutex);
-	for (int i = 0; i != NUM_CHANNELS; i++)
-		if (_channels[i] && _channels[i]->getType() == type)
+	for (uint i = 0; i != _numSlots; i++)
+		if (channel(i) && channel(i)->getType() == type)
 			return true;
 	return false;
 }
@@ -620,11 +715,7 @@ void MixerImpl::setVolumeForSoundType(SoundType type, int volume) {
 
 	Common::StackLock lock(_mutex);
 	_soundTypeSettings[type].volume = volume;
-
-	for (int i = 0; i != NUM_CHANNELS; ++i) {
-		if (_channels[i] && _channels[i]->getType() == type)
-			_channels[i]->notifyGlobalVolChange();
-	}
+	updateTypeVolume(type);
 }
 
 int MixerImpl::getVolumeForSoundType(SoundType type) const {
@@ -639,8 +730,8 @@ int MixerImpl::getVolumeForSoundType(SoundType type) const {
 #pragma mark -
 
 Channel::Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream,
-				 DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent)
-	: _type(type), _mixer(mixer), _id(id), _permanent(permanent), _volume(Mixer::kMaxChannelVolume),
+				 DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent, RateConverterQuality quality)
+	: _type(type), _mixer(mixer), _id(id), _permanent(permanent), _volume(Mixer::kMaxChannelVolume), _typeVolume(Mixer::kMaxMixerVolume),
 	  _balance(0), _faderL(255), _faderR(255), _pauseLevel(0), _samplesConsumed(0), _samplesDecoded(0), _mixerTimeStamp(0),
 	  _pauseStartTime(0), _pauseTime(0), _converter(nullptr), _volL(0), _volR(0),
 	  _stream(stream, autofreeStream) {
@@ -648,7 +739,7 @@ Channel::Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream,
 	assert(stream);
 
 	// Get a rate converter instance
-	_converter = makeRateConverter(_stream->getRate(), mixer->getOutputRate(), _stream->isStereo(), mixer->getOutputStereo(), reverseStereo);
+	_converter = makeRateConverter(_stream->getRate(), mixer->getOutputRate(), _stream->isStereo(), mixer->getOutputStereo(), reverseStereo, quality);
 }
 
 Channel::~Channel() {
@@ -664,6 +755,11 @@ byte Channel::getVolume() {
 	return _volume;
 }
 
+void Channel::setTypeVolume(int typeVolume) {
+	_typeVolume = typeVolume;
+	updateChannelVolumes();
+}
+
 void Channel::setBalance(const int8 balance) {
 	_balance = balance;
 	updateChannelVolumes();
@@ -718,8 +814,8 @@ void Channel::updateChannelVolumes() {
 	// volume is in the range 0 - kMaxMixerVolume.
 	// Hence, the vol_l/vol_r values will be in that range, too
 
-	if (!_mixer->isSoundTypeMuted(_type)) {
-		int vol = _mixer->getVolumeForSoundType(_type) * _volume;
+	if (_typeVolume) {
+		int vol = _typeVolume * _volume;
 
 		if (_balance == 0) {
 			_volL = vol / Mixer::kMaxChannelVolume;
@@ -793,7 +889,7 @@ void Channel::loop() {
 	}
 }
 
-int Channel::mix(int16 *data, uint len) {
+int Channel::mix(float *data, uint len) {
 	assert(_stream);
 	assert(_converter);
 
@@ -23,8 +23,10 @@
 #define AUDIO_MIXER_INTERN_H
 
 #include "common/scummsys.h"
+#include "common/array.h"
 #include "common/mutex.h"
 #include "audio/mixer.h"
+#include "audio/rate.h"
 
 namespace Audio {
 
@@ -58,7 +60,9 @@ namespace Audio {
 class MixerImpl : public Mixer {
 private:
 	enum {
-		NUM_CHANNELS = 32
+		CHANNELS_PER_BLOCK = 32,
+		MAX_CHANNEL_BLOCKS = 16,
+		MAX_CHANNELS = CHANNELS_PER_BLOCK * MAX_CHANNEL_BLOCKS
 	};
 
 	Common::Mutex _mutex;
@@ -76,8 +80,25 @@ private:
 		int volume;
 	};
 
+	/**
+	 * Channel slots are allocated in blocks, as more sounds are played at
+	 * the same time. Blocks are only freed by the destructor.
+	 */
+	struct ChannelBlock {
+		ChannelBlock();
+
+		Channel *channels[CHANNELS_PER_BLOCK];
+	};
+
 	SoundTypeSettings _soundTypeSettings[4];
-	Channel *_channels[NUM_CHANNELS];
+	uint _maxChannels;
+	RateConverterQuality _rateConverterQuality;
+
+	ChannelBlock *_blocks[MAX_CHANNEL_BLOCKS];
+	uint _numSlots;
+
+	Common::Array<float> _mixBuffer;
+	float _limiterGain;
 
 
 public:
@@ -140,9 +161,33 @@ public:
 	bool getOutputStereo() const override;
 	uint getOutputBufSize() const override;
 
+	/**
+	 * Limit the number of sounds which can play at the same time. The
+	 * channel slots grow on demand up to this number, which is at most
+	 * MAX_CHANNELS (the default).
+	 */
+	void setMaxChannels(uint maxChannels);
+	uint getMaxChannels() const { return _maxChannels; }
+
+	/**
+	 * Set how sounds are resampled to the output rate. This only affects
+	 * sounds which are started afterwards.
+	 */
+	void setRateConverterQuality(RateConverterQuality quality);
+	RateConverterQuality getRateConverterQuality() const { return _rateConverterQuality; }
+
 protected:
 	void insertChannel(SoundHandle *handle, Channel *chan);
 
+private:
+	Channel *&channel(uint index) { return _blocks[index / CHANNELS_PER_BLOCK]->channels[index % CHANNELS_PER_BLOCK]; }
+
+	Channel *findChannel(SoundHandle handle);
+	int allocateSlot();
+	void updateTypeVolume(SoundType type);
+	int mixFrames(int16 *dst, uint frames);
+	void outputMix(int16 *dst, const float *src, uint frames);
+
 public:
 	/**
 	 * The mixer callback function, to be called at regular intervals by
@@ -21,12 +21,14 @@ MODULE_OBJS := \
 	midiplayer.o \
 	miles_adlib.o \
 	miles_midi.o \
+	mixbus.o \
 	mixer.o \
 	mpu401.o \
 	mt32gm.o \
 	musicplugin.o \
 	null.o \
 	rate.o \
+	sinc.o \
 	sid.o \
 	timestamp.o \
 	decoders/3do.o \
@@ -138,5 +140,17 @@ MODULE_OBJS += \
 	soundfont/vab/vab.o
 endif
 
+ifdef SCUMMVM_NEON
+MODULE_OBJS += \
+	mixbus-neon.o \
+	sinc-neon.o
+endif
+
+ifdef SCUMMVM_SSE2
+MODULE_OBJS += \
+	mixbus-sse2.o \
+	sinc-sse2.o
+endif
+
 # Include common rules
 include $(srcdir)/rules.mk
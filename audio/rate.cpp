@@ -30,6 +30,8 @@
 #include "audio/audiostream.h"
 #include "audio/rate.h"
 #include "audio/mixer.h"
+#include "audio/mixbus.h"
+#include "audio/sinc.h"
 #include "common/util.h"
 
 namespace Audio {
@@ -45,6 +47,84 @@ enum {
 	FRAC_HALF_LOW = (1L << (FRAC_BITS_LOW-1))
 };
 
+enum {
+	/** Input samples per channel kept for the sinc filter */
+	SINC_HISTORY_SIZE = 512,
+
+	/** Output samples filtered at once by the sinc converter */
+	SINC_CHUNK_SIZE = 256
+};
+
+/**
+ * Add a frame to a 16-bit output buffer, clipping the result.
+ */
+template<bool outStereo, bool reverseStereo>
+static FORCEINLINE void mixFrame(st_sample_t *outBuffer, st_sample_t inL, st_sample_t inR, st_volume_t volL, st_volume_t volR) {
+	st_sample_t outL, outR;
+	outL = (inL * (int)volL) / Audio::Mixer::kMaxMixerVolume;
+	outR = (inR * (int)volR) / Audio::Mixer::kMaxMixerVolume;
+
+	if (outStereo) {
+		// Output left channel
+		clampedAdd(outBuffer[reverseStereo    ], outL);
+
+		// Output right channel
+		clampedAdd(outBuffer[reverseStereo ^ 1], outR);
+	} else {
+		// Output mono channel
+		clampedAdd(outBuffer[0], (outL + outR) / 2);
+	}
+}
+
+/**
+ * Add a filtered frame to a 16-bit output buffer, clipping the result.
+ */
+template<bool outStereo, bool reverseStereo>
+static FORCEINLINE void mixFrame(st_sample_t *outBuffer, float inL, float inR, st_volume_t volL, st_volume_t volR) {
+	const int outL = (int)lrintf(inL * (int)volL * (1.0f / Audio::Mixer::kMaxMixerVolume));
+	const int outR = (int)lrintf(inR * (int)volR * (1.0f / Audio::Mixer::kMaxMixerVolume));
+
+	if (outStereo) {
+		clampedAdd(outBuffer[reverseStereo    ], outL);
+		clampedAdd(outBuffer[reverseStereo ^ 1], outR);
+	} else {
+		clampedAdd(outBuffer[0], (outL + outR) / 2);
+	}
+}
+
+/**
+ * Add a filtered frame to a float mix buffer.
+ */
+template<bool outStereo, bool reverseStereo>
+static FORCEINLINE void mixFrame(float *outBuffer, float inL, float inR, st_volume_t volL, st_volume_t volR) {
+	const float outL = inL * (int)volL * (1.0f / Audio::Mixer::kMaxMixerVolume);
+	const float outR = inR * (int)volR * (1.0f / Audio::Mixer::kMaxMixerVolume);
+
+	if (outStereo) {
+		outBuffer[reverseStereo    ] += outL;
+		outBuffer[reverseStereo ^ 1] += outR;
+	} else {
+		outBuffer[0] += (outL + outR) * 0.5f;
+	}
+}
+
+/**
+ * Add a frame to a float mix buffer. The products of a sample and a volume
+ * fit into the float mantissa, so the scaling is exact.
+ */
+template<bool outStereo, bool reverseStereo>
+static FORCEINLINE void mixFrame(float *outBuffer, st_sample_t inL, st_sample_t inR, st_volume_t volL, st_volume_t volR) {
+	const float outL = (float)(inL * (int)volL) * (1.0f / Audio::Mixer::kMaxMixerVolume);
+	const float outR = (float)(inR * (int)volR) * (1.0f / Audio::Mixer::kMaxMixerVolume);
+
+	if (outStereo) {
+		outBuffer[reverseStereo    ] += outL;
+		outBuffer[reverseStereo ^ 1] += outR;
+	} else {
+		outBuffer[0] += (outL + outR) * 0.5f;
+	}
+}
+
 template<bool inStereo, bool outStereo, bool reverseStereo>
 class RateConverter_Impl : public RateConverter {
 private:
@@ -76,15 +156,61 @@ private:
 	/** Current sample(s) in the input stream (left/right channel) */
 	st_sample_t _inCurL, _inCurR;
 
-	int copyConvert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t vol_l, st_volume_t vol_r);
-	int simpleConvert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t vol_l, st_volume_t vol_r);
-	int interpolateConvert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t vol_l, st_volume_t vol_r);
+	/**
+	 * The input of the sinc filter, converted to float and split into
+	 * channels, each SINC_HISTORY_SIZE samples long. Only allocated for
+	 * the sinc quality.
+	 */
+	float *_history;
+
+	/** Number of samples per channel in the history */
+	uint _historyLength;
+
+	/** Position of the next output sample in the history, as 32.32 fixed point */
+	uint64 _historyPos;
+
+	/** Whether the end of the input stream has been added to the history */
+	bool _historyFlushed;
+
+	/**
+	 * Whether the history is in use. From then on all input goes through
+	 * it regardless of the rates, since the other conversions would skip
+	 * the samples buffered in it.
+	 */
+	bool _sincStarted;
+
+	bool useSinc() const { return _history && (_sincStarted || _inRate < _outRate); }
+	bool refillHistory(AudioStream &input);
+
+	template<typename T>
+	int copyConvert(AudioStream &input, T *outBuffer, st_size_t numSamples, st_volume_t vol_l, st_volume_t vol_r);
+	template<typename T>
+	int simpleConvert(AudioStream &input, T *outBuffer, st_size_t numSamples, st_volume_t vol_l, st_volume_t vol_r);
+	template<typename T>
+	int interpolateConvert(AudioStream &input, T *outBuffer, st_size_t numSamples, st_volume_t vol_l, st_volume_t vol_r);
+	template<typename T>
+	int sincConvert(AudioStream &input, T *outBuffer, st_size_t numSamples, st_volume_t vol_l, st_volume_t vol_r);
+	template<typename T>
+	int convertTo(AudioStream &input, T *outBuffer, st_size_t numSamples, st_volume_t vol_l, st_volume_t vol_r);
+
+	/**
+	 * Add as much of the input buffer as fits to the output in one go,
+	 * using the SIMD mix bus kernels. Returns false if that is not possible
+	 * for this output and channel layout.
+	 */
+	bool accumulateBuffer(st_sample_t *&outBuffer, const st_sample_t *outEnd, st_volume_t vol_l, st_volume_t vol_r) { return false; }
+	bool accumulateBuffer(float *&outBuffer, const float *outEnd, st_volume_t vol_l, st_volume_t vol_r);
 
 public:
-	RateConverter_Impl(st_rate_t inputRate, st_rate_t outputRate);
-	virtual ~RateConverter_Impl() {}
+	RateConverter_Impl(st_rate_t inputRate, st_rate_t outputRate, RateConverterQuality quality);
+	virtual ~RateConverter_Impl() { delete[] _history; }
 
-	int convert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t vol_l, st_volume_t vol_r) override;
+	int convert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t vol_l, st_volume_t vol_r) override {
+		return convertTo(input, outBuffer, numSamples, vol_l, vol_r);
+	}
+	int convert(AudioStream &input, float *outBuffer, st_size_t numSamples, st_volume_t vol_l, st_volume_t vol_r) override {
+		return convertTo(input, outBuffer, numSamples, vol_l, vol_r);
+	}
 
 	void setInputRate(st_rate_t inputRate) override { _inRate = inputRate; }
 	void setOutputRate(st_rate_t outputRate) override { _outRate = outputRate; }
@@ -92,12 +218,20 @@ public:
 	st_rate_t getInputRate() const override { return _inRate; }
 	st_rate_t getOutputRate() const override { return _outRate; }
 
-	bool needsDraining() const override { return _bufferSize != 0; }
+	bool needsDraining() const override {
+		if (_bufferSize != 0)
+			return true;
+
+		// The last input samples only leave the filter once the end of
+		// the stream has been seen
+		return useSinc() && (!_historyFlushed || (uint)(_historyPos >> 32) + SincFilter::kTaps <= _historyLength);
+	}
 };
 
 template<bool inStereo, bool outStereo, bool reverseStereo>
-int RateConverter_Impl<inStereo, outStereo, reverseStereo>::copyConvert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t volL, st_volume_t volR) {
-	st_sample_t *outStart, *outEnd;
+template<typename T>
+int RateConverter_Impl<inStereo, outStereo, reverseStereo>::copyConvert(AudioStream &input, T *outBuffer, st_size_t numSamples, st_volume_t volL, st_volume_t volR) {
+	T *outStart, *outEnd;
 
 	outStart = outBuffer;
 	outEnd = outBuffer + numSamples * (outStereo ? 2 : 1);
@@ -112,41 +246,29 @@ int RateConverter_Impl<inStereo, outStereo, reverseStereo>::copyConvert(AudioStr
 				return (outBuffer - outStart) / (outStereo ? 2 : 1);
 		}
 
+		if (accumulateBuffer(outBuffer, outEnd, volL, volR))
+			continue;
+
 		// Mix the data into the output buffer
 		st_sample_t inL, inR;
 		inL = *_bufferPos++;
 		inR = (inStereo ? *_bufferPos++ : inL);
 		_bufferSize -= (inStereo ? 2 : 1);
 
-		st_sample_t outL, outR;
-		outL = (inL * (int)volL) / Audio::Mixer::kMaxMixerVolume;
-		outR = (inR * (int)volR) / Audio::Mixer::kMaxMixerVolume;
-
-		if (outStereo) {
-			// Output left channel
-			clampedAdd(outBuffer[reverseStereo    ], outL);
-
-			// Output right channel
-			clampedAdd(outBuffer[reverseStereo ^ 1], outR);
-
-			outBuffer += 2;
-		} else {
-			// Output mono channel
-			clampedAdd(outBuffer[0], (outL + outR) / 2);
-
-			outBuffer += 1;
-		}
+		mixFrame<outStereo, reverseStereo>(outBuffer, inL, inR, volL, volR);
+		outBuffer += (outStereo ? 2 : 1);
 	}
 
 	return (outBuffer - outStart) / (outStereo ? 2 : 1);
 }
 
 template<bool inStereo, bool outStereo, bool reverseStereo>
-int RateConverter_Impl<inStereo, outStereo, reverseStereo>::simpleConvert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t volL, st_volume_t volR) {
+template<typename T>
+int RateConverter_Impl<inStereo, outStereo, reverseStereo>::simpleConvert(AudioStream &input, T *outBuffer, st_size_t numSamples, st_volume_t volL, st_volume_t volR) {
 	// How much to increment _outPos by
 	frac_t outPos_inc = _inRate / _outRate;
 
-	st_sample_t *outStart, *outEnd;
+	T *outStart, *outEnd;
 
 	outStart = outBuffer;
 	outEnd = outBuffer + numSamples * (outStereo ? 2 : 1);
@@ -178,34 +300,19 @@ int RateConverter_Impl<inStereo, outStereo, reverseStereo>::simpleConvert(AudioS
 		// Increment output position
 		_outPos += outPos_inc;
 
-		st_sample_t outL, outR;
-		outL = (inL * (int)volL) / Audio::Mixer::kMaxMixerVolume;
-		outR = (inR * (int)volR) / Audio::Mixer::kMaxMixerVolume;
-
-		if (outStereo) {
-			// output left channel
-			clampedAdd(outBuffer[reverseStereo    ], outL);
-
-			// output right channel
-			clampedAdd(outBuffer[reverseStereo ^ 1], outR);
-
-			outBuffer += 2;
-		} else {
-			// output mono channel
-			clampedAdd(outBuffer[0], (outL + outR) / 2);
-
-			outBuffer += 1;
-		}
+		mixFrame<outStereo, reverseStereo>(outBuffer, inL, inR, volL, volR);
+		outBuffer += (outStereo ? 2 : 1);
 	}
 	return (outBuffer - outStart) / (outStereo ? 2 : 1);
 }
 
 template<bool inStereo, bool outStereo, bool reverseStereo>
-int RateConverter_Impl<inStereo, outStereo, reverseStereo>::interpolateConvert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t volL, st_volume_t volR) {
+template<typename T>
+int RateConverter_Impl<inStereo, outStereo, reverseStereo>::interpolateConvert(AudioStream &input, T *outBuffer, st_size_t numSamples, st_volume_t volL, st_volume_t volR) {
 	// How much to increment _outPosFrac by
 	frac_t outPos_inc = (_inRate << FRAC_BITS_LOW) / _outRate;
 
-	st_sample_t *outStart, *outEnd;
+	T *outStart, *outEnd;
 	outStart = outBuffer;
 	outEnd = outBuffer + numSamples * (outStereo ? 2 : 1);
 
@@ -243,34 +350,112 @@ int RateConverter_Impl<inStereo, outStereo, reverseStereo>::interpolateConvert(A
 						(st_sample_t)(_inLastR + (((_inCurR - _inLastR) * _outPosFrac + FRAC_HALF_LOW) >> FRAC_BITS_LOW)) :
 						inL);
 
-			st_sample_t outL, outR;
-			outL = (inL * (int)volL) / Audio::Mixer::kMaxMixerVolume;
-			outR = (inR * (int)volR) / Audio::Mixer::kMaxMixerVolume;
+			mixFrame<outStereo, reverseStereo>(outBuffer, inL, inR, volL, volR);
+			outBuffer += (outStereo ? 2 : 1);
 
-			if (outStereo) {
-				// Output left channel
-				clampedAdd(outBuffer[reverseStereo    ], outL);
+			// Increment output position
+			_outPosFrac += outPos_inc;
+		}
+	}
+	return (outBuffer - outStart) / (outStereo ? 2 : 1);
+}
 
-				// Output right channel
-				clampedAdd(outBuffer[reverseStereo ^ 1], outR);
+template<bool inStereo, bool outStereo, bool reverseStereo>
+bool RateConverter_Impl<inStereo, outStereo, reverseStereo>::refillHistory(AudioStream &input) {
+	// Drop the samples before the window of the next output sample
+	const uint consumed = MIN<uint>((uint)(_historyPos >> 32), _historyLength);
+	if (consumed) {
+		for (int channel = 0; channel < (inStereo ? 2 : 1); channel++) {
+			float *history = _history + channel * SINC_HISTORY_SIZE;
+			memmove(history, history + consumed, (_historyLength - consumed) * sizeof(float));
+		}
+		_historyLength -= consumed;
+		_historyPos -= (uint64)consumed << 32;
+	}
+
+	// Samples left over by the other conversions are used up first
+	if (_bufferSize == 0) {
+		_bufferPos = _buffer;
+		_bufferSize = input.readBuffer(_buffer, MIN<int>(ARRAYSIZE(_buffer), (SINC_HISTORY_SIZE - _historyLength) * (inStereo ? 2 : 1)));
+
+		if (_bufferSize <= 0) {
+			_bufferSize = 0;
+			if (!input.endOfStream() || _historyFlushed)
+				return false;
+
+			// Append silence, so that the filter window can move past the
+			// last sample
+			for (int channel = 0; channel < (inStereo ? 2 : 1); channel++)
+				memset(_history + channel * SINC_HISTORY_SIZE + _historyLength, 0, SincFilter::kTaps / 2 * sizeof(float));
+			_historyLength += SincFilter::kTaps / 2;
+			_historyFlushed = true;
+			return true;
+		}
+	}
 
-				outBuffer += 2;
-			} else {
-				// Output mono channel
-				clampedAdd(outBuffer[0], (outL + outR) / 2);
+	const uint frames = MIN<uint>(_bufferSize / (inStereo ? 2 : 1), SINC_HISTORY_SIZE - _historyLength);
+	float *left = _history + _historyLength;
+	float *right = _history + SINC_HISTORY_SIZE + _historyLength;
+	for (uint i = 0; i < frames; i++) {
+		left[i] = *_bufferPos++;
+		if (inStereo)
+			right[i] = *_bufferPos++;
+	}
+	_bufferSize -= frames * (inStereo ? 2 : 1);
+	_historyLength += frames;
+	return true;
+}
 
-				outBuffer += 1;
+template<bool inStereo, bool outStereo, bool reverseStereo>
+template<typename T>
+int RateConverter_Impl<inStereo, outStereo, reverseStereo>::sincConvert(AudioStream &input, T *outBuffer, st_size_t numSamples, st_volume_t volL, st_volume_t volR) {
+	// How much to increment _historyPos by
+	const uint64 step = ((uint64)_inRate << 32) / _outRate;
+
+	float left[SINC_CHUNK_SIZE], right[SINC_CHUNK_SIZE];
+
+	if (!_sincStarted) {
+		// Start from the last sample the other conversions read rather
+		// than from silence
+		if (_bufferPos && _bufferPos > _buffer) {
+			const st_sample_t *last = _bufferPos - (inStereo ? 2 : 1);
+			for (uint i = 0; i < _historyLength; i++) {
+				_history[i] = last[0];
+				if (inStereo)
+					_history[SINC_HISTORY_SIZE + i] = last[1];
 			}
+		}
+		_sincStarted = true;
+	}
 
-			// Increment output position
-			_outPosFrac += outPos_inc;
+	T *outStart, *outEnd;
+	outStart = outBuffer;
+	outEnd = outBuffer + numSamples * (outStereo ? 2 : 1);
+
+	while (outBuffer < outEnd) {
+		const uint wanted = MIN<uint>(SINC_CHUNK_SIZE, (outEnd - outBuffer) / (outStereo ? 2 : 1));
+
+		uint64 rightPos = _historyPos;
+		const uint frames = SincFilter::filter(left, _history, _historyLength, _historyPos, step, wanted);
+		if (inStereo)
+			SincFilter::filter(right, _history + SINC_HISTORY_SIZE, _historyLength, rightPos, step, frames);
+
+		if (frames == 0) {
+			if (!refillHistory(input))
+				break;
+			continue;
+		}
+
+		for (uint i = 0; i < frames; i++) {
+			mixFrame<outStereo, reverseStereo>(outBuffer, left[i], inStereo ? right[i] : left[i], volL, volR);
+			outBuffer += (outStereo ? 2 : 1);
 		}
 	}
 	return (outBuffer - outStart) / (outStereo ? 2 : 1);
 }
 
 template<bool inStereo, bool outStereo, bool reverseStereo>
-RateConverter_Impl<inStereo, outStereo, reverseStereo>::RateConverter_Impl(st_rate_t inputRate, st_rate_t outputRate) :
+RateConverter_Impl<inStereo, outStereo, reverseStereo>::RateConverter_Impl(st_rate_t inputRate, st_rate_t outputRate, RateConverterQuality quality) :
 	_inRate(inputRate),
 	_outRate(outputRate),
 	_outPos(1),
@@ -280,13 +465,52 @@ RateConverter_Impl<inStereo, outStereo, reverseStereo>::RateConverter_Impl(st_ra
 	_inCurL(0),
 	_inCurR(0),
 	_bufferSize(0),
-	_bufferPos(nullptr) {}
+	_bufferPos(nullptr),
+	_history(nullptr),
+	_historyLength(SincFilter::kTaps / 2 - 1),
+	_historyPos(0),
+	_historyFlushed(false),
+	_sincStarted(false) {
+
+	if (quality == kRateConverterSinc) {
+		// The first input sample is at the center of the filter window
+		_history = new float[SINC_HISTORY_SIZE * (inStereo ? 2 : 1)];
+		memset(_history, 0, _historyLength * sizeof(float));
+		memset(_history + (inStereo ? SINC_HISTORY_SIZE : 0), 0, _historyLength * sizeof(float));
+	}
+}
 
 template<bool inStereo, bool outStereo, bool reverseStereo>
-int RateConverter_Impl<inStereo, outStereo, reverseStereo>::convert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t volL, st_volume_t volR) {
+bool RateConverter_Impl<inStereo, outStereo, reverseStereo>::accumulateBuffer(float *&outBuffer, const float *outEnd, st_volume_t volL, st_volume_t volR) {
+	// The kernels do not swap channels or downmix stereo
+	if (reverseStereo || (inStereo && !outStereo))
+		return false;
+
+	const uint frames = MIN<uint>(_bufferSize / (inStereo ? 2 : 1), (outEnd - outBuffer) / (outStereo ? 2 : 1));
+	const float gainL = (float)volL / Audio::Mixer::kMaxMixerVolume;
+	const float gainR = (float)volR / Audio::Mixer::kMaxMixerVolume;
+
+	if (inStereo)
+		MixBus::accumulateStereo(outBuffer, _bufferPos, frames, gainL, gainR);
+	else if (outStereo)
+		MixBus::accumulateMonoToStereo(outBuffer, _bufferPos, frames, gainL, gainR);
+	else
+		MixBus::accumulateMono(outBuffer, _bufferPos, frames, (gainL + gainR) * 0.5f);
+
+	_bufferPos += frames * (inStereo ? 2 : 1);
+	_bufferSize -= frames * (inStereo ? 2 : 1);
+	outBuffer += frames * (outStereo ? 2 : 1);
+	return true;
+}
+
+template<bool inStereo, bool outStereo, bool reverseStereo>
+template<typename T>
+int RateConverter_Impl<inStereo, outStereo, reverseStereo>::convertTo(AudioStream &input, T *outBuffer, st_size_t numSamples, st_volume_t volL, st_volume_t volR) {
 	assert(input.isStereo() == inStereo);
 
-	if (_inRate == _outRate) {
+	if (useSinc()) {
+		return sincConvert(input, outBuffer, numSamples, volL, volR);
+	} else if (_inRate == _outRate) {
 		return copyConvert(input, outBuffer, numSamples, volL, volR);
 	} else {
 		if ((_inRate % _outRate) == 0 && (_inRate < 65536)) {
@@ -297,20 +521,26 @@ int RateConverter_Impl<inStereo, outStereo, reverseStereo>::convert(AudioStream
 	}
 }
 
-RateConverter *makeRateConverter(st_rate_t inRate, st_rate_t outRate, bool inStereo, bool outStereo, bool reverseStereo) {
+RateConverter *makeRateConverter(st_rate_t inRate, st_rate_t outRate, bool inStereo, bool outStereo, bool reverseStereo, RateConverterQuality quality) {
+	if (quality == kRateConverterSinc) {
+		// Set up the coefficients here rather than in the audio thread
+		SincFilter::selectKernels();
+		SincFilter::coefficients();
+	}
+
 	if (inStereo) {
 		if (outStereo) {
 			if (reverseStereo)
-				return new RateConverter_Impl<true, true, true>(inRate, outRate);
+				return new RateConverter_Impl<true, true, true>(inRate, outRate, quality);
 			else
-				return new RateConverter_Impl<true, true, false>(inRate, outRate);
+				return new RateConverter_Impl<true, true, false>(inRate, outRate, quality);
 		} else
-			return new RateConverter_Impl<true, false, false>(inRate, outRate);
+			return new RateConverter_Impl<true, false, false>(inRate, outRate, quality);
 	} else {
 		if (outStereo) {
-			return new RateConverter_Impl<false, true, false>(inRate, outRate);
+			return new RateConverter_Impl<false, true, false>(inRate, outRate, quality);
 		} else
-			return new RateConverter_Impl<false, false, false>(inRate, outRate);
+			return new RateConverter_Impl<false, false, false>(inRate, outRate, quality);
 	}
 }
 
@@ -66,6 +66,24 @@ static inline void clampedAdd(int16& a, int b) {
 #endif
 }
 
+/**
+ * Resampling methods of a RateConverter.
+ */
+enum RateConverterQuality {
+	/**
+	 * Linear interpolation when upsampling. It is cheap, but makes high
+	 * frequency images of the input audible.
+	 */
+	kRateConverterLinear,
+
+	/**
+	 * A windowed sinc filter when upsampling, which suppresses the images.
+	 * It takes about twice as long as linear interpolation with the SIMD
+	 * kernels, and considerably longer without them.
+	 */
+	kRateConverterSinc
+};
+
 /**
  * Helper class that handles resampling an AudioStream between an input and output
  * sample rate. Its regular use case is upsampling from the native stream rate
@@ -90,6 +108,15 @@ public:
 	 */
 	virtual int convert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t vol_l, st_volume_t vol_r) = 0;
 
+	/**
+	 * Convert the provided AudioStream to the target sample rate, adding
+	 * the result to a float mix buffer. The samples are in 16-bit units and
+	 * are not clipped.
+	 *
+	 * @see convert(AudioStream &, st_sample_t *, st_size_t, st_volume_t, st_volume_t)
+	 */
+	virtual int convert(AudioStream &input, float *outBuffer, st_size_t numSamples, st_volume_t vol_l, st_volume_t vol_r) = 0;
+
 	virtual void setInputRate(st_rate_t inputRate) = 0;
 	virtual void setOutputRate(st_rate_t outputRate) = 0;
 
@@ -104,7 +131,11 @@ public:
 	virtual bool needsDraining() const = 0;
 };
 
-RateConverter *makeRateConverter(st_rate_t inRate, st_rate_t outRate, bool inStereo, bool outStereo, bool reverseStereo);
+/**
+ * Create a RateConverter. Downsampling and conversions between equal rates
+ * are done the same way for all qualities.
+ */
+RateConverter *makeRateConverter(st_rate_t inRate, st_rate_t outRate, bool inStereo, bool outStereo, bool reverseStereo, RateConverterQuality quality = kRateConverterLinear);
 
 /** @} */
 } // End of namespace Audio
@@ -0,0 +1,86 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#ifdef SCUMMVM_NEON
+
+#include "audio/sinc.h"
+
+#include <arm_neon.h>
+
+#if !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("neon"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("fpu=neon")
+#endif
+
+#endif // !defined(__aarch64__) && !defined(__ARM_NEON)
+
+namespace Audio {
+
+static FORCEINLINE float32x4_t neon_dot(const float *samples, const float *coeffs) {
+	float32x4_t sum = vmulq_f32(vld1q_f32(samples), vld1q_f32(coeffs));
+	for (int k = 4; k < SincFilter::kTaps; k += 4)
+		sum = vmlaq_f32(sum, vld1q_f32(samples + k), vld1q_f32(coeffs + k));
+	return sum;
+}
+
+uint SincFilter::filterNEON(float *dst, const float *src, uint length, uint64 &pos, uint64 step, uint count) {
+	const float *table = coefficients();
+
+	// Two output samples at a time, which share the horizontal additions
+	uint i = 0;
+	while (i + 2 <= count) {
+		const uint64 last = pos + step;
+		if ((uint)(last >> 32) + kTaps > length)
+			break;
+
+		const float32x4_t sum0 = neon_dot(src + (uint)(pos >> 32), table + phase(pos) * kTaps);
+		pos += step;
+		const float32x4_t sum1 = neon_dot(src + (uint)(pos >> 32), table + phase(pos) * kTaps);
+		pos += step;
+
+		const float32x2_t pairs0 = vadd_f32(vget_low_f32(sum0), vget_high_f32(sum0));
+		const float32x2_t pairs1 = vadd_f32(vget_low_f32(sum1), vget_high_f32(sum1));
+		vst1_f32(dst + i, vpadd_f32(pairs0, pairs1));
+		i += 2;
+	}
+
+	return i + filterGeneric(dst + i, src, length, pos, step, count - i);
+}
+
+} // End of namespace Audio
+
+#if !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif // !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#endif // SCUMMVM_NEON
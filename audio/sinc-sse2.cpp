@@ -0,0 +1,86 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#include "audio/sinc.h"
+
+#include <emmintrin.h>
+
+#if !defined(__x86_64__)
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("sse2"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("sse2")
+#endif
+
+#endif // !defined(__x86_64__)
+
+namespace Audio {
+
+static FORCEINLINE __m128 sse2_dot(const float *samples, const float *coeffs) {
+	__m128 sum = _mm_mul_ps(_mm_loadu_ps(samples), _mm_loadu_ps(coeffs));
+	for (int k = 4; k < SincFilter::kTaps; k += 4)
+		sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(samples + k), _mm_loadu_ps(coeffs + k)));
+	return sum;
+}
+
+uint SincFilter::filterSSE2(float *dst, const float *src, uint length, uint64 &pos, uint64 step, uint count) {
+	const float *table = coefficients();
+
+	// Four output samples at a time, whose sums are added up horizontally
+	// with a single transpose
+	uint i = 0;
+	while (i + 4 <= count) {
+		const uint64 last = pos + 3 * step;
+		if ((uint)(last >> 32) + kTaps > length)
+			break;
+
+		__m128 sum0 = sse2_dot(src + (uint)(pos >> 32), table + phase(pos) * kTaps);
+		pos += step;
+		__m128 sum1 = sse2_dot(src + (uint)(pos >> 32), table + phase(pos) * kTaps);
+		pos += step;
+		__m128 sum2 = sse2_dot(src + (uint)(pos >> 32), table + phase(pos) * kTaps);
+		pos += step;
+		__m128 sum3 = sse2_dot(src + (uint)(pos >> 32), table + phase(pos) * kTaps);
+		pos += step;
+
+		_MM_TRANSPOSE4_PS(sum0, sum1, sum2, sum3);
+		_mm_storeu_ps(dst + i, _mm_add_ps(_mm_add_ps(sum0, sum1), _mm_add_ps(sum2, sum3)));
+		i += 4;
+	}
+
+	return i + filterGeneric(dst + i, src, length, pos, step, count - i);
+}
+
+} // End of namespace Audio
+
+#if !defined(__x86_64__)
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif // !defined(__x86_64__)
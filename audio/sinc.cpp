@@ -0,0 +1,132 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/system.h"
+
+#include "audio/sinc.h"
+
+namespace Audio {
+
+SincFilter::FilterFunc SincFilter::filter = nullptr;
+
+void SincFilter::selectKernels() {
+	if (filter)
+		return;
+
+	filter = filterGeneric;
+	if (!g_system)
+		return;
+#ifdef SCUMMVM_NEON
+	if (g_system->hasFeature(OSystem::kFeatureCpuNEON))
+		filter = filterNEON;
+#endif
+#ifdef SCUMMVM_SSE2
+	if (g_system->hasFeature(OSystem::kFeatureCpuSSE2))
+		filter = filterSSE2;
+#endif
+}
+
+namespace {
+
+/** The cutoff frequency, relative to the Nyquist frequency of the input */
+const double kCutoff = 0.9;
+
+/** Shape of the Kaiser window, giving a stopband attenuation of about 60 dB */
+const double kKaiserBeta = 6.0;
+
+// Zeroth order modified Bessel function of the first kind
+double besselI0(double x) {
+	double sum = 1.0, term = 1.0;
+	for (int k = 1; k < 50 && term > sum * 1e-12; k++) {
+		term *= (x * x) / (4.0 * k * k);
+		sum += term;
+	}
+	return sum;
+}
+
+struct SincTable {
+	SincTable() {
+		const double halfWidth = SincFilter::kTaps / 2;
+		const double windowScale = 1.0 / besselI0(kKaiserBeta);
+
+		data = new float[(SincFilter::kPhases + 1) * SincFilter::kTaps];
+		for (int p = 0; p <= SincFilter::kPhases; p++) {
+			float *row = data + p * SincFilter::kTaps;
+			const double center = SincFilter::kTaps / 2 - 1 + (double)p / SincFilter::kPhases;
+
+			double coeffs[SincFilter::kTaps];
+			double sum = 0.0;
+			for (int k = 0; k < SincFilter::kTaps; k++) {
+				const double x = center - k;
+				const double r = x / halfWidth;
+				const double window = (r * r < 1.0) ? besselI0(kKaiserBeta * sqrt(1.0 - r * r)) * windowScale : 0.0;
+				const double arg = M_PI * kCutoff * x;
+				const double sinc = (x == 0.0) ? 1.0 : sin(arg) / arg;
+
+				coeffs[k] = kCutoff * sinc * window;
+				sum += coeffs[k];
+			}
+
+			// Normalize the gain of each phase, otherwise it would ripple
+			// with the position
+			for (int k = 0; k < SincFilter::kTaps; k++)
+				row[k] = (float)(coeffs[k] / sum);
+		}
+	}
+
+	~SincTable() {
+		delete[] data;
+	}
+
+	float *data;
+};
+
+} // End of anonymous namespace
+
+const float *SincFilter::coefficients() {
+	// Set up on first use, which is thread safe in C++11
+	static const SincTable table;
+	return table.data;
+}
+
+uint SincFilter::filterGeneric(float *dst, const float *src, uint length, uint64 &pos, uint64 step, uint count) {
+	const float *table = coefficients();
+
+	uint i = 0;
+	for (; i < count; i++) {
+		const uint index = (uint)(pos >> 32);
+		if (index + kTaps > length)
+			break;
+
+		const float *samples = src + index;
+		const float *coeffs = table + phase(pos) * kTaps;
+		float sum = 0.0f;
+		for (int k = 0; k < kTaps; k++)
+			sum += samples[k] * coeffs[k];
+
+		dst[i] = sum;
+		pos += step;
+	}
+
+	return i;
+}
+
+} // End of namespace Audio
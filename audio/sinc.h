@@ -0,0 +1,93 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AUDIO_SINC_H
+#define AUDIO_SINC_H
+
+#include "common/scummsys.h"
+
+namespace Audio {
+
+/**
+ * The windowed sinc filter of the high quality rate converter. It
+ * interpolates the input at arbitrary fractional positions, using
+ * precomputed coefficients for kPhases positions between two samples.
+ *
+ * The cutoff is just below the Nyquist frequency of the input, so the
+ * filter only suppresses the images created by upsampling. Downsampling
+ * would need a lower cutoff.
+ *
+ * The kernels come in SIMD variants which are selected at runtime
+ * according to the CPU features.
+ */
+class SincFilter {
+public:
+	enum {
+		kTaps = 24,                ///< Input samples contributing to each output sample
+		kPhaseBits = 10,
+		kPhases = 1 << kPhaseBits  ///< Positions between two input samples with their own coefficients
+	};
+
+	/**
+	 * Compute output samples at the 32.32 fixed point input positions pos,
+	 * pos + step, pos + 2 * step and so on. Position 0 is the center of the
+	 * window starting at src[0], which is kTaps / 2 - 1 samples later.
+	 *
+	 * It stops after count samples, or when the window of the next sample
+	 * extends past the length samples of src. pos is advanced past the
+	 * last output sample.
+	 *
+	 * @return number of samples written to dst
+	 */
+	typedef uint (*FilterFunc)(float *dst, const float *src, uint length, uint64 &pos, uint64 step, uint count);
+
+	static FilterFunc filter;
+
+	/**
+	 * Select the fastest kernels supported by the CPU, unless they have
+	 * been selected already.
+	 */
+	static void selectKernels();
+
+	/**
+	 * The coefficients, kTaps for each of the kPhases + 1 phases. The
+	 * last phase is for a position a whole sample after the first one,
+	 * which positions just below the next sample round to.
+	 */
+	static const float *coefficients();
+
+	/** The phase used for the fractional part of a position */
+	static inline uint phase(uint64 pos) {
+		return (uint)(((pos & 0xFFFFFFFF) + (1U << (31 - kPhaseBits))) >> (32 - kPhaseBits));
+	}
+
+	static uint filterGeneric(float *dst, const float *src, uint length, uint64 &pos, uint64 step, uint count);
+#ifdef SCUMMVM_NEON
+	static uint filterNEON(float *dst, const float *src, uint length, uint64 &pos, uint64 step, uint count);
+#endif
+#ifdef SCUMMVM_SSE2
+	static uint filterSSE2(float *dst, const float *src, uint length, uint64 &pos, uint64 step, uint count);
+#endif
+};
+
+} // End of namespace Audio
+
+#endif
@@ -136,7 +136,7 @@ public:
 
 	void initSizeHint(const Graphics::ModeList &modes) override;
 
-	Common::Keymap *getKeymap();
+	virtual Common::Keymap *getKeymap();
 
 protected:
 	enum CustomEventAction {
@@ -150,7 +150,8 @@ protected:
 		kActionIncreaseScaleFactor,
 		kActionDecreaseScaleFactor,
 		kActionNextScaleFilter,
-		kActionPreviousScaleFilter
+		kActionPreviousScaleFilter,
+		kActionToggleScalerTiming
 	};
 
 	/** Obtain the user configured fullscreen resolution, or default to the desktop resolution */
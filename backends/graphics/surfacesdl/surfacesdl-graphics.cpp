@@ -24,7 +24,10 @@
 #if defined(SDL_BACKEND)
 #include "backends/graphics/surfacesdl/surfacesdl-graphics.h"
 #include "backends/events/sdl/sdl-events.h"
+#include "backends/keymapper/action.h"
+#include "backends/keymapper/keymap.h"
 #include "common/config-manager.h"
+#include "common/jobs.h"
 #include "common/mutex.h"
 #include "common/textconsole.h"
 #include "common/translation.h"
@@ -117,6 +120,25 @@ static SDL_Surface *createSurface(int width, int height, SDL_Surface *surface) {
 #endif
 }
 
+#ifdef USE_OSD
+// SDL 1.2 has no high resolution timer, fall back to milliseconds there
+static uint64 getPerformanceCounter() {
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+	return SDL_GetPerformanceCounter();
+#else
+	return SDL_GetTicks();
+#endif
+}
+
+static uint64 getPerformanceFrequency() {
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+	return SDL_GetPerformanceFrequency();
+#else
+	return 1000;
+#endif
+}
+#endif
+
 static const OSystem::GraphicsMode s_supportedGraphicsModes[] = {
 	{"surfacesdl", _s("SDL Surface"), GFX_SURFACESDL},
 	{nullptr, nullptr, 0}
@@ -166,7 +188,8 @@ SurfaceSdlGraphicsManager::SurfaceSdlGraphicsManager(SdlEventSource *sdlEventSou
 	SdlGraphicsManager(sdlEventSource, window),
 #ifdef USE_OSD
 	_osdMessageSurface(nullptr), _osdMessageAlpha(SDL_ALPHA_TRANSPARENT), _osdMessageFadeStartTime(0),
-	_osdIconSurface(nullptr),
+	_osdIconSurface(nullptr), _osdTimingSurface(nullptr), _showScalerTiming(false),
+	_scalerTime(0), _scalerTimeFrames(0), _scalerTimeLastUpdate(0),
 #endif
 #if SDL_VERSION_ATLEAST(2, 0, 0)
 	_renderer(nullptr), _screenTexture(nullptr),
@@ -190,7 +213,7 @@ SurfaceSdlGraphicsManager::SurfaceSdlGraphicsManager(SdlEventSource *sdlEventSou
 	_enableFocusRectDebugCode(false), _enableFocusRect(false), _focusRect(),
 #endif
 	_transactionMode(kTransactionNone),
-	_scalerPlugins(ScalerMan.getPlugins()), _scalerPlugin(nullptr), _scaler(nullptr),
+	_scalerPlugins(ScalerMan.getPlugins()), _scalerPlugin(nullptr), _scaler(nullptr), _parallelScaling(false),
 	_needRestoreAfterOverlay(false), _isInOverlayPalette(false), _isDoubleBuf(false), _prevForceRedraw(false), _numPrevDirtyRects(0),
 	_prevCursorNeedsRedraw(false),
 	_mouseKeyColor(0), _disableMouseKeyColor(false) {
@@ -728,6 +751,7 @@ void SurfaceSdlGraphicsManager::setGraphicsModeIntern() {
 	_scaler->setFactor(_videoMode.scaleFactor);
 	_extraPixels = _scalerPlugin->extraPixels();
 	_useOldSrc = _scalerPlugin->useOldSource();
+	_parallelScaling = _scalerPlugin->canScaleInParallel();
 	if (_useOldSrc) {
 		_scaler->enableSource(true);
 		_scaler->setSource((byte *)_tmpscreen->pixels, _tmpscreen->pitch,
@@ -1133,6 +1157,11 @@ void SurfaceSdlGraphicsManager::unloadGFXMode() {
 		destroySurface(_osdIconSurface);
 		_osdIconSurface = nullptr;
 	}
+
+	if (_osdTimingSurface) {
+		destroySurface(_osdTimingSurface);
+		_osdTimingSurface = nullptr;
+	}
 #endif
 
 #if defined(WIN32) && !SDL_VERSION_ATLEAST(2, 0, 0)
@@ -1211,6 +1240,40 @@ void SurfaceSdlGraphicsManager::updateScreen(SDL_Rect *dirtyRectList, int actual
 	SDL_UpdateRects(_hwScreen, actualDirtyRects, dirtyRectList);
 }
 
+void SurfaceSdlGraphicsManager::scaleBandsProc(uint begin, uint end, void *param) {
+	const ScaleBands *bands = (const ScaleBands *)param;
+
+	bands->scaler->scale(bands->src + begin * bands->srcPitch, bands->srcPitch,
+			bands->dst + begin * bands->factor * bands->dstPitch, bands->dstPitch,
+			bands->width, end - begin, bands->x, bands->y + begin);
+}
+
+void SurfaceSdlGraphicsManager::scaleRect(const byte *src, uint32 srcPitch, byte *dst, uint32 dstPitch,
+                                          int width, int height, int x, int y, int factor) {
+	// Plain copies at 1x are not worth handing out to the workers
+	if (!_parallelScaling || factor == 1 || JobMan.getWorkerCount() == 0) {
+		_scaler->scale(src, srcPitch, dst, dstPitch, width, height, x, y);
+		return;
+	}
+
+	ScaleBands bands;
+	bands.scaler = _scaler;
+	bands.src = src;
+	bands.srcPitch = srcPitch;
+	bands.dst = dst;
+	bands.dstPitch = dstPitch;
+	bands.width = width;
+	bands.x = x;
+	bands.y = y;
+	bands.factor = factor;
+
+	// The bands only write their own rows, but the scaler reads up to
+	// extraPixels rows above and below each of them. Keep the bands high
+	// enough for these rows, which are read twice, to be a small share.
+	const uint minBandHeight = MAX<uint>(16, 8 * _extraPixels);
+	JobMan.parallelFor(height, scaleBandsProc, &bands, minBandHeight);
+}
+
 void SurfaceSdlGraphicsManager::internUpdateScreen() {
 	SDL_Surface *srcSurf, *origSurf;
 	int height, width;
@@ -1409,6 +1472,10 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 		srcPitch = srcSurf->pitch;
 		dstPitch = _hwScreen->pitch;
 
+#ifdef USE_OSD
+		const uint64 scaleStart = _showScalerTiming ? getPerformanceCounter() : 0;
+#endif
+
 		for (r = _dirtyRectList; r != lastRect; ++r) {
 			int src_x = r->x;
 			int src_y = r->y;
@@ -1453,8 +1520,8 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 				if (_videoMode.aspectRatioCorrection && !_overlayVisible)
 					dst_y = real2Aspect(dst_y);
 
-				_scaler->scale((byte *)srcSurf->pixels + (src_x + _maxExtraPixels) * bpp + (src_y + _maxExtraPixels) * srcPitch, srcPitch,
-						(byte *)_hwScreen->pixels + dst_x * bpp + dst_y * dstPitch, dstPitch, dst_w, dst_h, src_x, src_y);
+				scaleRect((byte *)srcSurf->pixels + (src_x + _maxExtraPixels) * bpp + (src_y + _maxExtraPixels) * srcPitch, srcPitch,
+						(byte *)_hwScreen->pixels + dst_x * bpp + dst_y * dstPitch, dstPitch, dst_w, dst_h, src_x, src_y, scale1);
 
 				r->x = dst_x;
 				r->y = dst_y;
@@ -1470,6 +1537,14 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 		SDL_UnlockSurface(srcSurf);
 		SDL_UnlockSurface(_hwScreen);
 
+#ifdef USE_OSD
+		if (_showScalerTiming) {
+			_scalerTime += getPerformanceCounter() - scaleStart;
+			_scalerTimeFrames++;
+			updateScalerTiming();
+		}
+#endif
+
 		// Readjust the dirty rect list in case we are doing a full update.
 		// This is necessary if shaking is active.
 		if (_forceRedraw) {
@@ -2841,7 +2916,7 @@ void SurfaceSdlGraphicsManager::updateOSD() {
 		}
 	}
 
-	if (_osdIconSurface || _osdMessageSurface) {
+	if (_osdIconSurface || _osdMessageSurface || _osdTimingSurface) {
 		// Redraw the area below the icon and message for the transparent blit to give correct results.
 		_forceRedraw = true;
 	}
@@ -2857,6 +2932,77 @@ void SurfaceSdlGraphicsManager::drawOSD() {
 		SDL_Rect dstRect = getOSDIconRect();
 		SDL_BlitSurface(_osdIconSurface, nullptr, _hwScreen, &dstRect);
 	}
+
+	if (_osdTimingSurface) {
+		SDL_Rect dstRect = getOSDTimingRect();
+		SDL_BlitSurface(_osdTimingSurface, nullptr, _hwScreen, &dstRect);
+	}
+}
+
+SDL_Rect SurfaceSdlGraphicsManager::getOSDTimingRect() const {
+	SDL_Rect dstRect;
+	dstRect.x = 10;
+	dstRect.y = 10;
+	dstRect.w = _osdTimingSurface->w;
+	dstRect.h = _osdTimingSurface->h;
+	return dstRect;
+}
+
+void SurfaceSdlGraphicsManager::updateScalerTiming() {
+	const uint32 now = SDL_GetTicks();
+	if (now - _scalerTimeLastUpdate < 1000 || !_scalerTimeFrames)
+		return;
+
+	const uint32 micros = _scalerTime * 1000000 / getPerformanceFrequency() / _scalerTimeFrames;
+	const uint threads = _parallelScaling ? JobMan.getWorkerCount() + 1 : 1;
+	const Common::U32String lines[] = {
+		Common::U32String::format("%S: %d.%02d ms", _("Scaling time per frame").c_str(), micros / 1000, micros % 1000 / 10),
+		Common::U32String::format("%S: %d", _("Scaler threads").c_str(), threads)
+	};
+
+	_scalerTime = 0;
+	_scalerTimeFrames = 0;
+	_scalerTimeLastUpdate = now;
+
+	if (_osdTimingSurface)
+		destroySurface(_osdTimingSurface);
+
+	const Graphics::Font *font = FontMan.getFontByUsage(Graphics::FontManager::kLocalizedFont);
+	const int vOffset = 4;
+	const int lineHeight = font->getFontHeight() + 2;
+	int width = 0;
+	for (uint i = 0; i < ARRAYSIZE(lines); i++)
+		width = MAX(width, font->getStringWidth(lines[i]) + 14);
+	width = MIN<int>(width, _hwScreen->w);
+	const int height = MIN<int>(lineHeight * ARRAYSIZE(lines) + 2 * vOffset, _hwScreen->h);
+
+	_osdTimingSurface = createSurface(width, height, _hwScreen);
+	if (!lockSurface(_osdTimingSurface))
+		error("updateScalerTiming: SDL_LockSurface failed: %s", SDL_GetError());
+
+#if SDL_VERSION_ATLEAST(3, 0, 0)
+	SDL_FillSurfaceRect(_osdTimingSurface, nullptr, SDL_MapSurfaceRGB(_osdTimingSurface, 64, 64, 64));
+	const uint32 color = SDL_MapSurfaceRGB(_osdTimingSurface, 255, 255, 255);
+#else
+	SDL_FillRect(_osdTimingSurface, nullptr, SDL_MapRGB(_osdTimingSurface->format, 64, 64, 64));
+	const uint32 color = SDL_MapRGB(_osdTimingSurface->format, 255, 255, 255);
+#endif
+
+	Graphics::Surface dst;
+	dst.init(_osdTimingSurface->w, _osdTimingSurface->h, _osdTimingSurface->pitch, _osdTimingSurface->pixels,
+		convertSDLPixelFormat(_osdTimingSurface->format));
+	for (uint i = 0; i < ARRAYSIZE(lines); i++)
+		font->drawString(&dst, lines[i], 7, vOffset + i * lineHeight + 1, width - 14, color, Graphics::kTextAlignLeft);
+
+	SDL_UnlockSurface(_osdTimingSurface);
+}
+
+void SurfaceSdlGraphicsManager::removeScalerTiming() {
+	if (_osdTimingSurface) {
+		destroySurface(_osdTimingSurface);
+		_osdTimingSurface = nullptr;
+		_forceRedraw = true;
+	}
 }
 
 #endif
@@ -3004,11 +3150,38 @@ bool SurfaceSdlGraphicsManager::notifyEvent(const Common::Event &event) {
 		return true;
 	}
 
+#ifdef USE_OSD
+	case kActionToggleScalerTiming: {
+		Common::StackLock lock(_graphicsMutex);
+
+		_showScalerTiming = !_showScalerTiming;
+		_scalerTime = 0;
+		_scalerTimeFrames = 0;
+		_scalerTimeLastUpdate = SDL_GetTicks();
+		if (!_showScalerTiming)
+			removeScalerTiming();
+		return true;
+	}
+#endif
+
 	default:
 		return SdlGraphicsManager::notifyEvent(event);
 	}
 }
 
+Common::Keymap *SurfaceSdlGraphicsManager::getKeymap() {
+	Common::Keymap *keymap = SdlGraphicsManager::getKeymap();
+
+#ifdef USE_OSD
+	Common::Action *act = new Common::Action("SCLT", _("Toggle scaler timing display"));
+	act->addDefaultInputMapping("C+A+t");
+	act->setCustomBackendActionEvent(kActionToggleScalerTiming);
+	keymap->addAction(act);
+#endif
+
+	return keymap;
+}
+
 void SurfaceSdlGraphicsManager::notifyVideoExpose() {
 	_forceRedraw = true;
 }
@@ -129,6 +129,8 @@ public:
 	// Override from Common::EventObserver
 	bool notifyEvent(const Common::Event &event) override;
 
+	Common::Keymap *getKeymap() override;
+
 	// SdlGraphicsManager interface
 	void notifyVideoExpose() override;
 	void notifyResize(const int width, const int height) override;
@@ -161,6 +163,22 @@ protected:
 	/** Screen rectangle where the OSD background activity icon is drawn */
 	SDL_Rect getOSDIconRect() const;
 
+	/** Surface containing the scaler timing readout */
+	SDL_Surface *_osdTimingSurface;
+	/** Whether the scaler timing readout is enabled */
+	bool _showScalerTiming;
+	/** Performance counter ticks spent scaling since the last readout */
+	uint64 _scalerTime;
+	/** Number of frames scaled since the last readout */
+	uint _scalerTimeFrames;
+	/** When the readout was last refreshed (in milliseconds) */
+	uint32 _scalerTimeLastUpdate;
+	/** Screen rectangle where the scaler timing readout is drawn */
+	SDL_Rect getOSDTimingRect() const;
+	/** Refresh the scaler timing readout once per second */
+	void updateScalerTiming();
+	void removeScalerTiming();
+
 	void updateOSD();
 	void drawOSD();
 #endif
@@ -345,6 +363,28 @@ protected:
 	Scaler *_scaler, *_mouseScaler;
 	uint _maxExtraPixels;
 	uint _extraPixels;
+	/** Whether the scaler can work on several bands of a rect in parallel */
+	bool _parallelScaling;
+
+	struct ScaleBands {
+		Scaler *scaler;
+		const byte *src;
+		uint32 srcPitch;
+		byte *dst;
+		uint32 dstPitch;
+		int width;
+		int x, y;
+		int factor;
+	};
+
+	static void scaleBandsProc(uint begin, uint end, void *param);
+
+	/**
+	 * Scale a rect of the game screen or overlay, split into horizontal
+	 * bands which are scaled on the job system workers.
+	 */
+	void scaleRect(const byte *src, uint32 srcPitch, byte *dst, uint32 dstPitch,
+	               int width, int height, int x, int y, int factor);
 
 	bool _screenIsLocked;
 	Graphics::Surface _framebuffer;
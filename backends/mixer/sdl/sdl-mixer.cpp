@@ -144,6 +144,12 @@ void SdlMixerManager::init() {
 
 	_mixer = new Audio::MixerImpl(_obtained.freq, _obtained.channels >= 2, desiredSamples);
 	assert(_mixer);
+
+	// The sinc filter is about twice as expensive as linear interpolation
+	// even with SIMD kernels, so it has to be asked for
+	if (ConfMan.hasKey("sinc_resampling") && ConfMan.getBool("sinc_resampling"))
+		_mixer->setRateConverterQuality(Audio::kRateConverterSinc);
+
 	_mixer->setReady(true);
 
 	startAudio();
@@ -215,6 +215,7 @@ MODULE_OBJS += \
 	mixer/sdl/sdl-mixer.o \
 	mixer/null/null-mixer.o \
 	mutex/sdl/sdl-mutex.o \
+	threads/sdl/sdl-threads.o \
 	timer/sdl/sdl-timer.o
 
 ifndef USE_SDL3
@@ -347,6 +348,7 @@ MODULE_OBJS += \
 	fs/android/android-saf-fs.o \
 	graphics/android/android-graphics.o \
 	mutex/pthread/pthread-mutex.o \
+	threads/pthread/pthread-threads.o \
 	networking/basic/android/jni.o \
 	networking/basic/android/socket.o \
 	networking/basic/android/url.o
@@ -441,6 +443,7 @@ ifdef IPHONE
 MODULE_OBJS += \
 	midi/coremidi.o \
 	mutex/pthread/pthread-mutex.o \
+	threads/pthread/pthread-threads.o \
 	graphics/ios/ios-graphics.o \
 	graphics/ios/renderbuffer.o
 
@@ -67,6 +67,7 @@
 #include "backends/audiocd/default/default-audiocd.h"
 #include "backends/events/default/default-events.h"
 #include "backends/mutex/pthread/pthread-mutex.h"
+#include "backends/threads/pthread/pthread-threads.h"
 #include "backends/saves/default/default-saves.h"
 #include "backends/timer/default/default-timer.h"
 
@@ -916,6 +917,42 @@ Common::MutexInternal *OSystem_Android::createMutex() {
 	return createPthreadMutexInternal();
 }
 
+struct AndroidThreadStart {
+	Common::ThreadProc proc;
+	void *param;
+};
+
+// Worker threads may end up calling into Java, e.g. for logging or file
+// access, so they have to be attached to the VM like our own threads.
+static void androidThreadProc(void *arg) {
+	AndroidThreadStart *start = (AndroidThreadStart *)arg;
+
+	JNI::attachThread();
+	start->proc(start->param);
+	JNI::detachThread();
+
+	delete start;
+}
+
+Common::ThreadInternal *OSystem_Android::createThread(Common::ThreadProc proc, void *param) {
+	AndroidThreadStart *start = new AndroidThreadStart();
+	start->proc = proc;
+	start->param = param;
+
+	Common::ThreadInternal *thread = createPthreadThreadInternal(androidThreadProc, start);
+	if (!thread)
+		delete start;
+	return thread;
+}
+
+Common::SemaphoreInternal *OSystem_Android::createSemaphore(uint initialValue) {
+	return createPthreadSemaphoreInternal(initialValue);
+}
+
+uint OSystem_Android::getCPUCount() {
+	return getPthreadCPUCount();
+}
+
 void OSystem_Android::quit() {
 	ENTER();
 
@@ -0,0 +1,131 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#define FORBIDDEN_SYMBOL_EXCEPTION_time_h
+#define FORBIDDEN_SYMBOL_EXCEPTION_unistd_h
+
+#include "backends/threads/pthread/pthread-threads.h"
+
+#include <pthread.h>
+#include <unistd.h>
+
+/**
+ * pthreads thread implementation
+ */
+class PthreadThreadInternal final : public Common::ThreadInternal {
+public:
+	PthreadThreadInternal(Common::ThreadProc proc, void *param) : _proc(proc), _param(param), _started(false) {}
+	~PthreadThreadInternal() override;
+
+	bool start();
+
+private:
+	static void *threadFunc(void *data);
+
+	Common::ThreadProc _proc;
+	void *_param;
+	pthread_t _thread;
+	bool _started;
+};
+
+PthreadThreadInternal::~PthreadThreadInternal() {
+	if (_started && pthread_join(_thread, nullptr) != 0)
+		warning("pthread_join() failed");
+}
+
+bool PthreadThreadInternal::start() {
+	_started = (pthread_create(&_thread, nullptr, threadFunc, this) == 0);
+	return _started;
+}
+
+void *PthreadThreadInternal::threadFunc(void *data) {
+	PthreadThreadInternal *thread = (PthreadThreadInternal *)data;
+	thread->_proc(thread->_param);
+	return nullptr;
+}
+
+/**
+ * pthreads semaphore implementation, built from a mutex and a condition
+ * variable since unnamed POSIX semaphores are not available everywhere.
+ */
+class PthreadSemaphoreInternal final : public Common::SemaphoreInternal {
+public:
+	PthreadSemaphoreInternal(uint initialValue);
+	~PthreadSemaphoreInternal() override;
+
+	void wait() override;
+	void post() override;
+
+private:
+	pthread_mutex_t _mutex;
+	pthread_cond_t _cond;
+	uint _value;
+};
+
+PthreadSemaphoreInternal::PthreadSemaphoreInternal(uint initialValue) : _value(initialValue) {
+	if (pthread_mutex_init(&_mutex, nullptr) != 0)
+		warning("pthread_mutex_init() failed");
+	if (pthread_cond_init(&_cond, nullptr) != 0)
+		warning("pthread_cond_init() failed");
+}
+
+PthreadSemaphoreInternal::~PthreadSemaphoreInternal() {
+	pthread_cond_destroy(&_cond);
+	pthread_mutex_destroy(&_mutex);
+}
+
+void PthreadSemaphoreInternal::wait() {
+	pthread_mutex_lock(&_mutex);
+	while (_value == 0)
+		pthread_cond_wait(&_cond, &_mutex);
+	_value--;
+	pthread_mutex_unlock(&_mutex);
+}
+
+void PthreadSemaphoreInternal::post() {
+	pthread_mutex_lock(&_mutex);
+	_value++;
+	pthread_cond_signal(&_cond);
+	pthread_mutex_unlock(&_mutex);
+}
+
+Common::ThreadInternal *createPthreadThreadInternal(Common::ThreadProc proc, void *param) {
+	PthreadThreadInternal *thread = new PthreadThreadInternal(proc, param);
+	if (!thread->start()) {
+		warning("pthread_create() failed");
+		delete thread;
+		return nullptr;
+	}
+	return thread;
+}
+
+Common::SemaphoreInternal *createPthreadSemaphoreInternal(uint initialValue) {
+	return new PthreadSemaphoreInternal(initialValue);
+}
+
+uint getPthreadCPUCount() {
+#ifdef _SC_NPROCESSORS_ONLN
+	long count = sysconf(_SC_NPROCESSORS_ONLN);
+	if (count > 1)
+		return (uint)count;
+#endif
+	return 1;
+}
@@ -43,6 +43,7 @@
 #include "common/events.h"
 #include "gui/EventRecorder.h"
 #include "common/fs.h"
+#include "common/jobs.h"
 #ifdef ENABLE_EVENTRECORDER
 #include "common/recorderfile.h"
 #endif
@@ -905,6 +906,7 @@ extern "C" int scummvm_main(int argc, const char * const argv[]) {
 #endif
 	PluginManager::destroy();
 	GUI::GuiManager::destroy();
+	Common::JobSystem::destroy();
 	Common::ConfigManager::destroy();
 	Common::DebugManager::destroy();
 	Common::OSDMessageQueue::destroy();
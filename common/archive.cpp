@@ -249,50 +249,78 @@ SeekableReadStream *MemcachingCaseInsensitiveArchive::createReadStreamForMemberI
 	cacheKey.path = translatePath(path);
 	cacheKey.altStreamType = isAltStream ? altStreamType : AltStreamType::Invalid;
 
-	bool isNew = false;
 	if (!_cache.contains(cacheKey)) {
 		SharedArchiveContents readResult = isAltStream ? readContentsForPathAltStream(cacheKey.path, altStreamType) : readContentsForPath(cacheKey.path);
 		if (readResult._bypass)
 			return readResult._bypass;
-		_cache[cacheKey] = readResult;
-		isNew = true;
+		_cache[cacheKey].contents = readResult;
 	}
 
-	SharedArchiveContents* entry = &_cache[cacheKey];
+	CacheEntry *entry = &_cache[cacheKey];
 
 	// Errors and missing files. Just return nullptr,
 	// no need to create stream.
-	if (entry->isFileMissing())
+	if (entry->contents.isFileMissing())
 		return nullptr;
 
 	// Check whether the entry is still valid as WeakPtr might have expired.
-	if (!entry->makeStrong()) {
+	if (!entry->contents.makeStrong()) {
 		// If it's expired, recreate the entry.
 		SharedArchiveContents readResult = isAltStream ? readContentsForPathAltStream(cacheKey.path, altStreamType) : readContentsForPath(cacheKey.path);
 		if (readResult._bypass)
 			return readResult._bypass;
-		_cache[cacheKey] = readResult;
-		entry = &_cache[cacheKey];
-		isNew = true;
+		entry->contents = readResult;
 	}
 
 	// It's possible that recreation failed in case of e.g. network
 	// share going offline.
-	if (entry->isFileMissing())
+	if (entry->contents.isFileMissing())
 		return nullptr;
 
 	// Now we have a valid contents reference. Make stream for it.
-	Common::MemoryReadStream *memStream = new Common::MemoryReadStream(entry->getContents(), entry->getSize());
-
-	// If the entry was just created and it's too big for strong caching,
-	// mark the copy in cache as weak
-	if (isNew && entry->getSize() > _maxStronglyCachedSize) {
-		entry->makeWeak();
+	Common::MemoryReadStream *memStream = new Common::MemoryReadStream(entry->contents.getContents(), entry->contents.getSize());
+
+	// Big entries are only kept strongly while they fit into the budget,
+	// otherwise the copy in cache is marked as weak.
+	if (entry->contents.getSize() > _maxStronglyCachedSize) {
+		if (entry->contents.getSize() <= _cacheBudget) {
+			touchCacheEntry(cacheKey, *entry);
+			enforceCacheBudget();
+		} else {
+			entry->contents.makeWeak();
+		}
 	}
 
 	return memStream;
 }
 
+void MemcachingCaseInsensitiveArchive::touchCacheEntry(const CacheKey &key, CacheEntry &entry) const {
+	if (entry.inLRU)
+		_lru.erase(entry.lruPos);
+	else
+		_cacheUsed += entry.contents.getSize();
+
+	entry.lruPos = _lru.insert(_lru.end(), key);
+	entry.inLRU = true;
+}
+
+void MemcachingCaseInsensitiveArchive::releaseCacheEntry(CacheEntry &entry) const {
+	_lru.erase(entry.lruPos);
+	_cacheUsed -= entry.contents.getSize();
+	entry.inLRU = false;
+	entry.contents.makeWeak();
+}
+
+void MemcachingCaseInsensitiveArchive::enforceCacheBudget() const {
+	while (_cacheUsed > _cacheBudget && !_lru.empty())
+		releaseCacheEntry(_cache[_lru.front()]);
+}
+
+void MemcachingCaseInsensitiveArchive::setCacheBudget(uint32 cacheBudget) {
+	_cacheBudget = cacheBudget;
+	enforceCacheBudget();
+}
+
 SharedArchiveContents MemcachingCaseInsensitiveArchive::readContentsForPathAltStream(const Path &translatedPath, AltStreamType altStreamType) const {
 	return SharedArchiveContents();
 }
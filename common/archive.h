@@ -283,10 +283,17 @@ private:
 
 /**
  * An archive that caches the resulting contents.
+ *
+ * Contents up to maxStronglyCachedSize bytes are always kept in memory.
+ * Larger contents are kept as long as the streams created from them are
+ * alive, and additionally up to cacheBudget bytes of them are kept in memory
+ * after that. Once the budget is exceeded, the least recently opened
+ * contents are released first.
  */
 class MemcachingCaseInsensitiveArchive : public Archive {
 public:
-	MemcachingCaseInsensitiveArchive(uint32 maxStronglyCachedSize = 512) : _maxStronglyCachedSize(maxStronglyCachedSize) {}
+	MemcachingCaseInsensitiveArchive(uint32 maxStronglyCachedSize = 512, uint32 cacheBudget = 0) :
+		_maxStronglyCachedSize(maxStronglyCachedSize), _cacheBudget(cacheBudget), _cacheUsed(0) {}
 	SeekableReadStream *createReadStreamForMember(const Path &path) const;
 	SeekableReadStream *createReadStreamForMemberAltStream(const Path &path, Common::AltStreamType altStreamType) const;
 
@@ -297,6 +304,13 @@ public:
 	virtual SharedArchiveContents readContentsForPath(const Path &translatedPath) const = 0;
 	virtual SharedArchiveContents readContentsForPathAltStream(const Path &translatedPath, AltStreamType altStreamType) const;
 
+	/**
+	 * Set the number of bytes of large contents which are kept in memory
+	 * after all streams reading them are gone. 0 disables this cache.
+	 */
+	void setCacheBudget(uint32 cacheBudget);
+	uint32 getCacheBudget() const { return _cacheBudget; }
+
 private:
 	struct CacheKey {
 		CacheKey();
@@ -305,6 +319,16 @@ private:
 		AltStreamType altStreamType;
 	};
 
+	typedef List<CacheKey> CacheKeyList;
+
+	struct CacheEntry {
+		CacheEntry() : inLRU(false) {}
+
+		SharedArchiveContents contents;
+		CacheKeyList::iterator lruPos;
+		bool inLRU;
+	};
+
 	struct CacheKey_EqualTo {
 		bool operator()(const CacheKey &x, const CacheKey &y) const;
 	};
@@ -314,9 +338,15 @@ private:
 	};
 
 	SeekableReadStream *createReadStreamForMemberImpl(const Path &path, bool isAltStream, Common::AltStreamType altStreamType) const;
+	void touchCacheEntry(const CacheKey &key, CacheEntry &entry) const;
+	void releaseCacheEntry(CacheEntry &entry) const;
+	void enforceCacheBudget() const;
 
-	mutable HashMap<CacheKey, SharedArchiveContents, CacheKey_Hash, CacheKey_EqualTo> _cache;
+	mutable HashMap<CacheKey, CacheEntry, CacheKey_Hash, CacheKey_EqualTo> _cache;
+	mutable CacheKeyList _lru;	///< Strongly held large contents, least recently used first
 	uint32 _maxStronglyCachedSize;
+	uint32 _cacheBudget;
+	mutable uint32 _cacheUsed;
 };
 
 /**
@@ -151,6 +151,23 @@ SeekableReadStream *wrapDeflateReadStream(SeekableReadStream *toBeWrapped,
 		DisposeAfterUse::Flag disposeParent = DisposeAfterUse::YES, uint64 knownSize = 0,
 		const byte *dict = nullptr, uint dictLen = 0);
 
+/**
+ * Like wrapDeflateReadStream, but optimized for random access into large
+ * members. While decompressing, the stream remembers the decoder state every
+ * checkpointInterval bytes of output, so a backward seek restarts from the
+ * nearest checkpoint instead of from the beginning of the data. Each
+ * checkpoint costs 32 KB of memory.
+ *
+ * Without ZLIB support this is the same as wrapDeflateReadStream.
+ *
+ * @param toBeWrapped	the stream to be wrapped (headerless deflate data)
+ * @param knownSize	the size of the uncompressed data
+ * @param checkpointInterval	the minimum distance between two checkpoints
+ */
+SeekableReadStream *wrapSeekableDeflateReadStream(SeekableReadStream *toBeWrapped,
+		DisposeAfterUse::Flag disposeParent, uint64 knownSize,
+		uint32 checkpointInterval = 1024 * 1024);
+
 /**
  * Take an arbitrary SeekableReadStream and wrap it in a custom stream which
  * provides transparent on-the-fly decompression. Assumes the data it
@@ -1383,6 +1383,10 @@ SeekableReadStream* wrapDeflateReadStream(Common::SeekableReadStream *parent, Di
 	return gzio;
 }
 
+SeekableReadStream *wrapSeekableDeflateReadStream(SeekableReadStream *toBeWrapped, DisposeAfterUse::Flag disposeParent, uint64 knownSize, uint32 checkpointInterval) {
+	return wrapDeflateReadStream(toBeWrapped, disposeParent, knownSize);
+}
+
 WriteStream *wrapCompressedWriteStream(WriteStream *toBeWrapped) {
 	// Not supported, return stream itself to write uncompressed data
 	return toBeWrapped;
@@ -95,6 +95,9 @@ typedef Byte Bytef;
 #include "common/compression/deflate.h"
 #include "common/compression/unzip.h"
 #include "common/memstream.h"
+#include "common/mutex.h"
+#include "common/ptr.h"
+#include "common/substream.h"
 
 #include "common/hashmap.h"
 #include "common/hash-str.h"
@@ -325,6 +328,8 @@ typedef Common::HashMap<Common::Path, cached_file_in_zip, Common::Path::IgnoreCa
 */
 typedef struct {
 	Common::SeekableReadStream *_stream;				/* io structore of the zipfile */
+	Common::SharedPtr<Common::SeekableReadStream> _streamRef;	/* owns _stream, shared with streamed members */
+	Common::SharedPtr<Common::Mutex> _streamMutex;	/* guards _stream, which streamed members may read from other threads */
 	unz_global_info gi;				/* public global information */
 	uLong byte_before_the_zipfile;	/* byte before the zipfile, (>0 for sfx)*/
 	uLong num_file;					/* number of the current file in the zipfile*/
@@ -459,6 +464,8 @@ unzFile unzOpen(Common::SeekableReadStream *stream, bool flattenTree) {
 	int err = UNZ_OK;
 
 	us->_stream = stream;
+	us->_streamRef.reset(stream);
+	us->_streamMutex.reset(new Common::Mutex());
 
 	central_pos = unzlocal_SearchCentralDir(*us->_stream);
 	if (central_pos == 0)
@@ -489,7 +496,6 @@ unzFile unzOpen(Common::SeekableReadStream *stream, bool flattenTree) {
 		err = UNZ_ERRNO;
 
 	if (err != UNZ_OK) {
-		delete us->_stream;
 		delete us;
 		return nullptr;
 	}
@@ -516,7 +522,6 @@ unzFile unzOpen(Common::SeekableReadStream *stream, bool flattenTree) {
 		err = UNZ_BADZIPFILE;
 
 	if (err != UNZ_OK) {
-		delete us->_stream;
 		delete us;
 		return nullptr;
 	}
@@ -606,7 +611,6 @@ int unzClose(unzFile file) {
 		return UNZ_PARAMERROR;
 	s = (unz_s *)file;
 
-	delete s->_stream;
 	delete s;
 	return UNZ_OK;
 }
@@ -958,6 +962,80 @@ static int unzlocal_CheckCurrentFileCoherencyHeader(unz_s *s, uInt *piSizeVar,
 	return err;
 }
 
+/* members at least this large are streamed instead of cached in memory */
+#define ZIP_STREAMING_THRESHOLD (1024 * 1024)
+/* smaller members are kept in memory up to this many bytes in total */
+#define ZIP_CACHE_BUDGET (8 * 1024 * 1024)
+
+/*
+  A member read straight from the zipfile. It shares the ownership of the
+  zipfile stream and of its mutex, so it stays valid after the archive has
+  been closed. Reads and seeks of the zipfile lock the mutex, as the archive
+  and other members may be reading the zipfile on other threads.
+  The CRC is checked once the member has been read from start to end;
+  on a mismatch, err() is set from then on.
+*/
+class ZipMemberReadStream : public Common::SeekableReadStream {
+public:
+	ZipMemberReadStream(Common::SeekableReadStream *member, const Common::SharedPtr<Common::SeekableReadStream> &zipStream,
+			const Common::SharedPtr<Common::Mutex> &zipMutex, uint32 crc) :
+		_zipStream(zipStream), _zipMutex(zipMutex), _member(member), _expectedCrc(crc), _crcPos(0), _crcError(false) {
+#ifdef USE_ZLIB
+		_crcValue = crc32(0, nullptr, 0);
+#else
+		_crcValue = _crc.getInitRemainder();
+#endif
+	}
+
+	uint32 read(void *dataPtr, uint32 dataSize) override {
+		const int64 start = _member->pos();
+		const uint32 len = _member->read(dataPtr, dataSize);
+		if (start == _crcPos && len > 0)
+			updateCrc((const byte *)dataPtr, len);
+		return len;
+	}
+
+	bool eos() const override { return _member->eos(); }
+	bool err() const override { return _crcError || _member->err(); }
+	void clearErr() override { _member->clearErr(); }
+	int64 pos() const override { return _member->pos(); }
+	int64 size() const override { return _member->size(); }
+	bool seek(int64 offset, int whence = SEEK_SET) override { return _member->seek(offset, whence); }
+
+private:
+	void updateCrc(const byte *data, uint32 len) {
+#ifdef USE_ZLIB
+		_crcValue = crc32(_crcValue, data, len);
+#else
+		for (uint32 i = 0; i < len; i++)
+			_crcValue = _crc.processByte(data[i], _crcValue);
+#endif
+		_crcPos += len;
+		if (_crcPos < _member->size())
+			return;
+
+#ifndef USE_ZLIB
+		_crcValue = _crc.finalize(_crcValue);
+#endif
+		if (_crcValue != _expectedCrc) {
+			warning("CRC32 mismatch: %08x, %08x", _crcValue, _expectedCrc);
+			_crcError = true;
+		}
+	}
+
+	// Declared first, so that the member is deleted before the zipfile
+	Common::SharedPtr<Common::SeekableReadStream> _zipStream;
+	Common::SharedPtr<Common::Mutex> _zipMutex;
+	Common::ScopedPtr<Common::SeekableReadStream> _member;
+#ifndef USE_ZLIB
+	Common::CRC32 _crc;
+#endif
+	uint32 _expectedCrc;
+	uint32 _crcValue;
+	int64 _crcPos;
+	bool _crcError;
+};
+
 /*
   Open for reading data the current file in the zipfile.
   If there is no error and the file is opened, the return value is UNZ_OK.
@@ -988,9 +1066,22 @@ Common::SharedArchiveContents unzOpenCurrentFile (unzFile file
 	}
 
 	uint32 crc32_wait = s->cur_file_info.crc;
+	uint32 dataOffset = s->cur_file_info_internal.offset_curfile + SIZEZIPLOCALHEADER + iSizeVar;
+
+	// Large members are not loaded into memory. They are read straight
+	// from the archive and decompressed on the fly instead.
+	if (s->cur_file_info.uncompressed_size >= ZIP_STREAMING_THRESHOLD) {
+		Common::SeekableReadStream *member = new Common::SafeMutexedSeekableSubReadStream(s->_stream, dataOffset, dataOffset + s->cur_file_info.compressed_size,
+			DisposeAfterUse::NO, *s->_streamMutex);
+		if (s->cur_file_info.compression_method == Z_DEFLATED)
+			member = Common::wrapSeekableDeflateReadStream(member, DisposeAfterUse::YES, s->cur_file_info.uncompressed_size);
+		if (member)
+			return Common::SharedArchiveContents::bypass(new ZipMemberReadStream(member, s->_streamRef, s->_streamMutex, crc32_wait));
+		return Common::SharedArchiveContents();
+	}
 
 	byte *compressedBuffer = new byte[s->cur_file_info.compressed_size];
-	s->_stream->seek(s->cur_file_info_internal.offset_curfile + SIZEZIPLOCALHEADER + iSizeVar);
+	s->_stream->seek(dataOffset);
 	s->_stream->read(compressedBuffer, s->cur_file_info.compressed_size);
 	byte *uncompressedBuffer = nullptr;
 
@@ -1035,6 +1126,12 @@ class ZipArchive : public MemcachingCaseInsensitiveArchive {
 #endif
 	bool _flattenTree;
 
+	// Streamed members read the zipfile stream on their own, possibly from
+	// other threads, so the archive locks it as well
+	Common::Mutex &streamMutex() const {
+		return *((const unz_s *)_zipFile)->_streamMutex;
+	}
+
 public:
 	ZipArchive(unzFile zipFile, bool flattenTree);
 
@@ -1069,7 +1166,7 @@ public:
 };
 */
 
-ZipArchive::ZipArchive(unzFile zipFile, bool flattenTree) : _zipFile(zipFile), _flattenTree(flattenTree) {
+ZipArchive::ZipArchive(unzFile zipFile, bool flattenTree) : MemcachingCaseInsensitiveArchive(512, ZIP_CACHE_BUDGET), _zipFile(zipFile), _flattenTree(flattenTree) {
 	assert(_zipFile);
 }
 
@@ -1078,10 +1175,12 @@ ZipArchive::~ZipArchive() {
 }
 
 bool ZipArchive::hasFile(const Path &path) const {
+	Common::StackLock lock(streamMutex());
 	return (unzLocateFile(_zipFile, path, 2) == UNZ_OK);
 }
 
 bool ZipArchive::isPathDirectory(const Path &path) const {
+	Common::StackLock lock(streamMutex());
 	if (unzLocateFile(_zipFile, path, 2) != UNZ_OK)
 		return false;
 
@@ -1112,6 +1211,7 @@ const ArchiveMemberPtr ZipArchive::getMember(const Path &path) const {
 }
 
 Common::SharedArchiveContents ZipArchive::readContentsForPath(const Common::Path &path) const {
+	Common::StackLock lock(streamMutex());
 	if (unzLocateFile(_zipFile, path, 2) != UNZ_OK)
 		return Common::SharedArchiveContents();
 #ifndef USE_ZLIB
@@ -33,6 +33,7 @@
 
 #include "common/compression/deflate.h"
 
+#include "common/array.h"
 #include "common/ptr.h"
 #include "common/util.h"
 #include "common/stream.h"
@@ -275,6 +276,241 @@ public:
 	}
 };
 
+/**
+ * A read stream for raw deflate data which supports cheap random access.
+ *
+ * Decompression goes through a 32 KB ring buffer holding the most recent
+ * output, which doubles as the deflate window. Every _checkpointInterval
+ * bytes, at the next deflate block boundary, the decoder position and the
+ * window are saved. Seeking backward then resumes from the nearest
+ * checkpoint, the same way zlib's zran example does.
+ */
+class SeekableDeflateReadStream : public SeekableReadStream {
+protected:
+	enum {
+		BUFSIZE = 16384,
+		WINSIZE = 32768		// 1 << MAX_WBITS
+	};
+
+	struct Checkpoint {
+		uint32 outPos;	// uncompressed offset
+		uint32 inPos;	// compressed offset of the first full byte
+		int bits;		// bits of the previous byte still unused
+		byte window[WINSIZE];
+	};
+
+	byte _buf[BUFSIZE];
+	byte _window[WINSIZE];
+
+	DisposablePtr<SeekableReadStream> _wrapped;
+	z_stream _stream;
+	int _zlibErr;
+	uint64 _parentPos;
+	uint32 _inPos;		// compressed bytes fed into _buf so far
+	uint32 _outPos;		// uncompressed bytes produced so far
+	uint32 _pos;		// read position, never ahead of _outPos
+	uint32 _origSize;
+	uint32 _checkpointInterval;
+	bool _eos;
+
+	Array<Checkpoint *> _checkpoints;
+
+	// Decompress the next chunk into the ring buffer. Only called when all
+	// data in the ring has been consumed, so nothing unread is overwritten.
+	bool inflateMore() {
+		if (_zlibErr != Z_OK)
+			return false;
+
+		if (_stream.avail_in == 0) {
+			_stream.next_in = _buf;
+			_stream.avail_in = _wrapped->read(_buf, BUFSIZE);
+			_inPos += _stream.avail_in;
+		}
+
+		const uint32 head = _outPos & (WINSIZE - 1);
+		_stream.next_out = _window + head;
+		_stream.avail_out = WINSIZE - head;
+		_zlibErr = inflate(&_stream, Z_BLOCK);
+		_outPos += WINSIZE - head - _stream.avail_out;
+
+		// bit 7 is set at the end of a block, bit 6 after the last one
+		if (_zlibErr == Z_OK && (_stream.data_type & 128) && !(_stream.data_type & 64))
+			addCheckpoint();
+
+		return _zlibErr == Z_OK || _zlibErr == Z_STREAM_END;
+	}
+
+	void addCheckpoint() {
+		const uint32 last = _checkpoints.empty() ? 0 : _checkpoints.back()->outPos;
+		if (_outPos < last + _checkpointInterval)
+			return;
+
+		Checkpoint *cp = new Checkpoint;
+		cp->outPos = _outPos;
+		cp->inPos = _inPos - _stream.avail_in;
+		cp->bits = _stream.data_type & 7;
+
+		// Unroll the ring so the window is in stream order
+		const uint32 head = _outPos & (WINSIZE - 1);
+		memcpy(cp->window, _window + head, WINSIZE - head);
+		memcpy(cp->window + WINSIZE - head, _window, head);
+		_checkpoints.push_back(cp);
+	}
+
+	bool restart(const Checkpoint *cp) {
+		_zlibErr = inflateReset(&_stream);
+		if (_zlibErr != Z_OK)
+			return false;
+
+		_stream.next_in = _buf;
+		_stream.avail_in = 0;
+
+		if (!cp) {
+			_inPos = _outPos = _pos = 0;
+			_wrapped->seek(_parentPos, SEEK_SET);
+			return true;
+		}
+
+		// A checkpoint may sit in the middle of a byte, in which case the
+		// remaining bits of that byte have to be primed first.
+		_wrapped->seek(_parentPos + cp->inPos - (cp->bits ? 1 : 0), SEEK_SET);
+		if (cp->bits) {
+			const byte b = _wrapped->readByte();
+			_zlibErr = inflatePrime(&_stream, cp->bits, b >> (8 - cp->bits));
+			if (_zlibErr != Z_OK)
+				return false;
+		}
+
+		_zlibErr = inflateSetDictionary(&_stream, cp->window, WINSIZE);
+		if (_zlibErr != Z_OK)
+			return false;
+
+		const uint32 head = cp->outPos & (WINSIZE - 1);
+		memcpy(_window + head, cp->window, WINSIZE - head);
+		memcpy(_window, cp->window + WINSIZE - head, head);
+
+		_inPos = cp->inPos;
+		_outPos = _pos = cp->outPos;
+		return true;
+	}
+
+public:
+	SeekableDeflateReadStream(SeekableReadStream *w, DisposeAfterUse::Flag disposeParent, uint32 knownSize, uint32 checkpointInterval) :
+			_wrapped(w, disposeParent), _stream(), _inPos(0), _outPos(0), _pos(0), _origSize(knownSize), _eos(false) {
+		assert(w != nullptr);
+
+		// Checkpoints closer than one window would not save anything
+		_checkpointInterval = MAX<uint32>(checkpointInterval, WINSIZE);
+		_parentPos = w->pos();
+
+		_zlibErr = inflateInit2(&_stream, -MAX_WBITS);
+		if (_zlibErr != Z_OK)
+			return;
+
+		_stream.next_in = _buf;
+		_stream.avail_in = 0;
+	}
+
+	~SeekableDeflateReadStream() {
+		inflateEnd(&_stream);
+		for (uint i = 0; i < _checkpoints.size(); i++)
+			delete _checkpoints[i];
+	}
+
+	bool err() const override { return (_zlibErr != Z_OK) && (_zlibErr != Z_STREAM_END); }
+	void clearErr() override {
+		// only reset _eos; I/O errors are not recoverable
+		_eos = false;
+	}
+
+	uint32 read(void *dataPtr, uint32 dataSize) override {
+		byte *dst = (byte *)dataPtr;
+		uint32 remaining = dataSize;
+
+		while (remaining) {
+			if (_pos == _outPos && !inflateMore())
+				break;
+			if (_pos == _outPos) {
+				if (_zlibErr == Z_STREAM_END)
+					break;
+				continue;
+			}
+
+			const uint32 tail = _pos & (WINSIZE - 1);
+			const uint32 len = MIN(remaining, MIN(_outPos - _pos, (uint32)WINSIZE - tail));
+			memcpy(dst, _window + tail, len);
+			dst += len;
+			_pos += len;
+			remaining -= len;
+		}
+
+		if (remaining)
+			_eos = true;
+
+		return dataSize - remaining;
+	}
+
+	bool eos() const override {
+		return _eos;
+	}
+	int64 pos() const override {
+		return _pos;
+	}
+	int64 size() const override {
+		return _origSize;
+	}
+	bool seek(int64 offset, int whence = SEEK_SET) override {
+		int64 newPos = 0;
+		switch (whence) {
+		default:
+			// fallthrough intended
+		case SEEK_SET:
+			newPos = offset;
+			break;
+		case SEEK_CUR:
+			newPos = _pos + offset;
+			break;
+		case SEEK_END:
+			newPos = size() + offset;
+			break;
+		}
+
+		if (newPos < 0 || newPos > _origSize)
+			return false;
+
+		// The ring still holds the last window of output
+		const uint32 windowStart = _outPos > WINSIZE ? _outPos - WINSIZE : 0;
+		if (newPos >= windowStart && newPos <= _outPos) {
+			_pos = newPos;
+			_eos = false;
+			return true;
+		}
+
+		// Resume from the closest checkpoint before the target, unless
+		// decoding on from the current position is closer.
+		const Checkpoint *cp = nullptr;
+		for (uint i = 0; i < _checkpoints.size() && _checkpoints[i]->outPos <= newPos; i++)
+			cp = _checkpoints[i];
+
+		if (newPos < _outPos || (cp && cp->outPos > _outPos)) {
+			if (!restart(cp))
+				return false;
+		}
+
+		_pos = _outPos;
+		while (_pos < newPos) {
+			if (_pos == _outPos && !inflateMore())
+				return false;
+			if (_pos == _outPos && _zlibErr == Z_STREAM_END)
+				return false;
+			_pos = MIN<uint32>(newPos, _outPos);
+		}
+
+		_eos = false;
+		return true;
+	}
+};
+
 /**
  * A simple wrapper class which can be used to wrap around an arbitrary
  * other WriteStream and will then provide on-the-fly compression support.
@@ -422,6 +658,20 @@ SeekableReadStream *wrapDeflateReadStream(SeekableReadStream *toBeWrapped, Dispo
 	return new GZipReadStream(toBeWrapped, disposeParent, knownSize, dict, dictLen);
 }
 
+SeekableReadStream *wrapSeekableDeflateReadStream(SeekableReadStream *toBeWrapped, DisposeAfterUse::Flag disposeParent, uint64 knownSize, uint32 checkpointInterval) {
+	if (!toBeWrapped) {
+		return nullptr;
+	}
+
+	if (toBeWrapped->eos() || toBeWrapped->err()) {
+		if (disposeParent == DisposeAfterUse::YES) {
+			delete toBeWrapped;
+		}
+		return nullptr;
+	}
+	return new SeekableDeflateReadStream(toBeWrapped, disposeParent, knownSize, checkpointInterval);
+}
+
 WriteStream *wrapCompressedWriteStream(WriteStream *toBeWrapped) {
 	if (!toBeWrapped)
 		return nullptr;
@@ -0,0 +1,608 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// The hash map in this file uses open addressing with linear probing and
+// "Robin Hood" displacement, with backward shift deletion instead of
+// tombstones.
+
+#ifndef COMMON_FLAT_HASHMAP_H
+#define COMMON_FLAT_HASHMAP_H
+
+#include "common/hashmap.h"
+
+namespace Common {
+
+/**
+ * @defgroup common_flat_hashmap Flat hash table (FlatHashMap)
+ * @ingroup common
+ *
+ * @brief API for operations on a hash table with inline storage.
+ *
+ * @{
+ */
+
+/**
+ * FlatHashMap<Key,Val> is a drop-in alternative to HashMap<Key,Val> that
+ * stores its nodes inline in a single array instead of allocating each of
+ * them separately. Lookups therefore touch fewer cache lines, and since
+ * erased entries are removed by shifting their successors back, the table
+ * never fills up with deleted markers.
+ *
+ * The requirements on Key, Val, HashFunc and EqualFunc are the same as for
+ * HashMap. In addition, the hash function should spread its values
+ * reasonably well, as the probe length of any entry is bounded.
+ *
+ * Iterators are invalidated by inserting new keys. Erasing the entry an
+ * iterator refers to keeps that iterator valid for continuing the
+ * iteration, as with HashMap; erasing other entries while iterating is
+ * not supported.
+ */
+template<class Key, class Val, class HashFunc = Hash<Key>, class EqualFunc = EqualTo<Key> >
+class FlatHashMap {
+public:
+	typedef uint size_type;
+
+	struct Node {
+		Val _value;
+		const Key _key;
+		explicit Node(const Key &key) : _value(), _key(key) {}
+		Node(const Node &node) : _value(node._value), _key(node._key) {}
+		Node(Node &&node) : _value(Common::move(node._value)), _key(Common::move(const_cast<Key &>(node._key))) {}
+	};
+
+private:
+
+	typedef FlatHashMap<Key, Val, HashFunc, EqualFunc> FHM_t;
+
+	enum {
+		FLATHASHMAP_MIN_CAPACITY = 16,
+		FLATHASHMAP_MIN_SHIFT = 28, ///< 32 - log2(FLATHASHMAP_MIN_CAPACITY)
+
+		// Maximum distance of an entry from its home slot. The storage
+		// has this many extra slots past the end, so probing never wraps.
+		FLATHASHMAP_MAX_DISTANCE = 128,
+
+		// Same meaning as in HashMap, but Robin Hood hashing keeps probe
+		// sequences short enough to allow a higher load.
+		FLATHASHMAP_LOADFACTOR_NUMERATOR = 3,
+		FLATHASHMAP_LOADFACTOR_DENOMINATOR = 4
+	};
+
+	/** Default value, returned by the const getVal. */
+	Val _defaultVal;
+
+	Node *_storage;     ///< Inline nodes, only slots with a non-zero _dist are constructed
+	byte *_dist;        ///< Distance from the home slot plus one for each slot, 0 if empty
+	size_type _mask;    ///< Number of home slots minus one; must be a power of two minus one
+	size_type _shift;   ///< Shift turning a 32 bit hash into a home slot index
+	size_type _slots;   ///< Number of slots, including the ones past the last home slot
+	size_type _size;
+
+	HashFunc _hash;
+	EqualFunc _equal;
+
+	size_type homeSlot(const Key &key) const {
+		// Fibonacci hashing, so that weak hash functions (e.g. the identity
+		// for integers) still spread over the whole table.
+		return (size_type)((uint32)(_hash(key) * 2654435769U) >> _shift);
+	}
+
+	void allocStorage(size_type capacity, size_type shift) {
+		_mask = capacity - 1;
+		_shift = shift;
+		_slots = capacity + MIN<size_type>(capacity, FLATHASHMAP_MAX_DISTANCE);
+		_storage = (Node *)malloc(_slots * sizeof(Node));
+		// One extra, always empty, entry terminates all probe loops
+		_dist = (byte *)calloc(_slots + 1, 1);
+		assert(_storage != nullptr && _dist != nullptr);
+	}
+
+	void freeStorage() {
+		for (size_type ctr = 0; ctr < _slots; ++ctr) {
+			if (_dist[ctr])
+				_storage[ctr].~Node();
+		}
+		free(_storage);
+		free(_dist);
+	}
+
+	void assign(const FHM_t &map);
+	size_type lookup(const Key &key) const;
+	size_type lookupAndCreateIfMissing(const Key &key);
+	bool makeRoom(const Key &key, size_type &idx, byte &dist);
+	void insertNode(Node &&node);
+	void eraseSlot(size_type idx);
+	void expandStorage();
+
+	/**
+	 * Simple FlatHashMap iterator implementation. Iteration goes from the
+	 * last slot to the first one, so that the backward shift done by
+	 * erasing the current entry only moves entries which were already
+	 * visited.
+	 */
+	template<class NodeType>
+	class IteratorImpl {
+		friend class FlatHashMap;
+		template<class T> friend class IteratorImpl;
+	protected:
+		typedef const FlatHashMap hashmap_t;
+
+		size_type _idx;
+		hashmap_t *_hashmap;
+
+	protected:
+		IteratorImpl(size_type idx, hashmap_t *hashmap) : _idx(idx), _hashmap(hashmap) {}
+
+		NodeType *deref() const {
+			assert(_hashmap != nullptr);
+			assert(_idx < _hashmap->_slots);
+			assert(_hashmap->_dist[_idx] != 0);
+			return &_hashmap->_storage[_idx];
+		}
+
+	public:
+		IteratorImpl() : _idx(0), _hashmap(nullptr) {}
+		template<class T>
+		IteratorImpl(const IteratorImpl<T> &c) : _idx(c._idx), _hashmap(c._hashmap) {}
+
+		NodeType &operator*() const { return *deref(); }
+		NodeType *operator->() const { return deref(); }
+
+		bool operator==(const IteratorImpl &iter) const { return _idx == iter._idx && _hashmap == iter._hashmap; }
+		bool operator!=(const IteratorImpl &iter) const { return !(*this == iter); }
+
+		IteratorImpl &operator++() {
+			assert(_hashmap);
+			assert(_idx != (size_type)-1);
+			do {
+				_idx--;
+			} while (_idx != (size_type)-1 && _hashmap->_dist[_idx] == 0);
+
+			return *this;
+		}
+
+		IteratorImpl operator++(int) {
+			IteratorImpl old = *this;
+			operator ++();
+			return old;
+		}
+	};
+
+	size_type lastUsedSlot() const {
+		size_type ctr = _slots;
+		while (ctr-- > 0) {
+			if (_dist[ctr])
+				return ctr;
+		}
+		return (size_type)-1;
+	}
+
+public:
+	typedef IteratorImpl<Node> iterator;
+	typedef IteratorImpl<const Node> const_iterator;
+
+	FlatHashMap();
+	FlatHashMap(const FHM_t &map);
+	~FlatHashMap();
+
+	FHM_t &operator=(const FHM_t &map) {
+		if (this == &map)
+			return *this;
+
+		// Remove the previous content and ...
+		freeStorage();
+		// ... copy the new stuff.
+		assign(map);
+		return *this;
+	}
+
+	bool contains(const Key &key) const;
+
+	Val &operator[](const Key &key);
+	const Val &operator[](const Key &key) const;
+
+	Val &getOrCreateVal(const Key &key);
+	Val &getVal(const Key &key);
+	const Val &getVal(const Key &key) const;
+	const Val &getValOrDefault(const Key &key) const;
+	const Val &getValOrDefault(const Key &key, const Val &defaultVal) const;
+	bool tryGetVal(const Key &key, Val &out) const;
+	void setVal(const Key &key, const Val &val);
+
+	void clear(bool shrinkArray = 0);
+
+	void erase(iterator entry);
+	void erase(const Key &key);
+
+	size_type size() const { return _size; }
+
+	iterator	begin() {
+		return iterator(lastUsedSlot(), this);
+	}
+	iterator	end() {
+		return iterator((size_type)-1, this);
+	}
+
+	const_iterator	begin() const {
+		return const_iterator(lastUsedSlot(), this);
+	}
+	const_iterator	end() const {
+		return const_iterator((size_type)-1, this);
+	}
+
+	iterator	find(const Key &key) {
+		return iterator(lookup(key), this);
+	}
+
+	const_iterator	find(const Key &key) const {
+		return const_iterator(lookup(key), this);
+	}
+
+	/** Return true if hashmap is empty. */
+	bool empty() const {
+		return (_size == 0);
+	}
+};
+
+//-------------------------------------------------------
+// FlatHashMap functions
+
+/**
+ * Base constructor, creates an empty hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+FlatHashMap<Key, Val, HashFunc, EqualFunc>::FlatHashMap() : _defaultVal() {
+	allocStorage(FLATHASHMAP_MIN_CAPACITY, FLATHASHMAP_MIN_SHIFT);
+	_size = 0;
+}
+
+/**
+ * Copy constructor, creates a full copy of the given hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+FlatHashMap<Key, Val, HashFunc, EqualFunc>::FlatHashMap(const FHM_t &map) :
+	_defaultVal() {
+	assign(map);
+}
+
+/**
+ * Destructor, frees all used memory.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+FlatHashMap<Key, Val, HashFunc, EqualFunc>::~FlatHashMap() {
+	freeStorage();
+}
+
+/**
+ * Internal method for assigning the content of another FlatHashMap
+ * to this one.
+ *
+ * @note The previous storage here is *not* deallocated here -- the caller is
+ *       responsible for doing that!
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::assign(const FHM_t &map) {
+	allocStorage(map._mask + 1, map._shift);
+
+	// Both tables have the same geometry, so the slots can be copied as is.
+	for (size_type ctr = 0; ctr < _slots; ++ctr) {
+		if (map._dist[ctr]) {
+			new (&_storage[ctr]) Node(map._storage[ctr]);
+			_dist[ctr] = map._dist[ctr];
+		}
+	}
+	_size = map._size;
+}
+
+/**
+ * Clear all values in the hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::clear(bool shrinkArray) {
+	if (shrinkArray && _mask >= FLATHASHMAP_MIN_CAPACITY) {
+		freeStorage();
+		allocStorage(FLATHASHMAP_MIN_CAPACITY, FLATHASHMAP_MIN_SHIFT);
+	} else {
+		for (size_type ctr = 0; ctr < _slots; ++ctr) {
+			if (_dist[ctr]) {
+				_storage[ctr].~Node();
+				_dist[ctr] = 0;
+			}
+		}
+	}
+
+	_size = 0;
+}
+
+/**
+ * Double the number of home slots and rehash all entries.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::expandStorage() {
+	assert(_shift > 0);
+
+#ifndef RELEASE_BUILD
+	const size_type old_size = _size;
+#endif
+	Node *old_storage = _storage;
+	byte *old_dist = _dist;
+	const size_type old_slots = _slots;
+
+	allocStorage((_mask + 1) * 2, _shift - 1);
+	_size = 0;
+
+	for (size_type ctr = 0; ctr < old_slots; ++ctr) {
+		if (!old_dist[ctr])
+			continue;
+
+		insertNode(Common::move(old_storage[ctr]));
+		old_storage[ctr].~Node();
+	}
+
+#ifndef RELEASE_BUILD
+	// Perform a sanity check: Old number of elements should match the new one!
+	assert(_size == old_size);
+#endif
+
+	free(old_storage);
+	free(old_dist);
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+typename FlatHashMap<Key, Val, HashFunc, EqualFunc>::size_type FlatHashMap<Key, Val, HashFunc, EqualFunc>::lookup(const Key &key) const {
+	size_type ctr = homeSlot(key);
+	// Entries along a probe sequence are ordered by decreasing distance, so
+	// the search can stop at the first entry closer to its home than the key
+	// would be (this includes empty slots).
+	for (uint dist = 1; _dist[ctr] >= dist; ++ctr, ++dist) {
+		if (_dist[ctr] == dist && _equal(_storage[ctr]._key, key))
+			return ctr;
+	}
+
+	return (size_type)-1;
+}
+
+/**
+ * Internal method finding the slot for a key which is not yet in the map,
+ * and shifting the following entries of the probe sequence one slot up to
+ * make it free. Returns false, without changing anything, if this would
+ * exceed the maximum probe distance.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+bool FlatHashMap<Key, Val, HashFunc, EqualFunc>::makeRoom(const Key &key, size_type &idx, byte &dist) {
+	size_type ctr = homeSlot(key);
+	uint d = 1;
+	while (_dist[ctr] >= d) {
+		++ctr;
+		++d;
+	}
+	if (d > FLATHASHMAP_MAX_DISTANCE)
+		return false;
+
+	size_type empty = ctr;
+	while (_dist[empty]) {
+		if (_dist[empty] >= FLATHASHMAP_MAX_DISTANCE)
+			return false;
+		++empty;
+	}
+	if (empty >= _slots)
+		return false;
+
+	for (; empty > ctr; --empty) {
+		new (&_storage[empty]) Node(Common::move(_storage[empty - 1]));
+		_storage[empty - 1].~Node();
+		_dist[empty] = _dist[empty - 1] + 1;
+	}
+
+	idx = ctr;
+	dist = (byte)d;
+	return true;
+}
+
+/**
+ * Internal method inserting a node whose key is known not to be in the map.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::insertNode(Node &&node) {
+	size_type ctr;
+	byte dist;
+	while (!makeRoom(node._key, ctr, dist))
+		expandStorage();
+
+	new (&_storage[ctr]) Node(Common::move(node));
+	_dist[ctr] = dist;
+	_size++;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+typename FlatHashMap<Key, Val, HashFunc, EqualFunc>::size_type FlatHashMap<Key, Val, HashFunc, EqualFunc>::lookupAndCreateIfMissing(const Key &key) {
+	size_type ctr = lookup(key);
+	if (ctr != (size_type)-1)
+		return ctr;
+
+	// Keep the load factor below a certain threshold.
+	if ((_size + 1) * FLATHASHMAP_LOADFACTOR_DENOMINATOR >
+	        (_mask + 1) * FLATHASHMAP_LOADFACTOR_NUMERATOR)
+		expandStorage();
+
+	byte dist;
+	while (!makeRoom(key, ctr, dist)) {
+		// Growing the table only helps if the hash values actually differ.
+		if (_mask / 64 > _size)
+			error("FlatHashMap: Too many hash collisions");
+		expandStorage();
+	}
+
+	new (&_storage[ctr]) Node(key);
+	_dist[ctr] = dist;
+	_size++;
+
+	return ctr;
+}
+
+/**
+ * Internal method removing the entry in slot @p idx, moving the following
+ * entries of its probe sequence one slot back.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::eraseSlot(size_type idx) {
+	_storage[idx].~Node();
+
+	size_type next = idx + 1;
+	for (; _dist[next] > 1; ++next) {
+		new (&_storage[next - 1]) Node(Common::move(_storage[next]));
+		_storage[next].~Node();
+		_dist[next - 1] = _dist[next] - 1;
+	}
+	_dist[next - 1] = 0;
+	_size--;
+}
+
+/**
+ * Check whether the hashmap contains the given key.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+bool FlatHashMap<Key, Val, HashFunc, EqualFunc>::contains(const Key &key) const {
+	return lookup(key) != (size_type)-1;
+}
+
+/**
+ * Get a value from the hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::operator[](const Key &key) {
+	return getOrCreateVal(key);
+}
+
+/**
+ * @overload
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::operator[](const Key &key) const {
+	return getVal(key);
+}
+
+/**
+ * Get a value from the hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getOrCreateVal(const Key &key) {
+	// The lookup may reallocate the storage, so it must be done first.
+	size_type ctr = lookupAndCreateIfMissing(key);
+	return _storage[ctr]._value;
+}
+
+/**
+ * @overload
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getVal(const Key &key) {
+	size_type ctr = lookup(key);
+	if (ctr != (size_type)-1)
+		return _storage[ctr]._value;
+	else
+		// See comment in HashMap::getVal().
+#ifdef RELEASE_BUILD
+		return _defaultVal;
+#else
+		unknownKeyError(key);
+#endif
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getVal(const Key &key) const {
+	size_type ctr = lookup(key);
+	if (ctr != (size_type)-1)
+		return _storage[ctr]._value;
+	else
+		// See comment in HashMap::getVal().
+#ifdef RELEASE_BUILD
+		return _defaultVal;
+#else
+		unknownKeyError(key);
+#endif
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getValOrDefault(const Key &key) const {
+	return getValOrDefault(key, _defaultVal);
+}
+
+/**
+ * Get a value from the hashmap. If the key is not present, then return @p defaultVal.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getValOrDefault(const Key &key, const Val &defaultVal) const {
+	size_type ctr = lookup(key);
+	if (ctr != (size_type)-1)
+		return _storage[ctr]._value;
+	else
+		return defaultVal;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+bool FlatHashMap<Key, Val, HashFunc, EqualFunc>::tryGetVal(const Key &key, Val &out) const {
+	size_type ctr = lookup(key);
+	if (ctr != (size_type)-1) {
+		out = _storage[ctr]._value;
+		return true;
+	} else {
+		return false;
+	}
+}
+
+/**
+ * Assign an element specified by @p key to a value @p val.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::setVal(const Key &key, const Val &val) {
+	size_type ctr = lookupAndCreateIfMissing(key);
+	_storage[ctr]._value = val;
+}
+
+/**
+ * Erase an element referred to by an iterator.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::erase(iterator entry) {
+	// Check whether we have a valid iterator
+	assert(entry._hashmap == this);
+	assert(entry._idx < _slots);
+	assert(_dist[entry._idx] != 0);
+
+	eraseSlot(entry._idx);
+}
+
+/**
+ * Erase an element specified by a key.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::erase(const Key &key) {
+	size_type ctr = lookup(key);
+	if (ctr != (size_type)-1)
+		eraseSlot(ctr);
+}
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
@@ -0,0 +1,222 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/jobs.h"
+#include "common/system.h"
+#include "common/thread.h"
+
+namespace Common {
+
+DECLARE_SINGLETON(JobSystem);
+
+JobGroup::JobGroup() : _pending(0) {
+	_done = g_system->createSemaphore(0);
+}
+
+JobGroup::~JobGroup() {
+	assert(_pending == 0);
+	delete _done;
+}
+
+JobSystem::JobSystem() : _jobsAvailable(nullptr), _nextQueue(0), _quit(false) {
+	const uint cores = g_system->getCPUCount();
+	if (cores <= 1)
+		return;
+
+	_jobsAvailable = g_system->createSemaphore(0);
+	if (!_jobsAvailable)
+		return;
+
+	// The thread waiting for jobs to finish runs them as well, so one
+	// worker less than there are cores keeps all of them busy.
+	for (uint i = 0; i < cores - 1; ++i) {
+		Worker *worker = new Worker();
+		worker->jobSystem = this;
+		worker->queue = i;
+		_queues.push_back(new JobQueue());
+		worker->thread = g_system->createThread(workerProc, worker);
+		if (!worker->thread) {
+			delete worker;
+			delete _queues.back();
+			_queues.pop_back();
+			break;
+		}
+		_workers.push_back(worker);
+	}
+}
+
+JobSystem::~JobSystem() {
+	_quit = true;
+	for (uint i = 0; i < _workers.size(); ++i)
+		_jobsAvailable->post();
+
+	for (uint i = 0; i < _workers.size(); ++i) {
+		delete _workers[i]->thread;
+		delete _workers[i];
+	}
+
+	for (uint i = 0; i < _queues.size(); ++i) {
+		assert(_queues[i]->jobs.empty());
+		delete _queues[i];
+	}
+
+	delete _jobsAvailable;
+}
+
+void JobSystem::workerProc(void *param) {
+	Worker *worker = (Worker *)param;
+	JobSystem *jobSystem = worker->jobSystem;
+
+	for (;;) {
+		jobSystem->_jobsAvailable->wait();
+		if (jobSystem->_quit)
+			break;
+		// The job may already have been taken by a thread waiting for its
+		// group, so finding nothing here is fine.
+		jobSystem->runJob(worker->queue);
+	}
+}
+
+bool JobSystem::runJob(uint queue) {
+	Job job;
+	bool found = false;
+
+	// Take the most recent job from our own queue, which is the most likely
+	// to still be in the cache, or else the oldest one from another queue.
+	if (queue < _queues.size()) {
+		StackLock lock(_queues[queue]->mutex);
+		if (!_queues[queue]->jobs.empty()) {
+			job = _queues[queue]->jobs.back();
+			_queues[queue]->jobs.pop_back();
+			found = true;
+		}
+	}
+
+	for (uint i = 1; !found && i <= _queues.size(); ++i) {
+		JobQueue *victim = _queues[(queue + i) % _queues.size()];
+		StackLock lock(victim->mutex);
+		if (!victim->jobs.empty()) {
+			job = victim->jobs.front();
+			victim->jobs.pop_front();
+			found = true;
+		}
+	}
+
+	if (!found)
+		return false;
+
+	job.proc(job.param);
+
+	StackLock lock(_mutex);
+	assert(job.group->_pending > 0);
+	if (--job.group->_pending == 0)
+		job.group->_done->post();
+	return true;
+}
+
+void JobSystem::submit(JobGroup &group, JobProc proc, void *param) {
+	if (_workers.empty()) {
+		proc(param);
+		return;
+	}
+
+	Job job;
+	job.proc = proc;
+	job.param = param;
+	job.group = &group;
+
+	uint queue;
+	{
+		StackLock lock(_mutex);
+		group._pending++;
+		queue = _nextQueue;
+		_nextQueue = (_nextQueue + 1) % _queues.size();
+	}
+
+	{
+		StackLock lock(_queues[queue]->mutex);
+		_queues[queue]->jobs.push_back(job);
+	}
+	_jobsAvailable->post();
+}
+
+void JobSystem::wait(JobGroup &group) {
+	if (_workers.empty())
+		return;
+
+	for (;;) {
+		{
+			StackLock lock(_mutex);
+			if (group._pending == 0)
+				return;
+		}
+
+		// Rather than blocking, help out with whatever is queued. Once
+		// nothing is left, the remaining jobs of the group are running on
+		// other threads.
+		if (!runJob(_queues.size()))
+			group._done->wait();
+	}
+}
+
+struct ParallelForBatch {
+	ParallelForProc proc;
+	void *param;
+	uint begin;
+	uint end;
+};
+
+static void parallelForJob(void *param) {
+	ParallelForBatch *batch = (ParallelForBatch *)param;
+	batch->proc(batch->begin, batch->end, batch->param);
+}
+
+void JobSystem::parallelFor(uint count, ParallelForProc proc, void *param, uint minBatch) {
+	if (count == 0)
+		return;
+
+	// A few batches per thread keep the threads balanced when the batches
+	// do not all take the same time.
+	const uint threads = _workers.size() + 1;
+	uint batchSize = MAX<uint>(minBatch, (count + threads * 4 - 1) / (threads * 4));
+	if (_workers.empty() || batchSize >= count) {
+		proc(0, count, param);
+		return;
+	}
+
+	Array<ParallelForBatch> batches;
+	batches.reserve((count + batchSize - 1) / batchSize);
+	for (uint begin = 0; begin < count; begin += batchSize) {
+		ParallelForBatch batch;
+		batch.proc = proc;
+		batch.param = param;
+		batch.begin = begin;
+		batch.end = MIN(begin + batchSize, count);
+		batches.push_back(batch);
+	}
+
+	JobGroup group;
+	for (uint i = 0; i < batches.size(); ++i)
+		submit(group, parallelForJob, &batches[i]);
+	wait(group);
+}
+
+} // End of namespace Common
@@ -0,0 +1,137 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef COMMON_JOBS_H
+#define COMMON_JOBS_H
+
+#include "common/array.h"
+#include "common/list.h"
+#include "common/mutex.h"
+#include "common/noncopyable.h"
+#include "common/singleton.h"
+
+namespace Common {
+
+/**
+ * @defgroup common_jobs Job system
+ * @ingroup common
+ *
+ * @brief API for running work in parallel on a pool of worker threads.
+ * @{
+ */
+
+class SemaphoreInternal;
+class ThreadInternal;
+
+typedef void (*JobProc)(void *param);
+typedef void (*ParallelForProc)(uint begin, uint end, void *param);
+
+/**
+ * A set of jobs which can be waited for together. A group can be reused
+ * for new jobs once JobSystem::wait() returned.
+ */
+class JobGroup : NonCopyable {
+	friend class JobSystem;
+
+	uint _pending;               ///< Number of jobs not yet finished, guarded by the JobSystem mutex
+	SemaphoreInternal *_done;    ///< Posted whenever _pending drops to zero
+
+public:
+	JobGroup();
+	~JobGroup();
+};
+
+/**
+ * Pool of worker threads, one less than the number of CPU cores, running
+ * submitted jobs. Every worker has its own queue and steals jobs from the
+ * other queues once it runs dry; threads waiting for a group help running
+ * jobs in the meantime.
+ *
+ * If the backend does not provide threads, or the system only has a single
+ * core, there are no workers and every job runs immediately in submit(). Code
+ * using the job system must therefore not rely on jobs running in parallel
+ * or in any particular order.
+ */
+class JobSystem : public Singleton<JobSystem> {
+public:
+	/**
+	 * Return the number of worker threads, 0 if jobs run synchronously.
+	 */
+	uint getWorkerCount() const { return _workers.size(); }
+
+	/**
+	 * Queue a job, calling @p proc with @p param on a worker thread.
+	 */
+	void submit(JobGroup &group, JobProc proc, void *param);
+
+	/**
+	 * Wait until all jobs submitted to @p group have finished.
+	 */
+	void wait(JobGroup &group);
+
+	/**
+	 * Split the range [0, count) into batches of at least @p minBatch
+	 * elements, call @p proc for each batch in parallel and wait for all
+	 * of them to finish.
+	 */
+	void parallelFor(uint count, ParallelForProc proc, void *param, uint minBatch = 1);
+
+private:
+	friend class Singleton<SingletonBaseType>;
+	JobSystem();
+	~JobSystem();
+
+	struct Job {
+		JobProc proc;
+		void *param;
+		JobGroup *group;
+	};
+
+	struct JobQueue {
+		Mutex mutex;
+		List<Job> jobs;
+	};
+
+	struct Worker {
+		JobSystem *jobSystem;
+		uint queue;
+		ThreadInternal *thread;
+	};
+
+	static void workerProc(void *param);
+	bool runJob(uint queue);
+
+	Array<JobQueue *> _queues;
+	Array<Worker *> _workers;
+	Mutex _mutex;                       ///< Guards _nextQueue and the job groups
+	SemaphoreInternal *_jobsAvailable;
+	uint _nextQueue;
+	bool _quit;
+};
+
+/** @} */
+
+} // End of namespace Common
+
+/** Shortcut for accessing the job system. */
+#define JobMan Common::JobSystem::instance()
+
+#endif
@@ -611,4 +611,9 @@ uint32 SafeMutexedSeekableSubReadStream::read(void *dataPtr, uint32 dataSize) {
 	return Common::SafeSeekableSubReadStream::read(dataPtr, dataSize);
 }
 
+bool SafeMutexedSeekableSubReadStream::seek(int64 offset, int whence) {
+	Common::StackLock lock(_mutex);
+	return Common::SafeSeekableSubReadStream::seek(offset, whence);
+}
+
 } // End of namespace Common
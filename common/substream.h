@@ -111,7 +111,8 @@ public:
 };
 
 /**
- * A special variant of SafeSeekableSubReadStream which locks a mutex during each read.
+ * A special variant of SafeSeekableSubReadStream which locks a mutex during each read
+ * and seek.
  * This is necessary if the music is streamed from disk and it could happen
  * that a sound effect or another music track is played from the same read stream
  * while the first music track is updated/read.
@@ -124,6 +125,7 @@ public:
 		: SafeSeekableSubReadStream(parentStream, begin, end, disposeParentStream), _mutex(mutex) {
 	}
 	uint32 read(void *dataPtr, uint32 dataSize) override;
+	bool seek(int64 offset, int whence = SEEK_SET) override;
 protected:
 	Common::Mutex &_mutex;
 };
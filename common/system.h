@@ -55,6 +55,8 @@ class Store;
 namespace Common {
 class EventManager;
 class MutexInternal;
+class SemaphoreInternal;
+class ThreadInternal;
 struct Rect;
 class SaveFileManager;
 class SearchSet;
@@ -80,6 +82,7 @@ class KeymapperDefaultBindings;
 enum RotationMode : int;
 
 typedef Array<Keymap *> KeymapArray;
+typedef void (*ThreadProc)(void *param);
 }
 
 /**
@@ -1658,6 +1661,49 @@ public:
 	/** @} */
 
 
+	/**
+	 * @defgroup common_system_threads Thread handling
+	 * @ingroup common_system
+	 * @{
+	 *
+	 * Threads are optional: backends that cannot or do not want to run code
+	 * in parallel keep the default implementations, which report that no
+	 * threads are available. Code using threads must therefore always be able
+	 * to do its work on the calling thread instead. Engines should not create
+	 * threads themselves, but submit work to Common::JobSystem, which takes
+	 * care of this.
+	 *
+	 * Backends implementing threads must also return real, recursive mutexes
+	 * from createMutex().
+	 */
+
+	/**
+	 * Create and start a new thread.
+	 *
+	 * @param proc   Function to run in the new thread.
+	 * @param param  Parameter passed to @p proc.
+	 *
+	 * @return The newly created thread, or 0 if threads are not supported or an error occurred.
+	 */
+	virtual Common::ThreadInternal *createThread(Common::ThreadProc proc, void *param) { return nullptr; }
+
+	/**
+	 * Create a new counting semaphore.
+	 *
+	 * @param initialValue  Initial value of the semaphore.
+	 *
+	 * @return The newly created semaphore, or 0 if threads are not supported or an error occurred.
+	 */
+	virtual Common::SemaphoreInternal *createSemaphore(uint initialValue = 0) { return nullptr; }
+
+	/**
+	 * Return the number of CPU cores available to run threads on.
+	 */
+	virtual uint getCPUCount() { return 1; }
+
+	/** @} */
+
+
 
 	/** @defgroup common_system_sound Sound
 	 *  @ingroup common_system
@@ -292,6 +292,7 @@ void Character_ChangeView(CharacterInfo *chap, int vii) {
 	debug_script_log("%s: Change view to %d", chap->scrname, vii + 1);
 	chap->defview = vii;
 	chap->view = vii;
+	prefetch_view(vii);
 	stop_character_anim(chap);
 	chap->frame = 0;
 	chap->wait = 0;
@@ -582,6 +583,7 @@ void Character_LockViewEx(CharacterInfo *chap, int vii, int stopMoving) {
 		Character_StopMoving(chap);
 	}
 	chap->view = vii;
+	prefetch_view(vii);
 	stop_character_anim(chap);
 	FindReasonableLoopForCharacter(chap);
 	chap->frame = 0;
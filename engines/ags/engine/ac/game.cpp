@@ -1391,6 +1391,18 @@ void precache_view(int view, int first_loop, int last_loop, bool with_sounds) {
 	Debug::Printf("\tSprite cache: %zu -> %zu KB", spcache_before / 1024u, spcache_after / 1024u);
 }
 
+void prefetch_view(int view) {
+	if (view < 0 || view >= _GP(game).numviews)
+		return;
+
+	std::vector<sprkey_t> sprites;
+	for (int i = 0; i < _GP(views)[view].numLoops; ++i) {
+		for (int j = 0; j < _GP(views)[view].loops[i].numFrames; ++j)
+			sprites.push_back(_GP(views)[view].loops[i].frames[j].pic);
+	}
+	_GP(spriteset).PrefetchSprites(sprites);
+}
+
 
 //=============================================================================
 //
@@ -216,6 +216,8 @@ void get_message_text(int msnum, char *buffer, char giveErr = 1);
 void game_sprite_updated(int sprnum, bool deleted = false);
 // Precaches sprites for a view, within a selected range of loops.
 void precache_view(int view, int first_loop = 0, int last_loop = INT32_MAX, bool with_sounds = false);
+// Loads sprites of the given view ahead on a worker thread
+void prefetch_view(int view);
 
 extern void set_loop_counter(unsigned int new_counter);
 
@@ -410,6 +410,24 @@ HError LoadRoomScript(RoomStruct *room, int newnum) {
 	return HError::None();
 }
 
+// Load sprites of the room objects and of the characters in the room ahead
+static void prefetch_room_sprites() {
+	std::vector<sprkey_t> sprites;
+	for (size_t i = 0; i < _G(croom)->numobj; ++i) {
+		const RoomObject &obj = _G(objs)[i];
+		if (obj.view != RoomObject::NoView)
+			prefetch_view(obj.view);
+		else
+			sprites.push_back(obj.num);
+	}
+	_GP(spriteset).PrefetchSprites(sprites);
+
+	for (int i = 0; i < _GP(game).numcharacters; ++i) {
+		if (_GP(game).chars[i].room == _G(displayed_room))
+			prefetch_view(_GP(game).chars[i].view);
+	}
+}
+
 static void reset_temp_room() {
 	_GP(troom) = RoomStatus();
 }
@@ -845,6 +863,7 @@ void load_new_room(int newnum, CharacterInfo *forchar) {
 		_GP(play).UpdateRoomCameras(); // update auto tracking
 	}
 	init_room_drawdata();
+	prefetch_room_sprites();
 
 	set_our_eip(212);
 	invalidate_screen();
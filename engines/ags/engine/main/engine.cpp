@@ -505,6 +505,10 @@ int engine_init_sprites() {
 	if (_GP(usetup).SpriteCacheSize > 0)
 		_GP(spriteset).SetMaxCacheSize(_GP(usetup).SpriteCacheSize * 1024);
 	Debug::Printf("Sprite cache set: %zu KB", _GP(spriteset).GetMaxCacheSize() / 1024);
+	if (_GP(usetup).SpriteCompressedCacheSize > 0) {
+		_GP(spriteset).SetMaxCompressedCacheSize(_GP(usetup).SpriteCompressedCacheSize * 1024);
+		Debug::Printf("Compressed sprite cache set: %zu KB", _GP(usetup).SpriteCompressedCacheSize);
+	}
 	return 0;
 }
 
@@ -253,6 +253,7 @@ ccInstance::ccInstance() {
 	numimports = 0;
 	resolved_imports = nullptr;
 	code_fixups         = nullptr;
+	code_ops            = nullptr;
 
 	memset(callStackLineNumber, 0, sizeof(callStackLineNumber));
 	memset(callStackAddr, 0, sizeof(callStackAddr));
@@ -583,17 +584,25 @@ int ccInstance::Run(int32_t curpc) {
 		//
 		/* Read operation */
 		//=====================================================================
-		codeOp.Instruction.Code         = codeInst->code[pc];
-		codeOp.Instruction.InstanceId   = (codeOp.Instruction.Code >> INSTANCE_ID_SHIFT) & INSTANCE_ID_MASK;
-		codeOp.Instruction.Code        &= INSTANCE_ID_REMOVEMASK; // now this is pure instruction code
+		const uint32_t code_op = codeInst->code_ops[pc];
+		if (code_op != CODE_OP_INVALID) {
+			codeOp.Instruction.Code         = code_op & 0xff;
+			codeOp.Instruction.InstanceId   = (code_op >> CODE_OP_INSTID_SHIFT) & 0xff;
+			codeOp.ArgCount                 = (code_op >> CODE_OP_ARGS_SHIFT) & 0xff;
+		} else {
+			// The instruction did not pass validation when decoded, report why
+			codeOp.Instruction.Code         = codeInst->code[pc];
+			codeOp.Instruction.InstanceId   = (codeOp.Instruction.Code >> INSTANCE_ID_SHIFT) & INSTANCE_ID_MASK;
+			codeOp.Instruction.Code        &= INSTANCE_ID_REMOVEMASK; // now this is pure instruction code
 
-		CC_ERROR_IF_RETCODE((codeOp.Instruction.Code < 0 || codeOp.Instruction.Code >= CC_NUM_SCCMDS),
-							"invalid instruction %d found in code stream", codeOp.Instruction.Code);
+			CC_ERROR_IF_RETCODE((codeOp.Instruction.Code < 0 || codeOp.Instruction.Code >= CC_NUM_SCCMDS),
+								"invalid instruction %d found in code stream", codeOp.Instruction.Code);
 
-		codeOp.ArgCount = (*g_commands)[codeOp.Instruction.Code].ArgCount;
+			codeOp.ArgCount = (*g_commands)[codeOp.Instruction.Code].ArgCount;
 
-		CC_ERROR_IF_RETCODE(pc + codeOp.ArgCount >= codeInst->codesize,
-							"unexpected end of code data (%d; %d)", pc + codeOp.ArgCount, codeInst->codesize);
+			CC_ERROR_IF_RETCODE(pc + codeOp.ArgCount >= codeInst->codesize,
+								"unexpected end of code data (%d; %d)", pc + codeOp.ArgCount, codeInst->codesize);
+		}
 
 
 		// Read arguments; use switch as it proved to be faster than the loop
@@ -1651,6 +1660,7 @@ bool ccInstance::_Create(PScript scri, const ccInstance *joined) {
 	if (joined) {
 		resolved_imports = joined->resolved_imports;
 		code_fixups = joined->code_fixups;
+		code_ops = joined->code_ops;
 	} else {
 		if (!CreateGlobalVars(scri.get())) {
 			return false;
@@ -1658,6 +1668,7 @@ bool ccInstance::_Create(PScript scri, const ccInstance *joined) {
 		if (!CreateRuntimeCodeFixups(scri.get())) {
 			return false;
 		}
+		CreateCodeOps();
 	}
 
 	exports = new RuntimeScriptValue[scri->numexports];
@@ -1737,9 +1748,11 @@ void ccInstance::Free() {
 	if ((flags & INSTF_SHAREDATA) == 0) {
 		delete[] resolved_imports;
 		delete[] code_fixups;
+		delete[] code_ops;
 	}
 	resolved_imports = nullptr;
 	code_fixups = nullptr;
+	code_ops = nullptr;
 }
 
 bool ccInstance::ResolveScriptImports(const ccScript *scri) {
@@ -1945,14 +1958,44 @@ bool ccInstance::ResolveImportFixups(const ccScript *scri) {
 			return false;
 		}
 		code[fixup] = import_index;
+		UpdateCodeOp(fixup);
 		// If the call is to another script function next CALLEXT
 		// must be replaced with CALLAS
-		if (import->InstancePtr != nullptr && (code[fixup + 1] & INSTANCE_ID_REMOVEMASK) == SCMD_CALLEXT)
+		if (import->InstancePtr != nullptr && (code[fixup + 1] & INSTANCE_ID_REMOVEMASK) == SCMD_CALLEXT) {
 			code[fixup + 1] = SCMD_CALLAS | (import->InstancePtr->loadedInstanceId << INSTANCE_ID_SHIFT);
+			UpdateCodeOp(fixup + 1);
+		}
 	}
 	return true;
 }
 
+void ccInstance::CreateCodeOps() {
+	// Every position is decoded on its own, so the result does not depend on
+	// where the instruction boundaries are
+	code_ops = new uint32_t[codesize];
+	for (int32_t at = 0; at < codesize; ++at)
+		UpdateCodeOp(at);
+}
+
+void ccInstance::UpdateCodeOp(int32_t at) {
+	if (!code_ops || at < 0 || at >= codesize)
+		return;
+
+	const intptr_t instr = code[at];
+	const int32_t instr_code = static_cast<int32_t>(instr & INSTANCE_ID_REMOVEMASK);
+	if (instr_code < 0 || instr_code >= CC_NUM_SCCMDS) {
+		code_ops[at] = CODE_OP_INVALID;
+		return;
+	}
+	const uint32_t arg_count = (*g_commands)[instr_code].ArgCount;
+	if (at + static_cast<int32_t>(arg_count) >= codesize) {
+		code_ops[at] = CODE_OP_INVALID;
+		return;
+	}
+	const uint32_t instance_id = static_cast<uint32_t>((instr >> INSTANCE_ID_SHIFT) & INSTANCE_ID_MASK);
+	code_ops[at] = instr_code | (arg_count << CODE_OP_ARGS_SHIFT) | (instance_id << CODE_OP_INSTID_SHIFT);
+}
+
 void ccInstance::PushValueToStack(const RuntimeScriptValue &rval) {
 	// Write value to the stack tail and advance stack ptr
 	registers[SREG_SP].WriteValue(rval);
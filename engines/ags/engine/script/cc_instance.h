@@ -53,6 +53,13 @@ using namespace AGS;
 #define INSTANCE_ID_MASK  0x00000000000000ffLL
 #define INSTANCE_ID_REMOVEMASK 0x0000000000ffffffLL
 
+// Pre-decoded instruction: code in bits 0-7, argument count in bits 8-15
+// and instance id in bits 16-23
+#define CODE_OP_ARGS_SHIFT   8
+#define CODE_OP_INSTID_SHIFT 16
+// Position which does not hold a valid instruction
+#define CODE_OP_INVALID      0xffffffffu
+
 // Script executor debugging flag:
 // enables mistake checks, but slows things down!
 #ifndef DEBUG_CC_EXEC
@@ -154,6 +161,9 @@ public:
 	int  numimports;
 
 	char *code_fixups;
+	// Instructions decoded from each code position, kept in sync with code[]
+	// so that the executor does not need to validate them on every step
+	uint32_t *code_ops;
 
 	// returns the currently executing instance, or NULL if none
 	static ccInstance *GetCurrentInstance(void);
@@ -208,6 +218,10 @@ private:
 	bool    AddGlobalVar(const ScriptVariable &glvar);
 	ScriptVariable *FindGlobalVar(int32_t var_addr);
 	bool    CreateRuntimeCodeFixups(const ccScript *scri);
+	// Decode instructions for all code positions
+	void    CreateCodeOps();
+	// Decode instruction at the given code position
+	void    UpdateCodeOp(int32_t at);
 
 	// Begin executing script starting from the given bytecode index
 	int     Run(int32_t curpc);
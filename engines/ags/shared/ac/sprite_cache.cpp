@@ -25,10 +25,14 @@
 //
 //=============================================================================
 
+#include "common/jobs.h"
+#include "common/mutex.h"
 #include "common/system.h"
 #include "ags/shared/core/platform.h"
 #include "ags/shared/util/stream.h"
 #include "common/std/algorithm.h"
+#include "common/std/list.h"
+#include "common/std/map.h"
 #include "ags/shared/ac/sprite_cache.h"
 #include "ags/shared/ac/game_struct_defines.h"
 #include "ags/shared/debugging/out.h"
@@ -58,9 +62,77 @@ using namespace AGS::Shared;
 namespace AGS {
 namespace Shared {
 
+// Sprites queued for loading on a worker thread, and the results.
+// The worker reads the sprite file through a stream of its own.
+struct SpriteCache::SpritePrefetch {
+	struct Request {
+		sprkey_t Index = -1;
+		size_t   Size = 0; // size of the decompressed image, estimated until loaded
+		SpriteDatHeader Hdr;
+		std::vector<uint8_t> Data; // read by the worker, unless the data was cached
+	};
+
+	const SpriteFile *File = nullptr;
+	std::unique_ptr<Stream> FileStream; // only used by the worker
+	Common::JobGroup Group;
+	Common::Mutex Mutex;
+	// All the following is guarded by the mutex
+	std::list<Request *> Queue;
+	// Sprites queued or decompressed; the image is null until it's ready
+	std::unordered_map<sprkey_t, Bitmap *> Pending;
+	size_t   PendingSize = 0; // size of the queued and decompressed images
+	sprkey_t Busy = -1;       // sprite being decompressed
+	bool     Running = false;
+	bool     Cancel = false;
+
+	// Stops the worker after the sprite it is busy with
+	void Pause() {
+		{
+			Common::StackLock lock(Mutex);
+			if (!Running)
+				return;
+			Cancel = true;
+		}
+		JobMan.wait(Group);
+		Cancel = false;
+	}
+
+	void Resume() {
+		Common::StackLock lock(Mutex);
+		if (Running || Queue.empty())
+			return;
+		Running = true;
+		JobMan.submit(Group, SpriteCache::PrefetchProc, this);
+	}
+
+	// Removes the sprite from the queue or the results, returns its image
+	// if one was ready; must not be called for the busy sprite
+	Bitmap *Take(sprkey_t index) {
+		Common::StackLock lock(Mutex);
+		auto it = Pending.find(index);
+		if (it == Pending.end())
+			return nullptr;
+		Bitmap *image = it->_value;
+		Pending.erase(it);
+		if (image) {
+			PendingSize -= image->GetWidth() * image->GetHeight() * image->GetBPP();
+			return image;
+		}
+		for (auto req = Queue.begin(); req != Queue.end(); ++req) {
+			if ((*req)->Index == index) {
+				PendingSize -= (*req)->Size;
+				delete *req;
+				Queue.erase(req);
+				break;
+			}
+		}
+		return nullptr;
+	}
+};
+
 SpriteCache::SpriteCache(std::vector<SpriteInfo> &sprInfos, const Callbacks &callbacks)
 	: _sprInfos(sprInfos), _maxCacheSize(DEFAULTCACHESIZE_KB * 1024u),
-	  _cacheSize(0u), _lockedSize(0u) {
+	  _cacheSize(0u), _lockedSize(0u), _maxCompressedSize(0u), _compressedSize(0u) {
 	_callbacks.AdjustSize = (callbacks.AdjustSize) ? callbacks.AdjustSize : DummyAdjustSize;
 	_callbacks.InitSprite = (callbacks.InitSprite) ? callbacks.InitSprite : DummyInitSprite;
 	_callbacks.PostInitSprite = (callbacks.PostInitSprite) ? callbacks.PostInitSprite : DummyPostInitSprite;
@@ -70,6 +142,10 @@ SpriteCache::SpriteCache(std::vector<SpriteInfo> &sprInfos, const Callbacks &cal
 	_placeholder.reset(BitmapHelper::CreateTransparentBitmap(1, 1, 8));
 }
 
+SpriteCache::~SpriteCache() {
+	StopPrefetch();
+}
+
 size_t SpriteCache::GetCacheSize() const {
 	return _cacheSize;
 }
@@ -91,6 +167,15 @@ void SpriteCache::SetMaxCacheSize(size_t size) {
 	_maxCacheSize = size;
 }
 
+size_t SpriteCache::GetCompressedCacheSize() const {
+	return _compressedSize;
+}
+
+void SpriteCache::SetMaxCompressedCacheSize(size_t size) {
+	_maxCompressedSize = size;
+	FreeCompressedMem(0);
+}
+
 bool SpriteCache::HasFreeSlots() const {
 	return !((_spriteData.size() == SIZE_MAX) || (_spriteData.size() > MAX_SPRITE_INDEX));
 }
@@ -101,11 +186,14 @@ bool SpriteCache::IsAssetSprite(sprkey_t index) const {
 }
 
 void SpriteCache::Reset() {
+	StopPrefetch();
 	_file.Close();
 	_spriteData.clear();
-	_mru.clear();
+	_mru.Clear();
+	_compressedMru.Clear();
 	_cacheSize = 0;
 	_lockedSize = 0;
+	_compressedSize = 0;
 }
 
 bool SpriteCache::SetSprite(sprkey_t index, std::unique_ptr<Bitmap> image, int flags) {
@@ -123,6 +211,7 @@ bool SpriteCache::SetSprite(sprkey_t index, std::unique_ptr<Bitmap> image, int f
 		| (SPF_HICOLOR * image->GetColorDepth() > 8)
 		| (SPF_TRUECOLOR * image->GetColorDepth() > 16);
 	_sprInfos[index] = SpriteInfo(image->GetWidth(), image->GetHeight(), spf_flags);
+	DetachSlot(index);
 	// Assign sprite with 0 size, as it will not be included into the cache size
 	_spriteData[index] = SpriteData(image.release(), 0, SPRCACHEFLAG_EXTERNAL | SPRCACHEFLAG_LOCKED);
 	SprCacheLog("SetSprite: (external) %d", index);
@@ -228,12 +317,12 @@ Bitmap *SpriteCache::operator[](sprkey_t index) {
 	// Either use ready image, or load one from assets
 	if (_spriteData[index].Image) {
 		// Move to the beginning of the MRU list
-		_mru.splice(_mru.begin(), _mru, _spriteData[index].MruIt);
+		LinkFront(_mru, &SpriteData::Mru, index);
 		return _spriteData[index].Image.get();
 	} else {
 		// Sprite exists in file but is not in mem, load it and add to MRU list
 		if (LoadSprite(index)) {
-			_spriteData[index].MruIt = _mru.insert(_mru.begin(), index);
+			LinkFront(_mru, &SpriteData::Mru, index);
 			return _spriteData[index].Image.get();
 		}
 	}
@@ -241,7 +330,7 @@ Bitmap *SpriteCache::operator[](sprkey_t index) {
 }
 
 void SpriteCache::FreeMem(size_t space) {
-	for (int tries = 0; (_mru.size() > 0) && (_cacheSize >= (_maxCacheSize - space)); ++tries) {
+	for (int tries = 0; (_mru.Count > 0) && (_cacheSize >= (_maxCacheSize - space)); ++tries) {
 		DisposeOldest();
 		if (tries > 1000) { // ???
 			Debug::Printf(kDbgGroup_SprCache, kDbgMsg_Error, "RUNTIME CACHE ERROR: STUCK IN FREE_UP_MEM; RESETTING CACHE");
@@ -251,11 +340,10 @@ void SpriteCache::FreeMem(size_t space) {
 }
 
 void SpriteCache::DisposeOldest() {
-	assert(_mru.size() > 0);
-	if (_mru.size() == 0)
+	assert(_mru.Count > 0);
+	if (_mru.Count == 0)
 		return;
-	auto it = std::prev(_mru.end());
-	const auto sprnum = *it;
+	const sprkey_t sprnum = _mru.Tail;
 	// Safety check: must be a sprite from resources
 	// TODO: compare with latest upstream
 	// Commented out the assertion, since it triggers for sprites that are in the list but remapped to the placeholder (sprite 0)
@@ -265,10 +353,7 @@ void SpriteCache::DisposeOldest() {
 
 	if (!_spriteData[sprnum].IsAssetSprite()) {
 		Debug::Printf(kDbgGroup_SprCache, kDbgMsg_Error, "SpriteCache::DisposeOldest: in MRU list sprite %d is external or does not exist", sprnum);
-		_mru.erase(it);
-		// std::list::erase() invalidates iterators to the erased item.
-		// But our implementation does not.
-		_spriteData[sprnum].MruIt._node = nullptr;
+		UnlinkSprite(_mru, &SpriteData::Mru, sprnum);
 		return;
 	}
 	// Delete the image, unless is locked
@@ -279,16 +364,79 @@ void SpriteCache::DisposeOldest() {
 		SprCacheLog("DisposeOldest: disposed %d, size now %d KB", sprnum, _cacheSize / 1024);
 	}
 	// Remove from the mru list
-	_mru.erase(it);
-	// std::list::erase() invalidates iterators to the erased item.
-	// But our implementation does not.
-	_spriteData[sprnum].MruIt._node = nullptr;
+	UnlinkSprite(_mru, &SpriteData::Mru, sprnum);
+}
+
+void SpriteCache::StoreCompressed(sprkey_t index, const SpriteDatHeader &hdr, std::vector<uint8_t> &data) {
+	const size_t size = data.size();
+	if (size == 0 || size > _maxCompressedSize)
+		return;
+	FreeCompressedMem(size);
+	_spriteData[index].CompressedHdr = hdr;
+	_spriteData[index].CompressedData.swap(data);
+	LinkFront(_compressedMru, &SpriteData::CompressedMru, index);
+	_compressedSize += size;
+}
+
+void SpriteCache::DisposeCompressed(sprkey_t index) {
+	if (!_spriteData[index].CompressedMru.Linked)
+		return;
+	UnlinkSprite(_compressedMru, &SpriteData::CompressedMru, index);
+	_compressedSize -= _spriteData[index].CompressedData.size();
+	_spriteData[index].CompressedData.clear();
+	_spriteData[index].CompressedHdr = SpriteDatHeader();
+}
+
+void SpriteCache::FreeCompressedMem(size_t space) {
+	while ((_compressedMru.Count > 0) && (_compressedSize + space > _maxCompressedSize))
+		DisposeCompressed(_compressedMru.Tail);
+}
+
+void SpriteCache::LinkFront(SpriteList &list, SpriteLinkPtr link, sprkey_t index) {
+	SpriteLink &node = _spriteData[index].*link;
+	if (node.Linked) {
+		if (list.Head == index)
+			return;
+		UnlinkSprite(list, link, index);
+	}
+	node.Prev = -1;
+	node.Next = list.Head;
+	if (list.Head >= 0)
+		(_spriteData[list.Head].*link).Prev = index;
+	else
+		list.Tail = index;
+	list.Head = index;
+	node.Linked = true;
+	list.Count++;
+}
+
+void SpriteCache::UnlinkSprite(SpriteList &list, SpriteLinkPtr link, sprkey_t index) {
+	SpriteLink &node = _spriteData[index].*link;
+	if (!node.Linked)
+		return;
+	if (node.Prev >= 0)
+		(_spriteData[node.Prev].*link).Next = node.Next;
+	else
+		list.Head = node.Next;
+	if (node.Next >= 0)
+		(_spriteData[node.Next].*link).Prev = node.Prev;
+	else
+		list.Tail = node.Prev;
+	node = SpriteLink();
+	list.Count--;
+}
+
+void SpriteCache::DetachSlot(sprkey_t index) {
+	UnlinkSprite(_mru, &SpriteData::Mru, index);
+	DisposeCompressed(index);
+	DiscardPrefetched(index);
 }
 
 void SpriteCache::DisposeCached(sprkey_t index) {
 	if (IsAssetSprite(index)) {
 		_spriteData[index].Flags &= ~SPRCACHEFLAG_LOCKED;
 		_spriteData[index].Image.reset();
+		UnlinkSprite(_mru, &SpriteData::Mru, index);
 	}
 	_cacheSize = _lockedSize;
 }
@@ -300,9 +448,11 @@ void SpriteCache::DisposeAllFreeCached() {
 		{
 			_spriteData[i].Image.reset();
 		}
+		_spriteData[i].Mru = SpriteLink();
+		DisposeCompressed(i);
 	}
 	_cacheSize = _lockedSize;
-	_mru.clear();
+	_mru.Clear();
 }
 
 void SpriteCache::PrecacheSprite(sprkey_t index) {
@@ -318,10 +468,7 @@ void SpriteCache::PrecacheSprite(sprkey_t index) {
 	} else if (!_spriteData[index].IsLocked()) {
 		size = _spriteData[index].Size;
 		// Remove locked sprite from the MRU list
-		_mru.erase(_spriteData[index].MruIt);
-		// std::list::erase() invalidates iterators to the erased item.
-		// But our implementation does not.
-		_spriteData[index].MruIt._node = nullptr;
+		UnlinkSprite(_mru, &SpriteData::Mru, index);
 	}
 
 	// make sure locked sprites can't fill the cache
@@ -365,7 +512,7 @@ size_t SpriteCache::LoadSprite(sprkey_t index, bool lock) {
 	assert((_spriteData[index].Flags & SPRCACHEFLAG_ISASSET) != 0);
 
 	Bitmap *image;
-	HError err = _file.LoadSprite(index, image);
+	HError err = ReadSpriteImage(index, image);
 	if (!image) {
 		Debug::Printf(kDbgGroup_SprCache, kDbgMsg_Warn,
 			"LoadSprite: failed to load sprite %d:\n%s\n - remapping to placeholder", index,
@@ -389,10 +536,12 @@ size_t SpriteCache::LoadSprite(sprkey_t index, bool lock) {
 	// Clear up space before adding to cache
 	const size_t size = image->GetWidth() * image->GetHeight() * image->GetBPP();
 	FreeMem(size);
-	// Add to the cache, lock if requested or if it's sprite 0
+	// Add to the cache, lock if requested or if it's sprite 0;
+	// keep the slot's list links and compressed data
 	const bool should_lock = lock || (index == 0);
-	_spriteData[index] = SpriteData(image, size, SPRCACHEFLAG_ISASSET);
-	_spriteData[index].Flags |= (SPRCACHEFLAG_LOCKED * should_lock);
+	_spriteData[index].Image.reset(image);
+	_spriteData[index].Size = size;
+	_spriteData[index].Flags = SPRCACHEFLAG_ISASSET | (SPRCACHEFLAG_LOCKED * should_lock);
 	_cacheSize += size;
 	SprCacheLog("Loaded %d, size now %zu KB", index, _cacheSize / 1024);
 
@@ -404,6 +553,147 @@ size_t SpriteCache::LoadSprite(sprkey_t index, bool lock) {
 	return size;
 }
 
+HError SpriteCache::ReadSpriteImage(sprkey_t index, Bitmap *&image) {
+	image = TakePrefetched(index);
+	if (image)
+		return HError::None();
+
+	SpriteData &data = _spriteData[index];
+	if (!data.CompressedData.empty()) {
+		LinkFront(_compressedMru, &SpriteData::CompressedMru, index);
+		return _file.LoadSpriteFromRaw(index, data.CompressedHdr, data.CompressedData, image);
+	}
+	if (_maxCompressedSize == 0)
+		return _file.LoadSprite(index, image);
+
+	// Read the raw data first, to keep it if the sprite is compressed
+	SpriteDatHeader hdr;
+	std::vector<uint8_t> raw;
+	HError err = _file.LoadRawData(index, hdr, raw);
+	if (!err)
+		return err;
+	err = _file.LoadSpriteFromRaw(index, hdr, raw, image);
+	if (image && (hdr.Compress != kSprCompress_None))
+		StoreCompressed(index, hdr, raw);
+	return err;
+}
+
+void SpriteCache::PrefetchSprites(const std::vector<sprkey_t> &indexes) {
+	if (JobMan.getWorkerCount() == 0)
+		return;
+	if (!_prefetch) {
+		Stream *stream = _file.OpenStream();
+		if (!stream)
+			return;
+		_prefetch.reset(new SpritePrefetch());
+		_prefetch->File = &_file;
+		_prefetch->FileStream.reset(stream);
+	}
+
+	// Keep the images waiting to be cached within a part of the cache limit
+	const size_t max_size = _maxCacheSize / 4;
+	SpritePrefetch &prefetch = *_prefetch;
+	for (sprkey_t index : indexes) {
+		if (index < 0 || (size_t)index >= _spriteData.size())
+			continue;
+		const SpriteData &data = _spriteData[index];
+		if (!data.IsAssetSprite() || data.IsError() || data.Image)
+			continue;
+		{
+			Common::StackLock lock(prefetch.Mutex);
+			if (prefetch.Pending.contains(index))
+				continue;
+		}
+
+		std::unique_ptr<SpritePrefetch::Request> request(new SpritePrefetch::Request());
+		request->Index = index;
+		if (!data.CompressedData.empty()) {
+			request->Hdr = data.CompressedHdr;
+			request->Data = data.CompressedData;
+		}
+		// The worker corrects this once it knows the color depth
+		request->Size = _sprInfos[index].Width * _sprInfos[index].Height * 4;
+
+		Common::StackLock lock(prefetch.Mutex);
+		if (prefetch.PendingSize + request->Size > max_size)
+			break;
+		prefetch.PendingSize += request->Size;
+		prefetch.Pending[index] = nullptr;
+		prefetch.Queue.push_back(request.release());
+	}
+	prefetch.Resume();
+}
+
+void SpriteCache::PrefetchProc(void *param) {
+	SpritePrefetch *prefetch = (SpritePrefetch *)param;
+	while (true) {
+		SpritePrefetch::Request *request;
+		{
+			Common::StackLock lock(prefetch->Mutex);
+			if (prefetch->Cancel || prefetch->Queue.empty()) {
+				prefetch->Running = false;
+				return;
+			}
+			request = prefetch->Queue.front();
+			prefetch->Queue.pop_front();
+			prefetch->Busy = request->Index;
+		}
+
+		Bitmap *image = nullptr;
+		if (request->Data.empty())
+			prefetch->File->LoadRawData(prefetch->FileStream.get(), request->Index, request->Hdr, request->Data);
+		if (request->Hdr.BPP > 0)
+			prefetch->File->LoadSpriteFromRaw(request->Index, request->Hdr, request->Data, image);
+
+		{
+			Common::StackLock lock(prefetch->Mutex);
+			prefetch->Busy = -1;
+			if (image) {
+				prefetch->Pending[request->Index] = image;
+				prefetch->PendingSize += image->GetWidth() * image->GetHeight() * image->GetBPP();
+				prefetch->PendingSize -= request->Size;
+			} else {
+				// Let the main thread load it and report the error
+				prefetch->Pending.erase(request->Index);
+				prefetch->PendingSize -= request->Size;
+			}
+		}
+		delete request;
+	}
+}
+
+Bitmap *SpriteCache::TakePrefetched(sprkey_t index) {
+	if (!_prefetch)
+		return nullptr;
+
+	bool busy;
+	{
+		Common::StackLock lock(_prefetch->Mutex);
+		busy = (_prefetch->Busy == index);
+	}
+	if (busy)
+		_prefetch->Pause();
+	Bitmap *image = _prefetch->Take(index);
+	if (busy)
+		_prefetch->Resume();
+	return image;
+}
+
+void SpriteCache::DiscardPrefetched(sprkey_t index) {
+	delete TakePrefetched(index);
+}
+
+void SpriteCache::StopPrefetch() {
+	if (!_prefetch)
+		return;
+	_prefetch->Pause();
+	for (SpritePrefetch::Request *request : _prefetch->Queue)
+		delete request;
+	for (auto &pending : _prefetch->Pending)
+		delete pending._value;
+	_prefetch.reset();
+}
+
 void SpriteCache::RemapSpriteToPlaceholder(sprkey_t index) {
 	assert((index > 0) && ((size_t)index < _spriteData.size()));
 	_sprInfos[index] = SpriteInfo(_placeholder->GetWidth(), _placeholder->GetHeight(), _placeholder->GetColorDepth());
@@ -413,6 +703,7 @@ void SpriteCache::RemapSpriteToPlaceholder(sprkey_t index) {
 
 void SpriteCache::InitNullSprite(sprkey_t index) {
 	assert(index >= 0);
+	DetachSlot(index);
 	_sprInfos[index] = SpriteInfo();
 	_spriteData[index] = SpriteData();
 }
@@ -438,7 +729,7 @@ HError SpriteCache::InitFile(const String &filename, const String &sprindex_file
 	size_t newsize = metrics.size();
 	_sprInfos.resize(newsize);
 	_spriteData.resize(newsize);
-	_mru.clear();
+	_mru.Clear();
 	for (size_t i = 0; i < metrics.size(); ++i) {
 		if (!metrics[i].IsNull()) {
 			// Existing sprite
@@ -455,6 +746,7 @@ HError SpriteCache::InitFile(const String &filename, const String &sprindex_file
 }
 
 void SpriteCache::DetachFile() {
+	StopPrefetch();
 	_file.Close();
 }
 
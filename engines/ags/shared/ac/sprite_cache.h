@@ -24,7 +24,9 @@
 //
 // SpriteFile handles sprite serialization and streaming.
 // SpriteCache provides bitmaps by demand; it uses SpriteFile to load sprites
-// and does MRU (most-recent-use) caching.
+// and does MRU (most-recent-use) caching. Optionally it keeps the compressed
+// data of recently loaded sprites, so that disposed images may be restored
+// without reading the file, and decompresses sprites ahead on request.
 //
 // TODO: store sprite data in a specialized container type that is optimized
 // for having most keys allocated in large continious sequences by default.
@@ -43,7 +45,6 @@
 
 #include "common/std/memory.h"
 #include "common/std/vector.h"
-#include "common/std/list.h"
 #include "ags/shared/ac/sprite_file.h"
 #include "ags/shared/core/platform.h"
 #include "ags/shared/gfx/bitmap.h"
@@ -96,7 +97,7 @@ public:
 	};
 
 	SpriteCache(std::vector<SpriteInfo> &sprInfos, const Callbacks &callbacks);
-	~SpriteCache() = default;
+	~SpriteCache();
 
 	// Loads sprite reference information and inits sprite stream
 	HError      InitFile(const String &filename, const String &sprindex_filename);
@@ -174,19 +175,64 @@ public:
 	void        SetEmptySprite(sprkey_t index, bool as_asset);
 	// Sets max cache size in bytes
 	void        SetMaxCacheSize(size_t size);
+	// Returns current size of the compressed sprite data kept in memory, in bytes
+	size_t      GetCompressedCacheSize() const;
+	// Sets max size of the compressed sprite data kept in memory, in bytes;
+	// 0 disables keeping compressed data
+	void        SetMaxCompressedCacheSize(size_t size);
+	// Reads and decompresses the given asset sprites that are not in memory
+	// on a worker thread; they are put into the cache when requested.
+	// Does nothing if there are no worker threads.
+	void        PrefetchSprites(const std::vector<sprkey_t> &indexes);
 
 	// Loads (if it's not in cache yet) and returns bitmap by the sprite index
 	Bitmap *operator[](sprkey_t index);
 
 private:
+	struct SpritePrefetch;
+
+	// Intrusive list of sprite indexes, linked through the SpriteData slots
+	struct SpriteList {
+		sprkey_t Head = -1;
+		sprkey_t Tail = -1;
+		size_t   Count = 0;
+
+		void Clear() {
+			Head = Tail = -1;
+			Count = 0;
+		}
+	};
+
+	struct SpriteLink {
+		sprkey_t Prev = -1;
+		sprkey_t Next = -1;
+		bool     Linked = false;
+	};
+
 	// Load sprite from game resource
 	size_t      LoadSprite(sprkey_t index, bool lock = false);
+	// Create sprite's image, using either prefetched image, compressed data or the file
+	HError      ReadSpriteImage(sprkey_t index, Bitmap *&image);
 	// Remap the given index to the placeholder
 	void        RemapSpriteToPlaceholder(sprkey_t index);
 	// Delete the oldest (least recently used) image in cache
 	void        DisposeOldest();
 	// Keep disposing oldest elements until cache has at least the given free space
 	void        FreeMem(size_t space);
+	// Keep compressed sprite data in memory, evicting the oldest data if needed
+	void        StoreCompressed(sprkey_t index, const SpriteDatHeader &hdr, std::vector<uint8_t> &data);
+	// Release compressed data of the given sprite
+	void        DisposeCompressed(sprkey_t index);
+	// Keep releasing oldest compressed data until there is the given free space
+	void        FreeCompressedMem(size_t space);
+	// Takes the image decompressed ahead for the given sprite, if any
+	Bitmap     *TakePrefetched(sprkey_t index);
+	// Forgets any prefetch results for the given sprite
+	void        DiscardPrefetched(sprkey_t index);
+	// Cancels pending prefetch requests and deletes their results
+	void        StopPrefetch();
+	// Worker thread procedure, decompresses queued sprites
+	static void PrefetchProc(void *param);
 	// Initialize the empty sprite slot
 	void 		InitNullSprite(sprkey_t index);
 	//
@@ -204,7 +250,12 @@ private:
 		std::unique_ptr<Bitmap> Image; // actual bitmap
 
 		// MRU list reference
-		std::list<sprkey_t>::iterator MruIt;
+		SpriteLink Mru;
+		// Compressed data, kept after the image is disposed
+		SpriteDatHeader CompressedHdr;
+		std::vector<uint8_t> CompressedData;
+		// Compressed data MRU list reference
+		SpriteLink CompressedMru;
 
 		SpriteData() = default;
 		SpriteData(SpriteData &&other) = default;
@@ -226,6 +277,16 @@ private:
 		bool IsLocked() const;
 	};
 
+	typedef SpriteLink SpriteData::*SpriteLinkPtr;
+
+	// Put sprite at the front of the list, moves it there if already listed
+	void        LinkFront(SpriteList &list, SpriteLinkPtr link, sprkey_t index);
+	// Remove sprite from the list, if it is there
+	void        UnlinkSprite(SpriteList &list, SpriteLinkPtr link, sprkey_t index);
+	// Remove the slot from all the lists and release its compressed data,
+	// before the slot is reassigned
+	void        DetachSlot(sprkey_t index);
+
 	// Provided map of sprite infos, to fill in loaded sprite properties
 	std::vector<SpriteInfo> &_sprInfos;
 	// Array of sprite references
@@ -239,11 +300,17 @@ private:
 	size_t _maxCacheSize;  // cache size limit
 	size_t _lockedSize;    // size in bytes of currently locked images
 	size_t _cacheSize;     // size in bytes of currently cached images
+	size_t _maxCompressedSize; // compressed data size limit
+	size_t _compressedSize;    // size in bytes of compressed data kept in memory
 
 	// MRU list: the way to track which sprites were used recently.
 	// When clearing up space for new sprites, cache first deletes the sprites
 	// that were last time used long ago.
-	std::list<sprkey_t> _mru;
+	SpriteList _mru;
+	// MRU list of the sprites with compressed data in memory
+	SpriteList _compressedMru;
+	// Sprites being decompressed on a worker thread
+	std::unique_ptr<SpritePrefetch> _prefetch;
 
 };
 
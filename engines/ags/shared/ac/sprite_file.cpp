@@ -167,6 +167,7 @@ HError SpriteFile::OpenFile(const String &filename, const String &sprindex_filen
 	_stream.reset(_GP(AssetMgr)->OpenAsset(filename));
 	if (_stream == nullptr)
 		return new Error(String::FromFormat("Failed to open spriteset file '%s'.", filename.GetCStr()));
+	_filename = filename;
 
 	spr_initial_offs = _stream->GetPosition();
 
@@ -231,6 +232,7 @@ HError SpriteFile::OpenFile(const String &filename, const String &sprindex_filen
 
 void SpriteFile::Close() {
 	_stream.reset();
+	_filename.Empty();
 	_spriteData.clear();
 	_version = kSprfVersion_Undefined;
 	_storeFlags = 0;
@@ -370,6 +372,22 @@ HError SpriteFile::LoadSprite(sprkey_t index, Shared::Bitmap *&sprite) {
 	SpriteDatHeader hdr;
 	ReadSprHeader(hdr, _stream.get(), _version, _compress);
 	if (hdr.BPP == 0) return HError::None(); // empty slot, this is normal
+	HError err = ReadSpriteData(index, hdr, _stream.get(), sprite);
+	if (!err)
+		return err;
+	_curPos = index + 1; // mark correct pos
+	return HError::None();
+}
+
+HError SpriteFile::LoadSpriteFromRaw(sprkey_t index, const SpriteDatHeader &hdr,
+		const std::vector<uint8_t> &data, Bitmap *&sprite) const {
+	sprite = nullptr;
+	if (hdr.BPP == 0) return HError::None(); // empty slot, this is normal
+	VectorStream in(data);
+	return ReadSpriteData(index, hdr, &in, sprite);
+}
+
+HError SpriteFile::ReadSpriteData(sprkey_t index, const SpriteDatHeader &hdr, Stream *in, Bitmap *&sprite) const {
 	int bpp = hdr.BPP, w = hdr.Width, h = hdr.Height;
 	std::unique_ptr<Bitmap> image(BitmapHelper::CreateBitmap(w, h, bpp * 8));
 	if (image == nullptr) {
@@ -384,11 +402,11 @@ HError SpriteFile::LoadSprite(sprkey_t index, Shared::Bitmap *&sprite) {
 	if (pal_bpp > 0) { // read palette if format assumes one
 		switch (pal_bpp) {
 		case 2: for (uint32_t i = 0; i < hdr.PalCount; ++i) {
-			palette[i] = _stream->ReadInt16();
+			palette[i] = in->ReadInt16();
 		}
 			  break;
 		case 4: for (uint32_t i = 0; i < hdr.PalCount; ++i) {
-			palette[i] = _stream->ReadInt32();
+			palette[i] = in->ReadInt32();
 		}
 			  break;
 		default: assert(0); break;
@@ -399,7 +417,7 @@ HError SpriteFile::LoadSprite(sprkey_t index, Shared::Bitmap *&sprite) {
 	// (Optional) Decompress the image data into the temp buffer
 	size_t in_data_size =
 		((_version >= kSprfVersion_StorageFormats) || _compress != kSprCompress_None) ?
-		(uint32_t)_stream->ReadInt32() : (w * h * bpp);
+		(uint32_t)in->ReadInt32() : (w * h * bpp);
 	if (hdr.Compress != kSprCompress_None) {
 		// TODO: rewrite this to only make a choice once the SpriteFile is initialized
 		// and use either function ptr or a decompressing stream class object
@@ -408,11 +426,11 @@ HError SpriteFile::LoadSprite(sprkey_t index, Shared::Bitmap *&sprite) {
 		}
 		bool result;
 		switch (hdr.Compress) {
-		case kSprCompress_RLE: result = rle_decompress(im_data.Buf, im_data.Size, im_data.BPP, _stream.get());
+		case kSprCompress_RLE: result = rle_decompress(im_data.Buf, im_data.Size, im_data.BPP, in);
 			break;
-		case kSprCompress_LZW: result = lzw_decompress(im_data.Buf, im_data.Size, im_data.BPP, _stream.get(), in_data_size);
+		case kSprCompress_LZW: result = lzw_decompress(im_data.Buf, im_data.Size, im_data.BPP, in, in_data_size);
 			break;
-		case kSprCompress_Deflate: result = inflate_decompress(im_data.Buf, im_data.Size, im_data.BPP, _stream.get(), in_data_size);
+		case kSprCompress_Deflate: result = inflate_decompress(im_data.Buf, im_data.Size, im_data.BPP, in, in_data_size);
 			break;
 		default: assert(!"Unsupported compression type!"); result = false; break;
 		}
@@ -424,12 +442,12 @@ HError SpriteFile::LoadSprite(sprkey_t index, Shared::Bitmap *&sprite) {
 	// Otherwise (no compression) read directly
 	else {
 		switch (im_data.BPP) {
-		case 1: _stream->Read(im_data.Buf, im_data.Size);
+		case 1: in->Read(im_data.Buf, im_data.Size);
 			break;
-		case 2: _stream->ReadArrayOfInt16(
+		case 2: in->ReadArrayOfInt16(
 			reinterpret_cast<int16_t *>(im_data.Buf), im_data.Size / sizeof(int16_t));
 			break;
-		case 4: _stream->ReadArrayOfInt32(
+		case 4: in->ReadArrayOfInt32(
 			reinterpret_cast<int32_t *>(im_data.Buf), im_data.Size / sizeof(int32_t));
 			break;
 		default: assert(0); break;
@@ -441,11 +459,24 @@ HError SpriteFile::LoadSprite(sprkey_t index, Shared::Bitmap *&sprite) {
 	}
 
 	sprite = image.release(); // FIXME: pass unique_ptr in this function
-	_curPos = index + 1; // mark correct pos
 	return HError::None();
 }
 
 HError SpriteFile::LoadRawData(sprkey_t index, SpriteDatHeader &hdr, std::vector<uint8_t> &data) {
+	_curPos = -2; // mark undefined pos
+	HError err = LoadRawData(_stream.get(), index, hdr, data);
+	if (err && hdr.BPP > 0)
+		_curPos = index + 1; // mark correct pos
+	return err;
+}
+
+Stream *SpriteFile::OpenStream() const {
+	if (_filename.IsEmpty())
+		return nullptr;
+	return _GP(AssetMgr)->OpenAsset(_filename);
+}
+
+HError SpriteFile::LoadRawData(Stream *in, sprkey_t index, SpriteDatHeader &hdr, std::vector<uint8_t> &data) const {
 	hdr = SpriteDatHeader();
 	data.resize(0);
 	if (index < 0 || (size_t)index >= _spriteData.size())
@@ -455,28 +486,25 @@ HError SpriteFile::LoadRawData(sprkey_t index, SpriteDatHeader &hdr, std::vector
 	if (_spriteData[index].Offset == 0)
 		return HError::None(); // sprite is not in file
 
-	SeekToSprite(index);
-	_curPos = -2; // mark undefined pos
+	in->Seek(_spriteData[index].Offset, kSeekBegin);
 
-	ReadSprHeader(hdr, _stream.get(), _version, _compress);
+	ReadSprHeader(hdr, in, _version, _compress);
 	if (hdr.BPP == 0) return HError::None(); // empty slot, this is normal
 	size_t data_size = 0;
-	soff_t data_pos = _stream->GetPosition();
+	soff_t data_pos = in->GetPosition();
 	// Optional palette
 	size_t pal_size = hdr.PalCount * GetPaletteBPP(hdr.SFormat);
 	data_size += pal_size;
-	_stream->Seek(pal_size);
+	in->Seek(pal_size);
 	// Pixel data
 	if ((_version >= kSprfVersion_StorageFormats) || _compress != kSprCompress_None)
-		data_size += (uint32_t)_stream->ReadInt32() + sizeof(uint32_t);
+		data_size += (uint32_t)in->ReadInt32() + sizeof(uint32_t);
 	else
 		data_size += hdr.Width * hdr.Height * hdr.BPP;
 	// Seek back and read all at once
 	data.resize(data_size);
-	_stream->Seek(data_pos, kSeekBegin);
-	_stream->Read(&data[0], data_size);
-
-	_curPos = index + 1; // mark correct pos
+	in->Seek(data_pos, kSeekBegin);
+	in->Read(&data[0], data_size);
 	return HError::None();
 }
 
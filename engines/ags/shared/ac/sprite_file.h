@@ -154,10 +154,21 @@ public:
 	HError      LoadSprite(sprkey_t index, Bitmap *&sprite);
 	// Loads a raw sprite element data into the buffer, stores header info separately
 	HError      LoadRawData(sprkey_t index, SpriteDatHeader &hdr, std::vector<uint8_t> &data);
+	// Opens another stream of the sprite file, for reading on another thread
+	Stream     *OpenStream() const;
+	// Same as LoadRawData, but reads from the given stream of the sprite file;
+	// does not touch the file stream, so may be called from another thread
+	HError      LoadRawData(Stream *in, sprkey_t index, SpriteDatHeader &hdr, std::vector<uint8_t> &data) const;
+	// Creates a ready bitmap from the raw data returned by LoadRawData;
+	// does not touch the file stream, so may be called from another thread
+	HError      LoadSpriteFromRaw(sprkey_t index, const SpriteDatHeader &hdr,
+		const std::vector<uint8_t> &data, Bitmap *&sprite) const;
 
 private:
 	// Seek stream to sprite
 	void        SeekToSprite(sprkey_t index);
+	// Reads image data following the sprite header and creates a bitmap
+	HError      ReadSpriteData(sprkey_t index, const SpriteDatHeader &hdr, Stream *in, Bitmap *&sprite) const;
 
 	// Internal sprite reference
 	struct SpriteRef {
@@ -169,6 +180,7 @@ private:
 	// Array of sprite references
 	std::vector<SpriteRef> _spriteData;
 	std::unique_ptr<Stream> _stream; // the sprite stream
+	String _filename; // the sprite file asset
 	SpriteFileVersion _version = kSprfVersion_Current;
 	int _storeFlags = 0; // storage flags, specify how sprites may be stored
 	SpriteCompression _compress = kSprCompress_None; // sprite compression typ
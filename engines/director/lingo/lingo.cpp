@@ -887,26 +887,53 @@ int Lingo::getAlignedType(const Datum &d1, const Datum &d2, bool equality) {
 Datum::Datum() {
 	u.s = nullptr;
 	type = VOID;
-	refCount = new int;
-	*refCount = 1;
+	refCount = nullptr;
 	ignoreGlobal = false;
 }
 
 Datum::Datum(const Datum &d) {
+	d.shareRefCount();
+	type = d.type;
+	u = d.u;
+	refCount = d.refCount;
+	if (refCount)
+		*refCount += 1;
+	ignoreGlobal = false;
+}
+
+Datum::Datum(Datum &&d) {
 	type = d.type;
 	u = d.u;
 	refCount = d.refCount;
-	*refCount += 1;
 	ignoreGlobal = false;
+	d.type = VOID;
+	d.refCount = nullptr;
 }
 
 Datum& Datum::operator=(const Datum &d) {
-	if (this != &d && refCount != d.refCount) {
+	if (this != &d) {
+		d.shareRefCount();
+		if (!refCount || refCount != d.refCount) {
+			reset();
+			type = d.type;
+			u = d.u;
+			refCount = d.refCount;
+			if (refCount)
+				*refCount += 1;
+		}
+	}
+	ignoreGlobal = false;
+	return *this;
+}
+
+Datum& Datum::operator=(Datum &&d) {
+	if (this != &d) {
 		reset();
 		type = d.type;
 		u = d.u;
 		refCount = d.refCount;
-		*refCount += 1;
+		d.type = VOID;
+		d.refCount = nullptr;
 	}
 	ignoreGlobal = false;
 	return *this;
@@ -915,24 +942,21 @@ Datum& Datum::operator=(const Datum &d) {
 Datum::Datum(int val) {
 	u.i = val;
 	type = INT;
-	refCount = new int;
-	*refCount = 1;
+	refCount = nullptr;
 	ignoreGlobal = false;
 }
 
 Datum::Datum(double val) {
 	u.f = val;
 	type = FLOAT;
-	refCount = new int;
-	*refCount = 1;
+	refCount = nullptr;
 	ignoreGlobal = false;
 }
 
 Datum::Datum(const Common::String &val) {
 	u.s = new Common::String(val);
 	type = STRING;
-	refCount = new int;
-	*refCount = 1;
+	refCount = nullptr;
 	ignoreGlobal = false;
 }
 
@@ -944,8 +968,7 @@ Datum::Datum(AbstractObject *val) {
 		*refCount += 1;
 	} else {
 		type = VOID;
-		refCount = new int;
-		*refCount = 1;
+		refCount = nullptr;
 	}
 	ignoreGlobal = false;
 }
@@ -958,8 +981,7 @@ Datum::Datum(CastMember *val) {
 		*refCount += 1;
 	} else {
 		type = VOID;
-		refCount = new int;
-		*refCount = 1;
+		refCount = nullptr;
 	}
 	ignoreGlobal = false;
 }
@@ -967,8 +989,7 @@ Datum::Datum(CastMember *val) {
 Datum::Datum(const CastMemberID &val) {
 	u.cast = new CastMemberID(val);
 	type = CASTREF;
-	refCount = new int;
-	*refCount = 1;
+	refCount = nullptr;
 	ignoreGlobal = false;
 }
 
@@ -977,8 +998,7 @@ Datum::Datum(const Common::Point &point) {
 	u.farr = new FArray;
 	u.farr->arr.push_back(Datum(point.x));
 	u.farr->arr.push_back(Datum(point.y));
-	refCount = new int;
-	*refCount = 1;
+	refCount = nullptr;
 	ignoreGlobal = false;
 }
 
@@ -989,80 +1009,124 @@ Datum::Datum(const Common::Rect &rect) {
 	u.farr->arr.push_back(Datum(rect.top));
 	u.farr->arr.push_back(Datum(rect.right));
 	u.farr->arr.push_back(Datum(rect.bottom));
-	refCount = new int;
-	*refCount = 1;
+	refCount = nullptr;
 	ignoreGlobal = false;
 }
 
-void Datum::reset() {
-	if (!refCount)
+bool Datum::isRefCounted() const {
+	switch (type) {
+	case VOID:
+	case INT:
+	case FLOAT:
+	case ARGC:
+	case ARGCNORET:
+	case CASTLIBREF:
+	case SPRITEREF:
+		return false;
+	default:
+		return true;
+	}
+}
+
+void Datum::shareRefCount() const {
+	if (refCount || !isRefCounted())
 		return;
 
-	*refCount -= 1;
-	// Coverity thinks that we always free memory, as it assumes
-	// (correctly) that there are cases when refCount == 0
-	// Thus, DO NOT COMPILE, trick it and shut tons of false positives
+	// The value is held by this Datum only
+	switch (type) {
+	case ARRAY:
+	case POINT:
+	case RECT:
+		refCount = u.farr ? &u.farr->_refCount : new int(0);
+		break;
+	case PARRAY:
+		refCount = u.parr ? &u.parr->_refCount : new int(0);
+		break;
+	default:
+		refCount = new int(0);
+		break;
+	}
+	*refCount += 1;
+}
+
+void Datum::reset() {
+	if (refCount) {
+		*refCount -= 1;
+		// Coverity thinks that we always free memory, as it assumes
+		// (correctly) that there are cases when refCount == 0
+		// Thus, DO NOT COMPILE, trick it and shut tons of false positives
 #ifndef __COVERITY__
-	if (*refCount <= 0) {
-		switch (type) {
-		case VOID:
-		case INT:
-		case FLOAT:
-		case ARGC:
-		case ARGCNORET:
-		case CASTLIBREF:
-		case SPRITEREF:
-			break;
-		case VARREF:
-		case GLOBALREF:
-		case LOCALREF:
-		case PROPREF:
-		case STRING:
-		case SYMBOL:
-			delete u.s;
-			break;
-		case ARRAY:
-		case POINT:
-		case RECT:
-			delete u.farr;
-			break;
-		case PARRAY:
-			delete u.parr;
-			break;
-		case MEDIA:
-			delete u.obj;
-			break;
-		case OBJECT:
-			if (u.obj->getObjType() == kWindowObj) {
-				// Window has an override for decRefCount, use it directly
+		if (*refCount > 0)
+			return;
+#endif
+	}
+
+#ifndef __COVERITY__
+	// Counts stored in the value are freed with it
+	bool ownRefCount = (type != OBJECT && type != MEDIA);
+	switch (type) {
+	case VOID:
+	case INT:
+	case FLOAT:
+	case ARGC:
+	case ARGCNORET:
+	case CASTLIBREF:
+	case SPRITEREF:
+		break;
+	case VARREF:
+	case GLOBALREF:
+	case LOCALREF:
+	case PROPREF:
+	case STRING:
+	case SYMBOL:
+		delete u.s;
+		break;
+	case ARRAY:
+	case POINT:
+	case RECT:
+		if (u.farr && refCount == &u.farr->_refCount)
+			ownRefCount = false;
+		delete u.farr;
+		break;
+	case PARRAY:
+		if (u.parr && refCount == &u.parr->_refCount)
+			ownRefCount = false;
+		delete u.parr;
+		break;
+	case MEDIA:
+		delete u.obj;
+		break;
+	case OBJECT:
+		if (u.obj->getObjType() == kWindowObj) {
+			// Window has an override for decRefCount, use it directly
+			if (refCount)
 				*refCount += 1;
-				static_cast<Window *>(u.obj)->decRefCount();
-			} else {
-				// *refCount is copied between the Datum and the Object,
-				// so should be safe to delete the Object
-				delete u.obj;
-			}
-			break;
-		case CHUNKREF:
-			delete u.cref;
-			break;
-		case CASTREF:
-		case FIELDREF:
-			delete u.cast;
-			break;
-		case MENUREF:
-			delete u.menu;
-			break;
-		case PICTUREREF:
-			delete u.picture;
-			break;
-		default:
-			warning("Datum::reset(): Unprocessed REF type %d", type);
-			break;
+			static_cast<Window *>(u.obj)->decRefCount();
+		} else {
+			// *refCount is copied between the Datum and the Object,
+			// so should be safe to delete the Object
+			delete u.obj;
 		}
-		if (type != OBJECT && type != MEDIA) // object owns refCount
-			delete refCount;
+		break;
+	case CHUNKREF:
+		delete u.cref;
+		break;
+	case CASTREF:
+	case FIELDREF:
+		delete u.cast;
+		break;
+	case MENUREF:
+		delete u.menu;
+		break;
+	case PICTUREREF:
+		delete u.picture;
+		break;
+	default:
+		warning("Datum::reset(): Unprocessed REF type %d", type);
+		break;
 	}
+	if (ownRefCount)
+		delete refCount;
 #endif
 }
 
@@ -1715,11 +1779,14 @@ void Lingo::varAssign(const Datum &var, const Datum &value) {
 	switch (var.type) {
 	case VARREF:
 		{
-			Common::String name = *var.u.s;
-			if (_state->localVars && _state->localVars->contains(name)) {
-				(*_state->localVars)[name] = value;
-				g_debugger->varWriteHook(name);
-				return;
+			const Common::String &name = *var.u.s;
+			if (_state->localVars) {
+				DatumHash::iterator it = _state->localVars->find(name);
+				if (it != _state->localVars->end()) {
+					it->_value = value;
+					g_debugger->varWriteHook(name);
+					return;
+				}
 			}
 			if (_state->me.type == OBJECT && _state->me.u.obj->hasProp(name)) {
 				_state->me.u.obj->setProp(name, value);
@@ -1739,9 +1806,10 @@ void Lingo::varAssign(const Datum &var, const Datum &value) {
 		break;
 	case LOCALREF:
 		{
-			Common::String name = *var.u.s;
-			if (_state->localVars && _state->localVars->contains(name)) {
-				(*_state->localVars)[name] = value;
+			const Common::String &name = *var.u.s;
+			DatumHash::iterator it;
+			if (_state->localVars && (it = _state->localVars->find(name)) != _state->localVars->end()) {
+				it->_value = value;
 				g_debugger->varWriteHook(name);
 			} else {
 				warning("varAssign: local variable %s not defined", name.c_str());
@@ -1750,7 +1818,7 @@ void Lingo::varAssign(const Datum &var, const Datum &value) {
 		break;
 	case PROPREF:
 		{
-			Common::String name = *var.u.s;
+			const Common::String &name = *var.u.s;
 			if (_state->me.type == OBJECT && _state->me.u.obj->hasProp(name)) {
 				_state->me.u.obj->setProp(name, value);
 				g_debugger->varWriteHook(name);
@@ -1831,18 +1899,20 @@ Datum Lingo::varFetch(const Datum &var, bool silent) {
 	switch (var.type) {
 	case VARREF:
 		{
-			Datum d;
-			Common::String name = *var.u.s;
+			const Common::String &name = *var.u.s;
 			g_debugger->varReadHook(name);
 
-			if (_state->localVars && _state->localVars->contains(name)) {
-				return (*_state->localVars)[name];
+			if (_state->localVars) {
+				DatumHash::const_iterator it = _state->localVars->find(name);
+				if (it != _state->localVars->end())
+					return it->_value;
 			}
 			if (_state->me.type == OBJECT && _state->me.u.obj->hasProp(name)) {
 				return _state->me.u.obj->getProp(name);
 			}
-			if (_globalvars.contains(name)) {
-				return _globalvars[name];
+			DatumHash::const_iterator it = _globalvars.find(name);
+			if (it != _globalvars.end()) {
+				return it->_value;
 			}
 
 			if (!silent)
@@ -1852,10 +1922,11 @@ Datum Lingo::varFetch(const Datum &var, bool silent) {
 		break;
 	case GLOBALREF:
 		{
-			Common::String name = *var.u.s;
+			const Common::String &name = *var.u.s;
 			g_debugger->varReadHook(name);
-			if (_globalvars.contains(name)) {
-				return _globalvars[name];
+			DatumHash::const_iterator it = _globalvars.find(name);
+			if (it != _globalvars.end()) {
+				return it->_value;
 			}
 			debugC(1, kDebugLingoExec, "varFetch: global variable %s not defined", name.c_str());
 			return result;
@@ -1863,10 +1934,12 @@ Datum Lingo::varFetch(const Datum &var, bool silent) {
 		break;
 	case LOCALREF:
 		{
-			Common::String name = *var.u.s;
+			const Common::String &name = *var.u.s;
 			g_debugger->varReadHook(name);
-			if (_state->localVars && _state->localVars->contains(name)) {
-				return (*_state->localVars)[name];
+			if (_state->localVars) {
+				DatumHash::const_iterator it = _state->localVars->find(name);
+				if (it != _state->localVars->end())
+					return it->_value;
 			}
 			debugC(1, kDebugLingoExec, "varFetch: local variable %s not defined", name.c_str());
 			return result;
@@ -1874,7 +1947,7 @@ Datum Lingo::varFetch(const Datum &var, bool silent) {
 		break;
 	case PROPREF:
 		{
-			Common::String name = *var.u.s;
+			const Common::String &name = *var.u.s;
 			g_debugger->varReadHook(name);
 			if (_state->me.type == OBJECT && _state->me.u.obj->hasProp(name)) {
 				return _state->me.u.obj->getProp(name);
@@ -110,20 +110,22 @@ struct Symbol {	/* symbol table entry */
 
 struct PArray {
 	bool _sorted;
+	int _refCount; // number of Datums sharing this array, see Datum::refCount
 	PropertyArray arr;
 
-	PArray() : _sorted(false) {}
+	PArray() : _sorted(false), _refCount(0) {}
 
-	PArray(int size) : _sorted(false), arr(size) {}
+	PArray(int size) : _sorted(false), _refCount(0), arr(size) {}
 };
 
 struct FArray {
 	bool _sorted;
+	int _refCount; // number of Datums sharing this array, see Datum::refCount
 	DatumArray arr;
 
-	FArray() : _sorted(false) {}
+	FArray() : _sorted(false), _refCount(0) {}
 
-	FArray(int size) : _sorted(false), arr(size) {}
+	FArray(int size) : _sorted(false), _refCount(0), arr(size) {}
 };
 
 
@@ -143,13 +145,18 @@ struct Datum {	/* interpreter stack type */
 		PictureReference *picture; /* PICTUREREF */
 	} u;
 
-	int *refCount;
+	// Reference count shared by the copies of a heap value. Scalar values
+	// have none, and a value held by a single Datum gets one when it is
+	// first copied. Arrays and objects keep the count inside the value.
+	mutable int *refCount;
 
 	bool ignoreGlobal; // True if this Datum should be ignored by showGlobals and clearGlobals
 
 	Datum();
 	Datum(const Datum &d);
+	Datum(Datum &&d);
 	Datum& operator=(const Datum &d);
+	Datum& operator=(Datum &&d);
 	Datum(int val);
 	Datum(double val);
 	Datum(const Common::String &val);
@@ -159,6 +166,10 @@ struct Datum {	/* interpreter stack type */
 	Datum(const Common::Point &point);
 	Datum(const Common::Rect &rect);
 	void reset();
+	// Tells if the value is allocated on the heap and freed by the last copy
+	bool isRefCounted() const;
+	// Makes sure the value has a reference count before it is copied
+	void shareRefCount() const;
 
 	~Datum() {
 		reset();
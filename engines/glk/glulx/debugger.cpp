@@ -0,0 +1,60 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "glk/glulx/debugger.h"
+#include "glk/glulx/glulx.h"
+#include "common/file.h"
+
+namespace Glk {
+namespace Glulx {
+
+Debugger::Debugger() : Glk::Debugger() {
+	registerCmd("replay", WRAP_METHOD(Debugger, cmdReplay));
+}
+
+bool Debugger::cmdReplay(int argc, const char **argv) {
+	if (argc != 2) {
+		debugPrintf("Format: replay <command file>\n");
+		return true;
+	}
+
+	Common::File f;
+	if (!f.open(Common::Path(argv[1]))) {
+		debugPrintf("Could not open %s\n", argv[1]);
+		return true;
+	}
+
+	Common::StringArray commands;
+	while (!f.eos()) {
+		Common::String line = f.readLine();
+		if (!line.empty() || !f.eos())
+			commands.push_back(line);
+	}
+
+	g_vm->replay_commands(commands);
+	debugPrintf("Replaying %u commands\n", commands.size());
+
+	// Close the debugger so that the game can run
+	return false;
+}
+
+} // End of namespace Glulx
+} // End of namespace Glk
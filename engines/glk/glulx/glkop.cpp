@@ -150,6 +150,8 @@ uint Glulx::perform_glk(uint funcnum, uint numargs, uint *arglist) {
 		glk_put_char_stream(find_stream_by_id(arglist[0]), arglist[1] & 0xFF);
 		break;
 	case 0x00C0: /* select */
+		/* feed any commands being replayed by the debugger */
+		replay_select();
 		/* call a library hook on every glk_select() */
 		if (library_select_hook)
 			library_select_hook(arglist[0]);
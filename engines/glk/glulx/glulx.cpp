@@ -20,6 +20,8 @@
  */
 
 #include "glk/glulx/glulx.h"
+#include "glk/glulx/debugger.h"
+#include "glk/windows.h"
 #include "common/config-manager.h"
 #include "common/translation.h"
 
@@ -42,10 +44,14 @@ Glulx::Glulx(OSystem *syst, const GlkGameDescription &gameDesc) : GlkAPI(syst, g
 		accelentries(nullptr),
 		// heap
 		heap_start(0), alloc_count(0), heap_head(nullptr), heap_tail(nullptr),
+		// operand
+		decodecache(nullptr),
 		// serial
 		max_undo_level(8), undo_chain_size(0), undo_chain_num(0), undo_chain(nullptr), ramcache(nullptr),
 		// string
-		iosys_mode(0), iosys_rock(0), tablecache_valid(false), glkio_unichar_han_ptr(nullptr) {
+		iosys_mode(0), iosys_rock(0), tablecache_valid(false), glkio_unichar_han_ptr(nullptr),
+		// replay
+		_replayNext(0), _replayStartTime(0) {
 	g_vm = this;
 
 	glkopInit();
@@ -76,6 +82,10 @@ void Glulx::runGame() {
 	profile_quit();
 }
 
+void Glulx::createDebugger() {
+	setDebugger(new Debugger());
+}
+
 bool Glulx::is_gamefile_valid() {
 	if (_gameFile.size() < 8) {
 		GUIErrorMessage(_("This is too short to be a valid Glulx file."));
@@ -139,6 +149,48 @@ void Glulx::nonfatal_warning_handler(const char *str, const char *arg, bool useV
 	warning("%s", msg.c_str());
 }
 
+void Glulx::replay_commands(const Common::StringArray &commands) {
+	_replayCommands = commands;
+	_replayNext = 0;
+	_replayStartTime = g_system->getMillis();
+}
+
+void Glulx::replay_select() {
+	if (_replayCommands.empty())
+		return;
+
+	Window *win = nullptr;
+	for (Windows::iterator i = _windows->begin(); i != _windows->end(); ++i) {
+		if ((*i)->_lineRequest || (*i)->_lineRequestUni || (*i)->_charRequest || (*i)->_charRequestUni) {
+			win = *i;
+			break;
+		}
+	}
+	if (!win)
+		return;
+
+	if (win->_charRequest || win->_charRequestUni) {
+		// Get past any "press a key" prompts
+		win->acceptReadChar(' ');
+		return;
+	}
+
+	if (_replayNext == _replayCommands.size()) {
+		// The game asks for input again after the last command
+		// Logged as info rather than with debug(), so it's shown without a
+		// debug level being set
+		Common::String msg = Common::String::format("Replayed %u commands in %u ms\n", _replayCommands.size(), g_system->getMillis() - _replayStartTime);
+		g_system->logMessage(LogMessageType::kInfo, msg.c_str());
+		_replayCommands.clear();
+		return;
+	}
+
+	const Common::String &command = _replayCommands[_replayNext++];
+	for (uint ix = 0; ix < command.size(); ix++)
+		win->acceptReadLine((byte)command[ix]);
+	win->acceptReadLine(keycode_Return);
+}
+
 void Glulx::glulx_sort(void *addr, int count, int size, int(*comparefunc)(const void *p1, const void *p2)) {
 	qsort(addr, count, size, comparefunc);
 }
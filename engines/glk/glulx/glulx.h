@@ -26,6 +26,7 @@
 
 #include "common/scummsys.h"
 #include "common/random.h"
+#include "common/str-array.h"
 #include "glk/glk_api.h"
 #include "glk/glulx/glulx_types.h"
 
@@ -145,6 +146,12 @@ private:
 	 */
 	const operandlist_t *fast_operandlist[0x80];
 
+	/**
+	 * Decoded instructions, indexed by their address. Only instructions which lie entirely in ROM
+	 * are cached, as they can never change while the game runs.
+	 */
+	decodedinst_t *decodecache;
+
 	/**@}*/
 
 	/**
@@ -188,6 +195,17 @@ private:
 
 	/**@}*/
 
+	/**
+	 * \defgroup replay fields
+	 * @{
+	 */
+
+	Common::StringArray _replayCommands;    ///< commands given by replay_commands()
+	uint _replayNext;                       ///< index of the next command to give
+	uint32 _replayStartTime;
+
+	/**@}*/
+
 	Common::String _savegameDescription;
 protected:
 	/**
@@ -392,6 +410,17 @@ protected:
 	void dumpcache(cacheblock_t *cablist, int count, int indent);
 
 	/**@}*/
+
+	/**
+	 * Give the next replayed command to the window waiting for line input. This is called
+	 * every time the VM blocks for input.
+	 */
+	void replay_select();
+
+	/**
+	 * Create the debugger
+	 */
+	void createDebugger() override;
 public:
 	/**
 	 * Constructor
@@ -431,6 +460,12 @@ public:
 	 */
 	Common::Error writeGameData(Common::WriteStream *ws) override;
 
+	/**
+	 * Type in the passed commands as the game asks for them, without waiting for the player.
+	 * Once all of them have been processed, the elapsed time is logged.
+	 */
+	void replay_commands(const Common::StringArray &commands);
+
 	/**
 	 * \defgroup Main access methods
 	 * @{
@@ -532,7 +567,8 @@ public:
 	 */
 
 	/**
-	 * Set up the fast-lookup array of operandlists. This is called just once, when the terp starts up.
+	 * Set up the fast-lookup array of operandlists, and empty the decode cache. This is called just
+	 * once, when the terp starts up.
 	 */
 	void init_operands();
 
@@ -551,6 +587,27 @@ public:
 	*/
 	void parse_operands(oparg_t *opargs, const operandlist_t *oplist);
 
+	/**
+	 * Read the opcode and the operands of the instruction at the PC, and put the operand values in
+	 * args. Upon return, the PC will be at the beginning of the next instruction. Instructions in ROM
+	 * are decoded once and then served from the decode cache.
+	 *
+	 * This also assumes that args points at an allocated array of MAX_OPERANDS oparg_t structures.
+	 */
+	uint fetch_instruction(oparg_t *opargs);
+
+	/**
+	 * Put a freshly parsed instruction into a decode cache entry. modeaddr is the address of its
+	 * operand mode list, and opargs the result of parse_operands() for it.
+	 */
+	void cache_instruction(decodedinst_t *entry, uint addr, uint opcode, const operandlist_t *oplist,
+		uint modeaddr, const oparg_t *opargs);
+
+	/**
+	 * Load the operand values of an instruction from the decode cache into args
+	 */
+	void load_cached_operands(oparg_t *opargs, const decodedinst_t *entry);
+
 	/**
 	 * Store a result value, according to the desttype and destaddress given. This is usually used to store
 	 * the result of an opcode, but it's also used by any code that pulls a call-stub off the stack.
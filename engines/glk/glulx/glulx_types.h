@@ -351,6 +351,47 @@ typedef oparg_struct oparg_t;
 
 #define MAX_OPERANDS (8)
 
+/**
+ * How an operand of an instruction in the decode cache gets its value.
+ */
+enum cachedform {
+	cachedform_Const = 0,   ///< value is the operand value
+	cachedform_Stack = 1,   ///< pop the operand value off the stack
+	cachedform_Mem = 2,     ///< value is the main memory address to load from
+	cachedform_Local = 3,   ///< value is the locals address to load from
+	cachedform_Store = 4    ///< desttype and value are used as they are
+};
+
+struct cachedoperand_struct {
+	uint value;
+	byte form;
+	byte desttype;
+};
+typedef cachedoperand_struct cachedoperand_t;
+
+/**
+ * Instructions with more operands than this are never put in the decode cache. Only the
+ * search opcodes have more.
+ */
+#define CACHED_OPERANDS (5)
+
+/**
+ * Number of entries in the decode cache. Must be a power of two.
+ */
+#define DECODECACHE_SIZE (8192)
+
+/**
+ * An instruction in the decode cache, with its opcode and operand modes already parsed.
+ */
+struct decodedinst_struct {
+	uint addr;                      ///< address of the instruction; zero for an empty entry
+	uint opcode;
+	uint nextpc;                    ///< address of the following instruction
+	const operandlist_t *oplist;
+	cachedoperand_t args[CACHED_OPERANDS];
+};
+typedef decodedinst_struct decodedinst_t;
+
 typedef uint(Glulx::*acceleration_func)(uint argc, uint *argv);
 
 struct accelentry_struct {
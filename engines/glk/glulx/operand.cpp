@@ -66,6 +66,14 @@ static const operandlist_t list_LLSS = { 4, 4, &array_LLSS[0] };
 void Glulx::init_operands() {
 	for (int ix = 0; ix < 0x80; ix++)
 		fast_operandlist[ix] = lookup_operandlist(ix);
+
+	if (!decodecache) {
+		decodecache = (decodedinst_t *)glulx_malloc(DECODECACHE_SIZE * sizeof(decodedinst_t));
+		if (!decodecache)
+			fatal_error("Unable to allocate the decode cache.");
+	}
+	for (int ix = 0; ix < DECODECACHE_SIZE; ix++)
+		decodecache[ix].addr = 0;
 }
 
 const operandlist_t *Glulx::lookup_operandlist(uint opcode) {
@@ -516,6 +524,211 @@ WrLocalsAddr:
 	}
 }
 
+uint Glulx::fetch_instruction(oparg_t *args) {
+	decodedinst_t *entry = &decodecache[pc & (DECODECACHE_SIZE - 1)];
+	uint opcode;
+	uint addr = pc;
+	uint modeaddr;
+	const operandlist_t *oplist;
+
+	if (entry->addr == addr) {
+		pc = entry->nextpc;
+		load_cached_operands(args, entry);
+		return entry->opcode;
+	}
+
+	/* Fetch the opcode number. */
+	opcode = Mem1(pc);
+	pc++;
+	if (opcode & 0x80) {
+		/* More than one-byte opcode. */
+		if (opcode & 0x40) {
+			/* Four-byte opcode */
+			opcode &= 0x3F;
+			opcode = (opcode << 8) | Mem1(pc);
+			pc++;
+			opcode = (opcode << 8) | Mem1(pc);
+			pc++;
+			opcode = (opcode << 8) | Mem1(pc);
+			pc++;
+		} else {
+			/* Two-byte opcode */
+			opcode &= 0x7F;
+			opcode = (opcode << 8) | Mem1(pc);
+			pc++;
+		}
+	}
+
+	/* Now we have an opcode number. */
+
+	/* Fetch the structure that describes how the operands for this
+	   opcode are arranged. This is a pointer to an immutable,
+	   static object. */
+	if (opcode < 0x80)
+		oplist = fast_operandlist[opcode];
+	else
+		oplist = lookup_operandlist(opcode);
+
+	if (!oplist)
+		fatal_error_i("Encountered unknown opcode.", opcode);
+
+	/* Based on the oplist structure, load the actual operand values
+	   into inst. This moves the PC up to the end of the instruction. */
+	modeaddr = pc;
+	parse_operands(args, oplist);
+
+	/* ROM can't be written to, so an instruction which lies entirely in
+	   it can be decoded once for all. */
+	if (pc <= ramstart && oplist->num_ops <= CACHED_OPERANDS)
+		cache_instruction(entry, addr, opcode, oplist, modeaddr, args);
+
+	return opcode;
+}
+
+void Glulx::cache_instruction(decodedinst_t *entry, uint addr, uint opcode, const operandlist_t *oplist,
+		uint modeaddr, const oparg_t *args) {
+	int ix;
+	int numops = oplist->num_ops;
+	uint argaddr = modeaddr + (numops + 1) / 2;
+	int modeval = 0;
+
+	for (ix = 0; ix < numops; ix++) {
+		cachedoperand_t *cop = &entry->args[ix];
+		int mode;
+		uint value;
+
+		if ((ix & 1) == 0) {
+			modeval = Mem1(modeaddr);
+			mode = (modeval & 0x0F);
+		} else {
+			mode = ((modeval >> 4) & 0x0F);
+			modeaddr++;
+		}
+
+		/* Read the constant or address following the mode list. The
+		   modes were already checked by parse_operands(). */
+		switch (mode) {
+		case 1:
+		case 5:
+		case 9:
+		case 13:
+			value = Mem1(argaddr);
+			argaddr++;
+			break;
+		case 2:
+		case 6:
+		case 10:
+		case 14:
+			value = Mem2(argaddr);
+			argaddr += 2;
+			break;
+		case 3:
+		case 7:
+		case 11:
+		case 15:
+			value = Mem4(argaddr);
+			argaddr += 4;
+			break;
+		default:
+			value = 0;
+			break;
+		}
+
+		cop->desttype = 0;
+		if (oplist->formlist[ix] != modeform_Load) {
+			cop->form = cachedform_Store;
+			cop->desttype = args[ix].desttype;
+			cop->value = args[ix].value;
+			continue;
+		}
+
+		switch (mode) {
+		case 0:
+		case 1:
+		case 2:
+		case 3:
+			/* The constant was sign-extended by parse_operands() */
+			cop->form = cachedform_Const;
+			cop->value = args[ix].value;
+			break;
+		case 8:
+			cop->form = cachedform_Stack;
+			cop->value = 0;
+			break;
+		case 5:
+		case 6:
+		case 7:
+			cop->form = cachedform_Mem;
+			cop->value = value;
+			break;
+		case 13:
+		case 14:
+		case 15:
+			cop->form = cachedform_Mem;
+			cop->value = value + ramstart;
+			break;
+		default: /* 9, 10, 11 */
+			cop->form = cachedform_Local;
+			cop->value = value;
+			break;
+		}
+	}
+
+	entry->addr = addr;
+	entry->opcode = opcode;
+	entry->nextpc = argaddr;
+	entry->oplist = oplist;
+}
+
+void Glulx::load_cached_operands(oparg_t *args, const decodedinst_t *entry) {
+	int ix;
+	int numops = entry->oplist->num_ops;
+	int argsize = entry->oplist->arg_size;
+	const cachedoperand_t *cop = entry->args;
+	oparg_t *curarg;
+	uint addr;
+
+	for (ix = 0, curarg = args; ix < numops; ix++, curarg++, cop++) {
+		curarg->desttype = cop->desttype;
+
+		switch (cop->form) {
+		case cachedform_Const:
+		case cachedform_Store:
+			curarg->value = cop->value;
+			break;
+
+		case cachedform_Stack:
+			if (stackptr < valstackbase + 4) {
+				fatal_error("Stack underflow in operand.");
+			}
+			stackptr -= 4;
+			curarg->value = Stk4(stackptr);
+			break;
+
+		case cachedform_Mem:
+			if (argsize == 4) {
+				curarg->value = Mem4(cop->value);
+			} else if (argsize == 2) {
+				curarg->value = Mem2(cop->value);
+			} else {
+				curarg->value = Mem1(cop->value);
+			}
+			break;
+
+		default: /* cachedform_Local */
+			addr = cop->value + localsbase;
+			if (argsize == 4) {
+				curarg->value = Stk4(addr);
+			} else if (argsize == 2) {
+				curarg->value = Stk2(addr);
+			} else {
+				curarg->value = Stk1(addr);
+			}
+			break;
+		}
+	}
+}
+
 void Glulx::store_operand(uint desttype, uint destaddr, uint storeval) {
 	switch (desttype) {
 
@@ -114,6 +114,10 @@ void Glulx::finalize_vm() {
 		glulx_free(stack);
 		stack = nullptr;
 	}
+	if (decodecache) {
+		glulx_free(decodecache);
+		decodecache = nullptr;
+	}
 
 	final_serial();
 }
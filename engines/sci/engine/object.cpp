@@ -37,6 +37,7 @@ void Object::init(const Script &owner, reg_t obj_pos, bool initVariables) {
 	const SciSpan<const byte> data = owner.getSpan(obj_pos.getOffset());
 	_baseObj = data;
 	_pos = obj_pos;
+	clearSelectorCache();
 
 	// Calling Object::init more than once will screw up _baseVars/_baseMethod
 	// by duplicating data. This could be turned into a soft error by warning
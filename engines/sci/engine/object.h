@@ -80,7 +80,9 @@ public:
 		_speciesSelectorSci3(NULL_REG),
 		_superClassPosSci3(NULL_REG)
 #endif
-		{}
+	{
+		clearSelectorCache();
+	}
 
 	Object &operator=(const Object &other) {
 		_name = other._name;
@@ -92,6 +94,7 @@ public:
 		_offset = other._offset;
 		_pos = other._pos;
 		_baseVars = other._baseVars;
+		clearSelectorCache();
 
 #ifdef ENABLE_SCI32
 		if (getSciVersion() == SCI_VERSION_3) {
@@ -263,6 +266,45 @@ public:
 	 */
 	int locateVarSelector(SegManager *segMan, Selector slc) const;
 
+	/**
+	 * A result of lookupSelector on this object.
+	 */
+	struct SelectorCacheEntry {
+		int selector;     ///< -1 if the entry is unused
+		byte type;        ///< A SelectorType
+		int16 varIndex;
+		reg_t func;
+		reg_t superClass; ///< The superclass the result was looked up with
+	};
+
+	/**
+	 * Returns the cached lookupSelector result for the given selector, or null.
+	 */
+	const SelectorCacheEntry *findCachedSelector(const int selector) const {
+		const reg_t superClass = getSuperClassSelector();
+		for (uint i = 0; i < kSelectorCacheSize; ++i) {
+			if (_selectorCache[i].selector == selector && _selectorCache[i].superClass == superClass)
+				return &_selectorCache[i];
+		}
+		return nullptr;
+	}
+
+	void cacheSelector(const int selector, const byte type, const int16 varIndex, const reg_t func) const {
+		SelectorCacheEntry &entry = _selectorCache[_nextSelectorCacheEntry];
+		_nextSelectorCacheEntry = (_nextSelectorCacheEntry + 1) % kSelectorCacheSize;
+		entry.selector = selector;
+		entry.type = type;
+		entry.varIndex = varIndex;
+		entry.func = func;
+		entry.superClass = getSuperClassSelector();
+	}
+
+	void clearSelectorCache() const {
+		for (uint i = 0; i < kSelectorCacheSize; ++i)
+			_selectorCache[i].selector = -1;
+		_nextSelectorCacheEntry = 0;
+	}
+
 	bool isClass() const { return (getInfoSelector().getOffset() & kInfoFlagClass); }
 	const Object *getClass(SegManager *segMan) const;
 
@@ -282,6 +324,7 @@ public:
 	void saveLoadWithSerializer(Common::Serializer &ser) override;
 
 	void cloneFromObject(const Object *obj) {
+		clearSelectorCache();
 		_name = obj ? obj->_name : NULL_REG;
 		_baseObj = obj ? obj->_baseObj : SciSpan<const byte>();
 		_baseMethod = obj ? obj->_baseMethod : Common::Array<uint32>();
@@ -368,6 +411,18 @@ private:
 	uint16 _offset;
 
 	reg_t _pos; /**< Object offset within its script; for clones, this is their base */
+
+	enum {
+		kSelectorCacheSize = 4
+	};
+
+	/**
+	 * The most recent selector lookups on this object. Scripts send the same
+	 * few selectors to an object over and over, while a lookup walks the
+	 * property and method tables of the whole class chain.
+	 */
+	mutable SelectorCacheEntry _selectorCache[kSelectorCacheSize];
+	mutable uint _nextSelectorCacheEntry;
 #ifdef ENABLE_SCI32
 	reg_t _superClassPosSci3; /**< reg_t pointing to superclass for SCI3 */
 	reg_t _speciesSelectorSci3;	/**< reg_t containing species "selector" for SCI3 */
@@ -59,6 +59,9 @@ void Script::freeScript(const bool keepLocalsSegment) {
 
 	_codeOffset = 0;
 
+	for (uint i = 0; i < kDecodeCacheSize; ++i)
+		_decodeCache[i].offset = 0xFFFFFFFF;
+
 	_localsOffset = 0;
 	if (!keepLocalsSegment) {
 		_localsSegment = 0;
@@ -81,6 +84,18 @@ enum {
 	kSci11ExportTableOffset = 8
 };
 
+uint Script::readInstruction(uint32 offset, byte &extOpcode, int16 opparams[4]) {
+	DecodedInstruction &decoded = _decodeCache[offset % kDecodeCacheSize];
+	if (decoded.offset != offset) {
+		decoded.size = readPMachineInstruction(getBuf(offset), decoded.extOpcode, decoded.opparams);
+		decoded.offset = offset;
+	}
+
+	extOpcode = decoded.extOpcode;
+	memcpy(opparams, decoded.opparams, sizeof(decoded.opparams));
+	return decoded.size;
+}
+
 void Script::load(int script_nr, ResourceManager *resMan, ScriptPatcher *scriptPatcher, bool applyScriptPatches) {
 	freeScript();
 
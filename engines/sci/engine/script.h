@@ -101,6 +101,27 @@ private:
 	uint16 _offsetLookupStringCount;
 	uint16 _offsetLookupSaidCount;
 
+	/**
+	 * An instruction decoded by readPMachineInstruction.
+	 */
+	struct DecodedInstruction {
+		uint32 offset; ///< Offset of the instruction, or 0xFFFFFFFF if unused
+		uint16 size;
+		byte extOpcode;
+		int16 opparams[4];
+	};
+
+	enum {
+		kDecodeCacheSize = 512
+	};
+
+	/**
+	 * Recently executed instructions, indexed by their offset modulo the
+	 * cache size, so that the operands of loops and frequently called
+	 * methods are parsed only once.
+	 */
+	DecodedInstruction _decodeCache[kDecodeCacheSize];
+
 public:
 	int getLocalsOffset() const { return _localsOffset; }
 	uint16 getLocalsCount() const { return _localsCount; }
@@ -117,6 +138,13 @@ public:
 	}
 
 	const byte *getBuf(uint offset = 0) const { return _buf->getUnsafeDataAt(offset); }
+
+	/**
+	 * Reads the instruction at the given offset, like readPMachineInstruction.
+	 * Instructions read before are served from a cache.
+	 * @return The size of the instruction
+	 */
+	uint readInstruction(uint32 offset, byte &extOpcode, int16 opparams[4]);
 	SciSpan<const byte> getSpan(uint offset) const { return _buf->subspan(offset); }
 
 	int getScriptNumber() const { return _nr; }
@@ -336,6 +336,17 @@ SelectorType lookupSelector(SegManager *segMan, reg_t obj_location, Selector sel
 		error("lookupSelector: Attempt to send to non-object or invalid script. Address %04x:%04x", PRINT_REG(obj_location));
 	}
 
+	const Object::SelectorCacheEntry *cached = obj->findCachedSelector(selectorId);
+	if (cached) {
+		if (cached->type == kSelectorVariable && varp) {
+			varp->obj = obj_location;
+			varp->varindex = cached->varIndex;
+		} else if (cached->type == kSelectorMethod && fptr) {
+			*fptr = cached->func;
+		}
+		return (SelectorType)cached->type;
+	}
+
 	int index = obj->locateVarSelector(segMan, selectorId);
 
 	if (index >= 0) {
@@ -344,21 +355,26 @@ SelectorType lookupSelector(SegManager *segMan, reg_t obj_location, Selector sel
 			varp->obj = obj_location;
 			varp->varindex = index;
 		}
+		obj->cacheSelector(selectorId, kSelectorVariable, index, NULL_REG);
 		return kSelectorVariable;
 	} else {
 		// Check if it's a method, with recursive lookup in superclasses
+		const Object *const sendObj = obj;
 		while (obj) {
 			index = obj->funcSelectorPosition(selectorId);
 			if (index >= 0) {
+				const reg_t func = obj->getFunction(index);
 				if (fptr)
-					*fptr = obj->getFunction(index);
+					*fptr = func;
 
+				sendObj->cacheSelector(selectorId, kSelectorMethod, 0, func);
 				return kSelectorMethod;
 			} else {
 				obj = segMan->getObject(obj->getSuperClassSelector());
 			}
 		}
 
+		// Not cached, the selector may be found once a superclass is loaded
 		return kSelectorNone;
 	}
 }
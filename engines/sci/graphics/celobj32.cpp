@@ -88,9 +88,12 @@ bool CelObj::_drawBlackLines = false;
 void CelObj::init() {
 	CelObj::deinit();
 	_drawBlackLines = false;
-	_nextCacheId = 1;
 	_scaler = new CelScaler();
-	_cache = new CelCache(100);
+
+	int cacheSize = kCelCacheSize;
+	if (ConfMan.hasKey("cel_cache_size"))
+		cacheSize = MAX(1, ConfMan.getInt("cel_cache_size"));
+	_cache = new CelCache(cacheSize);
 }
 
 void CelObj::deinit() {
@@ -698,45 +701,95 @@ void CelObj::submitPalette() const {
 #pragma mark -
 #pragma mark CelObj - Caching
 
-int CelObj::_nextCacheId = 1;
-CelCache *CelObj::_cache = nullptr;
+CelCache::CelCache(const uint capacity) :
+	_entries(capacity),
+	_mostRecent(0),
+	_leastRecent(capacity - 1) {
+	assert(capacity > 0);
 
-int CelObj::searchCache(const CelInfo32 &celInfo, int *const nextInsertIndex) const {
-	*nextInsertIndex = -1;
-	int oldestId = _nextCacheId + 1;
-	int oldestIndex = 0;
+	for (int i = 0; i < (int)capacity; ++i) {
+		_entries[i].prev = i - 1;
+		_entries[i].next = i + 1 < (int)capacity ? i + 1 : -1;
+	}
+}
 
-	for (int i = 0, len = _cache->size(); i < len; ++i) {
-		CelCacheEntry &entry = (*_cache)[i];
+void CelCache::unlinkEntry(const int index) {
+	Entry &entry = _entries[index];
 
-		if (entry.celObj == nullptr) {
-			if (*nextInsertIndex == -1) {
-				*nextInsertIndex = i;
-			}
-		} else if (entry.celObj->_info == celInfo) {
-			entry.id = ++_nextCacheId;
-			return i;
-		} else if (oldestId > entry.id) {
-			oldestId = entry.id;
-			oldestIndex = i;
-		}
+	if (entry.prev != -1) {
+		_entries[entry.prev].next = entry.next;
+	} else {
+		_mostRecent = entry.next;
+	}
+
+	if (entry.next != -1) {
+		_entries[entry.next].prev = entry.prev;
+	} else {
+		_leastRecent = entry.prev;
 	}
 
-	if (*nextInsertIndex == -1) {
-		*nextInsertIndex = oldestIndex;
+	entry.prev = entry.next = -1;
+}
+
+void CelCache::linkEntryFront(const int index) {
+	Entry &entry = _entries[index];
+	entry.prev = -1;
+	entry.next = _mostRecent;
+
+	if (_mostRecent != -1) {
+		_entries[_mostRecent].prev = index;
+	} else {
+		_leastRecent = index;
 	}
 
-	return -1;
+	_mostRecent = index;
 }
 
-void CelObj::putCopyInCache(const int cacheIndex) const {
-	if (cacheIndex == -1) {
-		error("Invalid cache index");
+const CelObj *CelCache::find(const CelInfo32 &celInfo) {
+	IndexMap::const_iterator it = _index.find(celInfo);
+	if (it == _index.end()) {
+		return nullptr;
+	}
+
+	const int index = it->_value;
+	if (index != _mostRecent) {
+		unlinkEntry(index);
+		linkEntryFront(index);
 	}
 
-	CelCacheEntry &entry = (*_cache)[cacheIndex];
-	entry.celObj.reset(duplicate());
-	entry.id = ++_nextCacheId;
+	return _entries[index].celObj.get();
+}
+
+void CelCache::insert(CelObj *celObj) {
+	int index;
+
+	IndexMap::const_iterator it = _index.find(celObj->_info);
+	if (it != _index.end()) {
+		index = it->_value;
+	} else {
+		index = _leastRecent;
+		if (_entries[index].celObj) {
+			_index.erase(_entries[index].celObj->_info);
+		}
+		_index[celObj->_info] = index;
+	}
+
+	_entries[index].celObj.reset(celObj);
+
+	if (index != _mostRecent) {
+		unlinkEntry(index);
+		linkEntryFront(index);
+	}
+}
+
+CelCache *CelObj::_cache = nullptr;
+
+const CelObj *CelObj::searchCache(const CelInfo32 &celInfo) const {
+	return _cache->find(celInfo);
+}
+
+void CelObj::putCopyInCache() const {
+	_cache->insert(duplicate());
 }
 
 #pragma mark -
@@ -983,16 +1036,13 @@ CelObjView::CelObjView(const GuiResourceId viewId, const int16 loopNo, const int
 	_compressionType = kCelCompressionInvalid;
 	_transparent = true;
 
-	int cacheInsertIndex;
-	const int cacheIndex = searchCache(_info, &cacheInsertIndex);
-	if (cacheIndex != -1) {
-		CelCacheEntry &entry = (*_cache)[cacheIndex];
-		const CelObjView *const cachedCelObj = dynamic_cast<CelObjView *>(entry.celObj.get());
+	const CelObj *const cachedCel = searchCache(_info);
+	if (cachedCel != nullptr) {
+		const CelObjView *const cachedCelObj = dynamic_cast<const CelObjView *>(cachedCel);
 		if (cachedCelObj == nullptr) {
-			error("Expected a CelObjView in cache slot %d", cacheIndex);
+			error("Expected a CelObjView in cache for %s", _info.toString().c_str());
 		}
 		*this = *cachedCelObj;
-		entry.id = ++_nextCacheId;
 		return;
 	}
 
@@ -1090,7 +1140,7 @@ CelObjView::CelObjView(const GuiResourceId viewId, const int16 loopNo, const int
 		_remap = analyzeForRemap();
 	}
 
-	putCopyInCache(cacheInsertIndex);
+	putCopyInCache();
 }
 
 bool CelObjView::analyzeUncompressedForRemap() const {
@@ -1191,16 +1241,13 @@ CelObjPic::CelObjPic(const GuiResourceId picId, const int16 celNo) {
 	_transparent = true;
 	_remap = false;
 
-	int cacheInsertIndex;
-	const int cacheIndex = searchCache(_info, &cacheInsertIndex);
-	if (cacheIndex != -1) {
-		CelCacheEntry &entry = (*_cache)[cacheIndex];
-		const CelObjPic *const cachedCelObj = dynamic_cast<CelObjPic *>(entry.celObj.get());
+	const CelObj *const cachedCel = searchCache(_info);
+	if (cachedCel != nullptr) {
+		const CelObjPic *const cachedCelObj = dynamic_cast<const CelObjPic *>(cachedCel);
 		if (cachedCelObj == nullptr) {
-			error("Expected a CelObjPic in cache slot %d", cacheIndex);
+			error("Expected a CelObjPic in cache for %s", _info.toString().c_str());
 		}
 		*this = *cachedCelObj;
-		entry.id = ++_nextCacheId;
 		return;
 	}
 
@@ -1264,7 +1311,7 @@ CelObjPic::CelObjPic(const GuiResourceId picId, const int16 celNo) {
 		}
 	}
 
-	putCopyInCache(cacheInsertIndex);
+	putCopyInCache();
 }
 
 bool CelObjPic::analyzeUncompressedForSkip() const {
@@ -22,6 +22,7 @@
 #ifndef SCI_GRAPHICS_CELOBJ32_H
 #define SCI_GRAPHICS_CELOBJ32_H
 
+#include "common/flat-hashmap.h"
 #include "common/rational.h"
 #include "common/rect.h"
 #include "sci/resource/resource.h"
@@ -105,7 +106,7 @@ struct CelInfo32 {
 
 	// This is the equivalence criteria used by CelObj::searchCache in at least
 	// SSCI SQ6. Notably, it does not check the color field.
-	inline bool operator==(const CelInfo32 &other) {
+	inline bool operator==(const CelInfo32 &other) const {
 		return (
 			type == other.type &&
 			resourceId == other.resourceId &&
@@ -115,7 +116,7 @@ struct CelInfo32 {
 		);
 	}
 
-	inline bool operator!=(const CelInfo32 &other) {
+	inline bool operator!=(const CelInfo32 &other) const {
 		return !(*this == other);
 	}
 
@@ -135,18 +136,78 @@ struct CelInfo32 {
 	}
 };
 
+struct CelInfo32Hash : public Common::UnaryFunction<CelInfo32, uint> {
+	uint operator()(const CelInfo32 &info) const {
+		// Like the equivalence criteria, this must not use the color field
+		uint hash = info.type;
+		hash = hash * 31 + info.resourceId;
+		hash = hash * 31 + (uint16)info.loopNo;
+		hash = hash * 31 + (uint16)info.celNo;
+		hash = hash * 31 + info.bitmap.getSegment();
+		return hash * 31 + info.bitmap.getOffset();
+	}
+};
+
 class CelObj;
-struct CelCacheEntry {
+
+enum {
 	/**
-	 * A monotonically increasing cache ID used to identify the least recently
-	 * used item in the cache for replacement.
+	 * The default number of entries in the cel cache. SSCI uses 100, but the
+	 * lookup cost no longer depends on the size of the cache.
 	 */
-	int id;
-	Common::ScopedPtr<CelObj> celObj;
-	CelCacheEntry() : id(0) {}
+	kCelCacheSize = 256
 };
 
-typedef Common::Array<CelCacheEntry> CelCache;
+/**
+ * A cache of cel objects keyed by their CelInfo32. When full, the least
+ * recently used cel object is replaced.
+ */
+class CelCache {
+public:
+	CelCache(const uint capacity);
+
+	/**
+	 * Returns the cached cel object matching the given CelInfo32 and marks it
+	 * as the most recently used one, or null if there is none.
+	 */
+	const CelObj *find(const CelInfo32 &celInfo);
+
+	/**
+	 * Puts the given cel object into the cache. The cache takes ownership of
+	 * it.
+	 */
+	void insert(CelObj *celObj);
+
+	uint size() const { return _index.size(); }
+	uint capacity() const { return _entries.size(); }
+
+private:
+	struct Entry {
+		Common::ScopedPtr<CelObj> celObj;
+
+		/**
+		 * Neighbours in the usage list, from the most to the least recently
+		 * used entry, or -1.
+		 */
+		int prev, next;
+
+		Entry() : prev(-1), next(-1) {}
+	};
+
+	typedef Common::FlatHashMap<CelInfo32, int, CelInfo32Hash> IndexMap;
+
+	Common::Array<Entry> _entries;
+	IndexMap _index;
+
+	/**
+	 * The most and the least recently used entries. Unused entries are kept
+	 * at the end of the list so that they are filled first.
+	 */
+	int _mostRecent, _leastRecent;
+
+	void unlinkEntry(const int index);
+	void linkEntryFront(const int index);
+};
 
 #pragma mark -
 #pragma mark CelScaler
@@ -450,12 +511,6 @@ private:
 #pragma mark -
 #pragma mark CelObj - Caching
 protected:
-	/**
-	 * A monotonically increasing cache ID used to identify the least recently
-	 * used item in the cache for replacement.
-	 */
-	static int _nextCacheId;
-
 	/**
 	 * A cache of cel objects used to avoid reinitialisation overhead for cels
 	 * with the same CelInfo32.
@@ -464,16 +519,15 @@ protected:
 
 	/**
 	 * Searches the cel cache for a CelObj matching the provided CelInfo32. If
-	 * not found, -1 is returned. `nextInsertIndex` will receive the index of
-	 * the oldest item in the cache, which can be used to replace the oldest
-	 * item with a newer item.
+	 * not found, null is returned.
 	 */
-	int searchCache(const CelInfo32 &celInfo, int *nextInsertIndex) const;
+	const CelObj *searchCache(const CelInfo32 &celInfo) const;
 
 	/**
-	 * Puts a copy of this CelObj into the cache at the given cache index.
+	 * Puts a copy of this CelObj into the cache, replacing the least recently
+	 * used item if the cache is full.
 	 */
-	void putCopyInCache(int index) const;
+	void putCopyInCache() const;
 };
 
 #pragma mark -
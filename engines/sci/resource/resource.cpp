@@ -24,6 +24,8 @@
 #include "common/config-manager.h"
 #include "common/file.h"
 #include "common/fs.h"
+#include "common/hash-ptr.h"
+#include "common/jobs.h"
 #include "common/macresman.h"
 #include "common/textconsole.h"
 #include "common/translation.h"
@@ -1002,7 +1004,8 @@ void ResourceManager::freeResourceSources() {
 }
 
 ResourceManager::ResourceManager(const bool detectionMode) :
-	_detectionMode(detectionMode) {}
+	_detectionMode(detectionMode),
+	_prefetch(nullptr) {}
 
 void ResourceManager::init() {
 	_maxMemoryLRU = 256 * 1024; // 256KiB
@@ -1082,6 +1085,12 @@ void ResourceManager::init() {
 		_maxMemoryLRU = 4096 * 1024; // 4MiB
 	}
 
+	// The limits above were chosen for the original target hardware, allow
+	// raising them (in KiB)
+	if (ConfMan.hasKey("resource_cache_size")) {
+		_maxMemoryLRU = MAX(0, ConfMan.getInt("resource_cache_size")) * 1024;
+	}
+
 	switch (_viewType) {
 	case kViewEga:
 		debugC(1, kDebugLevelResMan, "resMan: Detected EGA graphic resources");
@@ -1108,6 +1117,8 @@ void ResourceManager::init() {
 }
 
 ResourceManager::~ResourceManager() {
+	stopPrefetch();
+
 	// freeing resources
 	ResourceMap::iterator itr = _resMap.begin();
 	while (itr != _resMap.end()) {
@@ -1196,9 +1207,10 @@ Resource *ResourceManager::findResource(ResourceId id, bool lock) {
 	if (!retval)
 		return nullptr;
 
-	if (retval->_status == kResStatusNoMalloc)
-		loadResource(retval);
-	else if (retval->_status == kResStatusEnqueued)
+	if (retval->_status == kResStatusNoMalloc) {
+		if (!takePrefetchedResource(retval))
+			loadResource(retval);
+	} else if (retval->_status == kResStatusEnqueued)
 		// The resource is removed from its current position
 		// in the LRU list because it has been requested
 		// again. Below, it will either be locked, or it
@@ -1248,6 +1260,225 @@ void ResourceManager::unlockResource(Resource *res) {
 	freeOldResources();
 }
 
+struct ResourcePrefetch {
+	struct Request {
+		ResourceId id;
+		ResourceSource *source;
+		int32 fileOffset;
+		ResVersion volVersion;
+		Common::SeekableReadStream *file;
+	};
+
+	struct VolumeFile {
+		Common::File *file;
+		ResourceType firstType; ///< Type of the first resource in the volume
+	};
+
+	typedef Common::HashMap<ResourceSource *, VolumeFile> VolumeFileMap;
+	typedef Common::HashMap<ResourceId, Resource *, ResourceIdHash> DoneMap;
+
+	ResourceManager *resMan;
+	Common::JobGroup group;
+
+	/**
+	 * The worker's own handles on the volume files, opened and closed by the
+	 * main thread only.
+	 */
+	VolumeFileMap files;
+
+	Common::Mutex mutex; ///< Guards all fields below
+	Common::List<Request> queue;
+	DoneMap done;
+	uint32 doneSize;     ///< Total size of the resources in done
+	uint32 maxDoneSize;
+	ResourceId current;  ///< The resource being decompressed if busy is set
+	bool busy;
+	bool running;        ///< A job is submitted
+	bool cancel;         ///< Stop after the current resource
+
+	ResourcePrefetch() : resMan(nullptr), doneSize(0), maxDoneSize(0), busy(false), running(false), cancel(false) {}
+};
+
+void ResourceManager::prefetchResource(ResourceId id) {
+	if (_detectionMode || JobMan.getWorkerCount() == 0)
+		return;
+
+	Resource *res = testResource(id);
+
+	// Only plain volume resources are decompressed on workers. Audio is left
+	// out as it is validated with error() while decompressing.
+	if (!res || res->_status != kResStatusNoMalloc || !res->_source ||
+		res->_source->getSourceType() != kSourceVolume || res->_source->_resourceFile ||
+		res->getType() == kResourceTypeAudio)
+		return;
+
+	if (!_prefetch) {
+		_prefetch = new ResourcePrefetch();
+		_prefetch->resMan = this;
+		_prefetch->maxDoneSize = MAX(_maxMemoryLRU, 1024 * 1024);
+	}
+
+	ResourcePrefetch::VolumeFile volumeFile;
+	if (!_prefetch->files.tryGetVal(res->_source, volumeFile)) {
+		volumeFile.file = new Common::File();
+		if (!volumeFile.file->open(res->_source->getLocationName())) {
+			delete volumeFile.file;
+			return;
+		}
+		volumeFile.firstType = convertResType(volumeFile.file->readByte());
+		_prefetch->files[res->_source] = volumeFile;
+	}
+
+	ResourcePrefetch::Request request;
+	request.id = id;
+	request.source = res->_source;
+	request.fileOffset = res->_fileOffset;
+	request.file = volumeFile.file;
+
+	// Same special case as in ResourceSource::loadResource
+	request.volVersion = getVolVersion();
+	const ResourceType firstType = volumeFile.firstType;
+	if (((firstType == kResourceTypeMessage && id.getType() == kResourceTypeMessage) ||
+		 (firstType == kResourceTypeText && id.getType() == kResourceTypeText)) &&
+		g_sci && g_sci->getLanguage() == Common::KO_KOR)
+		request.volVersion = kResVersionSci11;
+
+	Common::StackLock lock(_prefetch->mutex);
+
+	if (_prefetch->done.contains(id) || (_prefetch->busy && _prefetch->current == id))
+		return;
+	for (Common::List<ResourcePrefetch::Request>::const_iterator it = _prefetch->queue.begin(); it != _prefetch->queue.end(); ++it) {
+		if (it->id == id)
+			return;
+	}
+
+	_prefetch->queue.push_back(request);
+
+	if (!_prefetch->running) {
+		_prefetch->running = true;
+		JobMan.submit(_prefetch->group, prefetchProc, _prefetch);
+	}
+}
+
+void ResourceManager::prefetchProc(void *param) {
+	ResourcePrefetch *prefetch = (ResourcePrefetch *)param;
+
+	for (;;) {
+		ResourcePrefetch::Request request;
+		{
+			Common::StackLock lock(prefetch->mutex);
+			if (prefetch->cancel || prefetch->queue.empty() || prefetch->doneSize >= prefetch->maxDoneSize) {
+				prefetch->running = false;
+				return;
+			}
+			request = prefetch->queue.front();
+			prefetch->queue.pop_front();
+			prefetch->current = request.id;
+			prefetch->busy = true;
+		}
+
+		Resource *res = new Resource(prefetch->resMan, request.id);
+		res->_source = request.source;
+		res->_fileOffset = request.fileOffset;
+
+		request.file->seek(request.fileOffset, SEEK_SET);
+		if (res->decompress(request.volVersion, request.file) || res->_id != request.id) {
+			// Leave it to findResource to load it again and report errors
+			delete res;
+			res = nullptr;
+		}
+
+		Common::StackLock lock(prefetch->mutex);
+		prefetch->busy = false;
+		if (res) {
+			prefetch->done[request.id] = res;
+			prefetch->doneSize += res->size();
+		}
+	}
+}
+
+bool ResourceManager::takePrefetchedResource(Resource *res) {
+	if (!_prefetch)
+		return false;
+
+	Resource *decompressed = nullptr;
+	bool wait = false;
+
+	_prefetch->mutex.lock();
+	ResourcePrefetch::DoneMap::iterator done = _prefetch->done.find(res->_id);
+	if (done != _prefetch->done.end()) {
+		decompressed = done->_value;
+		_prefetch->done.erase(done);
+		_prefetch->doneSize -= decompressed->size();
+	} else if (_prefetch->busy && _prefetch->current == res->_id) {
+		// Let the worker finish this one and stop
+		_prefetch->cancel = true;
+		wait = true;
+	} else {
+		for (Common::List<ResourcePrefetch::Request>::iterator it = _prefetch->queue.begin(); it != _prefetch->queue.end(); ++it) {
+			if (it->id == res->_id) {
+				_prefetch->queue.erase(it);
+				break;
+			}
+		}
+	}
+	_prefetch->mutex.unlock();
+
+	if (wait) {
+		JobMan.wait(_prefetch->group);
+
+		Common::StackLock lock(_prefetch->mutex);
+		_prefetch->cancel = false;
+		if (_prefetch->done.tryGetVal(res->_id, decompressed)) {
+			_prefetch->done.erase(res->_id);
+			_prefetch->doneSize -= decompressed->size();
+		}
+		if (!_prefetch->queue.empty()) {
+			_prefetch->running = true;
+			JobMan.submit(_prefetch->group, prefetchProc, _prefetch);
+		}
+	}
+
+	if (!decompressed)
+		return false;
+
+	// The resource may have been moved to a patch or another volume since
+	if (decompressed->_source != res->_source || decompressed->_fileOffset != res->_fileOffset) {
+		delete decompressed;
+		return false;
+	}
+
+	res->_data = decompressed->_data;
+	res->_size = decompressed->_size;
+	res->_status = kResStatusAllocated;
+	decompressed->_data = nullptr;
+	delete decompressed;
+
+	if (_patcher) {
+		_patcher->applyPatch(*res);
+	}
+
+	return true;
+}
+
+void ResourceManager::stopPrefetch() {
+	if (!_prefetch)
+		return;
+
+	_prefetch->mutex.lock();
+	_prefetch->cancel = true;
+	_prefetch->mutex.unlock();
+	JobMan.wait(_prefetch->group);
+
+	for (ResourcePrefetch::DoneMap::iterator it = _prefetch->done.begin(); it != _prefetch->done.end(); ++it)
+		delete it->_value;
+	for (ResourcePrefetch::VolumeFileMap::iterator it = _prefetch->files.begin(); it != _prefetch->files.end(); ++it)
+		delete it->_value.file;
+
+	delete _prefetch;
+	_prefetch = nullptr;
+}
+
 const char *ResourceManager::versionDescription(ResVersion version) const {
 	switch (version) {
 	case kResVersionUnknown:
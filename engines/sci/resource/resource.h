@@ -24,7 +24,7 @@
 
 #include "common/str.h"
 #include "common/list.h"
-#include "common/hashmap.h"
+#include "common/flat-hashmap.h"
 
 #include "sci/graphics/helpers.h"		// for ViewType
 #include "sci/resource/decompressor.h"
@@ -321,9 +321,10 @@ protected:
 	int readResourceInfo(ResVersion volVersion, Common::SeekableReadStream *file, uint32 &szPacked, ResourceCompression &compression);
 };
 
-typedef Common::HashMap<ResourceId, Resource *, ResourceIdHash> ResourceMap;
+typedef Common::FlatHashMap<ResourceId, Resource *, ResourceIdHash> ResourceMap;
 
 class IntMapResourceSource;
+struct ResourcePrefetch;
 class ResourceManager {
 	// FIXME: These 'friend' declarations are meant to be a temporary hack to
 	// ease transition to the ResourceSource class system.
@@ -380,6 +381,14 @@ public:
 	 */
 	void unlockResource(Resource *res);
 
+	/**
+	 * Hints that a resource is going to be needed soon. If worker threads
+	 * are available, the resource is decompressed on one of them, and a later
+	 * findResource call picks up the decompressed data.
+	 * @param id	The resource to prefetch
+	 */
+	void prefetchResource(ResourceId id);
+
 	/**
 	 * Tests whether a resource exists.
 	 *
@@ -508,6 +517,7 @@ protected:
 	ResVersion _volVersion; ///< resource.0xx version
 	ResVersion _mapVersion; ///< resource.map version
 	bool _isSci2Mac;
+	ResourcePrefetch *_prefetch; ///< Resources being decompressed ahead of use
 
 	/**
 	 * Add a path to the resource manager's list of sources.
@@ -563,6 +573,14 @@ protected:
 	void disposeVolumeFileStream(Common::SeekableReadStream *fileStream, ResourceSource *source);
 	void loadResource(Resource *res);
 	void freeOldResources();
+
+	/**
+	 * Moves the data of a prefetched resource into the given resource.
+	 * @return true if the resource was prefetched
+	 */
+	bool takePrefetchedResource(Resource *res);
+	void stopPrefetch();
+	static void prefetchProc(void *param);
 	bool validateResource(const ResourceId &resourceId, const Common::Path &sourceMapLocation, const Common::Path &sourceName, const uint32 offset, const uint32 size, const uint32 sourceSize) const;
 	Resource *addResource(ResourceId resId, ResourceSource *src, uint32 offset, uint32 size = 0, const Common::Path &sourceMapLocation = Common::Path("(no map location)"));
 	Resource *updateResource(ResourceId resId, ResourceSource *src, uint32 size, const Common::Path &sourceMapLocation = Common::Path("(no map location)"));
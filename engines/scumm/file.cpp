@@ -33,6 +33,7 @@ namespace Scumm {
 void BaseScummFile::close() {
   _baseStream.reset();
   _debugName.clear();
+  setReadCache(0, nullptr, 0);
 }
 
 #pragma mark -
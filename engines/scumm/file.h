@@ -39,10 +39,29 @@ protected:
 	Common::ScopedPtr<Common::SeekableReadStream> _baseStream;
 	Common::String _debugName;
 
+	// See setReadCache()
+	int64 _cacheStart;
+	uint32 _cacheSize;
+	const byte *_cacheData;
+
 public:
-	BaseScummFile() : _encbyte(0) {}
+	BaseScummFile() : _encbyte(0), _cacheStart(0), _cacheSize(0), _cacheData(nullptr) {}
 	void setEnc(byte value) { _encbyte = value; }
 
+	/**
+	 * Serve reads which lie completely within the given range of the file
+	 * from memory, e.g. for data which was read ahead through another
+	 * handle. The data is returned as is, so it has to be decrypted
+	 * already. The caller keeps ownership of @p data and has to reset the
+	 * cache by passing nullptr before freeing it. Closing the file resets
+	 * it as well.
+	 */
+	void setReadCache(int64 start, const byte *data, uint32 size) {
+		_cacheStart = start;
+		_cacheData = data;
+		_cacheSize = data ? size : 0;
+	}
+
 	virtual bool open(const Common::Path &filename) = 0;
 	virtual bool openSubFile(const Common::Path &filename) = 0;
 	virtual void close();
@@ -55,6 +55,7 @@ void ScummFile::resetSubfile() {
 }
 
 bool ScummFile::open(const Common::Path &filename) {
+	setReadCache(0, nullptr, 0);
 	_baseStream.reset(_isMac ?
 			  Common::MacResManager::openFileOrDataFork(filename) :
 			  SearchMan.createReadStreamForMember(filename));
@@ -165,6 +166,15 @@ bool ScummFile::seek(int64 offs, int whence) {
 uint32 ScummFile::read(void *dataPtr, uint32 dataSize) {
 	uint32 realLen;
 
+	if (_cacheData) {
+		const int64 curPos = pos();
+		if (curPos >= _cacheStart && curPos + dataSize <= _cacheStart + _cacheSize) {
+			memcpy(dataPtr, _cacheData + (curPos - _cacheStart), dataSize);
+			seek(dataSize, SEEK_CUR);
+			return dataSize;
+		}
+	}
+
 	if (_subFileLen) {
 		// Limit the amount we read by the subfile boundaries.
 		const int32 curPos = pos();
@@ -29,6 +29,7 @@
 #include "scumm/scumm_v0.h"
 #include "scumm/scumm_v5.h"
 #include "scumm/scumm_v6.h"
+#include "scumm/stripblit.h"
 #include "scumm/usage_bits.h"
 #include "scumm/he/wiz_he.h"
 #include "scumm/util.h"
@@ -216,6 +217,8 @@ Gdi::Gdi(ScummEngine *vm) : _vm(vm) {
 	_zbufferDisabled = false;
 	_objectMode = false;
 	_distaff = false;
+
+	StripBlit::selectKernels();
 }
 
 Gdi::~Gdi() {
@@ -691,6 +694,7 @@ void ScummEngine::drawStripToScreen(VirtScreen *vs, int x, int width, int top, i
 		// so loop unrolloing might be a good idea...
 		assert(IS_ALIGNED(text, 4));
 		assert(0 == (width & 3));
+		const int srcPitch = width * m * vs->format.bytesPerPixel + vsPitch;
 
 #ifndef DISABLE_TOWNS_DUAL_LAYER_MODE
 		if (_game.platform == Common::kPlatformFMTowns) {
@@ -700,60 +704,15 @@ void ScummEngine::drawStripToScreen(VirtScreen *vs, int x, int width, int top, i
 #endif
 		// Compose the text over the game graphics
 		if (_outputPixelFormat.bytesPerPixel == 2) {
-			const byte *srcPtr = (const byte *)src;
-			const byte *textPtr = (byte *)_textSurface.getBasePtr(x * m, y * m);
-			byte *dstPtr = _compositeBuf;
-
-			for (int h = 0; h < height * m; ++h) {
-				for (int w = 0; w < width * m; ++w) {
-					uint16 tmp = *textPtr++;
-					if (tmp == CHARSET_MASK_TRANSPARENCY) {
-						tmp = READ_UINT16(srcPtr);
-						WRITE_UINT16(dstPtr, tmp); dstPtr += 2;
-					} else if (_game.heversion != 0) {
-						error ("16Bit Color HE Game using old charset");
-					} else {
-						WRITE_UINT16(dstPtr, _16BitPalette[tmp]); dstPtr += 2;
-					}
-					srcPtr += vs->format.bytesPerPixel;
-				}
-				srcPtr += vsPitch;
-				textPtr += _textSurface.pitch - width * m;
-			}
+			if (StripBlit::composeText16(_compositeBuf, (const byte *)src, srcPitch, (const byte *)text, _textSurface.pitch,
+					_16BitPalette, width * m, height * m) && _game.heversion != 0)
+				error ("16Bit Color HE Game using old charset");
 		} else {
 #ifdef USE_ARM_GFX_ASM
 			asmDrawStripToScreen(height, width, text, src, _compositeBuf, vs->pitch, width, _textSurface.pitch);
 #else
-			// We blit four pixels at a time, for improved performance.
-			const uint32 *src32 = (const uint32 *)src;
-			uint32 *dst32 = (uint32 *)_compositeBuf;
-
-			vsPitch >>= 2;
-
-			const uint32 *text32 = (const uint32 *)text;
-			const int textPitch = (_textSurface.pitch - width * m) >> 2;
-			for (int h = height * m; h > 0; --h) {
-				for (int w = width * m; w > 0; w -= 4) {
-					uint32 temp = *text32++;
-
-					// Generate a byte mask for those text pixels (bytes) with
-					// value CHARSET_MASK_TRANSPARENCY. In the end, each byte
-					// in mask will be either equal to 0x00 or 0xFF.
-					// Doing it this way avoids branches and bytewise operations,
-					// at the cost of readability ;).
-					uint32 mask = temp ^ CHARSET_MASK_TRANSPARENCY_32;
-					mask = (((mask & 0x7f7f7f7f) + 0x7f7f7f7f) | mask) & 0x80808080;
-					mask = ((mask >> 7) + 0x7f7f7f7f) ^ 0x80808080;
-
-					// The following line is equivalent to this code:
-					//   *dst32++ = (*src32++ & mask) | (temp & ~mask);
-					// However, some compilers can generate somewhat better
-					// machine code for this equivalent statement:
-					*dst32++ = ((temp ^ *src32++) & mask) ^ temp;
-				}
-				src32 += vsPitch;
-				text32 += textPitch;
-			}
+			StripBlit::composeText8(_compositeBuf, (const byte *)src, srcPitch, (const byte *)text, _textSurface.pitch,
+				width * m, height * m);
 #endif
 		}
 		src = _compositeBuf;
@@ -4107,23 +4066,19 @@ void Gdi::drawStrip3DO(byte *dst, int dstPitch, const byte *src, int height, con
 	} while (0)
 
 void Gdi::drawStripComplex(byte *dst, int dstPitch, const byte *src, int height, const bool transpCheck) const {
-	byte color;
 	MajMinCodec majMin;
 
 	majMin.setupBitReader(_decomp_shr, src);
 
-	byte lineBuffer[8];
-	memset(lineBuffer, 0, 8);
+	const byte *palette = getStripPalette();
+	byte colors[8 * kStripChunkLines];
 
-	while (height--) {
-		majMin.decodeLine(lineBuffer, 8, 1);
-		for (byte i = 0; i < 8; i ++) {
-			color = lineBuffer[i];
-			if (!transpCheck || color != _transparentColor)
-				writeRoomColor(dst, color);
-			dst += _vm->_bytesPerPixel;
-		}
-		dst += dstPitch - 8 * _vm->_bytesPerPixel;
+	while (height > 0) {
+		const int lines = MIN<int>(height, kStripChunkLines);
+		majMin.decodeLine(colors, 8 * lines, 1);
+		writeRoomColors(dst, dstPitch, colors, lines, palette, transpCheck);
+		dst += lines * dstPitch;
+		height -= lines;
 	}
 }
 
@@ -4134,13 +4089,16 @@ void Gdi::drawStripBasicH(byte *dst, int dstPitch, const byte *src, int height,
 	byte bit;
 	int8 inc = -1;
 
+	const byte *palette = getStripPalette();
+	byte colors[8 * kStripChunkLines];
+
 	do {
-		int x = 8;
+		const int lines = MIN<int>(height, kStripChunkLines);
+		byte *out = colors;
+		int x = 8 * lines;
 		do {
 			FILL_BITS;
-			if (!transpCheck || color != _transparentColor)
-				writeRoomColor(dst, color);
-			dst += _vm->_bytesPerPixel;
+			*out++ = color;
 			if (!READ_BIT) {
 			} else if (!READ_BIT) {
 				FILL_BITS;
@@ -4155,8 +4113,10 @@ void Gdi::drawStripBasicH(byte *dst, int dstPitch, const byte *src, int height,
 				color += inc;
 			}
 		} while (--x);
-		dst += dstPitch - 8 * _vm->_bytesPerPixel;
-	} while (--height);
+		writeRoomColors(dst, dstPitch, colors, lines, palette, transpCheck);
+		dst += lines * dstPitch;
+		height -= lines;
+	} while (height > 0);
 }
 
 void Gdi::drawStripBasicV(byte *dst, int dstPitch, const byte *src, int height, const bool transpCheck) const {
@@ -4236,14 +4196,7 @@ void Gdi::drawStripRaw(byte *dst, int dstPitch, const byte *src, int height, con
 			NEXT_ROW;
 		}
 	} else {
-		do {
-			for (x = 0; x < 8; x ++) {
-				byte color = *src++;
-				if (!transpCheck || color != _transparentColor)
-					writeRoomColor(dst + x * _vm->_bytesPerPixel, color);
-			}
-			dst += dstPitch;
-		} while (--height);
+		writeRoomColors(dst, dstPitch, src, height, getStripPalette(), transpCheck);
 	}
 }
 
@@ -4383,6 +4336,28 @@ void Gdi::writeRoomColor(byte *dst, byte color) const {
 	*dst = _roomPalette[(color + _paletteMod) & 0xFF];
 }
 
+const byte *Gdi::getStripPalette() const {
+	if (_paletteMod == 0 && StripBlit::isIdentityPalette(_roomPalette))
+		return nullptr;
+	return _roomPalette;
+}
+
+void Gdi::writeRoomColors(byte *dst, int dstPitch, const byte *colors, int height, const byte *palette, const bool transpCheck) const {
+	if (_vm->_bytesPerPixel == 1) {
+		StripBlit::writeStrip(dst, dstPitch, colors, height, palette, _paletteMod, transpCheck ? _transparentColor : -1);
+		return;
+	}
+
+	for (; height > 0; --height) {
+		for (int x = 0; x < 8; x++) {
+			const byte color = *colors++;
+			if (!transpCheck || color != _transparentColor)
+				writeRoomColor(dst + x * _vm->_bytesPerPixel, color);
+		}
+		dst += dstPitch;
+	}
+}
+
 
 #pragma mark -
 #pragma mark --- Transition effects ---
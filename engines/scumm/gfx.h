@@ -332,6 +332,14 @@ protected:
 	void drawStripHE(byte *dst, int dstPitch, const byte *src, int width, int height, const bool transpCheck) const;
 	virtual void writeRoomColor(byte *dst, byte color) const;
 
+	/** Rows decoded at once before they are stored by writeRoomColors() */
+	static const int kStripChunkLines = 16;
+
+	/** The room palette for writeRoomColors(), null if it does not change any color */
+	const byte *getStripPalette() const;
+	/** Store height rows of 8 decoded colors like writeRoomColor() does */
+	void writeRoomColors(byte *dst, int dstPitch, const byte *colors, int height, const byte *palette, const bool transpCheck) const;
+
 	/* Mask decompressors */
 	void decompressMaskImgOr(byte *dst, const byte *src, int height) const;
 	void decompressMaskImg(byte *dst, const byte *src, int height) const;
@@ -151,6 +151,15 @@ enum {
 	TREE_DEPTH = 2
 };
 
+// Pack map coordinates into a query cache key, fails for coordinates out of range
+static bool packPoint(int x, int y, uint32 &key) {
+	if ((uint)x > 0xFFFF || (uint)y > 0xFFFF)
+		return false;
+
+	key = ((uint32)x << 16) | (uint32)y;
+	return true;
+}
+
 AI::AI(ScummEngine_v100he *vm) : _vm(vm) {
 	memset(_aiType, 0, sizeof(_aiType));
 	_aiState = STATE_CHOOSE_BEHAVIOR;
@@ -182,6 +191,9 @@ void AI::resetAI() {
 
 		_moveList[i] = new patternList;
 	}
+
+	clearQueryCache();
+	Node::releasePool();
 }
 
 void AI::cleanUpAI() {
@@ -200,6 +212,15 @@ void AI::cleanUpAI() {
 			_moveList[i] = NULL;
 		}
 	}
+
+	clearQueryCache();
+	Node::releasePool();
+}
+
+void AI::clearQueryCache() {
+	_terrainCache.clear();
+	_altitudeCache.clear();
+	_distanceCache.clear();
 }
 
 void AI::setAIType(const int paramCount, const int32 *params) {
@@ -314,6 +335,9 @@ int AI::masterControlProgram(const int paramCount, const int32 *params) {
 
 	switch (_aiState) {
 	case STATE_CHOOSE_BEHAVIOR:
+		// A new decision starts, the map may have changed since the last one
+		clearQueryCache();
+
 		_behavior = chooseBehavior();
 		debugC(DEBUG_MOONBASE_AI, "Behavior mode: %d", _behavior);
 
@@ -2411,7 +2435,17 @@ int AI::getClosestUnit(int x, int y, int radius, int player, int alignment, int
 }
 
 int AI::getDistance(int originX, int originY, int endX, int endY) {
+	uint32 origin, end;
+	if (!packPoint(originX, originY, origin) || !packPoint(endX, endY, end))
+		return _vm->_moonbase->callScummFunction(_mcpParams[F_GET_WORLD_DIST], 4, originX, originY, endX, endY);
+
+	const uint64 key = ((uint64)origin << 32) | end;
+	DistanceQueryCache::const_iterator i = _distanceCache.find(key);
+	if (i != _distanceCache.end())
+		return i->_value;
+
 	int retVal = _vm->_moonbase->callScummFunction(_mcpParams[F_GET_WORLD_DIST], 4, originX, originY, endX, endY);
+	_distanceCache[key] = retVal;
 	return retVal;
 }
 
@@ -2426,7 +2460,16 @@ int AI::calcAngle(int originX, int originY, int endX, int endY, int noWrapFlag)
 }
 
 int AI::getTerrain(int x, int y) {
+	uint32 key;
+	if (!packPoint(x, y, key))
+		return _vm->_moonbase->callScummFunction(_mcpParams[F_GET_TERRAIN_TYPE], 2, x, y);
+
+	PointQueryCache::const_iterator i = _terrainCache.find(key);
+	if (i != _terrainCache.end())
+		return i->_value;
+
 	int retVal = _vm->_moonbase->callScummFunction(_mcpParams[F_GET_TERRAIN_TYPE], 2, x, y);
+	_terrainCache[key] = retVal;
 	return retVal;
 }
 
@@ -2650,7 +2693,16 @@ int AI::getTurnCounter() {
 }
 
 int AI::getGroundAltitude(int x, int y) {
+	uint32 key;
+	if (!packPoint(x, y, key))
+		return _vm->_moonbase->callScummFunction(_mcpParams[F_GET_GROUND_ALTITUDE], 2, x, y);
+
+	PointQueryCache::const_iterator i = _altitudeCache.find(key);
+	if (i != _altitudeCache.end())
+		return i->_value;
+
 	int retVal = _vm->_moonbase->callScummFunction(_mcpParams[F_GET_GROUND_ALTITUDE], 2, x, y);
+	_altitudeCache[key] = retVal;
 	return retVal;
 }
 
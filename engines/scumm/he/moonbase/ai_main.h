@@ -23,6 +23,7 @@
 #define SCUMM_HE_MOONBASE_AI_MAIN_H
 
 #include "common/array.h"
+#include "common/hashmap.h"
 #include "scumm/he/moonbase/ai_tree.h"
 
 namespace Scumm {
@@ -188,6 +189,17 @@ private:
 	int energyPoolSize(int pool);
 	int getMaxCollectors(int pool);
 
+	void clearQueryCache();
+
+	typedef Common::HashMap<uint32, int> PointQueryCache;
+	typedef Common::HashMap<uint64, int> DistanceQueryCache;
+
+	// Results of script queries which cannot change while a decision is
+	// made, keyed on the packed coordinates
+	PointQueryCache _terrainCache;
+	PointQueryCache _altitudeCache;
+	DistanceQueryCache _distanceCache;
+
 public:
 	Common::Array<int> _lastXCoord[5];
 	Common::Array<int> _lastYCoord[5];
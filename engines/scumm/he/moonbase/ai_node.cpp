@@ -19,6 +19,8 @@
  *
  */
 
+#include "common/memorypool.h"
+
 #include "scumm/he/moonbase/ai_node.h"
 
 namespace Scumm {
@@ -29,6 +31,7 @@ IContainedObject::IContainedObject(IContainedObject &sourceContainedObject) {
 }
 
 int Node::_nodeCount = 0;
+Common::MemoryPool *Node::_pool = nullptr;
 
 Node::Node() {
 	_parent = nullptr;
@@ -39,9 +42,8 @@ Node::Node() {
 
 Node::Node(Node *sourceNode) {
 	_parent = nullptr;
-	_children = sourceNode->getChildren();
-
 	_depth = sourceNode->getDepth();
+	_nodeCount++;
 
 	_contents = sourceNode->getContainedObject()->duplicate();
 }
@@ -55,6 +57,32 @@ Node::~Node() {
 	_nodeCount--;
 }
 
+void *Node::operator new(size_t size) {
+	assert(size == sizeof(Node));
+
+	if (!_pool)
+		_pool = new Common::MemoryPool(sizeof(Node));
+
+	return _pool->allocChunk();
+}
+
+void Node::operator delete(void *ptr) {
+	if (ptr)
+		_pool->freeChunk(ptr);
+}
+
+void Node::releasePool() {
+	if (!_pool)
+		return;
+
+	if (_nodeCount) {
+		_pool->freeUnusedPages();
+	} else {
+		delete _pool;
+		_pool = nullptr;
+	}
+}
+
 int Node::generateChildren() {
 	int numChildren = _contents->numChildrenToGen();
 
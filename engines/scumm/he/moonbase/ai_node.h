@@ -24,6 +24,10 @@
 
 #include "common/array.h"
 
+namespace Common {
+class MemoryPool;
+}
+
 namespace Scumm {
 
 const float SUCCESS = -1;
@@ -69,6 +73,9 @@ private:
 	int _depth;
 	static int _nodeCount;
 
+	// Searches create and drop nodes by the thousands, keep them in pages
+	static Common::MemoryPool *_pool;
+
 	IContainedObject *_contents;
 
 public:
@@ -76,6 +83,10 @@ public:
 	Node(Node *sourceNode);
 	~Node();
 
+	static void *operator new(size_t size);
+	static void operator delete(void *ptr);
+	static void releasePool();
+
 	void setParent(Node *parentPtr) { _parent = parentPtr; }
 	Node *getParent() const { return _parent; }
 
@@ -87,7 +98,8 @@ public:
 	void setContainedObject(IContainedObject *value) { _contents = value; }
 	IContainedObject *getContainedObject() { return _contents; }
 
-	Common::Array<Node *> getChildren() const { return _children; }
+	const Common::Array<Node *> &getChildren() const { return _children; }
+	void addChild(Node *child) { _children.push_back(child); }
 	int generateChildren();
 	int generateNextChild();
 	Node *popChild();
@@ -27,13 +27,44 @@
 
 namespace Scumm {
 
-static int compareTreeNodes(const void *a, const void *b) {
-	if (((const TreeNode *)a)->value < ((const TreeNode *)b)->value)
-		return -1;
-	else if (((const TreeNode *)a)->value > ((const TreeNode *)b)->value)
-		return 1;
-	else
-		return 0;
+void OpenList::push(float value, Node *node) {
+	_heap.push_back(TreeNode(value, _nextOrder++, node));
+
+	uint i = _heap.size() - 1;
+	while (i > 0) {
+		const uint parent = (i - 1) / 2;
+		if (!isBefore(_heap[i], _heap[parent]))
+			break;
+		SWAP(_heap[i], _heap[parent]);
+		i = parent;
+	}
+}
+
+Node *OpenList::pop() {
+	assert(!_heap.empty());
+
+	Node *node = _heap[0].node;
+	_heap[0] = _heap.back();
+	_heap.pop_back();
+
+	const uint size = _heap.size();
+	uint i = 0;
+	for (;;) {
+		const uint left = 2 * i + 1;
+		if (left >= size)
+			break;
+
+		uint child = left;
+		if (left + 1 < size && isBefore(_heap[left + 1], _heap[left]))
+			child = left + 1;
+		if (!isBefore(_heap[child], _heap[i]))
+			break;
+
+		SWAP(_heap[i], _heap[child]);
+		i = child;
+	}
+
+	return node;
 }
 
 Tree::Tree(AI *ai) : _ai(ai) {
@@ -42,8 +73,6 @@ Tree::Tree(AI *ai) : _ai(ai) {
 	_maxNodes = MAX_NODES;
 	_currentNode = nullptr;
 	_currentChildIndex = 0;
-
-	_currentMap = new Common::SortedArray<TreeNode *>(compareTreeNodes);
 }
 
 Tree::Tree(IContainedObject *contents, AI *ai) : _ai(ai) {
@@ -53,8 +82,6 @@ Tree::Tree(IContainedObject *contents, AI *ai) : _ai(ai) {
 	_maxNodes = MAX_NODES;
 	_currentNode = nullptr;
 	_currentChildIndex = 0;
-
-	_currentMap = new Common::SortedArray<TreeNode *>(compareTreeNodes);
 }
 
 Tree::Tree(IContainedObject *contents, int maxDepth, AI *ai) : _ai(ai) {
@@ -64,8 +91,6 @@ Tree::Tree(IContainedObject *contents, int maxDepth, AI *ai) : _ai(ai) {
 	_maxNodes = MAX_NODES;
 	_currentNode = nullptr;
 	_currentChildIndex = 0;
-
-	_currentMap = new Common::SortedArray<TreeNode *>(compareTreeNodes);
 }
 
 Tree::Tree(IContainedObject *contents, int maxDepth, int maxNodes, AI *ai) : _ai(ai) {
@@ -75,19 +100,16 @@ Tree::Tree(IContainedObject *contents, int maxDepth, int maxNodes, AI *ai) : _ai
 	_maxNodes = maxNodes;
 	_currentNode = nullptr;
 	_currentChildIndex = 0;
-
-	_currentMap = new Common::SortedArray<TreeNode *>(compareTreeNodes);
 }
 
 void Tree::duplicateTree(Node *sourceNode, Node *destNode) {
-	Common::Array<Node *> vUnvisited = sourceNode->getChildren();
+	const Common::Array<Node *> &vUnvisited = sourceNode->getChildren();
 
-	while (vUnvisited.size()) {
-		Node *newNode = new Node(*(vUnvisited.end()));
+	for (Common::Array<Node *>::const_iterator i = vUnvisited.begin(); i != vUnvisited.end(); i++) {
+		Node *newNode = new Node(*i);
 		newNode->setParent(destNode);
-		(destNode->getChildren()).push_back(newNode);
-		duplicateTree(*(vUnvisited.end()), newNode);
-		vUnvisited.pop_back();
+		destNode->addChild(newNode);
+		duplicateTree(*i, newNode);
 	}
 }
 
@@ -95,7 +117,6 @@ Tree::Tree(const Tree *sourceTree, AI *ai) : _ai(ai) {
 	pBaseNode = new Node(sourceTree->getBaseNode());
 	_maxDepth = sourceTree->getMaxDepth();
 	_maxNodes = sourceTree->getMaxNodes();
-	_currentMap = new Common::SortedArray<TreeNode *>(compareTreeNodes);
 	_currentNode = nullptr;
 	_currentChildIndex = 0;
 
@@ -119,12 +140,10 @@ Tree::~Tree() {
 			pTemp = nullptr;
 		}
 	}
-
-	delete _currentMap;
 }
 
 Node *Tree::aStarSearch() {
-	Common::SortedArray<TreeNode *> mmfpOpen(compareTreeNodes);
+	OpenList mmfpOpen;
 
 	Node *currentNode = nullptr;
 	float currentT;
@@ -134,24 +153,23 @@ Node *Tree::aStarSearch() {
 	float temp = pBaseNode->getContainedObject()->calcT();
 
 	if (static_cast<int>(temp) != SUCCESS) {
-		mmfpOpen.insert(new TreeNode(pBaseNode->getObjectT(), pBaseNode));
+		mmfpOpen.push(pBaseNode->getObjectT(), pBaseNode);
 
-		while (mmfpOpen.size() && (retNode == nullptr)) {
-			currentNode = mmfpOpen.front()->node;
-			mmfpOpen.erase(mmfpOpen.begin());
+		while (!mmfpOpen.empty() && (retNode == nullptr)) {
+			currentNode = mmfpOpen.pop();
 
 			if ((currentNode->getDepth() < _maxDepth) && (Node::getNodeCount() < _maxNodes)) {
 				// Generate nodes
-				Common::Array<Node *> vChildren = currentNode->getChildren();
+				const Common::Array<Node *> &vChildren = currentNode->getChildren();
 
-				for (Common::Array<Node *>::iterator i = vChildren.begin(); i != vChildren.end(); i++) {
+				for (Common::Array<Node *>::const_iterator i = vChildren.begin(); i != vChildren.end(); i++) {
 					IContainedObject *pTemp = (*i)->getContainedObject();
 					currentT = pTemp->calcT();
 
 					if (currentT == SUCCESS)
 						retNode = *i;
 					else
-						mmfpOpen.insert(new TreeNode(currentT, (*i)));
+						mmfpOpen.push(currentT, *i);
 				}
 			} else {
 				retNode = currentNode;
@@ -173,7 +191,7 @@ Node *Tree::aStarSearch_singlePassInit() {
 	float temp = pBaseNode->getContainedObject()->calcT();
 
 	if (static_cast<int>(temp) != SUCCESS) {
-		_currentMap->insert(new TreeNode(pBaseNode->getObjectT(), pBaseNode));
+		_currentMap.push(pBaseNode->getObjectT(), pBaseNode);
 	} else {
 		retNode = pBaseNode;
 	}
@@ -192,13 +210,12 @@ Node *Tree::aStarSearch_singlePass() {
 	}
 
 	if (_currentChildIndex) {
-		if (!(_currentMap->size())) {
+		if (_currentMap.empty()) {
 			retNode = _currentNode;
 			return retNode;
 		}
 
-		_currentNode = _currentMap->front()->node;
-		_currentMap->erase(_currentMap->begin());
+		_currentNode = _currentMap.pop();
 	}
 
 	if ((_currentNode->getDepth() < _maxDepth) && (Node::getNodeCount() < _maxNodes) && ((!maxTime) || (_ai->getTimerValue(3) < maxTime))) {
@@ -206,14 +223,14 @@ Node *Tree::aStarSearch_singlePass() {
 		_currentChildIndex = _currentNode->generateChildren();
 
 		if (_currentChildIndex) {
-			Common::Array<Node *> vChildren = _currentNode->getChildren();
+			const Common::Array<Node *> &vChildren = _currentNode->getChildren();
 
-			if (!vChildren.size() && !_currentMap->size()) {
+			if (!vChildren.size() && _currentMap.empty()) {
 				_currentChildIndex = 0;
 				retNode = _currentNode;
 			}
 
-			for (Common::Array<Node *>::iterator i = vChildren.begin(); i != vChildren.end(); i++) {
+			for (Common::Array<Node *>::const_iterator i = vChildren.begin(); i != vChildren.end(); i++) {
 				IContainedObject *pTemp = (*i)->getContainedObject();
 				currentT = pTemp->calcT();
 
@@ -221,11 +238,11 @@ Node *Tree::aStarSearch_singlePass() {
 					retNode = *i;
 					i = vChildren.end() - 1;
 				} else {
-					_currentMap->insert(new TreeNode(currentT, (*i)));
+					_currentMap.push(currentT, *i);
 				}
 			}
 
-			if (!(_currentMap->size()) && (currentT != SUCCESS)) {
+			if (_currentMap.empty() && (currentT != SUCCESS)) {
 				assert(_currentNode != nullptr);
 				retNode = _currentNode;
 			}
@@ -34,9 +34,37 @@ class AI;
 
 struct TreeNode {
 	float value;
+	uint32 order;
 	Node *node;
 
-	TreeNode(float v, Node *n) { value = v; node = n; }
+	TreeNode(float v, uint32 o, Node *n) { value = v; order = o; node = n; }
+};
+
+/**
+ * Open set of the A* searches: a binary min-heap on the node values.
+ * Nodes with equal values are popped in the order they were pushed.
+ */
+class OpenList {
+private:
+	Common::Array<TreeNode> _heap;
+	uint32 _nextOrder;
+
+	static bool isBefore(const TreeNode &a, const TreeNode &b) {
+		if (a.value < b.value)
+			return true;
+		if (b.value < a.value)
+			return false;
+		return a.order < b.order;
+	}
+
+public:
+	OpenList() : _nextOrder(0) {}
+
+	bool empty() const { return _heap.empty(); }
+	uint size() const { return _heap.size(); }
+
+	void push(float value, Node *node);
+	Node *pop();
 };
 
 class Tree {
@@ -48,7 +76,7 @@ private:
 
 	int _currentChildIndex;
 
-	Common::SortedArray<TreeNode *> *_currentMap;
+	OpenList _currentMap;
 	Node *_currentNode;
 
 	AI *_ai;
@@ -1170,7 +1170,7 @@ int Insane::smlayer_loadSound(int id, int flag, int phase) {
 	if (phase == 2)
 		_vm->ensureResourceLoaded(rtSound, resid);
 
-	_vm->_res->setResourceCounter(rtSound, resid, 1);
+	_vm->_res->touchResource(rtSound, resid);
 
 	if (phase == 1) {
 		_objArray2Idx2++;
@@ -1192,7 +1192,7 @@ int Insane::smlayer_loadCostume(int id, int phase) {
 		return 0;
 
 	_vm->ensureResourceLoaded(rtCostume, resid);
-	_vm->_res->setResourceCounter(rtCostume, resid, 1);
+	_vm->_res->touchResource(rtCostume, resid);
 
 	if (phase == 1) {
 		_objArray1Idx2++;
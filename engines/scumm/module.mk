@@ -91,6 +91,7 @@ MODULE_OBJS := \
 	soundcd.o \
 	soundse.o \
 	string.o \
+	stripblit.o \
 	usage_bits.o \
 	util.o \
 	vars.o \
@@ -156,6 +157,19 @@ MODULE_OBJS += \
 	gfxARM.o
 endif
 
+ifdef SCUMMVM_NEON
+MODULE_OBJS += \
+	stripblit-neon.o
+endif
+ifdef SCUMMVM_SSE2
+MODULE_OBJS += \
+	stripblit-sse2.o
+endif
+ifdef SCUMMVM_AVX2
+MODULE_OBJS += \
+	stripblit-avx2.o
+endif
+
 ifdef ENABLE_HE
 MODULE_OBJS += \
 	he/animation_he.o \
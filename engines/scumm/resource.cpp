@@ -23,6 +23,8 @@
 #include "common/str.h"
 #include "common/memstream.h"
 #include "common/macresman.h"
+#include "common/algorithm.h"
+#include "common/jobs.h"
 #ifndef MACOSX
 #include "common/config-manager.h"
 #endif
@@ -45,8 +47,6 @@ namespace Scumm {
 
 enum {
 	RF_LOCK = 0x80,
-	RF_USAGE = 0x7F,
-	RF_USAGE_MAX = RF_USAGE,
 
 	RS_MODIFIED = 0x10,
 	RF_OFFHEAP = 0x40
@@ -543,11 +543,13 @@ void ResourceManager::allocResTypeData(ResType type, uint32 tag, int num, ResTyp
 	if (num >= 8000)
 		error("Too many %s resources (%d) in directory", nameOfResType(type), num);
 
-	_types[type]._mode = mode;
-	_types[type]._tag = tag;
-
 	// If there was data in there, let's clear it out completely. This is important
 	// in case we are restarting the game.
+	for (ResId idx = 0; idx < _types[type].size(); idx++)
+		nukeResource(type, idx);
+
+	_types[type]._mode = mode;
+	_types[type]._tag = tag;
 	_types[type].clear();
 	_types[type].resize(num);
 
@@ -647,7 +649,6 @@ void ScummEngine::ensureResourceLoaded(ResType type, ResId idx) {
 int ScummEngine::loadResource(ResType type, ResId idx) {
 	int roomNr;
 	uint32 fileOffs;
-	uint32 size, tag;
 
 	debugC(DEBUG_RESOURCE, "loadResource(%s,%d)", nameOfResType(type), idx);
 
@@ -670,6 +671,23 @@ int ScummEngine::loadResource(ResType type, ResId idx) {
 
 	openRoom(roomNr);
 
+	// Read from memory if the resource was prefetched
+	uint32 prefetchedSize;
+	byte *prefetched = takePrefetchedResource(type, idx, roomNr, fileOffs + _fileOffset, prefetchedSize);
+	if (!prefetched)
+		return readResource(type, idx, fileOffs);
+
+	_fileHandle->setReadCache(fileOffs + _fileOffset, prefetched, prefetchedSize);
+	const int result = readResource(type, idx, fileOffs);
+	_fileHandle->setReadCache(0, nullptr, 0);
+	delete[] prefetched;
+
+	return result;
+}
+
+int ScummEngine::readResource(ResType type, ResId idx, uint32 fileOffs) {
+	uint32 size, tag;
+
 	_fileHandle->seek(fileOffs + _fileOffset, SEEK_SET);
 
 	if (_game.features & GF_OLD_BUNDLE) {
@@ -711,7 +729,7 @@ int ScummEngine::loadResource(ResType type, ResId idx) {
 			error("Unknown res tag '%s' encountered (expected '%s') "
 			        "while trying to load res (%s,%d) in room %d at %d+%d in file %s",
 			        tag2str(tag), tag2str(_res->_types[type]._tag),
-					nameOfResType(type), idx, roomNr,
+					nameOfResType(type), idx, _lastLoadedRoom,
 			                _fileOffset, fileOffs, _fileHandle->getDebugName().c_str());
 		}
 
@@ -736,6 +754,179 @@ int ScummEngine::loadResource(ResType type, ResId idx) {
 	return 1;
 }
 
+struct ScummEngine::ResourcePrefetch {
+	enum {
+		// Don't read ahead more than this, the rest is loaded on demand
+		kMaxSize = 4 * 1024 * 1024
+	};
+
+	struct Block {
+		ResType type;
+		ResId idx;
+		int64 offset;
+		uint32 size;
+		byte *data;     ///< Decrypted resource data, nullptr if not read
+		bool taken;     ///< Loaded by the engine already, no need to read it
+	};
+
+	static bool compareOffsets(const Block &a, const Block &b) {
+		return a.offset < b.offset;
+	}
+
+	Common::ScopedPtr<ScummFile> file;
+	int room;
+	Common::Array<Block> blocks;
+
+	Common::Mutex mutex;    ///< Guards the data and taken fields of the blocks and cancel
+	bool cancel;
+	Common::JobGroup group;
+
+	ResourcePrefetch() : room(0), cancel(false) {}
+
+	~ResourcePrefetch() {
+		for (uint i = 0; i < blocks.size(); ++i)
+			delete[] blocks[i].data;
+	}
+
+	static void readProc(void *param);
+};
+
+void ScummEngine::ResourcePrefetch::readProc(void *param) {
+	ResourcePrefetch *prefetch = (ResourcePrefetch *)param;
+	uint32 total = 0;
+
+	for (uint i = 0; i < prefetch->blocks.size(); ++i) {
+		Block &block = prefetch->blocks[i];
+
+		{
+			Common::StackLock lock(prefetch->mutex);
+			if (prefetch->cancel)
+				return;
+			if (block.taken)
+				continue;
+		}
+
+		// All resource types read ahead start with a tag and the size of
+		// the whole block.
+		byte *data = nullptr;
+		prefetch->file->seek(block.offset, SEEK_SET);
+		prefetch->file->readUint32BE();
+		const uint32 size = prefetch->file->readUint32BE();
+		if (!prefetch->file->err() && size >= 8 && total + size <= kMaxSize) {
+			data = new byte[size];
+			prefetch->file->seek(block.offset, SEEK_SET);
+			if (prefetch->file->read(data, size) != size) {
+				delete[] data;
+				data = nullptr;
+			}
+		}
+		prefetch->file->clearErr();
+
+		Common::StackLock lock(prefetch->mutex);
+		if (data && !block.taken) {
+			block.data = data;
+			block.size = size;
+			total += size;
+		} else {
+			delete[] data;
+		}
+	}
+}
+
+void ScummEngine::prefetchRoomResources(int room) {
+	stopPrefetching();
+
+	// Only games which store their resources as plain chunks are supported.
+	// Without worker threads reading ahead would only delay the room change.
+	if (_game.version < 5 || (_game.features & (GF_SMALL_HEADER | GF_OLD_BUNDLE | GF_DOUBLEFINE_PAK)))
+		return;
+	if (JobMan.getWorkerCount() == 0 || room <= 0 || (uint)room >= _res->_types[rtRoom].size())
+		return;
+	if (_res->_types[rtRoom][room]._roomoffs == RES_INVALID_OFFSET)
+		return;
+
+	Common::ScopedPtr<ResourcePrefetch> prefetch(new ResourcePrefetch());
+	prefetch->room = room;
+
+	// Resources are stored in the room in which they are used first, so
+	// these are likely to be needed soon.
+	static const ResType types[] = { rtScript, rtCostume, rtSound };
+	for (int i = 0; i < ARRAYSIZE(types); ++i) {
+		const ResType type = types[i];
+		for (ResId idx = 1; idx < _res->_types[type].size(); ++idx) {
+			const ResourceManager::Resource &res = _res->_types[type][idx];
+			if (res._roomno != room || res._address || res._roomoffs == RES_INVALID_OFFSET)
+				continue;
+
+			ResourcePrefetch::Block block;
+			block.type = type;
+			block.idx = idx;
+			block.offset = getResourceRoomOffset(type, idx);
+			block.size = 0;
+			block.data = nullptr;
+			block.taken = false;
+			prefetch->blocks.push_back(block);
+		}
+	}
+
+	if (prefetch->blocks.empty())
+		return;
+
+	// The engine is going to open the room anyway, and this gives us the
+	// offset of the room in its file.
+	openRoom(room);
+
+	prefetch->file.reset(instantiateScummFile(false));
+	if (!openFile(*prefetch->file, generateFilename(room), true))
+		return;
+	prefetch->file->setEnc(getEncByte(room));
+
+	for (uint i = 0; i < prefetch->blocks.size(); ++i)
+		prefetch->blocks[i].offset += _fileOffset;
+
+	// Read the file front to back
+	Common::sort(prefetch->blocks.begin(), prefetch->blocks.end(), ResourcePrefetch::compareOffsets);
+
+	debugC(DEBUG_RESOURCE, "prefetchRoomResources(%d): %d resources", room, prefetch->blocks.size());
+
+	_prefetch = prefetch.release();
+	JobMan.submit(_prefetch->group, ResourcePrefetch::readProc, _prefetch);
+}
+
+void ScummEngine::stopPrefetching() {
+	if (!_prefetch)
+		return;
+
+	_prefetch->mutex.lock();
+	_prefetch->cancel = true;
+	_prefetch->mutex.unlock();
+
+	JobMan.wait(_prefetch->group);
+	delete _prefetch;
+	_prefetch = nullptr;
+}
+
+byte *ScummEngine::takePrefetchedResource(ResType type, ResId idx, int room, int64 offset, uint32 &size) {
+	if (!_prefetch || _prefetch->room != room)
+		return nullptr;
+
+	Common::StackLock lock(_prefetch->mutex);
+	for (uint i = 0; i < _prefetch->blocks.size(); ++i) {
+		ResourcePrefetch::Block &block = _prefetch->blocks[i];
+		if (block.type != type || block.idx != idx || block.offset != offset)
+			continue;
+
+		// If the block was not read yet, the engine reads it itself
+		byte *data = block.data;
+		size = block.size;
+		block.data = nullptr;
+		block.taken = true;
+		return data;
+	}
+
+	return nullptr;
+}
+
 int ScummEngine::getResourceRoomNr(ResType type, ResId idx) {
 	if (type == rtRoom && _game.heversion < 70)
 		return idx;
@@ -785,7 +976,7 @@ byte *ScummEngine::getResourceAddress(ResType type, ResId idx) {
 		return nullptr;
 	}
 
-	_res->setResourceCounter(type, idx, 1);
+	_res->touchResource(type, idx);
 
 	debugC(DEBUG_RESOURCE, "getResourceAddress(%s,%d) == %p", nameOfResType(type), idx, (void *)ptr);
 	return ptr;
@@ -808,40 +999,76 @@ byte *ScummEngine::getStringAddressVar(int i) {
 	return getStringAddress(_scummVars[i]);
 }
 
-void ResourceManager::increaseExpireCounter() {
-	++_expireCounter;
-	if (_expireCounter == 0) {	// overflow?
-		increaseResourceCounters();
-	}
-}
-
-void ResourceManager::increaseResourceCounters() {
-	for (ResType type = rtFirst; type <= rtLast; type = ResType(type + 1)) {
-		ResId idx = _types[type].size();
-		while (idx-- > 0) {
-			_mutex->lock();
-			byte counter = _types[type][idx].getResourceCounter();
-			_mutex->unlock();
+void ResourceManager::touchResource(ResType type, ResId idx) {
+	Common::StackLock lock(*_mutex);
+	if (!validateResource("touchResource", type, idx) || !_types[type][idx]._address)
+		return;
 
-			if (counter && counter < RF_USAGE_MAX) {
-				setResourceCounter(type, idx, counter + 1);
-			}
-		}
+	if (_types[type]._lruHead == idx) {
+		_types[type][idx]._lastUse = ++_useCounter;
+	} else {
+		unlinkResource(type, idx);
+		linkResource(type, idx, true);
 	}
 }
 
-void ResourceManager::setResourceCounter(ResType type, ResId idx, byte counter) {
+void ResourceManager::markResourceForExpiry(ResType type, ResId idx) {
 	Common::StackLock lock(*_mutex);
-	_types[type][idx].setResourceCounter(counter);
+	if (!validateResource("markResourceForExpiry", type, idx) || !_types[type][idx]._address)
+		return;
+
+	unlinkResource(type, idx);
+	linkResource(type, idx, false);
 }
 
-void ResourceManager::Resource::setResourceCounter(byte counter) {
-	_flags &= RF_LOCK;	// Clear lower 7 bits, preserve the lock bit.
-	_flags |= counter;	// Update the usage counter
+void ResourceManager::linkResource(ResType type, ResId idx, bool mostRecent) {
+	ResTypeData &data = _types[type];
+	Resource &res = data[idx];
+
+	// Only resources which may be expired are kept track of. This also lets
+	// the engine shuffle around e.g. inventory resources as it likes.
+	if (data._mode == kDynamicResTypeMode)
+		return;
+
+	if (mostRecent) {
+		res._lastUse = ++_useCounter;
+		res._lruPrev = kNoResId;
+		res._lruNext = data._lruHead;
+		if (data._lruHead != kNoResId)
+			data[data._lruHead]._lruPrev = idx;
+		else
+			data._lruTail = idx;
+		data._lruHead = idx;
+	} else {
+		res._lastUse = 0;
+		res._lruPrev = data._lruTail;
+		res._lruNext = kNoResId;
+		if (data._lruTail != kNoResId)
+			data[data._lruTail]._lruNext = idx;
+		else
+			data._lruHead = idx;
+		data._lruTail = idx;
+	}
 }
 
-byte ResourceManager::Resource::getResourceCounter() const {
-	return _flags & RF_USAGE;
+void ResourceManager::unlinkResource(ResType type, ResId idx) {
+	ResTypeData &data = _types[type];
+	Resource &res = data[idx];
+
+	if (data._mode == kDynamicResTypeMode)
+		return;
+
+	if (res._lruPrev != kNoResId)
+		data[res._lruPrev]._lruNext = res._lruNext;
+	else
+		data._lruHead = res._lruNext;
+
+	if (res._lruNext != kNoResId)
+		data[res._lruNext]._lruPrev = res._lruPrev;
+	else
+		data._lruTail = res._lruPrev;
+
+	res._lruPrev = res._lruNext = kNoResId;
 }
 
 byte *ResourceManager::createResource(ResType type, ResId idx, uint32 size) {
@@ -876,15 +1103,14 @@ byte *ResourceManager::createResource(ResType type, ResId idx, uint32 size) {
 	// This is just one of the many differences of our system versus the HE resource allocation system...
 	// The whole thing should probably be rewritten at some point to match the source code. ;-)
 	if (_vm->_game.heversion >= 70 && _types[type][idx]._address && _types[type][idx]._size == size) {
-		increaseResourceCounters();
-		setResourceCounter(type, idx, 1);
+		touchResource(type, idx);
 		_vm->_insideCreateResource--;
 		return _types[type][idx]._address;
 	} else {
 		nukeResource(type, idx);
 	}
 
-	expireResources(size);
+	expireResources(type, size);
 
 	byte *ptr = new byte[size + SAFETY_AREA]();
 	if (ptr == nullptr) {
@@ -892,11 +1118,13 @@ byte *ResourceManager::createResource(ResType type, ResId idx, uint32 size) {
 		error("createResource(%s,%d): Out of memory while allocating %d", nameOfResType(type), idx, size);
 	}
 
+	Common::StackLock lock(*_mutex);
 	_allocatedSize += size;
+	_types[type]._allocatedSize += size;
 
 	_types[type][idx]._address = ptr;
 	_types[type][idx]._size = size;
-	setResourceCounter(type, idx, 1);
+	linkResource(type, idx, true);
 
 	_vm->_insideCreateResource--;
 
@@ -906,6 +1134,8 @@ byte *ResourceManager::createResource(ResType type, ResId idx, uint32 size) {
 ResourceManager::Resource::Resource() {
 	_address = nullptr;
 	_size = 0;
+	_lruPrev = _lruNext = kNoResId;
+	_lastUse = 0;
 	_flags = 0;
 	_status = 0;
 	_roomno = 0;
@@ -928,6 +1158,9 @@ void ResourceManager::Resource::nuke() {
 ResourceManager::ResTypeData::ResTypeData() {
 	_mode = kDynamicResTypeMode;
 	_tag = 0;
+	_lruHead = _lruTail = kNoResId;
+	_allocatedSize = 0;
+	_budget = 0;
 }
 
 ResourceManager::ResTypeData::~ResTypeData() {
@@ -938,7 +1171,7 @@ ResourceManager::ResourceManager(ScummEngine *vm) : _vm(vm) {
 	_allocatedSize = 0;
 	_maxHeapThreshold = 0;
 	_minHeapThreshold = 0;
-	_expireCounter = 0;
+	_useCounter = 0;
 }
 
 ResourceManager::~ResourceManager() {
@@ -952,6 +1185,11 @@ void ResourceManager::setHeapThreshold(int min, int max) {
 	_minHeapThreshold = min;
 }
 
+void ResourceManager::setTypeBudget(ResType type, uint32 budget) {
+	assert(type >= rtFirst && type <= rtLast);
+	_types[type]._budget = budget;
+}
+
 bool ResourceManager::validateResource(const char *str, ResType type, ResId idx) const {
 	if (type < rtFirst || type > rtLast || (uint)idx >= (uint)_types[type].size()) {
 		warning("%s Illegal Glob type %s (%d) num %d", str, nameOfResType(type), type, idx);
@@ -966,6 +1204,8 @@ void ResourceManager::nukeResource(ResType type, ResId idx) {
 	if (ptr != nullptr) {
 		debugC(DEBUG_RESOURCE, "nukeResource(%s,%d)", nameOfResType(type), idx);
 		_allocatedSize -= _types[type][idx]._size;
+		_types[type]._allocatedSize -= _types[type][idx]._size;
+		unlinkResource(type, idx);
 		_types[type][idx].nuke();
 	}
 }
@@ -1109,51 +1349,82 @@ void ResourceManager::Resource::setOnHeap() {
 	_status &= ~RF_OFFHEAP;
 }
 
-void ResourceManager::expireResources(uint32 size) {
-	byte best_counter;
-	ResType best_type;
-	int best_res = 0;
-	uint32 oldAllocatedSize;
+ResId ResourceManager::findExpirableResource(ResType type) {
+	ResTypeData &data = _types[type];
+
+	// Resources which can't be expired right now are moved to the front of
+	// the list, so that they are not looked at again until all others were.
+	// Stop once we get back to them.
+	//
+	// The mutex is not held while asking the engine whether a resource is in
+	// use, since that locks e.g. the iMUSE mutex, whose owner may in turn be
+	// waiting for us.
+	_mutex->lock();
+	const uint64 searchStart = _useCounter;
+
+	while (data._lruTail != kNoResId) {
+		const ResId idx = data._lruTail;
+		Resource &res = data[idx];
+		if (res._lastUse > searchStart)
+			break;
+
+		const bool expirable = !res.isLocked() && !res.isOffHeap();
+		_mutex->unlock();
+
+		if (expirable && !_vm->isResourceInUse(type, idx))
+			return idx;
 
-	if (_expireCounter != 0xFF) {
-		_expireCounter = 0xFF;
-		increaseResourceCounters();
+		_mutex->lock();
+		if (res._address) {
+			unlinkResource(type, idx);
+			linkResource(type, idx, true);
+		}
 	}
 
-	if (size + _allocatedSize < _maxHeapThreshold)
-		return;
+	_mutex->unlock();
+	return kNoResId;
+}
 
-	oldAllocatedSize = _allocatedSize;
+void ResourceManager::expireResources(ResType type, uint32 size) {
+	uint32 oldAllocatedSize = _allocatedSize;
 
-	do {
-		best_type = rtInvalid;
-		best_counter = 2;
-
-		for (ResType type = rtFirst; type <= rtLast; type = ResType(type + 1)) {
-			if (_types[type]._mode != kDynamicResTypeMode) {
-				// Resources of this type can be reloaded from the data files,
-				// so we can potentially unload them to free memory.
-				ResId idx = _types[type].size();
-				while (idx-- > 0) {
-					Resource &tmp = _types[type][idx];
-					byte counter = tmp.getResourceCounter();
-					if (!tmp.isLocked() && counter >= best_counter && tmp._address && !_vm->isResourceInUse(type, idx) && !tmp.isOffHeap()) {
-						best_counter = counter;
-						best_type = type;
-						best_res = idx;
-					}
-				}
-			}
+	// Keep the type within its own budget first. Resources of types which
+	// can't be restored from the data files are never expired.
+	ResTypeData &data = _types[type];
+	if (data._mode != kDynamicResTypeMode && data._budget) {
+		while (data._allocatedSize + size > data._budget) {
+			const ResId idx = findExpirableResource(type);
+			if (idx == kNoResId)
+				break;
+			nukeResource(type, idx);
 		}
+	}
 
-		if (!best_type)
-			break;
-		nukeResource(best_type, best_res);
-	} while (size + _allocatedSize > _minHeapThreshold);
+	if (size + _allocatedSize >= _maxHeapThreshold) {
+		do {
+			// Expire the least recently used resource of all types
+			ResType bestType = rtInvalid;
+			ResId bestIdx = kNoResId;
+
+			for (ResType t = rtFirst; t <= rtLast; t = ResType(t + 1)) {
+				if (_types[t]._mode == kDynamicResTypeMode)
+					continue;
+
+				const ResId idx = findExpirableResource(t);
+				if (idx != kNoResId && (bestType == rtInvalid || _types[t][idx]._lastUse < _types[bestType][bestIdx]._lastUse)) {
+					bestType = t;
+					bestIdx = idx;
+				}
+			}
 
-	increaseResourceCounters();
+			if (bestType == rtInvalid)
+				break;
+			nukeResource(bestType, bestIdx);
+		} while (size + _allocatedSize > _minHeapThreshold);
+	}
 
-	debugC(DEBUG_RESOURCE, "Expired resources, mem %d -> %d", oldAllocatedSize, _allocatedSize);
+	if (oldAllocatedSize != _allocatedSize)
+		debugC(DEBUG_RESOURCE, "Expired resources, mem %d -> %d", oldAllocatedSize, _allocatedSize);
 }
 
 void ResourceManager::freeResources() {
@@ -53,6 +53,10 @@ enum : uint {
 	RES_INVALID_OFFSET = 0xFFFFFFFF
 };
 
+enum : ResId {
+	kNoResId = 0xFFFF
+};
+
 class ScummEngine;
 
 /**
@@ -97,15 +101,23 @@ public:
 		 */
 		uint32 _size;
 
+		/**
+		 * Neighbours of the resource in the least recently used list of its
+		 * type, see ResTypeData. kNoResId if there is none.
+		 */
+		ResId _lruPrev, _lruNext;
+
+		/**
+		 * Value of the use counter of the resource manager when the resource
+		 * was last used. This allows comparing the age of resources of
+		 * different types. It is 64 bits wide, as it is bumped on every
+		 * access and must not wrap during a session.
+		 */
+		uint64 _lastUse;
+
 	protected:
 		/**
 		 * The uppermost bit indicates whether the resources is locked.
-		 * The lower 7 bits contain a counter. This counter measures roughly
-		 * how old the resource is; it starts out with a count of 1 and can go
-		 * as high as 127. When memory falls low resp. when the engine decides
-		 * that it should throw out some unused stuff, then it begins by
-		 * removing the resources with the highest counter (excluding locked
-		 * resources and resources that are known to be in use).
 		 */
 		byte _flags;
 
@@ -137,9 +149,6 @@ public:
 
 		void nuke();
 
-		inline void setResourceCounter(byte counter);
-		inline byte getResourceCounter() const;
-
 		void lock();
 		void unlock();
 		bool isLocked() const;
@@ -170,6 +179,26 @@ public:
 		 */
 		uint32 _tag;
 
+	protected:
+		/**
+		 * Most and least recently used loaded resources of this type. When
+		 * memory falls low, resources are expired starting from the least
+		 * recently used one (excluding locked resources and resources that
+		 * are known to be in use).
+		 */
+		ResId _lruHead, _lruTail;
+
+		/**
+		 * Memory used by the loaded resources of this type.
+		 */
+		uint32 _allocatedSize;
+
+		/**
+		 * Memory the loaded resources of this type may use before they are
+		 * expired, regardless of the overall heap size. 0 for no limit.
+		 */
+		uint32 _budget;
+
 	public:
 		ResTypeData();
 		~ResTypeData();
@@ -179,13 +208,24 @@ public:
 protected:
 	uint32 _allocatedSize;
 	uint32 _maxHeapThreshold, _minHeapThreshold;
-	byte _expireCounter;
+	uint64 _useCounter;
 
 public:
 	ResourceManager(ScummEngine *vm);
 	~ResourceManager();
 
 	void setHeapThreshold(int min, int max);
+
+	/**
+	 * Limit the memory used by the loaded resources of the given type, so
+	 * that e.g. large sounds cannot push all rooms and costumes out of
+	 * memory. Only applies to resource types which can be restored from
+	 * the data files.
+	 *
+	 * @param budget  The limit in bytes, 0 for no limit besides the heap
+	 *                thresholds.
+	 */
+	void setTypeBudget(ResType type, uint32 budget);
 	uint32 getHeapSize() { return _allocatedSize; }
 
 	void allocResTypeData(ResType type, uint32 tag, int num, ResTypeMode mode);
@@ -211,31 +251,26 @@ public:
 	void setOnHeap(ResType type, ResId idx);
 
 	/**
-	 * This method increments the _expireCounter, and if it overflows (which happens
-	 * after at most 256 calls), it calls increaseResourceCounter.
-	 * It is invoked in the engine's main loop ScummEngine::scummLoop().
-	 */
-	void increaseExpireCounter();
-
-	/**
-	 * Update the specified resource's counter.
+	 * Mark the specified resource as used, making it the last one of its
+	 * type to be expired.
 	 */
-	void setResourceCounter(ResType type, ResId idx, byte counter);
+	void touchResource(ResType type, ResId idx);
 
 	/**
-	 * Increment the counter of all unlocked loaded resources.
-	 * The maximal count is 255.
-	 * This is called by increaseExpireCounter and expireResources,
-	 * but also by ScummEngine::startScene.
+	 * Make the specified resource the first one of its type to be expired,
+	 * e.g. because a script told us that it is no longer needed.
 	 */
-	void increaseResourceCounters();
+	void markResourceForExpiry(ResType type, ResId idx);
 
 	void resourceStats();
 
 //protected:
 	bool validateResource(const char *str, ResType type, ResId idx) const;
 protected:
-	void expireResources(uint32 size);
+	void linkResource(ResType type, ResId idx, bool mostRecent);
+	void unlinkResource(ResType type, ResId idx);
+	ResId findExpirableResource(ResType type);
+	void expireResources(ResType type, uint32 size);
 };
 
 } // End of namespace Scumm
@@ -149,8 +149,6 @@ void ScummEngine::startScene(int room, Actor *a, int objectNr) {
 	VAR(VAR_ROOM) = room;
 	_fullRedraw = true;
 
-	_res->increaseResourceCounters();
-
 	_currentRoom = room;
 	VAR(VAR_ROOM) = room;
 
@@ -171,8 +169,10 @@ void ScummEngine::startScene(int room, Actor *a, int objectNr) {
 	if (VAR_ROOM_RESOURCE != 0xFF)
 		VAR(VAR_ROOM_RESOURCE) = _roomResource;
 
-	if (room != 0)
+	if (room != 0) {
 		ensureResourceLoaded(rtRoom, room);
+		prefetchRoomResources(_roomResource);
+	}
 
 	clearRoomObjects();
 
@@ -2250,7 +2250,7 @@ void ScummEngine_v5::o5_resourceRoutines() {
 				resid = _resourceMapper[resid & 0x7F];
 
 			if (_currentRoom != resid) {
-				_res->setResourceCounter(rtRoom, resid, 1);
+				_res->touchResource(rtRoom, resid);
 			}
 		}
 		break;
@@ -2262,7 +2262,7 @@ void ScummEngine_v5::o5_resourceRoutines() {
 		if (_game.id == GID_ZAK && (_game.platform == Common::kPlatformFMTowns))
 			error("o5_resourceRoutines %d should not occur in Zak256", op);
 		else
-			_res->setResourceCounter(resType[op-5], resid, 0x7F);
+			_res->markResourceForExpiry(resType[op-5], resid);
 		break;
 	case 9:			// SO_LOCK_SCRIPT
 		if (resid >= _numGlobalScripts)
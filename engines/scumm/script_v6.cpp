@@ -1979,19 +1979,19 @@ void ScummEngine_v6::o6_resourceRoutines() {
 		if (_game.version >= 7)
 			if (resid >= _numGlobalScripts)
 				break;
-		_res->setResourceCounter(rtScript, resid, 0x7F);
+		_res->markResourceForExpiry(rtScript, resid);
 		break;
 	case SO_NUKE_SOUND:
 		resid = pop();
-		_res->setResourceCounter(rtSound, resid, 0x7F);
+		_res->markResourceForExpiry(rtSound, resid);
 		break;
 	case SO_NUKE_COSTUME:
 		resid = pop();
-		_res->setResourceCounter(rtCostume, resid, 0x7F);
+		_res->markResourceForExpiry(rtCostume, resid);
 		break;
 	case SO_NUKE_ROOM:
 		resid = pop();
-		_res->setResourceCounter(rtRoom, resid, 0x7F);
+		_res->markResourceForExpiry(rtRoom, resid);
 		break;
 	case SO_LOCK_SCRIPT:
 		resid = pop();
@@ -686,16 +686,16 @@ void ScummEngine_v8::o8_resourceRoutines() {
 		_res->unlock(rtSound, resid);
 		break;
 	case SO_HEAP_NUKE_COSTUME:		// Remove costume from heap
-		_res->setResourceCounter(rtCostume, resid, 0x7F);
+		_res->markResourceForExpiry(rtCostume, resid);
 		break;
 	case SO_HEAP_NUKE_ROOM:		// Remove room from heap
-		_res->setResourceCounter(rtRoom, resid, 0x7F);
+		_res->markResourceForExpiry(rtRoom, resid);
 		break;
 	case SO_HEAP_NUKE_SCRIPT:		// Remove script from heap
-		_res->setResourceCounter(rtScript, resid, 0x7F);
+		_res->markResourceForExpiry(rtScript, resid);
 		break;
 	case SO_HEAP_NUKE_SOUND:		// Remove sound from heap
-		_res->setResourceCounter(rtSound, resid, 0x7F);
+		_res->markResourceForExpiry(rtSound, resid);
 		break;
 	default:
 		error("o8_resourceRoutines: default case 0x%x", subOp);
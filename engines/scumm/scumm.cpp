@@ -489,6 +489,7 @@ ScummEngine::~ScummEngine() {
 	delete _messageDialog;
 	delete _pauseDialog;
 	delete _versionDialog;
+	stopPrefetching();
 	delete _fileHandle;
 
 	if (_game.heversion == 0)
@@ -1763,9 +1764,13 @@ void ScummEngine::setupScumm(const Common::Path &macResourceFile) {
 	}
 
 	_res->setHeapThreshold(400000, maxHeapThreshold);
+
+	// Don't let sounds push all rooms, scripts and costumes out of memory
+	_res->setTypeBudget(rtSound, maxHeapThreshold / 2);
 #else
 	// RAM is cheap, disk I/O isn't... helps with retaining the resources in COMI and similar
 	_res->setHeapThreshold(16 * 1024 * 1024, 32 * 1024 * 1024);
+	_res->setTypeBudget(rtSound, 16 * 1024 * 1024);
 #endif
 
 	free(_compositeBuf);
@@ -3205,8 +3210,6 @@ load_game:
 		checkExecVerbs();
 	}
 
-	_res->increaseExpireCounter();
-
 	if (!isUsingOriginalGUI() || ((_game.version >= 3) || !isPaused()))
 		animateCursor();
 
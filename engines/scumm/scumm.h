@@ -1149,6 +1149,7 @@ protected:
 //	void allocResTypeData(ResType type, uint32 tag, int num, int mode);
 //	byte *createResource(int type, int index, uint32 size);
 	int loadResource(ResType type, ResId idx);
+	int readResource(ResType type, ResId idx, uint32 fileOffs);
 //	void nukeResource(ResType type, ResId idx);
 	int getResourceRoomNr(ResType type, ResId idx);
 	virtual uint32 getResourceRoomOffset(ResType type, ResId idx);
@@ -1165,6 +1166,15 @@ protected:
 										// to avoid race conditions between the audio thread of Digital iMUSE
 										// and the main SCUMM thread
 
+	// Reading the scripts, costumes and sounds of a room ahead on a worker
+	// thread, while the room starts
+	struct ResourcePrefetch;
+	ResourcePrefetch *_prefetch = nullptr;
+
+	void prefetchRoomResources(int room);
+	void stopPrefetching();
+	byte *takePrefetchedResource(ResType type, ResId idx, int room, int64 offset, uint32 &size);
+
 	int readSoundResource(ResId idx);
 	int readSoundResourceSmallHeader(ResId idx);
 	bool isResourceInUse(ResType type, ResId idx) const;
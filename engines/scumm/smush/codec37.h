@@ -43,6 +43,8 @@ private:
 public:
 	SmushDeltaBlocksDecoder(int width, int height);
 	~SmushDeltaBlocksDecoder();
+	int getWidth() const { return _width; }
+	int getHeight() const { return _height; }
 protected:
 	void makeTable(int, int);
 	void proc1(byte *dst, const byte *src, int32, int, int, int, int16 *);
@@ -54,6 +54,8 @@ private:
 public:
 	SmushDeltaGlyphsDecoder(int width, int height);
 	~SmushDeltaGlyphsDecoder();
+	int getWidth() const { return _width; }
+	int getHeight() const { return _height; }
 	bool decode(byte *dst, const byte *src);
 };
 
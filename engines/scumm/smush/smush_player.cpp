@@ -21,6 +21,8 @@
 
 #include "common/config-manager.h"
 #include "common/file.h"
+#include "common/jobs.h"
+#include "common/ptr.h"
 #include "common/system.h"
 #include "common/util.h"
 #include "common/rect.h"
@@ -270,6 +272,7 @@ SmushPlayer::SmushPlayer(ScummEngine_v7 *scumm, IMuseDigital *imuseDigital, Insa
 	_smushTracksNeedInit = true;
 	_smushAudioInitialized = false;
 	_smushAudioCallbackEnabled = false;
+	_decodeAhead = nullptr;
 
 	initAudio(_imuseDigital->getSampleRate(), 200000);
 }
@@ -312,6 +315,8 @@ void SmushPlayer::init(int32 speed) {
 void SmushPlayer::release() {
 	_vm->_smushVideoShouldFinish = true;
 
+	stopDecodeAhead();
+
 	for (int i = 0; i < 5; i++) {
 		delete _sf[i];
 		_sf[i] = nullptr;
@@ -754,7 +759,7 @@ byte *SmushPlayer::getVideoPalette() {
 void smushDecodeRLE(byte *dst, const byte *src, int left, int top, int width, int height, int pitch);
 void smushDecodeUncompressed(byte *dst, const byte *src, int left, int top, int width, int height, int pitch);
 
-void SmushPlayer::decodeFrameObject(int codec, const uint8 *src, int left, int top, int width, int height) {
+void SmushPlayer::decodeFrameObject(int codec, const uint8 *src, int left, int top, int width, int height, const byte *decoded) {
 	if ((height == 242) && (width == 384)) {
 		if (_specialBuffer == 0)
 			_specialBuffer = (byte *)malloc(242 * 384);
@@ -775,29 +780,37 @@ void SmushPlayer::decodeFrameObject(int codec, const uint8 *src, int left, int t
 		_height = _vm->_screenHeight;
 	}
 
-	switch (codec) {
-	case SMUSH_CODEC_RLE:
-	case SMUSH_CODEC_RLE_ALT:
-		smushDecodeRLE(_dst, src, left, top, width, height, _vm->_screenWidth);
-		break;
-	case SMUSH_CODEC_DELTA_BLOCKS:
-		if (!_deltaBlocksCodec)
-			_deltaBlocksCodec = new SmushDeltaBlocksDecoder(width, height);
-		if (_deltaBlocksCodec)
-			_deltaBlocksCodec->decode(_dst, src);
-		break;
-	case SMUSH_CODEC_DELTA_GLYPHS:
-		if (!_deltaGlyphsCodec)
-			_deltaGlyphsCodec = new SmushDeltaGlyphsDecoder(width, height);
-		if (_deltaGlyphsCodec)
-			_deltaGlyphsCodec->decode(_dst, src);
-		break;
-	case SMUSH_CODEC_UNCOMPRESSED:
-		// Used by Full Throttle Classic (from Remastered)
-		smushDecodeUncompressed(_dst, src, left, top, width, height, _vm->_screenWidth);
-		break;
-	default:
-		error("Invalid codec for frame object : %d", codec);
+	if (decoded) {
+		// Decoded ahead by the same codec, see DecodeAhead
+		memcpy(_dst, decoded, width * height);
+	} else {
+		switch (codec) {
+		case SMUSH_CODEC_RLE:
+		case SMUSH_CODEC_RLE_ALT:
+			smushDecodeRLE(_dst, src, left, top, width, height, _vm->_screenWidth);
+			break;
+		case SMUSH_CODEC_DELTA_BLOCKS:
+			// The codecs can only be used by one thread at a time
+			stopDecodeAhead();
+			if (!_deltaBlocksCodec)
+				_deltaBlocksCodec = new SmushDeltaBlocksDecoder(width, height);
+			if (_deltaBlocksCodec)
+				_deltaBlocksCodec->decode(_dst, src);
+			break;
+		case SMUSH_CODEC_DELTA_GLYPHS:
+			stopDecodeAhead();
+			if (!_deltaGlyphsCodec)
+				_deltaGlyphsCodec = new SmushDeltaGlyphsDecoder(width, height);
+			if (_deltaGlyphsCodec)
+				_deltaGlyphsCodec->decode(_dst, src);
+			break;
+		case SMUSH_CODEC_UNCOMPRESSED:
+			// Used by Full Throttle Classic (from Remastered)
+			smushDecodeUncompressed(_dst, src, left, top, width, height, _vm->_screenWidth);
+			break;
+		default:
+			error("Invalid codec for frame object : %d", codec);
+		}
 	}
 
 	if (_storeFrame) {
@@ -815,6 +828,9 @@ void SmushPlayer::handleZlibFrameObject(int32 subSize, Common::SeekableReadStrea
 		return;
 	}
 
+	if (presentDecodedFrame(b.pos()))
+		return;
+
 	int32 chunkSize = subSize;
 	byte *chunkBuffer = (byte *)malloc(chunkSize);
 	assert(chunkBuffer);
@@ -845,6 +861,9 @@ void SmushPlayer::handleFrameObject(int32 subSize, Common::SeekableReadStream &b
 		return;
 	}
 
+	if (presentDecodedFrame(b.pos()))
+		return;
+
 	int codec = b.readUint16LE();
 	int left = b.readUint16LE();
 	int top = b.readUint16LE();
@@ -864,6 +883,266 @@ void SmushPlayer::handleFrameObject(int32 subSize, Common::SeekableReadStream &b
 	free(chunk_buffer);
 }
 
+/**
+ * Decodes the codec 37 and 47 frame objects of a video ahead of the player
+ * on a worker thread, which reads them through its own file handle. The
+ * frames go into a ring of slots, and the player copies them to the screen
+ * once it reaches their chunks. Everything else in the frames, like audio,
+ * palettes and text, is still handled by the player.
+ *
+ * The codecs keep the previous frames, so only one decode job runs at a
+ * time. A job which finished its frame queues the job for the next slot,
+ * as long as there is a free one.
+ */
+struct SmushPlayer::DecodeAhead {
+	enum {
+		kNumSlots = 4
+	};
+
+	struct Slot {
+		Common::JobGroup group;  ///< The job decoding into this slot
+		int32 chunkOffset;       ///< Offset of the frame object data, -1 if the worker stopped before it
+		int codec, left, top, width, height;
+		byte *pixels;
+		uint32 size;
+
+		Slot() : chunkOffset(-1), codec(0), left(0), top(0), width(0), height(0), pixels(nullptr), size(0) {}
+		~Slot() { free(pixels); }
+	};
+
+	SmushPlayer *player;
+	Common::ScopedPtr<Common::SeekableReadStream> file;
+	uint32 fileSize;
+
+	// Only used by the decode jobs
+	int32 frameEnd;          ///< End of the FRME chunk the worker is in
+	int blocksWidth, blocksHeight;
+	int glyphsWidth, glyphsHeight;
+
+	Slot slots[kNumSlots];
+
+	Common::Mutex mutex;     ///< Guards the fields below
+	uint head;               ///< Slot of the next frame to show
+	uint count;              ///< Slots which are decoded or being decoded
+	bool running;            ///< A decode job is queued or running, it decodes into the last slot
+	bool finished;           ///< The worker reached the end of the file or a frame it can't decode
+	bool cancel;
+
+	DecodeAhead(SmushPlayer *p, Common::SeekableReadStream *f, uint32 size) :
+		player(p), file(f), fileSize(size), frameEnd(0),
+		blocksWidth(0), blocksHeight(0), glyphsWidth(0), glyphsHeight(0),
+		head(0), count(0), running(false), finished(false), cancel(false) {}
+
+	// Must be called with the mutex held
+	void queueNext() {
+		if (running || finished || cancel || count == kNumSlots)
+			return;
+		running = true;
+		const uint slot = (head + count++) % kNumSlots;
+		JobMan.submit(slots[slot].group, decodeProc, this);
+	}
+
+	static void decodeProc(void *param);
+};
+
+void SmushPlayer::DecodeAhead::decodeProc(void *param) {
+	DecodeAhead *decodeAhead = (DecodeAhead *)param;
+	uint slot;
+	bool cancelled;
+	{
+		Common::StackLock lock(decodeAhead->mutex);
+		slot = (decodeAhead->head + decodeAhead->count - 1) % kNumSlots;
+		cancelled = decodeAhead->cancel;
+	}
+
+	const bool decoded = !cancelled && decodeAhead->player->decodeAheadFrame(*decodeAhead, slot);
+
+	Common::StackLock lock(decodeAhead->mutex);
+	decodeAhead->running = false;
+	if (!decoded) {
+		decodeAhead->slots[slot].chunkOffset = -1;
+		decodeAhead->finished = true;
+	}
+	decodeAhead->queueNext();
+}
+
+void SmushPlayer::startDecodeAhead() {
+	stopDecodeAhead();
+
+	// INSANE seeks around in its videos, and without worker threads
+	// decoding ahead would only delay the frames.
+	if (_insanity || JobMan.getWorkerCount() == 0 || _seekFile.empty())
+		return;
+
+	ScummFile *file = _vm->instantiateScummFile();
+	if (!_vm->openFile(*file, Common::Path(_seekFile))) {
+		delete file;
+		return;
+	}
+	file->seek(_base->pos(), SEEK_SET);
+
+	_decodeAhead = new DecodeAhead(this, file, _baseSize);
+
+	// The codecs move to the worker, which continues from the frame the
+	// player decoded last, e.g. after a seek
+	if (_deltaBlocksCodec) {
+		_decodeAhead->blocksWidth = _deltaBlocksCodec->getWidth();
+		_decodeAhead->blocksHeight = _deltaBlocksCodec->getHeight();
+	}
+	if (_deltaGlyphsCodec) {
+		_decodeAhead->glyphsWidth = _deltaGlyphsCodec->getWidth();
+		_decodeAhead->glyphsHeight = _deltaGlyphsCodec->getHeight();
+	}
+
+	Common::StackLock lock(_decodeAhead->mutex);
+	_decodeAhead->queueNext();
+}
+
+void SmushPlayer::stopDecodeAhead() {
+	if (!_decodeAhead)
+		return;
+
+	_decodeAhead->mutex.lock();
+	_decodeAhead->cancel = true;
+	_decodeAhead->mutex.unlock();
+
+	for (int i = 0; i < DecodeAhead::kNumSlots; i++)
+		JobMan.wait(_decodeAhead->slots[i].group);
+	delete _decodeAhead;
+	_decodeAhead = nullptr;
+}
+
+bool SmushPlayer::decodeAheadFrame(DecodeAhead &decodeAhead, int slotIdx) {
+	Common::SeekableReadStream &file = *decodeAhead.file;
+	DecodeAhead::Slot &slot = decodeAhead.slots[slotIdx];
+
+	for (;;) {
+		if (file.pos() >= decodeAhead.frameEnd) {
+			const uint32 type = file.readUint32BE();
+			const int32 size = file.readUint32BE();
+			const int32 offset = file.pos();
+			if (file.err() || file.eos() || offset >= (int32)decodeAhead.fileSize)
+				return false;
+
+			if (type == MKTAG('F','R','M','E'))
+				decodeAhead.frameEnd = offset + size;
+			else
+				file.seek(offset + size, SEEK_SET);
+			continue;
+		}
+
+		const uint32 subType = file.readUint32BE();
+		const int32 subSize = file.readUint32BE();
+		const int32 subOffset = file.pos();
+		if (file.err() || file.eos() || subSize < 0)
+			return false;
+
+		if ((subType == MKTAG('F','O','B','J') && subSize >= 14) || subType == MKTAG('Z','F','O','B')) {
+			byte *chunk = (byte *)malloc(subSize);
+			if (!chunk || file.read(chunk, subSize) != (uint32)subSize) {
+				free(chunk);
+				return false;
+			}
+
+			byte *fobj = chunk;
+			if (subType == MKTAG('Z','F','O','B')) {
+				unsigned long decompressedSize = subSize >= 4 ? READ_BE_UINT32(chunk) : 0;
+				fobj = decompressedSize >= 14 ? (byte *)malloc(decompressedSize) : nullptr;
+				const bool inflated = fobj && Common::inflateZlib(fobj, &decompressedSize, chunk + 4, subSize - 4);
+				free(chunk);
+				if (!inflated) {
+					// The player reports the error
+					free(fobj);
+					return false;
+				}
+			}
+
+			const int codec = READ_LE_UINT16(fobj);
+			const int width = READ_LE_UINT16(fobj + 6);
+			const int height = READ_LE_UINT16(fobj + 8);
+			const bool fullFrame = (width == 384 && height == 242) || (width == _vm->_screenWidth && height == _vm->_screenHeight);
+
+			if (fullFrame && (codec == SMUSH_CODEC_DELTA_BLOCKS || codec == SMUSH_CODEC_DELTA_GLYPHS)) {
+				// Same as decodeFrameObject(), which would create the codecs
+				// for the size of the first frame
+				int &codecWidth = codec == SMUSH_CODEC_DELTA_BLOCKS ? decodeAhead.blocksWidth : decodeAhead.glyphsWidth;
+				int &codecHeight = codec == SMUSH_CODEC_DELTA_BLOCKS ? decodeAhead.blocksHeight : decodeAhead.glyphsHeight;
+				if (codecWidth == 0) {
+					codecWidth = width;
+					codecHeight = height;
+					if (codec == SMUSH_CODEC_DELTA_BLOCKS)
+						_deltaBlocksCodec = new SmushDeltaBlocksDecoder(width, height);
+					else
+						_deltaGlyphsCodec = new SmushDeltaGlyphsDecoder(width, height);
+				} else if (codecWidth != width || codecHeight != height) {
+					// Leave the oddities to the player
+					free(fobj);
+					return false;
+				}
+
+				const uint32 size = width * height;
+				if (slot.size < size) {
+					free(slot.pixels);
+					slot.pixels = (byte *)malloc(size);
+					slot.size = size;
+				}
+
+				if (codec == SMUSH_CODEC_DELTA_BLOCKS)
+					_deltaBlocksCodec->decode(slot.pixels, fobj + 14);
+				else
+					_deltaGlyphsCodec->decode(slot.pixels, fobj + 14);
+
+				slot.chunkOffset = subOffset;
+				slot.codec = codec;
+				slot.left = READ_LE_UINT16(fobj + 2);
+				slot.top = READ_LE_UINT16(fobj + 4);
+				slot.width = width;
+				slot.height = height;
+				free(fobj);
+
+				file.seek(subOffset + subSize + (subSize & 1), SEEK_SET);
+				return true;
+			}
+			free(fobj);
+		}
+
+		file.seek(subOffset + subSize + (subSize & 1), SEEK_SET);
+	}
+}
+
+bool SmushPlayer::presentDecodedFrame(int32 chunkOffset) {
+	if (!_decodeAhead)
+		return false;
+
+	for (;;) {
+		uint head;
+		{
+			Common::StackLock lock(_decodeAhead->mutex);
+			if (_decodeAhead->count == 0)
+				return false;
+			head = _decodeAhead->head;
+		}
+
+		DecodeAhead::Slot &slot = _decodeAhead->slots[head];
+		JobMan.wait(slot.group);
+
+		// Frames the worker skipped or stopped at are decoded here
+		if (slot.chunkOffset == -1 || slot.chunkOffset > chunkOffset)
+			return false;
+
+		const bool found = slot.chunkOffset == chunkOffset;
+		if (found)
+			decodeFrameObject(slot.codec, nullptr, slot.left, slot.top, slot.width, slot.height, slot.pixels);
+
+		Common::StackLock lock(_decodeAhead->mutex);
+		_decodeAhead->head = (head + 1) % DecodeAhead::kNumSlots;
+		_decodeAhead->count--;
+		_decodeAhead->queueNext();
+		if (found)
+			return true;
+	}
+}
+
 void SmushPlayer::handleFrame(int32 frameSize, Common::SeekableReadStream &b) {
 	debugC(DEBUG_SMUSH, "SmushPlayer::handleFrame(%d)", _frame);
 	uint8 *audioChunk = nullptr;
@@ -1065,6 +1344,9 @@ void SmushPlayer::parseNextFrame() {
 		_startTime = _vm->_system->getMillis();
 
 		_seekPos = -1;
+
+		startDecodeAhead();
+		debugC(DEBUG_SMUSH, "SmushPlayer: Decoding ahead %s at frame %d", _decodeAhead ? "resumed" : "off", _frame);
 	}
 
 	assert(_base);
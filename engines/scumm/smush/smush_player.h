@@ -192,6 +192,9 @@ private:
 	bool _smushAudioInitialized;
 	bool _smushAudioCallbackEnabled;
 
+	struct DecodeAhead;
+	DecodeAhead *_decodeAhead;
+
 public:
 	SmushPlayer(ScummEngine_v7 *scumm, IMuseDigital *_imuseDigital, Insane *insane);
 	~SmushPlayer();
@@ -235,7 +238,7 @@ private:
 	void tryCmpFile(const char *filename);
 
 	bool readString(const char *file);
-	void decodeFrameObject(int codec, const uint8 *src, int left, int top, int width, int height);
+	void decodeFrameObject(int codec, const uint8 *src, int left, int top, int width, int height, const byte *decoded = nullptr);
 	void handleAnimHeader(int32 subSize, Common::SeekableReadStream &);
 	void handleFrame(int32 frameSize, Common::SeekableReadStream &);
 	void handleNewPalette(int32 subSize, Common::SeekableReadStream &);
@@ -249,6 +252,11 @@ private:
 	void handleDeltaPalette(int32 subSize, Common::SeekableReadStream &);
 	void readPalette(byte *, Common::SeekableReadStream &);
 
+	void startDecodeAhead();
+	void stopDecodeAhead();
+	bool decodeAheadFrame(DecodeAhead &decodeAhead, int slot);
+	bool presentDecodedFrame(int32 chunkOffset);
+
 	void initAudio(int samplerate, int32 maxChunkSize);
 	void terminateAudio();
 	int isChanActive(int flagId);
@@ -0,0 +1,104 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#include "scumm/gfx.h"
+#include "scumm/stripblit.h"
+
+#include <immintrin.h>
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("avx2"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+namespace Scumm {
+
+void StripBlit::composeText8AVX2(byte *dst, const byte *src, int srcPitch, const byte *text, int textPitch, int width, int height) {
+	const __m256i transparent = _mm256_set1_epi8((char)CHARSET_MASK_TRANSPARENCY);
+
+	for (; height > 0; --height) {
+		int x = 0;
+		for (; x + 32 <= width; x += 32) {
+			const __m256i t = _mm256_loadu_si256((const __m256i *)(text + x));
+			const __m256i s = _mm256_loadu_si256((const __m256i *)(src + x));
+			_mm256_storeu_si256((__m256i *)(dst + x), _mm256_blendv_epi8(t, s, _mm256_cmpeq_epi8(t, transparent)));
+		}
+		for (; x + 8 <= width; x += 8) {
+			const __m128i t = _mm_loadl_epi64((const __m128i *)(text + x));
+			const __m128i s = _mm_loadl_epi64((const __m128i *)(src + x));
+			_mm_storel_epi64((__m128i *)(dst + x), _mm_blendv_epi8(t, s, _mm_cmpeq_epi8(t, _mm256_castsi256_si128(transparent))));
+		}
+		for (; x < width; ++x)
+			dst[x] = text[x] == CHARSET_MASK_TRANSPARENCY ? src[x] : text[x];
+		dst += width;
+		src += srcPitch;
+		text += textPitch;
+	}
+}
+
+bool StripBlit::composeText16AVX2(byte *dst, const byte *src, int srcPitch, const byte *text, int textPitch, const uint16 *palette, int width, int height) {
+	const __m128i transparent = _mm_set1_epi8((char)CHARSET_MASK_TRANSPARENCY);
+	bool drawn = false;
+
+	for (; height > 0; --height) {
+		int x = 0;
+		for (; x + 16 <= width; x += 16) {
+			const __m128i mask = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(text + x)), transparent);
+			const __m256i s = _mm256_loadu_si256((const __m256i *)(src + x * 2));
+			if (_mm_movemask_epi8(mask) == 0xFFFF) {
+				// Most of the screen has no text on it
+				_mm256_storeu_si256((__m256i *)(dst + x * 2), s);
+				continue;
+			}
+
+			uint16 expanded[16];
+			for (int i = 0; i < 16; ++i)
+				expanded[i] = palette[text[x + i]];
+			const __m256i p = _mm256_loadu_si256((const __m256i *)expanded);
+			_mm256_storeu_si256((__m256i *)(dst + x * 2), _mm256_blendv_epi8(p, s, _mm256_cvtepi8_epi16(mask)));
+			drawn = true;
+		}
+		for (; x < width; ++x) {
+			if (text[x] == CHARSET_MASK_TRANSPARENCY) {
+				WRITE_UINT16(dst + x * 2, READ_UINT16(src + x * 2));
+			} else {
+				WRITE_UINT16(dst + x * 2, palette[text[x]]);
+				drawn = true;
+			}
+		}
+		dst += width * 2;
+		src += srcPitch;
+		text += textPitch;
+	}
+	return drawn;
+}
+
+} // End of namespace Scumm
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
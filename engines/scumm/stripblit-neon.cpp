@@ -0,0 +1,134 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#ifdef SCUMMVM_NEON
+
+#include "scumm/gfx.h"
+#include "scumm/stripblit.h"
+
+#include <arm_neon.h>
+
+#if !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("neon"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("fpu=neon")
+#endif
+
+#endif // !defined(__aarch64__) && !defined(__ARM_NEON)
+
+namespace Scumm {
+
+void StripBlit::composeText8NEON(byte *dst, const byte *src, int srcPitch, const byte *text, int textPitch, int width, int height) {
+	const uint8x16_t transparent = vdupq_n_u8(CHARSET_MASK_TRANSPARENCY);
+
+	for (; height > 0; --height) {
+		int x = 0;
+		for (; x + 16 <= width; x += 16) {
+			const uint8x16_t t = vld1q_u8(text + x);
+			vst1q_u8(dst + x, vbslq_u8(vceqq_u8(t, transparent), vld1q_u8(src + x), t));
+		}
+		for (; x + 8 <= width; x += 8) {
+			const uint8x8_t t = vld1_u8(text + x);
+			vst1_u8(dst + x, vbsl_u8(vceq_u8(t, vget_low_u8(transparent)), vld1_u8(src + x), t));
+		}
+		for (; x < width; ++x)
+			dst[x] = text[x] == CHARSET_MASK_TRANSPARENCY ? src[x] : text[x];
+		dst += width;
+		src += srcPitch;
+		text += textPitch;
+	}
+}
+
+bool StripBlit::composeText16NEON(byte *dst, const byte *src, int srcPitch, const byte *text, int textPitch, const uint16 *palette, int width, int height) {
+	const uint8x8_t transparent = vdup_n_u8(CHARSET_MASK_TRANSPARENCY);
+	bool drawn = false;
+
+	for (; height > 0; --height) {
+		int x = 0;
+		for (; x + 8 <= width; x += 8) {
+			const uint8x8_t mask = vceq_u8(vld1_u8(text + x), transparent);
+			const uint16x8_t s = vreinterpretq_u16_u8(vld1q_u8(src + x * 2));
+			if (vget_lane_u64(vreinterpret_u64_u8(mask), 0) == ~(uint64)0) {
+				// Most of the screen has no text on it
+				vst1q_u8(dst + x * 2, vreinterpretq_u8_u16(s));
+				continue;
+			}
+
+			uint16 expanded[8];
+			for (int i = 0; i < 8; ++i)
+				expanded[i] = palette[text[x + i]];
+			const uint16x8_t mask16 = vreinterpretq_u16_s16(vmovl_s8(vreinterpret_s8_u8(mask)));
+			vst1q_u8(dst + x * 2, vreinterpretq_u8_u16(vbslq_u16(mask16, s, vld1q_u16(expanded))));
+			drawn = true;
+		}
+		for (; x < width; ++x) {
+			if (text[x] == CHARSET_MASK_TRANSPARENCY) {
+				WRITE_UINT16(dst + x * 2, READ_UINT16(src + x * 2));
+			} else {
+				WRITE_UINT16(dst + x * 2, palette[text[x]]);
+				drawn = true;
+			}
+		}
+		dst += width * 2;
+		src += srcPitch;
+		text += textPitch;
+	}
+	return drawn;
+}
+
+void StripBlit::writeStripNEON(byte *dst, int dstPitch, const byte *colors, int height, const byte *palette, byte paletteMod, int transparentColor) {
+	const uint8x8_t transparent = vdup_n_u8((uint8)transparentColor);
+
+	for (; height > 0; --height) {
+		const uint8x8_t c = vld1_u8(colors);
+		uint8x8_t out = c;
+		if (palette) {
+			byte mapped[8];
+			for (int i = 0; i < 8; ++i)
+				mapped[i] = palette[(colors[i] + paletteMod) & 0xFF];
+			out = vld1_u8(mapped);
+		}
+		if (transparentColor >= 0)
+			out = vbsl_u8(vceq_u8(c, transparent), vld1_u8(dst), out);
+		vst1_u8(dst, out);
+		dst += dstPitch;
+		colors += 8;
+	}
+}
+
+} // End of namespace Scumm
+
+#if !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif // !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#endif // SCUMMVM_NEON
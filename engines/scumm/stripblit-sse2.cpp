@@ -0,0 +1,150 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#include "scumm/gfx.h"
+#include "scumm/stripblit.h"
+
+#include <emmintrin.h>
+
+#if !defined(__x86_64__)
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("sse2"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("sse2")
+#endif
+
+#endif // !defined(__x86_64__)
+
+namespace Scumm {
+
+// Pick a where mask is set, b elsewhere
+static FORCEINLINE __m128i sse2_select(__m128i mask, __m128i a, __m128i b) {
+	return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+static FORCEINLINE __m128i sse2_mapColors(const byte *colors, int count, const byte *palette, byte paletteMod) {
+	byte mapped[16];
+	for (int i = 0; i < count; ++i)
+		mapped[i] = palette[(colors[i] + paletteMod) & 0xFF];
+	return count == 16 ? _mm_loadu_si128((const __m128i *)mapped) : _mm_loadl_epi64((const __m128i *)mapped);
+}
+
+void StripBlit::composeText8SSE2(byte *dst, const byte *src, int srcPitch, const byte *text, int textPitch, int width, int height) {
+	const __m128i transparent = _mm_set1_epi8((char)CHARSET_MASK_TRANSPARENCY);
+
+	for (; height > 0; --height) {
+		int x = 0;
+		for (; x + 16 <= width; x += 16) {
+			const __m128i t = _mm_loadu_si128((const __m128i *)(text + x));
+			const __m128i s = _mm_loadu_si128((const __m128i *)(src + x));
+			_mm_storeu_si128((__m128i *)(dst + x), sse2_select(_mm_cmpeq_epi8(t, transparent), s, t));
+		}
+		for (; x + 8 <= width; x += 8) {
+			const __m128i t = _mm_loadl_epi64((const __m128i *)(text + x));
+			const __m128i s = _mm_loadl_epi64((const __m128i *)(src + x));
+			_mm_storel_epi64((__m128i *)(dst + x), sse2_select(_mm_cmpeq_epi8(t, transparent), s, t));
+		}
+		for (; x < width; ++x)
+			dst[x] = text[x] == CHARSET_MASK_TRANSPARENCY ? src[x] : text[x];
+		dst += width;
+		src += srcPitch;
+		text += textPitch;
+	}
+}
+
+bool StripBlit::composeText16SSE2(byte *dst, const byte *src, int srcPitch, const byte *text, int textPitch, const uint16 *palette, int width, int height) {
+	const __m128i transparent = _mm_set1_epi8((char)CHARSET_MASK_TRANSPARENCY);
+	bool drawn = false;
+
+	for (; height > 0; --height) {
+		int x = 0;
+		for (; x + 8 <= width; x += 8) {
+			const __m128i mask = _mm_cmpeq_epi8(_mm_loadl_epi64((const __m128i *)(text + x)), transparent);
+			const __m128i s = _mm_loadu_si128((const __m128i *)(src + x * 2));
+			if ((_mm_movemask_epi8(mask) & 0xFF) == 0xFF) {
+				// Most of the screen has no text on it
+				_mm_storeu_si128((__m128i *)(dst + x * 2), s);
+				continue;
+			}
+
+			uint16 expanded[8];
+			for (int i = 0; i < 8; ++i)
+				expanded[i] = palette[text[x + i]];
+			const __m128i p = _mm_loadu_si128((const __m128i *)expanded);
+			_mm_storeu_si128((__m128i *)(dst + x * 2), sse2_select(_mm_unpacklo_epi8(mask, mask), s, p));
+			drawn = true;
+		}
+		for (; x < width; ++x) {
+			if (text[x] == CHARSET_MASK_TRANSPARENCY) {
+				WRITE_UINT16(dst + x * 2, READ_UINT16(src + x * 2));
+			} else {
+				WRITE_UINT16(dst + x * 2, palette[text[x]]);
+				drawn = true;
+			}
+		}
+		dst += width * 2;
+		src += srcPitch;
+		text += textPitch;
+	}
+	return drawn;
+}
+
+void StripBlit::writeStripSSE2(byte *dst, int dstPitch, const byte *colors, int height, const byte *palette, byte paletteMod, int transparentColor) {
+	const __m128i transparent = _mm_set1_epi8((char)transparentColor);
+
+	// Two rows at a time
+	for (; height >= 2; height -= 2) {
+		const __m128i c = _mm_loadu_si128((const __m128i *)colors);
+		__m128i out = palette ? sse2_mapColors(colors, 16, palette, paletteMod) : c;
+		if (transparentColor >= 0) {
+			const __m128i d = _mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i *)dst), _mm_loadl_epi64((const __m128i *)(dst + dstPitch)));
+			out = sse2_select(_mm_cmpeq_epi8(c, transparent), d, out);
+		}
+		_mm_storel_epi64((__m128i *)dst, out);
+		_mm_storel_epi64((__m128i *)(dst + dstPitch), _mm_unpackhi_epi64(out, out));
+		dst += dstPitch * 2;
+		colors += 16;
+	}
+
+	if (height) {
+		const __m128i c = _mm_loadl_epi64((const __m128i *)colors);
+		__m128i out = palette ? sse2_mapColors(colors, 8, palette, paletteMod) : c;
+		if (transparentColor >= 0)
+			out = sse2_select(_mm_cmpeq_epi8(c, transparent), _mm_loadl_epi64((const __m128i *)dst), out);
+		_mm_storel_epi64((__m128i *)dst, out);
+	}
+}
+
+} // End of namespace Scumm
+
+#if !defined(__x86_64__)
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif // !defined(__x86_64__)
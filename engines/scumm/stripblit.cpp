@@ -0,0 +1,132 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/endian.h"
+#include "common/system.h"
+
+#include "scumm/gfx.h"
+#include "scumm/stripblit.h"
+
+namespace Scumm {
+
+StripBlit::ComposeText8Func StripBlit::composeText8 = nullptr;
+StripBlit::ComposeText16Func StripBlit::composeText16 = nullptr;
+StripBlit::WriteStripFunc StripBlit::writeStrip = nullptr;
+
+void StripBlit::selectKernels() {
+	if (composeText8 && composeText16 && writeStrip)
+		return;
+
+	composeText8 = composeText8Generic;
+	composeText16 = composeText16Generic;
+	writeStrip = writeStripGeneric;
+	if (!g_system)
+		return;
+#ifdef SCUMMVM_NEON
+	if (g_system->hasFeature(OSystem::kFeatureCpuNEON)) {
+		composeText8 = composeText8NEON;
+		composeText16 = composeText16NEON;
+		writeStrip = writeStripNEON;
+	}
+#endif
+#ifdef SCUMMVM_SSE2
+	if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) {
+		composeText8 = composeText8SSE2;
+		composeText16 = composeText16SSE2;
+		writeStrip = writeStripSSE2;
+	}
+#endif
+#ifdef SCUMMVM_AVX2
+	// Strip rows are only eight pixels wide, the SSE2 kernel already
+	// handles two of them at once.
+	if (g_system->hasFeature(OSystem::kFeatureCpuAVX2)) {
+		composeText8 = composeText8AVX2;
+		composeText16 = composeText16AVX2;
+	}
+#endif
+}
+
+bool StripBlit::isIdentityPalette(const byte *palette) {
+	for (int i = 0; i < 256; ++i) {
+		if (palette[i] != i)
+			return false;
+	}
+	return true;
+}
+
+void StripBlit::composeText8Generic(byte *dst, const byte *src, int srcPitch, const byte *text, int textPitch, int width, int height) {
+	// We blit four pixels at a time, for improved performance.
+	for (; height > 0; --height) {
+		for (int x = 0; x < width; x += 4) {
+			const uint32 temp = READ_UINT32(text + x);
+
+			// Generate a byte mask for those text pixels (bytes) with
+			// value CHARSET_MASK_TRANSPARENCY. In the end, each byte
+			// in mask will be either equal to 0x00 or 0xFF.
+			// Doing it this way avoids branches and bytewise operations,
+			// at the cost of readability ;).
+			uint32 mask = temp ^ CHARSET_MASK_TRANSPARENCY_32;
+			mask = (((mask & 0x7f7f7f7f) + 0x7f7f7f7f) | mask) & 0x80808080;
+			mask = ((mask >> 7) + 0x7f7f7f7f) ^ 0x80808080;
+
+			// The following line is equivalent to this code:
+			//   dst = (src & mask) | (temp & ~mask);
+			// However, some compilers can generate somewhat better
+			// machine code for this equivalent statement:
+			WRITE_UINT32(dst + x, ((temp ^ READ_UINT32(src + x)) & mask) ^ temp);
+		}
+		dst += width;
+		src += srcPitch;
+		text += textPitch;
+	}
+}
+
+bool StripBlit::composeText16Generic(byte *dst, const byte *src, int srcPitch, const byte *text, int textPitch, const uint16 *palette, int width, int height) {
+	bool drawn = false;
+	for (; height > 0; --height) {
+		for (int x = 0; x < width; ++x) {
+			if (text[x] == CHARSET_MASK_TRANSPARENCY) {
+				WRITE_UINT16(dst + x * 2, READ_UINT16(src + x * 2));
+			} else {
+				WRITE_UINT16(dst + x * 2, palette[text[x]]);
+				drawn = true;
+			}
+		}
+		dst += width * 2;
+		src += srcPitch;
+		text += textPitch;
+	}
+	return drawn;
+}
+
+void StripBlit::writeStripGeneric(byte *dst, int dstPitch, const byte *colors, int height, const byte *palette, byte paletteMod, int transparentColor) {
+	for (; height > 0; --height) {
+		for (int x = 0; x < 8; ++x) {
+			const byte color = colors[x];
+			if (color != transparentColor)
+				dst[x] = palette ? palette[(color + paletteMod) & 0xFF] : color;
+		}
+		dst += dstPitch;
+		colors += 8;
+	}
+}
+
+} // End of namespace Scumm
@@ -0,0 +1,95 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef SCUMM_STRIPBLIT_H
+#define SCUMM_STRIPBLIT_H
+
+#include "common/scummsys.h"
+
+namespace Scumm {
+
+/**
+ * Kernels for moving 8-bit strips around: compositing the text surface over
+ * the virtual screens before they go to the backend, and storing the pixels
+ * of decoded room strips with their transparent color left out.
+ *
+ * The kernels come in SIMD variants which are selected at runtime
+ * according to the CPU features. All of them produce exactly the same
+ * pixels as the generic ones, and none of them needs aligned buffers.
+ */
+class StripBlit {
+public:
+	/**
+	 * Compose width x height text pixels over 8-bit graphics. Text pixels
+	 * equal to CHARSET_MASK_TRANSPARENCY let the graphics through. dst is
+	 * packed, width must be a multiple of 4.
+	 */
+	typedef void (*ComposeText8Func)(byte *dst, const byte *src, int srcPitch, const byte *text, int textPitch, int width, int height);
+	/**
+	 * Compose width x height text pixels over 16-bit graphics, expanding
+	 * the text colors through palette. dst is packed.
+	 *
+	 * @return whether any text pixel was drawn
+	 */
+	typedef bool (*ComposeText16Func)(byte *dst, const byte *src, int srcPitch, const byte *text, int textPitch, const uint16 *palette, int width, int height);
+	/**
+	 * Store height rows of a decoded 8 pixel wide strip. colors holds the
+	 * packed rows of color indices, which are mapped through
+	 * palette[(color + paletteMod) & 0xFF] unless palette is null. Colors
+	 * equal to transparentColor are skipped, unless it is negative.
+	 */
+	typedef void (*WriteStripFunc)(byte *dst, int dstPitch, const byte *colors, int height, const byte *palette, byte paletteMod, int transparentColor);
+
+	static ComposeText8Func composeText8;
+	static ComposeText16Func composeText16;
+	static WriteStripFunc writeStrip;
+
+	/**
+	 * Select the fastest kernels supported by the CPU, unless they have
+	 * been selected already.
+	 */
+	static void selectKernels();
+
+	/** Whether palette maps every color to itself */
+	static bool isIdentityPalette(const byte *palette);
+
+	static void composeText8Generic(byte *dst, const byte *src, int srcPitch, const byte *text, int textPitch, int width, int height);
+	static bool composeText16Generic(byte *dst, const byte *src, int srcPitch, const byte *text, int textPitch, const uint16 *palette, int width, int height);
+	static void writeStripGeneric(byte *dst, int dstPitch, const byte *colors, int height, const byte *palette, byte paletteMod, int transparentColor);
+#ifdef SCUMMVM_NEON
+	static void composeText8NEON(byte *dst, const byte *src, int srcPitch, const byte *text, int textPitch, int width, int height);
+	static bool composeText16NEON(byte *dst, const byte *src, int srcPitch, const byte *text, int textPitch, const uint16 *palette, int width, int height);
+	static void writeStripNEON(byte *dst, int dstPitch, const byte *colors, int height, const byte *palette, byte paletteMod, int transparentColor);
+#endif
+#ifdef SCUMMVM_SSE2
+	static void composeText8SSE2(byte *dst, const byte *src, int srcPitch, const byte *text, int textPitch, int width, int height);
+	static bool composeText16SSE2(byte *dst, const byte *src, int srcPitch, const byte *text, int textPitch, const uint16 *palette, int width, int height);
+	static void writeStripSSE2(byte *dst, int dstPitch, const byte *colors, int height, const byte *palette, byte paletteMod, int transparentColor);
+#endif
+#ifdef SCUMMVM_AVX2
+	static void composeText8AVX2(byte *dst, const byte *src, int srcPitch, const byte *text, int textPitch, int width, int height);
+	static bool composeText16AVX2(byte *dst, const byte *src, int srcPitch, const byte *text, int textPitch, const uint16 *palette, int width, int height);
+#endif
+};
+
+} // End of namespace Scumm
+
+#endif
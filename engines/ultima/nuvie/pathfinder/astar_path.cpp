@@ -27,7 +27,15 @@
 namespace Ultima {
 namespace Nuvie {
 
-AStarPath::AStarPath() : final_node(0) {
+static const uint32 ASTAR_NODE_BLOCK = 256; // nodes allocated at a time
+
+AStarPath::AStarPath() : node_count(0), final_node(0) {
+}
+
+AStarPath::~AStarPath() {
+	delete_nodes();
+	for (astar_node *block : node_blocks)
+		delete[] block;
 }
 
 void AStarPath::create_path() {
@@ -52,11 +60,7 @@ bool AStarPath::score_to_neighbor(sint8 dir, astar_node *nnode, astar_node *neig
 	// get neighbor of nnode towards sx,sy, and cost to that neighbor
 	neighbor->loc = nnode->loc.abs_coords(sx, sy);
 	nnode_to_neighbor = step_cost(nnode->loc, neighbor->loc);
-	if (nnode_to_neighbor == -1) {
-		delete neighbor; // this neighbor is blocked
-		return false;
-	}
-	return true;
+	return nnode_to_neighbor != -1; // false if this neighbor is blocked
 }/* Compare a node's score to the start node to already scored neighbors. */
 bool AStarPath::compare_neighbors(astar_node *nnode, astar_node *neighbor,
 								  sint32 nnode_to_neighbor, astar_node *in_open,
@@ -64,36 +68,32 @@ bool AStarPath::compare_neighbors(astar_node *nnode, astar_node *neighbor,
 	neighbor->to_start = nnode->to_start + nnode_to_neighbor;
 	// ignore this neighbor if already checked and closer to start
 	if ((in_open && in_open->to_start <= neighbor->to_start)
-	        || (in_closed && in_closed->to_start <= neighbor->to_start)) {
-		delete neighbor;
+	        || (in_closed && in_closed->to_start <= neighbor->to_start))
 		return false;
-	}
 	return true;
 }/* Check all neighbors of a node (location) and save them to the "seen" list. */
 bool AStarPath::search_node_neighbors(astar_node *nnode, const MapCoord &goal,
 									  const uint32 max_score) {
 	for (uint32 dir = 1; dir < 8; dir += 2) {
-		astar_node *neighbor = new astar_node;
+		astar_node neighbor; // only stored if it's put into the open list
 		sint32 nnode_to_neighbor = -1;
-		if (!score_to_neighbor(dir, nnode, neighbor, nnode_to_neighbor))
+		if (!score_to_neighbor(dir, nnode, &neighbor, nnode_to_neighbor))
 			continue; // this neighbor is blocked
-		astar_node *in_open = find_open_node(neighbor),
-		            *in_closed = find_closed_node(neighbor);
-		if (!compare_neighbors(nnode, neighbor, nnode_to_neighbor, in_open, in_closed))
-			continue;
-		neighbor->parent = nnode;
-		neighbor->to_goal = path_cost_est(neighbor->loc, goal);
-		neighbor->score = neighbor->to_start + neighbor->to_goal;
-		neighbor->len = nnode->len + 1;
-		if (neighbor->score > max_score) {
-			delete neighbor; // too far away
+		astar_node *seen = find_node(neighbor.loc);
+		astar_node *in_open = (seen && !seen->closed) ? seen : nullptr,
+		            *in_closed = (seen && seen->closed) ? seen : nullptr;
+		if (!compare_neighbors(nnode, &neighbor, nnode_to_neighbor, in_open, in_closed))
 			continue;
-		}
-		// take neighbor out of closed list and put into open list
-		if (in_closed)
-			remove_closed_node(in_closed);
+		neighbor.parent = nnode;
+		neighbor.to_goal = path_cost_est(neighbor.loc, goal);
+		neighbor.score = neighbor.to_start + neighbor.to_goal;
+		neighbor.len = nnode->len + 1;
+		if (neighbor.score > max_score)
+			continue; // too far away
+		// a closed neighbor is searched again from the open list, the old
+		// node is kept as it may be the parent of other nodes
 		if (!in_open)
-			push_open_node(neighbor);
+			push_open_node(new_node(neighbor));
 	}
 	return true;
 }
@@ -106,12 +106,13 @@ bool AStarPath::search_node_neighbors(astar_node *nnode, const MapCoord &goal,
  */
 bool AStarPath::path_search(const MapCoord &start, const MapCoord &goal) {
 	//DEBUG(0,LEVEL_DEBUGGING,"SEARCH: %d: %d,%d -> %d,%d\n",actor->get_actor_num(),start.x,start.y,goal.x,goal.y);
-	astar_node *start_node = new astar_node;
-	start_node->loc = start;
-	start_node->to_start = 0;
-	start_node->to_goal = path_cost_est(start, goal);
-	start_node->score = start_node->to_start + start_node->to_goal;
-	start_node->len = 0;
+	astar_node start_init;
+	start_init.loc = start;
+	start_init.to_start = 0;
+	start_init.to_goal = path_cost_est(start, goal);
+	start_init.score = start_init.to_start + start_init.to_goal;
+	start_init.len = 0;
+	astar_node *start_node = new_node(start_init);
 	push_open_node(start_node);
 	const uint32 max_score = get_max_score(start_node->to_goal);
 	const uint32 max_steps = 8 * 2 * 4; // walk up to four screen lengths before searching again
@@ -129,7 +130,7 @@ bool AStarPath::path_search(const MapCoord &start, const MapCoord &goal) {
 		// check cardinal neighbors (starting at top going clockwise)
 		search_node_neighbors(nnode, goal, max_score);
 		// node and neighbors checked, put into closed
-		closed_nodes.push_back(nnode);
+		nnode->closed = true;
 	}
 //DEBUG(0,LEVEL_DEBUGGING,"FAIL\n");
 	delete_nodes();
@@ -146,72 +147,81 @@ sint32 AStarPath::step_cost(const MapCoord &c1, const MapCoord &c2) {
 	return 1;
 }
 
-/* Return an item in the list of closed nodes whose location matches `ncmp'.
+/* Return a new node for this search, copied from `init'. Nodes are taken
+ * from blocks which are reused by later searches.
  */
-astar_node *AStarPath::find_closed_node(astar_node *ncmp) {
-	for (astar_node *n : closed_nodes)
-		if (n->loc == ncmp->loc)
-			return n;
-	return nullptr;
+astar_node *AStarPath::new_node(const astar_node &init) {
+	if (node_count == node_blocks.size() * ASTAR_NODE_BLOCK)
+		node_blocks.push_back(new astar_node[ASTAR_NODE_BLOCK]);
+	astar_node *node = &node_blocks[node_count / ASTAR_NODE_BLOCK][node_count % ASTAR_NODE_BLOCK];
+	*node = init;
+	node->order = node_count++;
+	node->closed = false;
+	return node;
 }
 
-/* Return an item in the list of open nodes whose location matches `ncmp'.
+/* Return the open or closed node at location `loc', or nullptr if it hasn't
+ * been seen in this search.
  */
-astar_node *AStarPath::find_open_node(astar_node *ncmp) {
-	for (astar_node *n : open_nodes)
-		if (n->loc == ncmp->loc)
-			return n;
-	return nullptr;
+astar_node *AStarPath::find_node(const MapCoord &loc) {
+	Common::HashMap<uint32, astar_node *>::iterator n = seen_nodes.find(node_key(loc));
+	return n != seen_nodes.end() ? n->_value : nullptr;
 }
 
-/* Add new node pointer to the list of open nodes (sorting by score).
+/* Add new node pointer to the heap of open nodes (sorting by score), and make
+ * it the node seen at its location.
  */
 void AStarPath::push_open_node(astar_node *node) {
-	if (open_nodes.empty()) {
-		open_nodes.push_front(node);
-		return;
-	}
+	seen_nodes[node_key(node->loc)] = node;
 
-	Common::List<astar_node *>::iterator n = open_nodes.begin();
-	// get to end of list or to a node with equal or greater score
-	while (n != open_nodes.end() && (*n++)->score < node->score);
-	open_nodes.insert(n, node); // and add before that location
+	uint32 n = open_nodes.size();
+	open_nodes.push_back(node);
+	while (n > 0) { // move up to the first parent with an equal or better score
+		const uint32 parent = (n - 1) / 2;
+		if (!open_node_less(node, open_nodes[parent]))
+			break;
+		open_nodes[n] = open_nodes[parent];
+		n = parent;
+	}
+	open_nodes[n] = node;
 }
 
-/* Return pointer to the highest priority node from the list of open nodes, and
+/* Return pointer to the highest priority node from the heap of open nodes, and
  * remove it.
  */
 astar_node *AStarPath::pop_open_node() {
 	astar_node *best = open_nodes.front();
-	open_nodes.pop_front(); // remove it
-	return best;
-}
+	astar_node *last = open_nodes.back();
+	open_nodes.pop_back();
 
-/* Find item in the list of closed nodes whose location matched `ncmp', and
- * remove it from the list.
- */
-void AStarPath::remove_closed_node(astar_node *ncmp) {
-	Common::List<astar_node *>::iterator n;
-	for (n = closed_nodes.begin(); n != closed_nodes.end(); n++)
-		if ((*n)->loc == ncmp->loc) {
-			closed_nodes.erase(n);
-			return;
-		}
+	const uint32 size = open_nodes.size();
+	uint32 n = 0;
+	while (size > 0) { // move the last node down from the top
+		uint32 child = n * 2 + 1;
+		if (child >= size)
+			break;
+		if (child + 1 < size && open_node_less(open_nodes[child + 1], open_nodes[child]))
+			child++;
+		if (!open_node_less(open_nodes[child], last))
+			break;
+		open_nodes[n] = open_nodes[child];
+		n = child;
+	}
+	if (size > 0)
+		open_nodes[n] = last;
+	return best;
 }
 
-/* Delete nodes dereferenced from pointers in the lists.
+/* Forget the nodes of the last search. Only the first block of nodes is kept.
  */
 void AStarPath::delete_nodes() {
-	while (!open_nodes.empty()) {
-		astar_node *delnode = open_nodes.front();
-		open_nodes.pop_front();
-		delete delnode;
-	}
-	while (!closed_nodes.empty()) {
-		astar_node *delnode = closed_nodes.front();
-		closed_nodes.pop_front();
-		delete delnode;
-	}
+	open_nodes.clear();
+	seen_nodes.clear(true);
+	for (uint32 b = 1; b < node_blocks.size(); b++)
+		delete[] node_blocks[b];
+	if (node_blocks.size() > 1)
+		node_blocks.resize(1);
+	node_count = 0;
 }
 
 } // End of namespace Nuvie
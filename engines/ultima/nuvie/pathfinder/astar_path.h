@@ -22,6 +22,7 @@
 #ifndef NUVIE_PATHFINDER_ASTAR_PATH_H
 #define NUVIE_PATHFINDER_ASTAR_PATH_H
 
+#include "common/hashmap.h"
 #include "ultima/nuvie/core/map.h"
 #include "ultima/nuvie/pathfinder/path.h"
 
@@ -34,14 +35,19 @@ typedef struct astar_node_s {
 	uint32 to_goal;
 	uint32 score; // node score
 	uint32 len; // number of nodes before this one, regardless of score
+	uint32 order; // creation order, newer nodes are searched first on equal score
+	bool closed; // already searched
 	struct astar_node_s *parent;
 	astar_node_s() : loc(0, 0, 0), to_start(0), to_goal(0), score(0), len(0),
-		parent(nullptr) { }
+		order(0), closed(false), parent(nullptr) { }
 } astar_node;
 /* Provides A* search and cost methods for PathFinder and subclasses.
  */class AStarPath: public Path {
 protected:
-	Common::List<astar_node *> open_nodes, closed_nodes; // nodes seen
+	Common::Array<astar_node *> open_nodes; // binary heap, best node first
+	Common::HashMap<uint32, astar_node *> seen_nodes; // open and closed nodes by location
+	Common::Array<astar_node *> node_blocks; // storage for the nodes of a search
+	uint32 node_count; // nodes used in node_blocks
 	astar_node *final_node; // last node in path search, used by create_path()
 	/* Forms a usable path from results of a search. */
 	void create_path();
@@ -54,7 +60,7 @@ protected:
 	                       sint32 &nnode_to_neighbor);
 public:
 	AStarPath();
-	~AStarPath() override { }
+	~AStarPath() override;
 	bool path_search(const MapCoord &start, const MapCoord &goal) override;
 	uint32 path_cost_est(const MapCoord &s, const MapCoord &g) override  {
 		return Path::path_cost_est(s, g);
@@ -67,13 +73,19 @@ public:
 	}
 	sint32 step_cost(const MapCoord &c1, const MapCoord &c2) override;
 protected:
-	/* FIXME: These node functions can be replaced with a priority_queue and a list. */
-	astar_node *find_open_node(astar_node *ncmp);
+	astar_node *new_node(const astar_node &init);
+	astar_node *find_node(const MapCoord &loc);
 	void push_open_node(astar_node *node);
 	astar_node *pop_open_node();
-	astar_node *find_closed_node(astar_node *ncmp);
-	void remove_closed_node(astar_node *ncmp);
 	void delete_nodes();
+
+	static uint32 node_key(const MapCoord &loc) {
+		// map coordinates are below 1024
+		return (loc.x & 0x3ff) | ((loc.y & 0x3ff) << 10) | (loc.z << 20);
+	}
+	static bool open_node_less(const astar_node *n1, const astar_node *n2) {
+		return n1->score < n2->score || (n1->score == n2->score && n1->order > n2->order);
+	}
 };
 
 } // End of namespace Nuvie
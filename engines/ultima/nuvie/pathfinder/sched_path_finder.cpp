@@ -22,12 +22,16 @@
 #include "ultima/nuvie/core/nuvie_defs.h"
 #include "ultima/nuvie/actors/actor.h"
 #include "ultima/nuvie/core/map.h"
+#include "ultima/nuvie/misc/sdl_compat.h"
 #include "ultima/nuvie/pathfinder/path.h"
 #include "ultima/nuvie/pathfinder/sched_path_finder.h"
 
 namespace Ultima {
 namespace Nuvie {
 
+uint32 SchedPathFinder::search_period_start = 0;
+uint32 SchedPathFinder::search_count = 0;
+
 /* NOTE: Path_type must always be valid. */
 SchedPathFinder::SchedPathFinder(Actor *a, MapCoord g, Path *path_type)
 	: ActorPathFinder(a, g), prev_step_i(0), next_step_i(0) {
@@ -56,7 +60,23 @@ bool SchedPathFinder::get_next_move(MapCoord &step) {
 	return true;
 }
 
+/* Returns true if another search fits into the current period. Actors which
+ * can't search now keep trying on their next updates. */
+bool SchedPathFinder::can_search() {
+	const uint32 now = SDL_GetTicks();
+	if (now - search_period_start >= SEARCH_PERIOD_MS) {
+		search_period_start = now;
+		search_count = 0;
+	}
+	if (search_count >= SEARCHES_PER_PERIOD)
+		return false;
+	++search_count;
+	return true;
+}
+
 bool SchedPathFinder::find_path() {
+	if (!can_search())
+		return false; // too many searches this period, try again later
 	if (search->have_path())
 		search->delete_path();
 	if (!search->path_search(loc, goal)) {
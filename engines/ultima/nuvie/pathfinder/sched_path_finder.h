@@ -33,6 +33,13 @@ class SchedPathFinder: public ActorPathFinder {
 protected:
 	uint32 prev_step_i, next_step_i; /* step counters */
 
+	/* Searches allowed in one period, so that many NPCs starting a new
+	   schedule at once have their paths found over several updates. */
+	static const uint32 SEARCH_PERIOD_MS = 50;
+	static const uint32 SEARCHES_PER_PERIOD = 8;
+	static uint32 search_period_start;
+	static uint32 search_count;
+
 public:
 	/* Pass 'path_type' to define search rules and methods to be used. The
 	   PathFinder is responsible for deleting it when finished. */
@@ -46,6 +53,7 @@ public:
 	bool check_loc(const MapCoord &loc) override; // ignores other actors
 protected:
 	bool is_location_in_path();
+	bool can_search();
 	void incr_step();
 };
 
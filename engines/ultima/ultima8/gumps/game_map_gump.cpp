@@ -19,6 +19,7 @@
  *
  */
 
+#include "common/system.h"
 #include "ultima/ultima.h"
 #include "ultima/ultima8/gumps/game_map_gump.h"
 #include "ultima/ultima8/gumps/gump_notify_process.h"
@@ -76,11 +77,25 @@ Point3 GameMapGump::GetCameraLocation(int lerp_factor) {
 }
 
 void GameMapGump::PaintThis(RenderSurface *surf, int32 lerp_factor, bool scaled) {
+	Common::Rect32 clipWindow = surf->getClippingRect();
+	CurrentMap *map = BuildDisplayList(clipWindow, lerp_factor);
+	if (!map)
+		return;
+
+	int gridlines = _gridlines;
+	if (gridlines < 0) {
+		gridlines = map->getChunkSize();
+	}
+
+	_displayList->PaintDisplayList(surf, _highlightItems, _showFootpads, gridlines);
+}
+
+CurrentMap *GameMapGump::BuildDisplayList(const Common::Rect32 &clipWindow, int32 lerp_factor) {
 	World *world = World::get_instance();
-	if (!world) return; // Is it possible the world doesn't exist?
+	if (!world) return nullptr; // Is it possible the world doesn't exist?
 
 	CurrentMap *map = world->getCurrentMap();
-	if (!map) return;   // Is it possible the map doesn't exist?
+	if (!map) return nullptr;   // Is it possible the map doesn't exist?
 
 
 	// Get the camera location
@@ -105,7 +120,6 @@ void GameMapGump::PaintThis(RenderSurface *surf, int32 lerp_factor, bool scaled)
 		zlimit = roof->getZ();
 	}
 
-	Common::Rect32 clipWindow = surf->getClippingRect();
 	_displayList->BeginDisplayList(clipWindow, loc);
 
 	uint32 gametick = Kernel::get_instance()->getFrameNum();
@@ -118,7 +132,7 @@ void GameMapGump::PaintThis(RenderSurface *surf, int32 lerp_factor, bool scaled)
 			// Not fast, ignore
 			if (!map->isChunkFast(cx, cy)) continue;
 
-			const Common::List<Item *> *items = map->getItemList(cx, cy);
+			const Common::Array<Item *> *items = map->getItemList(cx, cy);
 
 			if (!items) continue;
 
@@ -159,12 +173,21 @@ void GameMapGump::PaintThis(RenderSurface *surf, int32 lerp_factor, bool scaled)
 		                      _draggingFlags, Item::EXT_TRANSPARENT);
 	}
 
-	int gridlines = _gridlines;
-	if (gridlines < 0) {
-		gridlines = map->getChunkSize();
-	}
+	return map;
+}
 
-	_displayList->PaintDisplayList(surf, _highlightItems, _showFootpads, gridlines);
+uint32 GameMapGump::BenchmarkDisplayList(int count, int &itemCount) {
+	itemCount = 0;
+	uint32 start = g_system->getMillis();
+	for (int i = 0; i < count; i++) {
+		if (!BuildDisplayList(_dims, 256))
+			break;
+
+		// Sort without drawing anything
+		_displayList->PaintDisplayList(nullptr);
+		itemCount = _displayList->getItemCount();
+	}
+	return g_system->getMillis() - start;
 }
 
 // Trace a click, and return ObjId
@@ -31,6 +31,7 @@ namespace Ultima8 {
 
 class ItemSorter;
 class CameraProcess;
+class CurrentMap;
 
 /**
  * The  gump which holds all the game map elements (floor, avatar, objects, etc)
@@ -76,6 +77,10 @@ public:
 
 	void IncSortOrder(int count);
 
+	// Build and sort the display list of the current view count times
+	// without painting. Returns the time taken in milliseconds.
+	uint32 BenchmarkDisplayList(int count, int &itemCount);
+
 	bool loadData(Common::ReadStream *rs, uint32 version);
 	void saveData(Common::WriteStream *ws) override;
 
@@ -101,6 +106,10 @@ public:
 	void        RenderSurfaceChanged() override;
 
 protected:
+	// Fill the display list with the items in view. Returns the current map,
+	// or nullptr if there is nothing to display.
+	CurrentMap *BuildDisplayList(const Common::Rect32 &clipWindow, int32 lerp_factor);
+
 	bool _displayDragging;
 	uint32 _draggingShape;
 	uint32 _draggingFrame;
@@ -42,9 +42,11 @@
 #include "ultima/ultima8/gumps/shape_viewer_gump.h"
 #include "ultima/ultima8/kernel/kernel.h"
 #include "ultima/ultima8/kernel/object_manager.h"
+#include "ultima/ultima8/misc/direction_util.h"
 #include "ultima/ultima8/misc/id_man.h"
 #include "ultima/ultima8/ultima8.h"
 #include "ultima/ultima8/usecode/bit_set.h"
+#include "ultima/ultima8/usecode/uc_list.h"
 #include "ultima/ultima8/usecode/uc_machine.h"
 #include "ultima/ultima8/world/actors/avatar_mover_process.h"
 #include "ultima/ultima8/world/actors/main_actor.h"
@@ -55,6 +57,7 @@
 #include "ultima/ultima8/world/get_object.h"
 #include "ultima/ultima8/world/item_factory.h"
 #include "ultima/ultima8/world/item_selection_process.h"
+#include "ultima/ultima8/world/loop_script.h"
 #include "ultima/ultima8/world/target_reticle_process.h"
 #include "ultima/ultima8/world/world.h"
 
@@ -99,6 +102,9 @@ Debugger::Debugger() : GUI::Debugger() {
 	registerCmd("GameMapGump::dumpAllMaps", WRAP_METHOD(Debugger, cmdDumpAllMaps));
 	registerCmd("GameMapGump::incrementSortOrder", WRAP_METHOD(Debugger, cmdIncrementSortOrder));
 	registerCmd("GameMapGump::decrementSortOrder", WRAP_METHOD(Debugger, cmdDecrementSortOrder));
+	registerCmd("GameMapGump::benchmarkSorter", WRAP_METHOD(Debugger, cmdBenchmarkSorter));
+
+	registerCmd("CurrentMap::benchmarkQueries", WRAP_METHOD(Debugger, cmdBenchmarkQueries));
 
 	registerCmd("Kernel::processTypes", WRAP_METHOD(Debugger, cmdProcessTypes));
 	registerCmd("Kernel::processInfo", WRAP_METHOD(Debugger, cmdProcessInfo));
@@ -730,7 +736,7 @@ void Debugger::dumpCurrentMap() {
 	// Work out the map limits in chunks
 	for (int32 y = 0; y < MAP_NUM_CHUNKS; y++) {
 		for (int32 x = 0; x < MAP_NUM_CHUNKS; x++) {
-			const Common::List<Item *> *list = curmap->getItemList(x, y);
+			const Common::Array<Item *> *list = curmap->getItemList(x, y);
 
 			// Should iterate the items!
 			// (items could extend outside of this chunk and they have height)
@@ -901,6 +907,58 @@ bool Debugger::cmdDecrementSortOrder(int argc, const char **argv) {
 	return false;
 }
 
+bool Debugger::cmdBenchmarkSorter(int argc, const char **argv) {
+	int count = argc > 1 ? strtol(argv[1], 0, 0) : 100;
+	GameMapGump *gump = Ultima8Engine::get_instance()->getGameMapGump();
+	if (!gump || count <= 0)
+		return true;
+
+	int items;
+	uint32 time = gump->BenchmarkDisplayList(count, items);
+	debugPrintf("Sorted %d items %d times in %u ms\n", items, count, time);
+	return true;
+}
+
+bool Debugger::cmdBenchmarkQueries(int argc, const char **argv) {
+	int count = argc > 1 ? strtol(argv[1], 0, 0) : 1000;
+	const CurrentMap *map = World::get_instance()->getCurrentMap();
+	const MainActor *av = getMainActor();
+	if (!map || !av || count <= 0)
+		return true;
+
+	// Run the queries a moving avatar does in its surroundings
+	LOOPSCRIPT(script, LS_TOKEN_TRUE);
+	const Box box = av->getWorldBox();
+	const Point3 pt = av->getLocation();
+	const uint32 shapeflags = av->getShapeInfo()->_flags;
+	const int32 dims[3] = { box._xd, box._yd, box._zd };
+	uint32 time[3];
+
+	time[0] = g_system->getMillis();
+	for (int i = 0; i < count; i++) {
+		UCList itemlist(2);
+		map->areaSearch(&itemlist, script, sizeof(script), av, 640, false);
+	}
+
+	time[1] = g_system->getMillis();
+	for (int i = 0; i < count; i++) {
+		Direction dir = static_cast<Direction>((i * 2) % 16);
+		Point3 end(pt.x + Direction_XFactor(dir) * 64, pt.y + Direction_YFactor(dir) * 64, pt.z);
+		Common::List<CurrentMap::SweepItem> hit;
+		map->sweepTest(pt, end, dims, shapeflags, av->getObjId(), false, &hit);
+	}
+
+	time[2] = g_system->getMillis();
+	for (int i = 0; i < count; i++) {
+		map->getPositionInfo(box, box, shapeflags, av->getObjId());
+	}
+
+	uint32 end = g_system->getMillis();
+	debugPrintf("%d calls: areaSearch %u ms, sweepTest %u ms, getPositionInfo %u ms\n",
+				count, time[1] - time[0], time[2] - time[1], end - time[2]);
+	return true;
+}
+
 
 bool Debugger::cmdProcessTypes(int argc, const char **argv) {
 	Kernel::get_instance()->processTypes();
@@ -52,6 +52,55 @@ typedef Common::List<Item *> item_list;
 const int INT_MAX_VALUE = 0x7fffffff;
 const int INT_MIN_VALUE = -INT_MAX_VALUE - 1;
 
+int ChunkItems::find(const Item *item) const {
+	// An item is in at most one list, so a matching hint is conclusive. The
+	// hint may be stale for items in no list (anymore), as lists are cleared
+	// without touching their items.
+	const uint idx = item->_chunkIdx;
+	if (idx < _item.size() && _item[idx] == item)
+		return idx;
+	return -1;
+}
+
+void ChunkItems::insert(uint idx, Item *item) {
+	_item.insert_at(idx, item);
+	_x.insert_at(idx, 0);
+	_y.insert_at(idx, 0);
+	_xyd.insert_at(idx, 0);
+	updateBounds(idx);
+	reindex(idx);
+}
+
+void ChunkItems::remove(uint idx) {
+	_item.remove_at(idx);
+	_x.remove_at(idx);
+	_y.remove_at(idx);
+	_xyd.remove_at(idx);
+	reindex(idx);
+}
+
+void ChunkItems::reindex(uint from) {
+	for (uint i = from; i < _item.size(); i++)
+		_item[i]->_chunkIdx = i;
+}
+
+void ChunkItems::updateBounds(uint idx) {
+	const Item *item = _item[idx];
+	int32 xd, yd, zd;
+	Point3 pt = item->getLocation();
+	item->getFootpadWorld(xd, yd, zd);
+	_x[idx] = pt.x;
+	_y[idx] = pt.y;
+	_xyd[idx] = MAX(xd, yd);
+}
+
+void ChunkItems::clear() {
+	_item.clear();
+	_x.clear();
+	_y.clear();
+	_xyd.clear();
+}
+
 CurrentMap::CurrentMap() : _currentMap(0), _eggHatcher(0),
 	  _fastXMin(-1), _fastYMin(-1), _fastXMax(-1), _fastYMax(-1) {
 	for (unsigned int i = 0; i < MAP_NUM_CHUNKS; i++) {
@@ -248,7 +297,7 @@ void CurrentMap::addItem(Item *item) {
 	}
 #endif
 
-	_items[cx][cy].push_front(item);
+	_items[cx][cy].insert(0, item);
 	item->setExtFlag(Item::EXT_INCURMAP);
 
 	Egg *egg = dynamic_cast<Egg *>(item);
@@ -283,7 +332,7 @@ void CurrentMap::addItemToEnd(Item *item) {
 	}
 #endif
 
-	_items[cx][cy].push_back(item);
+	_items[cx][cy].insert(_items[cx][cy].size(), item);
 	item->setExtFlag(Item::EXT_INCURMAP);
 
 	Egg *egg = dynamic_cast<Egg *>(item);
@@ -394,10 +443,36 @@ void CurrentMap::removeItemFromList(Item *item, int32 oldx, int32 oldy) {
 	int32 cx = oldx / _mapChunkSize;
 	int32 cy = oldy / _mapChunkSize;
 
-	_items[cx][cy].remove(item);
+	ChunkItems &chunk = _items[cx][cy];
+	int idx = chunk.find(item);
+	if (idx >= 0)
+		chunk.remove(idx);
 	item->clearExtFlag(Item::EXT_INCURMAP);
 }
 
+ChunkItems *CurrentMap::findItemChunk(const Item *item, int32 x, int32 y, int &idx) {
+	if (x < 0 || x >= _mapChunkSize * MAP_NUM_CHUNKS ||
+	        y < 0 || y >= _mapChunkSize * MAP_NUM_CHUNKS)
+		return nullptr;
+
+	ChunkItems &chunk = _items[x / _mapChunkSize][y / _mapChunkSize];
+	idx = chunk.find(item);
+	return idx >= 0 ? &chunk : nullptr;
+}
+
+void CurrentMap::updateItemBounds(Item *item, int32 oldx, int32 oldy) {
+	// Items moved with setLocation stay in the chunk they were added to, so
+	// the new location may be in another chunk
+	int idx;
+	ChunkItems *chunk = findItemChunk(item, oldx, oldy, idx);
+	if (!chunk) {
+		Point3 pt = item->getLocation();
+		chunk = findItemChunk(item, pt.x, pt.y, idx);
+	}
+	if (chunk)
+		chunk->updateBounds(idx);
+}
+
 // Check to see if the chunk is on the screen
 static inline bool ChunkOnScreen(int32 cx, int32 cy, int32 sleft, int32 stop, int32 sright, int32 sbot, int mapChunkSize) {
 	int32 scx = (cx * mapChunkSize - cy * mapChunkSize) / 4;
@@ -506,18 +581,21 @@ void CurrentMap::updateFastArea(const Point3 &from, const Point3 &to) {
 void CurrentMap::setChunkFast(int32 cx, int32 cy) {
 	_fast[cy][cx / 32] |= 1 << (cx & 31);
 
-	for (auto *item : _items[cx][cy]) {
-		item->enterFastArea();
+	// Items can get added to the end of the chunk while iterating
+	// (eg, by GlobEggs), those enter the fast area as well
+	const ChunkItems &chunk = _items[cx][cy];
+	for (uint i = 0; i < chunk.size(); i++) {
+		chunk._item[i]->enterFastArea();
 	}
 }
 
 void CurrentMap::unsetChunkFast(int32 cx, int32 cy) {
 	_fast[cy][cx / 32] &= ~(1 << (cx & 31));
 
-	auto iter = _items[cx][cy].begin();
-	while (iter != _items[cx][cy].end()) {
-		Item *item = *iter;
-		++iter;
+	const ChunkItems &chunk = _items[cx][cy];
+	uint i = 0;
+	while (i < chunk.size()) {
+		Item *item = chunk._item[i];
 #ifdef VALIDATE_CHUNKS
 		int32 x, y, z;
 		item->getLocation(x, y, z);
@@ -527,6 +605,10 @@ void CurrentMap::unsetChunkFast(int32 cx, int32 cy) {
 		}
 #endif
 		item->leaveFastArea();  // Can destroy the item
+
+		// Only advance if the item is still in this chunk
+		if (i < chunk.size() && chunk._item[i] == item)
+			i++;
 	}
 }
 
@@ -579,7 +661,12 @@ void CurrentMap::areaSearch(UCList *itemlist, const uint8 *loopscript,
 	//
 	for (int cy = miny; cy <= maxy; cy++) {
 		for (int cx = minx; cx <= maxx; cx++) {
-			for (const auto *item : _items[cx][cy]) {
+			const ChunkItems &chunk = _items[cx][cy];
+			for (uint i = 0; i < chunk.size(); i++) {
+				if (!searchrange.containsXY(chunk._x[i], chunk._y[i]))
+					continue;
+
+				const Item *item = chunk._item[i];
 				if (item->hasExtFlags(Item::EXT_SPRITE))
 					continue;
 
@@ -621,7 +708,12 @@ void CurrentMap::surfaceSearch(UCList *itemlist, const uint8 *loopscript,
 
 	for (int cy = miny; cy <= maxy; cy++) {
 		for (int cx = minx; cx <= maxx; cx++) {
-			for (const auto *item : _items[cx][cy]) {
+			const ChunkItems &chunk = _items[cx][cy];
+			for (uint i = 0; i < chunk.size(); i++) {
+				if (!chunk.mayOverlapXY(i, searchrange))
+					continue;
+
+				const Item *item = chunk._item[i];
 				if (item->getObjId() == check->getObjId())
 					continue;
 				if (item->hasExtFlags(Item::EXT_SPRITE))
@@ -674,10 +766,10 @@ TeleportEgg *CurrentMap::findDestination(uint16 id) {
 	return nullptr;
 }
 
-const Common::List<Item *> *CurrentMap::getItemList(int32 gx, int32 gy) const {
+const Common::Array<Item *> *CurrentMap::getItemList(int32 gx, int32 gy) const {
 	if (gx < 0 || gy < 0 || gx >= MAP_NUM_CHUNKS || gy >= MAP_NUM_CHUNKS)
 		return nullptr;
-	return &_items[gx][gy];
+	return &_items[gx][gy]._item;
 }
 
 PositionInfo CurrentMap::getPositionInfo(int32 x, int32 y, int32 z, uint32 shape, ObjId id) const {
@@ -713,7 +805,14 @@ PositionInfo CurrentMap::getPositionInfo(const Box &target, const Box &start, ui
 
 	for (int cx = minx; cx <= maxx; cx++) {
 		for (int cy = miny; cy <= maxy; cy++) {
-			for (const auto *item : _items[cx][cy]) {
+			const ChunkItems &chunk = _items[cx][cy];
+			for (uint i = 0; i < chunk.size(); i++) {
+				// All checks below need the item to overlap the target or
+				// contain its bottom center
+				if (!chunk.mayOverlapXY(i, target) && !chunk.mayContainXY(i, midx, midy))
+					continue;
+
+				const Item *item = chunk._item[i];
 				if (item->getObjId() == id)
 					continue;
 				if (item->hasExtFlags(Item::EXT_SPRITE))
@@ -1005,9 +1104,19 @@ bool CurrentMap::sweepTest(const Point3 &start, const Point3 &end,
 	if (hit)
 		sw_it = hit->end();
 
+	// Area covered by the whole move. Items touching it are hit as well, so
+	// allow some slack for rounding in the checks below.
+	const Box sweep(MAX(start.x, end.x) + 2, MAX(start.y, end.y) + 2, 0,
+	                ABS(vel[0]) + dims[0] + 4, ABS(vel[1]) + dims[1] + 4, 0);
+
 	for (int cx = minx; cx <= maxx; cx++) {
 		for (int cy = miny; cy <= maxy; cy++) {
-			for (const auto *other_item : _items[cx][cy]) {
+			const ChunkItems &chunk = _items[cx][cy];
+			for (uint idx = 0; idx < chunk.size(); idx++) {
+				if (!chunk.mayOverlapXY(idx, sweep))
+					continue;
+
+				const Item *other_item = chunk._item[idx];
 				if (other_item->getObjId() == item)
 					continue;
 				if (other_item->hasExtFlags(Item::EXT_SPRITE))
@@ -22,7 +22,9 @@
 #ifndef ULTIMA8_WORLD_CURRENTMAP_H
 #define ULTIMA8_WORLD_CURRENTMAP_H
 
+#include "common/array.h"
 #include "common/list.h"
+#include "ultima/ultima8/misc/box.h"
 #include "ultima/ultima8/misc/common_types.h"
 #include "ultima/ultima8/misc/direction.h"
 #include "ultima/ultima8/misc/point3.h"
@@ -32,7 +34,6 @@
 namespace Ultima {
 namespace Ultima8 {
 
-struct Box;
 class Map;
 class Item;
 class UCList;
@@ -42,6 +43,51 @@ class EggHatcherProcess;
 #define MAP_NUM_CHUNKS  64
 #define MAP_NUM_TARGET_ITEMS 200
 
+/**
+ * The items of a map chunk. The x/y bounds of each item are kept in arrays
+ * next to the item pointers, so spatial queries can skip most items without
+ * touching them. The bounds are only used to reject items: they cover the
+ * footpad both flipped and unflipped.
+ */
+struct ChunkItems {
+	Common::Array<Item *> _item;
+	Common::Array<int32> _x, _y;    // Item location
+	Common::Array<int32> _xyd;      // Largest footpad dimension
+
+	uint size() const {
+		return _item.size();
+	}
+
+	Common::Array<Item *>::const_iterator begin() const {
+		return _item.begin();
+	}
+
+	Common::Array<Item *>::const_iterator end() const {
+		return _item.end();
+	}
+
+	int find(const Item *item) const;
+	void insert(uint idx, Item *item);
+	void remove(uint idx);
+	void updateBounds(uint idx);
+	void clear();
+
+	//! Store the list positions from idx on in their items
+	void reindex(uint from);
+
+	//! Can the item at idx overlap the x/y of the box?
+	bool mayOverlapXY(uint idx, const Box &box) const {
+		return _x[idx] > box._x - box._xd && box._x > _x[idx] - _xyd[idx] &&
+		       _y[idx] > box._y - box._yd && box._y > _y[idx] - _xyd[idx];
+	}
+
+	//! Can the item at idx contain the point in x/y?
+	bool mayContainXY(uint idx, int32 px, int32 py) const {
+		return px > _x[idx] - _xyd[idx] && px <= _x[idx] &&
+		       py > _y[idx] - _xyd[idx] && py <= _y[idx];
+	}
+};
+
 class CurrentMap {
 	friend class World;
 public:
@@ -74,6 +120,10 @@ public:
 	void removeItemFromList(Item *item, int32 oldx, int32 oldy);
 	void removeItem(Item *item);
 
+	//! Update the cached bounds of an item after it moved or changed shape
+	//! without leaving its chunk
+	void updateItemBounds(Item *item, int32 oldx, int32 oldy);
+
 	//! Add an item to the list of possible targets (in Crusader)
 	void addTargetItem(const Item *item);
 	//! Remove an item from the list of possible targets (in Crusader)
@@ -173,7 +223,7 @@ public:
 	TeleportEgg *findDestination(uint16 id);
 
 	// Not allowed to modify the list. Remember to use const_iterator
-	const Common::List<Item *> *getItemList(int32 gx, int32 gy) const;
+	const Common::Array<Item *> *getItemList(int32 gx, int32 gy) const;
 
 	bool isChunkFast(int32 cx, int32 cy) const {
 		// CONSTANTS!
@@ -200,11 +250,14 @@ private:
 	//! clip the given map chunk numbers to iterate over them safely
 	static void clipMapChunks(int &minx, int &maxx, int &miny, int &maxy);
 
+	//! find the chunk holding an item, checking the chunk at (x, y) first
+	ChunkItems *findItemChunk(const Item *item, int32 x, int32 y, int &idx);
+
 	Map *_currentMap;
 
 	// item lists. Lots of them :-)
 	// items[x][y]
-	Common::List<Item *> _items[MAP_NUM_CHUNKS][MAP_NUM_CHUNKS];
+	ChunkItems _items[MAP_NUM_CHUNKS][MAP_NUM_CHUNKS];
 
 	ProcId _eggHatcher;
 
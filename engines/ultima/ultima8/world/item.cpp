@@ -78,7 +78,7 @@ Item::Item()
 	  _flags(0), _quality(0), _npcNum(0), _mapNum(0),
 	  _extendedFlags(0), _parent(0),
 	  _cachedShape(nullptr), _cachedShapeInfo(nullptr),
-	  _gump(0), _bark(0), _gravityPid(0), _lastSetup(0),
+	  _gump(0), _bark(0), _gravityPid(0), _lastSetup(0), _chunkIdx(0),
 	  _ix(0), _iy(0), _iz(0), _damagePoints(1) {
 }
 
@@ -147,15 +147,18 @@ const Item *Item::getTopItem() const {
 }
 
 void Item::setLocation(int32 X, int32 Y, int32 Z) {
+	int32 oldx = _x;
+	int32 oldy = _y;
 	_x = X;
 	_y = Y;
 	_z = Z;
+
+	if (_extendedFlags & EXT_INCURMAP)
+		World::get_instance()->getCurrentMap()->updateItemBounds(this, oldx, oldy);
 }
 
 void Item::setLocation(const Point3 &pt) {
-	_x = pt.x;
-	_y = pt.y;
-	_z = pt.z;
+	setLocation(pt.x, pt.y, pt.z);
 }
 
 void Item::move(const Point3 &pt) {
@@ -212,6 +215,8 @@ void Item::move(int32 X, int32 Y, int32 Z) {
 	_flags &= ~(FLG_CONTAINED | FLG_EQUIPPED | FLG_ETHEREAL);
 
 	// Set the location
+	int32 oldx = _x;
+	int32 oldy = _y;
 	_x = X;
 	_y = Y;
 	_z = Z;
@@ -224,6 +229,9 @@ void Item::move(int32 X, int32 Y, int32 Z) {
 			map->addItemToEnd(this);
 		else
 			map->addItem(this);
+	} else {
+		// Still in the same chunk
+		map->updateItemBounds(this, oldx, oldy);
 	}
 
 	// Call just moved
@@ -503,6 +511,10 @@ void Item::setShape(uint32 shape) {
 		_shape = shape;
 		_cachedShapeInfo = nullptr;
 	}
+
+	// The footpad may have changed
+	if (_extendedFlags & EXT_INCURMAP)
+		World::get_instance()->getCurrentMap()->updateItemBounds(this, _x, _y);
 }
 
 bool Item::overlaps(const Item &item2) const {
@@ -38,9 +38,11 @@ class ShapeInfo;
 class Shape;
 class Gump;
 class GravityProcess;
+struct ChunkItems;
 
 class Item : public Object {
 	friend class ItemFactory;
+	friend struct ChunkItems;
 
 public:
 	Item();
@@ -664,6 +666,10 @@ private:
 	//! The gametick setupLerp was last called on
 	int32 _lastSetup;
 
+	//! Position in the CurrentMap chunk list holding this item. Only a hint,
+	//! ChunkItems::find checks it before trusting it.
+	uint32 _chunkIdx;
+
 	//! Animate the item (called by setupLerp)
 	void animateItem();
 
@@ -19,6 +19,7 @@
  *
  */
 
+#include "common/algorithm.h"
 #include "ultima/ultima.h"
 #include "ultima/ultima8/misc/common_types.h"
 #include "ultima/ultima8/world/item_sorter.h"
@@ -45,10 +46,13 @@ namespace Ultima8 {
 static const uint32 TRANSPARENT_COLOR = TEX32_PACK_RGBA(0x7F, 0x00, 0x00, 0x7F);
 static const uint32 HIGHLIGHT_COLOR = TEX32_PACK_RGBA(0xFF, 0xFF, 0x00, 0x1F);
 
+static const int32 GRID_CELL_SIZE = 64;
+
 ItemSorter::ItemSorter(int capacity) :
 	_shapes(nullptr), _clipWindow(0, 0, 0, 0), _items(nullptr), _itemsTail(nullptr),
 	_itemsUnused(nullptr), _painted(nullptr), _camSx(0), _camSy(0),
-	_sortLimit(0), _sortLimitChanged(false) {
+	_sortLimit(0), _sortLimitChanged(false), _itemCount(0), _itemsSorted(true),
+	_gridCols(0), _gridRows(0) {
 	int i = capacity;
 	while (i--) {
 		SortItem *next = _itemsUnused;
@@ -87,6 +91,15 @@ void ItemSorter::BeginDisplayList(const Common::Rect32 &clipWindow, const Point3
 	_items = nullptr;
 	_itemsTail = nullptr;
 	_painted = nullptr;
+	_itemCount = 0;
+	_itemsSorted = true;
+
+	// Reset the grid, keeping the storage of the previous frame
+	_gridCols = MAX<int32>(1, (clipWindow.width() + GRID_CELL_SIZE - 1) / GRID_CELL_SIZE);
+	_gridRows = MAX<int32>(1, (clipWindow.height() + GRID_CELL_SIZE - 1) / GRID_CELL_SIZE);
+	_gridCells.resize(_gridCols * _gridRows);
+	Common::fill(_gridCells.begin(), _gridCells.end(), -1);
+	_gridEntries.resize(0);
 
 	// Screenspace bounding box bottom x coord (RNB x coord)
 	int32 camSx = (cam.x - cam.y) / 4;
@@ -181,21 +194,38 @@ void ItemSorter::AddItem(const Point3 &pt, uint32 shapeNum, uint32 frame_num, ui
 
 	si->_occluded = false;
 	si->_order = -1;
+	si->_addOrder = _itemCount++;
+	si->_gridMark = -1;
 
 	// We will clear all the vector memory
 	// Stictly speaking the vector will sort of leak memory, since they
 	// are never deleted
 	si->_depends.clear();
 
-	// Iterate the list and compare _shapes
+	// Gather the items sharing a grid cell with us. Only those can overlap
+	// as overlap() requires the shape frames to intersect.
+	int32 x0, y0, x1, y1;
+	GetGridRange(si->_sr, x0, y0, x1, y1);
+
+	_gridItems.resize(0);
+	for (int32 y = y0; y <= y1; y++) {
+		for (int32 x = x0; x <= x1; x++) {
+			for (int32 e = _gridCells[y * _gridCols + x]; e >= 0; e = _gridEntries[e]._next) {
+				SortItem *si2 = _gridEntries[e]._item;
+				if (si2->_gridMark != si->_addOrder) {
+					si2->_gridMark = si->_addOrder;
+					_gridItems.push_back(si2);
+				}
+			}
+		}
+	}
 
-	// Ok,
-	SortItem *addpoint = nullptr;
-	for (SortItem *si2 = _items; si2 != nullptr; si2 = si2->_next) {
-		// Get the insert point... which is before the first item that has higher z than us
-		if (!addpoint && si->listLessThan(*si2))
-			addpoint = si2;
+	// Compare in display list order, as the checks below stop at the
+	// first item found to occlude us
+	Common::sort(_gridItems.begin(), _gridItems.end(), SortItem::listOrderLessThan);
 
+	for (uint i = 0; i < _gridItems.size(); i++) {
+		SortItem *si2 = _gridItems[i];
 		if (si2->_occluded)
 			continue;
 
@@ -243,30 +273,73 @@ void ItemSorter::AddItem(const Point3 &pt, uint32 shapeNum, uint32 frame_num, ui
 		}
 	}
 
-	// Add it to the list
+	// Add it to the end of the list, it gets sorted before painting
 	_itemsUnused = _itemsUnused->_next;
 
-	// have a position
-	//addpoint = 0;
-	if (addpoint) {
-		si->_next = addpoint;
-		si->_prev = addpoint->_prev;
-		addpoint->_prev = si;
-		if (si->_prev)
-			si->_prev->_next = si;
-		else
-			_items = si;
+	if (_itemsTail) {
+		_itemsTail->_next = si;
+		if (_itemsSorted && SortItem::listOrderLessThan(si, _itemsTail))
+			_itemsSorted = false;
+	}
+	if (!_items)
+		_items = si;
+	si->_next = nullptr;
+	si->_prev = _itemsTail;
+	_itemsTail = si;
+
+	// Occluded items are skipped by all later checks, so leave them out of the grid
+	if (!si->_occluded) {
+		for (int32 y = y0; y <= y1; y++) {
+			for (int32 x = x0; x <= x1; x++) {
+				GridEntry entry;
+				entry._item = si;
+				entry._next = _gridCells[y * _gridCols + x];
+				_gridCells[y * _gridCols + x] = _gridEntries.size();
+				_gridEntries.push_back(entry);
+			}
+		}
 	}
-	// Add it to the end of the list
-	else {
-		if (_itemsTail)
-			_itemsTail->_next = si;
-		if (!_items)
-			_items = si;
-		si->_next = nullptr;
-		si->_prev = _itemsTail;
-		_itemsTail = si;
+}
+
+/**
+ * Get the range of grid cells covered by a screenspace rect. Rects outside
+ * of the clip window are clamped to the border cells so that intersecting
+ * rects always share a cell.
+ */
+void ItemSorter::GetGridRange(const Common::Rect32 &r, int32 &x0, int32 &y0, int32 &x1, int32 &y1) const {
+	x0 = CLIP<int32>((r.left - _clipWindow.left) / GRID_CELL_SIZE, 0, _gridCols - 1);
+	y0 = CLIP<int32>((r.top - _clipWindow.top) / GRID_CELL_SIZE, 0, _gridRows - 1);
+	x1 = CLIP<int32>((r.right - 1 - _clipWindow.left) / GRID_CELL_SIZE, x0, _gridCols - 1);
+	y1 = CLIP<int32>((r.bottom - 1 - _clipWindow.top) / GRID_CELL_SIZE, y0, _gridRows - 1);
+}
+
+/**
+ * Put the display list into painting order, unless items were already
+ * added in that order.
+ */
+void ItemSorter::SortDisplayList() {
+	if (_itemsSorted)
+		return;
+
+	_gridItems.resize(0);
+	for (SortItem *si = _items; si != nullptr; si = si->_next)
+		_gridItems.push_back(si);
+
+	Common::sort(_gridItems.begin(), _gridItems.end(), SortItem::listOrderLessThan);
+
+	SortItem *prev = nullptr;
+	for (uint i = 0; i < _gridItems.size(); i++) {
+		SortItem *si = _gridItems[i];
+		si->_prev = prev;
+		if (prev)
+			prev->_next = si;
+		prev = si;
 	}
+	prev->_next = nullptr;
+
+	_items = _gridItems.front();
+	_itemsTail = prev;
+	_itemsSorted = true;
 }
 
 void ItemSorter::AddItem(const Item *add) {
@@ -275,7 +348,9 @@ void ItemSorter::AddItem(const Item *add) {
 }
 
 void ItemSorter::PaintDisplayList(RenderSurface *surf, bool item_highlight, bool showFootpads, int gridlines) {
-	if (_sortLimit) {
+	SortDisplayList();
+
+	if (_sortLimit && surf) {
 		// Clear the surface when debugging the sorter
 		uint32 color = TEX32_PACK_RGB(0, 0, 0);
 		surf->fill32(color, _clipWindow);
@@ -541,6 +616,8 @@ uint16 ItemSorter::Trace(int32 x, int32 y, HitFace *face, bool item_highlight) {
 	SortItem *it;
 	SortItem *selected;
 
+	SortDisplayList();
+
 	if (!_painted) { // If no painted item found, we need to sort the items
 		it = _items;
 		_painted = nullptr;
@@ -22,6 +22,7 @@
 #ifndef ULTIMA8_WORLD_ITEMSORTER_H
 #define ULTIMA8_WORLD_ITEMSORTER_H
 
+#include "common/array.h"
 #include "common/rect.h"
 
 namespace Ultima {
@@ -46,6 +47,22 @@ class ItemSorter {
 	int32       _sortLimit;
 	bool        _sortLimitChanged;
 
+	int32       _itemCount;
+	bool        _itemsSorted;
+
+	// Screenspace grid over the clip window. Each cell holds a chain of
+	// entries for the items whose shape frame covers it, so only items
+	// sharing a cell need to be compared when adding an item.
+	struct GridEntry {
+		SortItem *_item;
+		int32     _next;
+	};
+
+	int32                       _gridCols, _gridRows;
+	Common::Array<int32>        _gridCells;
+	Common::Array<GridEntry>    _gridEntries;
+	Common::Array<SortItem *>   _gridItems;
+
 public:
 	ItemSorter(int capacity);
 	~ItemSorter();
@@ -69,7 +86,13 @@ public:
 
 	void IncSortLimit(int count);
 
+	int32 getItemCount() const {
+		return _itemCount;
+	}
+
 private:
+	void GetGridRange(const Common::Rect32 &r, int32 &x0, int32 &y0, int32 &x1, int32 &y1) const;
+	void SortDisplayList();
 	bool PaintSortItem(RenderSurface *surf, SortItem *si, bool showFootpad, int gridlines);
 };
 
@@ -49,7 +49,7 @@ struct SortItem {
 			_occl(false), _solid(false), _draw(false), _roof(false),
 			_noisy(false), _anim(false), _trans(false), _fixed(false),
 			_land(false), _occluded(false), _sprite(false),
-			_invitem(false) { }
+			_invitem(false), _addOrder(0), _gridMark(-1) { }
 
 	SortItem                *_next;
 	SortItem                *_prev;
@@ -119,6 +119,9 @@ struct SortItem {
 
 	int32   _order;      // Rendering _order. -1 is not yet drawn
 
+	int32   _addOrder;   // Position in which this was added to the display list
+	int32   _gridMark;   // _addOrder of the last item that visited this in the sorter grid
+
 	// Note that PriorityQueue could be used here, BUT there is no guarantee that it's implementation
 	// will be friendly to insertions
 	// Alternatively i could use Common::List, BUT there is no guarantee that it will keep won't delete
@@ -262,6 +265,15 @@ struct SortItem {
 		return si1._flat > si2._flat;
 	}
 
+	// Display list order. Equal items keep the order in which they were added.
+	static inline bool listOrderLessThan(const SortItem *si1, const SortItem *si2) {
+		if (si1->listLessThan(*si2))
+			return true;
+		if (si2->listLessThan(*si1))
+			return false;
+		return si1->_addOrder < si2->_addOrder;
+	}
+
 	Common::String dumpInfo() const;
 };
 
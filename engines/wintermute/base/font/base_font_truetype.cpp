@@ -38,6 +38,7 @@
 #include "engines/wintermute/wintermute.h"
 #include "engines/wintermute/dcgf.h"
 
+#include "graphics/fonts/glyphatlas.h"
 #include "graphics/fonts/ttf.h"
 #include "graphics/fontman.h"
 #include "common/unicode-bidi.h"
@@ -260,18 +261,14 @@ BaseSurface *BaseFontTT::renderTextToTexture(const WideString &text, int width,
 	Graphics::Surface *surface = new Graphics::Surface();
 	surface->create((uint16)width, (uint16)(_lineHeight * lines.size()), _game->_renderer->getPixelFormat());
 	uint32 useColor = 0xffffffff;
-	Common::Array<WideString>::iterator it;
-	int heightOffset = 0;
-	for (it = lines.begin(); it != lines.end(); ++it) {
-		WideString str;
+	for (uint i = 0; i < lines.size(); i++) {
 		if (_game->_textRTL) {
-			str = Common::convertBiDiU32String(*it, Common::BIDI_PAR_RTL);
+			lines[i] = Common::convertBiDiU32String(lines[i], Common::BIDI_PAR_RTL);
 		} else {
-			str = Common::convertBiDiU32String(*it, Common::BIDI_PAR_LTR);
+			lines[i] = Common::convertBiDiU32String(lines[i], Common::BIDI_PAR_LTR);
 		}
-		_font->drawAlphaString(surface, str, 0, heightOffset, width, useColor, alignment);
-		heightOffset += (int)_lineHeight;
 	}
+	_font->drawAlphaStrings(surface, lines, 0, 0, width, (int)_lineHeight, useColor, alignment);
 
 	BaseSurface *retSurface = _game->_renderer->createSurface();
 	retSurface->create(surface->w, surface->h);
@@ -576,6 +573,13 @@ bool BaseFontTT::initFont() {
 		_deletableFont = Graphics::loadTTFFontFromArchive(fallbackFilename, _fontHeight, Graphics::kTTFSizeModeCharacter, 96); // Use the same dpi as WME (96 vs 72).
 		_font = _deletableFont;
 	}
+
+	// Keep the glyphs of about a thousand characters, which the default
+	// budget cannot for large fonts or CJK texts
+	if (_deletableFont) {
+		const uint32 glyphBytes = _deletableFont->getFontHeight() * _deletableFont->getFontHeight();
+		_deletableFont->setGlyphCacheBudget(MAX<uint32>(Graphics::GlyphAtlas::kDefaultBudget, 1024 * glyphBytes));
+	}
 #else
 	warning("BaseFontTT::InitFont - FreeType2-support not compiled in, TTF-fonts will not be loaded");
 #endif // USE_FREETYPE2
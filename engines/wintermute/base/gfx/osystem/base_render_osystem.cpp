@@ -56,7 +56,6 @@ BaseRenderOSystem::BaseRenderOSystem(BaseGame *inGame) : BaseRenderer(inGame) {
 
 	_borderLeft = _borderRight = _borderTop = _borderBottom = 0;
 	_ratioX = _ratioY = 1.0f;
-	_dirtyRect = nullptr;
 	_disableDirtyRects = false;
 	if (ConfMan.hasKey("dirty_rects")) {
 		_disableDirtyRects = !ConfMan.getBool("dirty_rects");
@@ -74,8 +73,6 @@ BaseRenderOSystem::~BaseRenderOSystem() {
 		delete ticket;
 	}
 
-	delete _dirtyRect;
-
 	_renderSurface->free();
 	delete _renderSurface;
 }
@@ -148,8 +145,7 @@ bool BaseRenderOSystem::forcedFlip() {
 bool BaseRenderOSystem::flip() {
 	if (_skipThisFrame) {
 		_skipThisFrame = false;
-		delete _dirtyRect;
-		_dirtyRect = nullptr;
+		_dirtyRegion.clear();
 		g_system->updateScreen();
 		_needsFlip = false;
 
@@ -188,8 +184,7 @@ bool BaseRenderOSystem::flip() {
 		if (_disableDirtyRects || screenChanged) {
 			g_system->copyRectToScreen(_renderSurface->getPixels(), _renderSurface->pitch, 0, 0, _renderSurface->w, _renderSurface->h);
 		}
-		delete _dirtyRect;
-		_dirtyRect = nullptr;
+		_dirtyRegion.clear();
 		_needsFlip = false;
 	}
 	_lastFrameIter = _renderQueue.end();
@@ -272,21 +267,18 @@ void BaseRenderOSystem::drawSurface(BaseSurfaceOSystem *owner, const Graphics::S
 
 	if (owner) { // Fade-tickets are owner-less
 		RenderTicket compare(owner, nullptr, srcRect, dstRect, transform);
-		RenderQueueIterator it = _lastFrameIter;
-		++it;
-		// Avoid calling end() and operator* every time, when potentially going through
-		// LOTS of tickets.
-		RenderQueueIterator endIterator = _renderQueue.end();
-		RenderTicket *compareTicket = nullptr;
-		for (; it != endIterator; ++it) {
-			compareTicket = *it;
-			if (*(compareTicket) == compare && compareTicket->_isValid) {
-				if (_disableDirtyRects) {
-					drawFromSurface(compareTicket);
-				} else {
+		TicketIndex::iterator bucket = _ticketIndex.find(compare.getHash());
+		if (bucket != _ticketIndex.end()) {
+			const Common::Array<RenderQueueIterator> &candidates = bucket->_value;
+			for (uint i = 0; i < candidates.size(); ++i) {
+				RenderTicket *compareTicket = *candidates[i];
+				// The tickets not drawn yet this frame are the ones after _lastFrameIter
+				if (!compareTicket->_wantsDraw && compareTicket->_isValid && *compareTicket == compare) {
+					// Copied, as drawing may move the ticket and change the index
+					RenderQueueIterator it = candidates[i];
 					drawFromQueuedTicket(it);
+					return;
 				}
-				return;
 			}
 		}
 	}
@@ -332,6 +324,7 @@ void BaseRenderOSystem::drawFromTicket(RenderTicket *renderTicket) {
 		--_lastFrameIter;
 		addDirtyRect(renderTicket->_dstRect);
 	}
+	indexTicket(_lastFrameIter);
 }
 
 void BaseRenderOSystem::drawFromQueuedTicket(const RenderQueueIterator &ticket) {
@@ -345,6 +338,7 @@ void BaseRenderOSystem::drawFromQueuedTicket(const RenderQueueIterator &ticket)
 		--_lastFrameIter;
 		// Remove the ticket from the list
 		assert(*_lastFrameIter != renderTicket);
+		unindexTicket(renderTicket);
 		_renderQueue.erase(ticket);
 		// Is not in order, so readd it as if it was a new ticket
 		drawFromTicket(renderTicket);
@@ -352,12 +346,40 @@ void BaseRenderOSystem::drawFromQueuedTicket(const RenderQueueIterator &ticket)
 }
 
 void BaseRenderOSystem::addDirtyRect(const Common::Rect &rect) {
-	if (!_dirtyRect) {
-		_dirtyRect = new Common::Rect(rect);
-	} else {
-		_dirtyRect->extend(rect);
+	Common::Rect dirtyRect(rect);
+	dirtyRect.clip(_renderRect);
+	_dirtyRegion.add(dirtyRect);
+}
+
+void BaseRenderOSystem::indexTicket(const RenderQueueIterator &ticket) {
+	if ((*ticket)->_owner) {
+		_ticketIndex[(*ticket)->getHash()].push_back(ticket);
+	}
+}
+
+void BaseRenderOSystem::unindexTicket(RenderTicket *ticket) {
+	TicketIndex::iterator bucket = _ticketIndex.find(ticket->getHash());
+	if (bucket == _ticketIndex.end()) {
+		return;
+	}
+	Common::Array<RenderQueueIterator> &tickets = bucket->_value;
+	for (uint i = 0; i < tickets.size(); ++i) {
+		if (*tickets[i] == ticket) {
+			tickets.remove_at(i);
+			break;
+		}
+	}
+	if (tickets.empty()) {
+		_ticketIndex.erase(bucket);
 	}
-	_dirtyRect->clip(_renderRect);
+}
+
+BaseRenderOSystem::RenderQueueIterator BaseRenderOSystem::deleteTicket(const RenderQueueIterator &ticket) {
+	RenderTicket *renderTicket = *ticket;
+	unindexTicket(renderTicket);
+	RenderQueueIterator next = _renderQueue.erase(ticket);
+	delete renderTicket;
+	return next;
 }
 
 void BaseRenderOSystem::drawTickets() {
@@ -368,15 +390,13 @@ void BaseRenderOSystem::drawTickets() {
 	// we have a copy of their data, so their invalidness won't affect us.
 	while (it != _renderQueue.end()) {
 		if ((*it)->_wantsDraw == false) {
-			RenderTicket *ticket = *it;
 			addDirtyRect((*it)->_dstRect);
-			it = _renderQueue.erase(it);
-			delete ticket;
+			it = deleteTicket(it);
 		} else {
 			++it;
 		}
 	}
-	if (!_dirtyRect || _dirtyRect->width() == 0 || _dirtyRect->height() == 0) {
+	if (_dirtyRegion.isEmpty()) {
 		it = _renderQueue.begin();
 		while (it != _renderQueue.end()) {
 			RenderTicket *ticket = *it;
@@ -386,52 +406,63 @@ void BaseRenderOSystem::drawTickets() {
 		return;
 	}
 
+	const Common::Array<Common::Rect> &dirtyRects = _dirtyRegion.getRects();
+	const Common::Rect dirtyBounds = _dirtyRegion.getBounds();
+
 	it = _renderQueue.begin();
 	_lastFrameIter = _renderQueue.end();
 	// A special case: If the screen has one giant OPAQUE rect to be drawn, then we skip filling
 	// the background color. Typical use-case: Fullscreen FMVs.
 	// Caveat: The FPS-counter will invalidate this.
+	bool skipFill = false;
 	if (it != _lastFrameIter && _renderQueue.front() == _renderQueue.back() && (*it)->_transform._alphaDisable == true) {
 		// If our single opaque rect fills the dirty rect, we can skip filling.
-		if (*_dirtyRect != (*it)->_dstRect) {
-			// Apply the clear-color to the dirty rect.
-			_renderSurface->fillRect(*_dirtyRect, _clearColor);
+		skipFill = (dirtyRects.size() == 1 && dirtyRects[0] == (*it)->_dstRect);
+	}
+	if (!skipFill) {
+		// Apply the clear-color to the dirty rects.
+		for (uint i = 0; i < dirtyRects.size(); ++i) {
+			_renderSurface->fillRect(dirtyRects[i], _clearColor);
 		}
-		// Otherwise Do NOT fill.
-	} else {
-		// Apply the clear-color to the dirty rect.
-		_renderSurface->fillRect(*_dirtyRect, _clearColor);
 	}
 	for (; it != _renderQueue.end(); ++it) {
 		RenderTicket *ticket = *it;
-		if (ticket->_dstRect.intersects(*_dirtyRect)) {
-			// dstClip is the area we want redrawn.
-			Common::Rect dstClip(ticket->_dstRect);
-			// reduce it to the dirty rect
-			dstClip.clip(*_dirtyRect);
-			// we need to keep track of the position to redraw the dirty rect
-			Common::Rect pos(dstClip);
-			int16 offsetX = ticket->_dstRect.left;
-			int16 offsetY = ticket->_dstRect.top;
-			// convert from screen-coords to surface-coords.
-			dstClip.translate(-offsetX, -offsetY);
-
-			drawFromSurface(ticket, &pos, &dstClip);
-			_needsFlip = true;
+		if (ticket->_dstRect.intersects(dirtyBounds)) {
+			// The dirty rects are disjoint, so drawing the ticket into each of
+			// them in turn keeps the drawing order of every pixel.
+			for (uint i = 0; i < dirtyRects.size(); ++i) {
+				if (!ticket->_dstRect.intersects(dirtyRects[i])) {
+					continue;
+				}
+				// dstClip is the area we want redrawn.
+				Common::Rect dstClip(ticket->_dstRect);
+				// reduce it to the dirty rect
+				dstClip.clip(dirtyRects[i]);
+				// we need to keep track of the position to redraw the dirty rect
+				Common::Rect pos(dstClip);
+				int16 offsetX = ticket->_dstRect.left;
+				int16 offsetY = ticket->_dstRect.top;
+				// convert from screen-coords to surface-coords.
+				dstClip.translate(-offsetX, -offsetY);
+
+				drawFromSurface(ticket, &pos, &dstClip);
+				_needsFlip = true;
+			}
 		}
 		// Some tickets want redraw but don't actually clip the dirty area (typically the ones that shouldn't become clear-color)
 		ticket->_wantsDraw = false;
 	}
-	g_system->copyRectToScreen(_renderSurface->getBasePtr(_dirtyRect->left, _dirtyRect->top), _renderSurface->pitch, _dirtyRect->left, _dirtyRect->top, _dirtyRect->width(), _dirtyRect->height());
+	for (uint i = 0; i < dirtyRects.size(); ++i) {
+		const Common::Rect &rect = dirtyRects[i];
+		g_system->copyRectToScreen(_renderSurface->getBasePtr(rect.left, rect.top), _renderSurface->pitch, rect.left, rect.top, rect.width(), rect.height());
+	}
 
 	it = _renderQueue.begin();
 	// Clean out the old tickets
 	while (it != _renderQueue.end()) {
 		if ((*it)->_isValid == false) {
-			RenderTicket *ticket = *it;
 			addDirtyRect((*it)->_dstRect);
-			it = _renderQueue.erase(it);
-			delete ticket;
+			it = deleteTicket(it);
 		} else {
 			++it;
 		}
@@ -559,6 +590,7 @@ void BaseRenderOSystem::endSaveLoad() {
 		it = _renderQueue.erase(it);
 		delete ticket;
 	}
+	_ticketIndex.clear();
 	// HACK: After a save the buffer will be drawn before the scripts get to update it,
 	// so just skip this single frame.
 	_skipThisFrame = true;
@@ -29,9 +29,11 @@
 #define WINTERMUTE_BASE_RENDERER_SDL_H
 
 #include "engines/wintermute/base/gfx/base_renderer.h"
+#include "engines/wintermute/base/gfx/osystem/dirty_region.h"
 
 #include "common/rect.h"
 #include "common/list.h"
+#include "common/hashmap.h"
 
 #include "graphics/managed_surface.h"
 #include "graphics/transform_struct.h"
@@ -47,6 +49,10 @@ class RenderTicket;
  * (i.e. in the exact same order, with the exact same arguments), and thus
  * figure out which parts of the screen need to be redrawn.
  *
+ * Tickets from last frame are found through a hash of their arguments, and
+ * the screen regions that changed are kept as a small set of disjoint rects,
+ * so that only the tickets intersecting those get drawn again.
+ *
  * Important concepts to handle here, is the ordered number of any ticket
  * which is called the "drawNum", every frame this starts from scratch, and
  * then the incoming tickets created from the draw-calls are checked to see whether
@@ -124,12 +130,28 @@ private:
 	 * Traverse the tickets that are dirty, and draw them
 	 */
 	void drawTickets();
+	/**
+	 * Add a queued ticket to the index used to find it again next frame.
+	 * Fade-tickets are never looked up and are left out.
+	 */
+	void indexTicket(const RenderQueueIterator &ticket);
+	/**
+	 * Remove a ticket from the index, before it leaves the queue.
+	 */
+	void unindexTicket(RenderTicket *ticket);
+	/**
+	 * Remove a ticket from the index and the queue, and delete it.
+	 * @return iterator pointing to the following ticket.
+	 */
+	RenderQueueIterator deleteTicket(const RenderQueueIterator &ticket);
 	// Non-dirty-rects:
 	void drawFromSurface(RenderTicket *ticket);
 	// Dirty-rects:
 	void drawFromSurface(RenderTicket *ticket, Common::Rect *dstRect, Common::Rect *clipRect);
-	Common::Rect *_dirtyRect;
+	DirtyRegion _dirtyRegion;
 	Common::List<RenderTicket *> _renderQueue;
+	typedef Common::HashMap<uint32, Common::Array<RenderQueueIterator> > TicketIndex;
+	TicketIndex _ticketIndex; // queued tickets by RenderTicket::getHash()
 
 	bool _needsFlip;
 	RenderQueueIterator _lastFrameIter;
@@ -0,0 +1,101 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "engines/wintermute/base/gfx/osystem/dirty_region.h"
+
+namespace Wintermute {
+
+DirtyRegion::DirtyRegion(uint maxRects) : _maxRects(maxRects) {
+	assert(_maxRects > 0);
+}
+
+bool DirtyRegion::shouldMerge(const Common::Rect &r1, const Common::Rect &r2) {
+	if (r1.intersects(r2))
+		return true;
+	Common::Rect bounds(r1);
+	bounds.extend(r2);
+	return area(bounds) <= area(r1) + area(r2);
+}
+
+void DirtyRegion::add(const Common::Rect &rect) {
+	if (rect.isEmpty())
+		return;
+
+	Common::Rect newRect(rect);
+	uint i = 0;
+	while (i < _rects.size()) {
+		if (_rects[i].contains(newRect))
+			return;
+		if (shouldMerge(newRect, _rects[i])) {
+			newRect.extend(_rects[i]);
+			_rects.remove_at(i);
+			// The grown rect may now overlap rects that were checked already
+			i = 0;
+		} else {
+			++i;
+		}
+	}
+
+	if (_rects.size() >= _maxRects) {
+		uint best = 0;
+		int32 bestGrowth = 0;
+		for (i = 0; i < _rects.size(); ++i) {
+			Common::Rect bounds(_rects[i]);
+			bounds.extend(newRect);
+			const int32 growth = area(bounds) - area(_rects[i]);
+			if (i == 0 || growth < bestGrowth) {
+				best = i;
+				bestGrowth = growth;
+			}
+		}
+		newRect.extend(_rects[best]);
+		_rects.remove_at(best);
+		// Merging may have made it overlap others
+		add(newRect);
+		return;
+	}
+
+	_rects.push_back(newRect);
+}
+
+void DirtyRegion::clear() {
+	_rects.resize(0);
+}
+
+Common::Rect DirtyRegion::getBounds() const {
+	if (_rects.empty())
+		return Common::Rect();
+
+	Common::Rect bounds(_rects[0]);
+	for (uint i = 1; i < _rects.size(); ++i)
+		bounds.extend(_rects[i]);
+	return bounds;
+}
+
+bool DirtyRegion::intersects(const Common::Rect &rect) const {
+	for (uint i = 0; i < _rects.size(); ++i) {
+		if (_rects[i].intersects(rect))
+			return true;
+	}
+	return false;
+}
+
+} // End of namespace Wintermute
@@ -0,0 +1,64 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef WINTERMUTE_DIRTY_REGION_H
+#define WINTERMUTE_DIRTY_REGION_H
+
+#include "common/array.h"
+#include "common/rect.h"
+
+namespace Wintermute {
+
+/**
+ * The parts of the screen that have to be redrawn, as a list of disjoint rects.
+ * Rects that overlap, or that take no more area together than apart, are merged
+ * as they are added. When there are too many rects, new ones are merged into the
+ * rect that grows the least, so that a few small changes far apart on the screen
+ * don't cause a redraw of everything between them.
+ */
+class DirtyRegion {
+public:
+	DirtyRegion(uint maxRects = 16);
+
+	/**
+	 * Add a rect to the region. Empty rects are ignored.
+	 */
+	void add(const Common::Rect &rect);
+	void clear();
+
+	bool isEmpty() const { return _rects.empty(); }
+	const Common::Array<Common::Rect> &getRects() const { return _rects; }
+	/**
+	 * The smallest rect containing the whole region
+	 */
+	Common::Rect getBounds() const;
+	bool intersects(const Common::Rect &rect) const;
+private:
+	static int32 area(const Common::Rect &rect) { return (int32)rect.width() * rect.height(); }
+	static bool shouldMerge(const Common::Rect &r1, const Common::Rect &r2);
+
+	Common::Array<Common::Rect> _rects;
+	uint _maxRects;
+};
+
+} // End of namespace Wintermute
+
+#endif
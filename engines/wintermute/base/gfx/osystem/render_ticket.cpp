@@ -44,6 +44,14 @@ RenderTicket::RenderTicket(BaseSurfaceOSystem *owner, const Graphics::Surface *s
 	        _isValid(true),
 	        _wantsDraw(true),
 	        _transform(transform) {
+	_hash = (uint32)(uintptr)owner;
+	_hash = _hash * 31 + (uint16)_dstRect.left + ((uint32)(uint16)_dstRect.top << 16);
+	_hash = _hash * 31 + (uint16)_dstRect.right + ((uint32)(uint16)_dstRect.bottom << 16);
+	_hash = _hash * 31 + (uint16)_srcRect.left + ((uint32)(uint16)_srcRect.top << 16);
+	_hash = _hash * 31 + (uint16)_srcRect.right + ((uint32)(uint16)_srcRect.bottom << 16);
+	_hash = _hash * 31 + _transform._rgbaMod;
+	_hash = _hash * 31 + (uint32)_transform._angle;
+
 	if (surf) {
 		assert(surf->format.bytesPerPixel == 4);
 
@@ -55,6 +55,7 @@ MODULE_OBJS := \
 	base/gfx/base_surface.o \
 	base/gfx/osystem/base_surface_osystem.o \
 	base/gfx/osystem/base_render_osystem.o \
+	base/gfx/osystem/dirty_region.o \
 	base/gfx/osystem/render_ticket.o \
 	base/gfx/xmath.o \
 	base/particles/part_particle.o \
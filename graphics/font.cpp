@@ -532,6 +532,21 @@ void Font::drawString(ManagedSurface *dst, const Common::U32String &str, int x,
 	}
 }
 
+void Font::drawStrings(Surface *dst, const Common::Array<Common::U32String> &lines, int x, int y, int w, int lineHeight, uint32 color, TextAlign align) const {
+	for (uint i = 0; i < lines.size(); ++i)
+		drawString(dst, lines[i], x, y + i * lineHeight, w, color, align);
+}
+
+void Font::drawStrings(ManagedSurface *dst, const Common::Array<Common::U32String> &lines, int x, int y, int w, int lineHeight, uint32 color, TextAlign align) const {
+	for (uint i = 0; i < lines.size(); ++i)
+		drawString(dst, lines[i], x, y + i * lineHeight, w, color, align);
+}
+
+void Font::drawAlphaStrings(Surface *dst, const Common::Array<Common::U32String> &lines, int x, int y, int w, int lineHeight, uint32 color, TextAlign align) const {
+	for (uint i = 0; i < lines.size(); ++i)
+		drawAlphaString(dst, lines[i], x, y + i * lineHeight, w, color, align);
+}
+
 void Font::drawAlphaString(Surface *dst, const Common::String &str, int x, int y, int w, uint32 color, TextAlign align, int deltax, bool useEllipsis, bool allowCharClipping) const {
 	Common::String renderStr = useEllipsis ? handleEllipsis(*this, str, w) : str;
 	drawStringImpl(*this, dst, renderStr, x, y, w, color, align, deltax, true, allowCharClipping);
@@ -267,6 +267,39 @@ public:
 	/** @overload */
 	void drawString(ManagedSurface *dst, const Common::U32String &str, int x, int y, int w, uint32 color, TextAlign align = kTextAlignLeft, int deltax = 0, bool useEllipsis = false, bool allowCharClipping = false) const;
 
+	/**
+	 * Draw several lines of text below each other. The result is the same
+	 * as calling drawString() for every line, moving down by @p lineHeight
+	 * pixels each time, but fonts with a glyph cache draw the lines in a
+	 * single pass over it.
+	 *
+	 * @param dst         The surface on which to draw the lines.
+	 * @param lines       The lines to draw, e.g. as returned by wordWrapText().
+	 * @param x           The x position where to start drawing.
+	 * @param y           The y position of the first line.
+	 * @param w           Width of the text area.
+	 * @param lineHeight  Vertical distance between two lines.
+	 * @param color       The color with which to draw the lines.
+	 * @param align       Text alignment of each line in the given area.
+	 */
+	virtual void drawStrings(Surface *dst, const Common::Array<Common::U32String> &lines, int x, int y, int w, int lineHeight, uint32 color, TextAlign align = kTextAlignLeft) const;
+	/** @overload */
+	virtual void drawStrings(ManagedSurface *dst, const Common::Array<Common::U32String> &lines, int x, int y, int w, int lineHeight, uint32 color, TextAlign align = kTextAlignLeft) const;
+
+	/**
+	 * Draw several lines of text like drawStrings(), but store the alpha
+	 * channel like drawAlphaString() does.
+	 */
+	virtual void drawAlphaStrings(Surface *dst, const Common::Array<Common::U32String> &lines, int x, int y, int w, int lineHeight, uint32 color, TextAlign align = kTextAlignLeft) const;
+
+	/**
+	 * Limit the memory used for caching rendered glyphs. Only fonts which
+	 * render their glyphs on demand use a cache; others ignore this.
+	 *
+	 * @param bytes  The cache budget in bytes.
+	 */
+	virtual void setGlyphCacheBudget(uint32 bytes) {}
+
 	/**
 	 * Draw the given @p str string to the given @p dst surface.
 	 *
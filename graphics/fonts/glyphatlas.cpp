@@ -0,0 +1,225 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "graphics/fonts/glyphatlas.h"
+
+#include "common/util.h"
+
+namespace Graphics {
+
+GlyphAtlas::GlyphAtlas(uint32 budget)
+	: _numPages(0), _currentPage(-1), _budget(budget), _pageMemory(0), _useCounter(0) {
+}
+
+GlyphAtlas::~GlyphAtlas() {
+	clear();
+}
+
+void GlyphAtlas::setBudget(uint32 budget) {
+	_budget = budget;
+
+	while (_numPages > 1 && _pageMemory > _budget)
+		releasePage(findLeastRecentlyUsedPage());
+}
+
+const GlyphAtlas::Glyph *GlyphAtlas::find(uint32 chr) {
+	GlyphMap::iterator i = _glyphs.find(chr);
+	if (i == _glyphs.end())
+		return nullptr;
+
+	if (i->_value.page >= 0)
+		_pages[i->_value.page]->lastUse = ++_useCounter;
+	return &i->_value.glyph;
+}
+
+GlyphAtlas::Glyph *GlyphAtlas::insert(uint32 chr, int width, int height) {
+	Entry &entry = _glyphs[chr];
+	entry.glyph.image = Surface();
+	entry.glyph.xOffset = entry.glyph.yOffset = 0;
+	entry.glyph.advance = 0;
+	entry.glyph.index = 0;
+	entry.page = -1;
+
+	if (width <= 0 || height <= 0)
+		return &entry.glyph;
+
+	// Making room may drop other glyphs, but never the one being inserted,
+	// so the reference stays valid.
+	int x = 0, y = 0;
+	const uint index = allocateGlyph(width, height, x, y);
+	Page &page = *_pages[index];
+
+	page.glyphs.push_back(chr);
+	page.lastUse = ++_useCounter;
+
+	byte *pixels = page.pixels + y * page.width + x;
+	for (int row = 0; row < height; ++row)
+		memset(pixels + row * page.width, 0, width);
+
+	entry.glyph.image.init(width, height, page.width, pixels, PixelFormat::createFormatCLUT8());
+	entry.page = index;
+	return &entry.glyph;
+}
+
+void GlyphAtlas::clear() {
+	for (uint i = 0; i < _pages.size(); ++i) {
+		if (_pages[i]) {
+			delete[] _pages[i]->pixels;
+			delete _pages[i];
+		}
+	}
+
+	_pages.clear();
+	_glyphs.clear();
+	_numPages = 0;
+	_currentPage = -1;
+	_pageMemory = 0;
+}
+
+bool GlyphAtlas::allocate(Page &page, int width, int height, int &x, int &y) {
+	// Rounding the shelf heights keeps glyphs of similar height together
+	const int shelfHeight = (height + 3) & ~3;
+
+	for (uint i = 0; i < page.shelves.size(); ++i) {
+		Shelf &shelf = page.shelves[i];
+		if (shelf.height == shelfHeight && shelf.x + width <= page.width) {
+			x = shelf.x;
+			y = shelf.y;
+			shelf.x += width;
+			return true;
+		}
+	}
+
+	if (width > page.width || page.usedHeight + shelfHeight > page.height)
+		return false;
+
+	Shelf shelf;
+	shelf.y = page.usedHeight;
+	shelf.height = shelfHeight;
+	shelf.x = width;
+	page.shelves.push_back(shelf);
+	page.usedHeight += shelfHeight;
+
+	x = 0;
+	y = shelf.y;
+	return true;
+}
+
+uint GlyphAtlas::createPage(int width, int height) {
+	Page *page = new Page();
+	page->width = width;
+	page->height = height;
+	page->usedHeight = 0;
+	page->lastUse = ++_useCounter;
+	page->pixels = new byte[width * height];
+
+	_pageMemory += width * height;
+	_numPages++;
+
+	for (uint i = 0; i < _pages.size(); ++i) {
+		if (!_pages[i]) {
+			_pages[i] = page;
+			return i;
+		}
+	}
+
+	_pages.push_back(page);
+	return _pages.size() - 1;
+}
+
+uint GlyphAtlas::allocateGlyph(int width, int height, int &x, int &y) {
+	// Glyphs too large for a regular page get a page of their own
+	if (width > kPageSize || height > kPageSize) {
+		const int pageHeight = (height + 3) & ~3;
+		while (_numPages > 0 && _pageMemory + width * pageHeight > _budget)
+			releasePage(findLeastRecentlyUsedPage());
+
+		const uint index = createPage(width, pageHeight);
+		allocate(*_pages[index], width, height, x, y);
+		return index;
+	}
+
+	if (_currentPage >= 0 && allocate(*_pages[_currentPage], width, height, x, y))
+		return _currentPage;
+
+	// Reuse the least recently used page once the budget is exhausted
+	int index = -1;
+	while (_numPages > 0 && _pageMemory + kPageSize * kPageSize > _budget) {
+		const uint victim = findLeastRecentlyUsedPage();
+		if (_pages[victim]->width == kPageSize && _pages[victim]->height == kPageSize) {
+			emptyPage(victim);
+			index = victim;
+			break;
+		}
+		releasePage(victim);
+	}
+
+	if (index < 0)
+		index = createPage(kPageSize, kPageSize);
+
+	_currentPage = index;
+	allocate(*_pages[index], width, height, x, y);
+	return index;
+}
+
+void GlyphAtlas::emptyPage(uint index) {
+	Page &page = *_pages[index];
+
+	// Glyphs which were inserted again later live on another page now
+	for (uint i = 0; i < page.glyphs.size(); ++i) {
+		GlyphMap::iterator glyph = _glyphs.find(page.glyphs[i]);
+		if (glyph != _glyphs.end() && glyph->_value.page == (int)index)
+			_glyphs.erase(glyph);
+	}
+
+	page.glyphs.clear();
+	page.shelves.clear();
+	page.usedHeight = 0;
+}
+
+void GlyphAtlas::releasePage(uint index) {
+	emptyPage(index);
+
+	_pageMemory -= _pages[index]->width * _pages[index]->height;
+	_numPages--;
+	if (_currentPage == (int)index)
+		_currentPage = -1;
+
+	delete[] _pages[index]->pixels;
+	delete _pages[index];
+	_pages[index] = nullptr;
+}
+
+uint GlyphAtlas::findLeastRecentlyUsedPage() const {
+	uint result = 0;
+	uint32 oldest = 0xFFFFFFFF;
+
+	for (uint i = 0; i < _pages.size(); ++i) {
+		if (_pages[i] && _pages[i]->lastUse <= oldest) {
+			oldest = _pages[i]->lastUse;
+			result = i;
+		}
+	}
+
+	return result;
+}
+
+} // End of namespace Graphics
@@ -0,0 +1,138 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef GRAPHICS_FONTS_GLYPHATLAS_H
+#define GRAPHICS_FONTS_GLYPHATLAS_H
+
+#include "common/array.h"
+#include "common/hashmap.h"
+#include "common/noncopyable.h"
+
+#include "graphics/surface.h"
+
+namespace Graphics {
+
+/**
+ * Cache for the coverage bitmaps of glyphs which fonts render on demand.
+ *
+ * The 8 bit bitmaps are packed row by row into shared pages instead of
+ * being allocated one by one. Once the pages would take more memory than
+ * the budget, the least recently used page is emptied and reused, which
+ * drops all glyphs stored on it. Fonts have to render those again the next
+ * time they are needed.
+ *
+ * Glyphs without pixels, e.g. spaces, are not stored on any page and never
+ * dropped.
+ */
+class GlyphAtlas : Common::NonCopyable {
+public:
+	enum {
+		kPageSize = 256,
+		kDefaultBudget = 1024 * 1024
+	};
+
+	struct Glyph {
+		Surface image;      ///< Coverage bitmap, pointing into the page it is stored on
+		int xOffset;        ///< Horizontal offset of the bitmap to the pen position
+		int yOffset;        ///< Vertical offset of the bitmap to the top of the line
+		int advance;        ///< Horizontal pen movement after the glyph
+		uint32 index;       ///< Font specific glyph index
+	};
+
+	GlyphAtlas(uint32 budget = kDefaultBudget);
+	~GlyphAtlas();
+
+	/**
+	 * Set the memory budget for the pages in bytes. At least one page is
+	 * always kept. Pages above the new budget are released right away.
+	 */
+	void setBudget(uint32 budget);
+	uint32 getBudget() const { return _budget; }
+
+	/** Return the memory currently allocated for pages in bytes. */
+	uint32 getPageMemory() const { return _pageMemory; }
+
+	/**
+	 * Look up a cached glyph and mark its page as recently used.
+	 *
+	 * @return The glyph, or nullptr if it is not cached. The pointer stays
+	 *         valid until the next call to insert() or clear().
+	 */
+	const Glyph *find(uint32 chr);
+
+	/**
+	 * Add a glyph with a bitmap of the given size, replacing any cached
+	 * glyph for @p chr. This may drop other glyphs to stay within the
+	 * budget.
+	 *
+	 * @return The new glyph, whose image is cleared to zero and has to be
+	 *         filled in by the caller along with the metrics.
+	 */
+	Glyph *insert(uint32 chr, int width, int height);
+
+	/** Drop all glyphs and release all pages. */
+	void clear();
+
+	/** Return the number of cached glyphs. */
+	uint size() const { return _glyphs.size(); }
+
+private:
+	/** A row of glyphs of about the same height */
+	struct Shelf {
+		int y, height;
+		int x;                  ///< Where the next glyph goes
+	};
+
+	struct Page {
+		byte *pixels;
+		int width, height;
+		int usedHeight;         ///< Height covered by the shelves
+		uint32 lastUse;
+		Common::Array<Shelf> shelves;
+		Common::Array<uint32> glyphs;
+	};
+
+	struct Entry {
+		Glyph glyph;
+		int page;               ///< Index into _pages, or -1 for glyphs without pixels
+	};
+
+	typedef Common::HashMap<uint32, Entry> GlyphMap;
+
+	static bool allocate(Page &page, int width, int height, int &x, int &y);
+	uint createPage(int width, int height);
+	uint allocateGlyph(int width, int height, int &x, int &y);
+	void emptyPage(uint index);
+	void releasePage(uint index);
+	uint findLeastRecentlyUsedPage() const;
+
+	GlyphMap _glyphs;
+	Common::Array<Page *> _pages; ///< Released pages leave a null entry, so that indices stay valid
+	uint _numPages;
+	int _currentPage;           ///< Page receiving new glyphs, or -1
+	uint32 _budget;
+	uint32 _pageMemory;
+	uint32 _useCounter;
+};
+
+} // End of namespace Graphics
+
+#endif
@@ -27,6 +27,7 @@
 #ifdef USE_FREETYPE2
 
 #include "graphics/fonts/ttf.h"
+#include "graphics/fonts/glyphatlas.h"
 #include "graphics/font.h"
 #include "graphics/surface.h"
 #include "graphics/managed_surface.h"
@@ -186,6 +187,12 @@ public:
 	void drawAlphaChar(Surface *dst, uint32 chr, int x, int y, uint32 color) const override;
 	void drawAlphaChar(ManagedSurface *dst, uint32 chr, int x, int y, uint32 color) const override;
 
+	void drawStrings(Surface *dst, const Common::Array<Common::U32String> &lines, int x, int y, int w, int lineHeight, uint32 color, TextAlign align) const override;
+	void drawStrings(ManagedSurface *dst, const Common::Array<Common::U32String> &lines, int x, int y, int w, int lineHeight, uint32 color, TextAlign align) const override;
+	void drawAlphaStrings(Surface *dst, const Common::Array<Common::U32String> &lines, int x, int y, int w, int lineHeight, uint32 color, TextAlign align) const override;
+
+	void setGlyphCacheBudget(uint32 bytes) override;
+
 private:
 	bool _initialized;
 	FT_StreamRec_ _stream;
@@ -197,18 +204,14 @@ private:
 	int _width, _height;
 	int _ascent, _descent;
 
-	struct Glyph {
-		Surface image;
-		int xOffset, yOffset;
-		int advance;
-		FT_UInt slot;
-	};
+	typedef GlyphAtlas::Glyph Glyph;
 
-	bool cacheGlyph(Glyph &glyph, uint32 chr) const;
-	typedef Common::HashMap<uint32, Glyph> GlyphCache;
-	mutable GlyphCache _glyphs;
-	bool _allowLateCaching;
-	void assureCached(uint32 chr) const;
+	const Glyph *getGlyph(uint32 chr) const;
+	bool cacheGlyph(uint32 chr, uint32 unicode) const;
+	mutable GlyphAtlas _glyphs;
+	// Characters of a fixed mapping, empty if any unicode character may be
+	// loaded. Kept to render glyphs again after they were dropped.
+	Common::Array<uint32> _mapping;
 
 	Common::SeekableReadStream *readTTFTable(FT_ULong tag) const;
 
@@ -217,6 +220,10 @@ private:
 	int computePointSizeFromHeaders(int height) const;
 	void drawCharIntern(Surface *dst, uint32 chr, int x, int y, uint32 color,
 		const uint32 *transparentColor, bool alpha) const;
+	void drawGlyph(Surface *dst, const Glyph &glyph, int x, int y, uint32 color,
+		const uint32 *transparentColor, bool alpha) const;
+	void drawStringsIntern(Surface *dst, const Common::Array<Common::U32String> &lines, int x, int y, int w, int lineHeight,
+		uint32 color, TextAlign align, const uint32 *transparentColor, bool alpha, Common::Array<Common::Rect> *dirtyRects) const;
 
 	FT_Int32 _loadFlags;
 	FT_Render_Mode _renderMode;
@@ -229,7 +236,7 @@ private:
 TTFFont::TTFFont()
 	: _initialized(false), _stream(), _face(), _ttfFile(0), _width(0), _height(0), _ascent(0),
 	  _descent(0), _glyphs(), _loadFlags(FT_LOAD_TARGET_NORMAL), _renderMode(FT_RENDER_MODE_NORMAL),
-	  _hasKerning(false), _allowLateCaching(false), _fakeBold(false), _fakeItalic(false),
+	  _hasKerning(false), _fakeBold(false), _fakeItalic(false),
 	  _disposeAfterUse(DisposeAfterUse::NO) {
 }
 
@@ -241,9 +248,6 @@ TTFFont::~TTFFont() {
 			delete _ttfFile;
 		_ttfFile = 0;
 
-		for (GlyphCache::iterator i = _glyphs.begin(), end = _glyphs.end(); i != end; ++i)
-			i->_value.image.free();
-
 		_initialized = false;
 	}
 }
@@ -375,27 +379,30 @@ bool TTFFont::load(Common::SeekableReadStream *ttfFile, DisposeAfterUse::Flag di
 		_loadFlags |= FT_LOAD_NO_BITMAP;
 	}
 
-	if (!mapping) {
-		// Allow loading of all unicode characters.
-		_allowLateCaching = true;
+	_glyphs.clear();
+	_mapping.clear();
+	uint numGlyphs = 0;
 
-		// Load all ISO-8859-1 characters.
+	if (!mapping) {
+		// Load all ISO-8859-1 characters, all other unicode characters are
+		// loaded when they are first used.
 		for (uint i = 0; i < 256; ++i) {
-			if (!cacheGlyph(_glyphs[i], i)) {
-				_glyphs.erase(i);
-			}
+			if (cacheGlyph(i, i))
+				++numGlyphs;
 		}
 	} else {
 		// We have a fixed map of characters do not load more later.
-		_allowLateCaching = false;
+		_mapping.resize(256);
 
 		for (uint i = 0; i < 256; ++i) {
 			const uint32 unicode = mapping[i] & 0x7FFFFFFF;
 			const bool isRequired = (mapping[i] & 0x80000000) != 0;
+			_mapping[i] = unicode;
 			// Check whether loading an important glyph fails and error out if
 			// that is the case.
-			if (!cacheGlyph(_glyphs[i], unicode)) {
-				_glyphs.erase(i);
+			if (cacheGlyph(i, unicode)) {
+				++numGlyphs;
+			} else {
 				if (isRequired) {
 					g_ttf.closeFont(_face);
 
@@ -408,7 +415,7 @@ bool TTFFont::load(Common::SeekableReadStream *ttfFile, DisposeAfterUse::Flag di
 		}
 	}
 
-	if (_glyphs.size() == 0) {
+	if (numGlyphs == 0) {
 		g_ttf.closeFont(_face);
 
 		// Don't delete ttfFile as we return fail
@@ -561,34 +568,30 @@ int TTFFont::getMaxCharWidth() const {
 }
 
 int TTFFont::getCharWidth(uint32 chr) const {
-	assureCached(chr);
-	GlyphCache::const_iterator glyphEntry = _glyphs.find(chr);
-	if (glyphEntry == _glyphs.end())
+	const Glyph *glyph = getGlyph(chr);
+	if (!glyph)
 		return 0;
 	else
-		return glyphEntry->_value.advance;
+		return glyph->advance;
 }
 
 int TTFFont::getKerningOffset(uint32 left, uint32 right) const {
 	if (!_hasKerning)
 		return 0;
 
-	assureCached(left);
-	assureCached(right);
-
 	FT_UInt leftGlyph, rightGlyph;
-	GlyphCache::const_iterator glyphEntry;
+	const Glyph *glyph;
 
-	glyphEntry = _glyphs.find(left);
-	if (glyphEntry != _glyphs.end()) {
-		leftGlyph = glyphEntry->_value.slot;
+	glyph = getGlyph(left);
+	if (glyph) {
+		leftGlyph = glyph->index;
 	} else {
 		return 0;
 	}
 
-	glyphEntry = _glyphs.find(right);
-	if (glyphEntry != _glyphs.end()) {
-		rightGlyph = glyphEntry->_value.slot;
+	glyph = getGlyph(right);
+	if (glyph) {
+		rightGlyph = glyph->index;
 	} else {
 		return 0;
 	}
@@ -602,18 +605,21 @@ int TTFFont::getKerningOffset(uint32 left, uint32 right) const {
 }
 
 Common::Rect TTFFont::getBoundingBox(uint32 chr) const {
-	assureCached(chr);
-	GlyphCache::const_iterator glyphEntry = _glyphs.find(chr);
-	if (glyphEntry == _glyphs.end()) {
+	const Glyph *glyph = getGlyph(chr);
+	if (!glyph) {
 		return Common::Rect();
 	} else {
-		const int xOffset = glyphEntry->_value.xOffset;
-		const int yOffset = glyphEntry->_value.yOffset;
-		const Graphics::Surface &image = glyphEntry->_value.image;
+		const int xOffset = glyph->xOffset;
+		const int yOffset = glyph->yOffset;
+		const Graphics::Surface &image = glyph->image;
 		return Common::Rect(xOffset, yOffset, xOffset + image.w, yOffset + image.h);
 	}
 }
 
+void TTFFont::setGlyphCacheBudget(uint32 bytes) {
+	_glyphs.setBudget(bytes);
+}
+
 namespace {
 
 template<typename ColorType>
@@ -623,6 +629,41 @@ static void renderGlyph(uint8 *dstPos, const int dstPitch, const uint8 *srcPos,
 	uint8 sA, sR, sG, sB;
 	dstFormat.colorToRGB(color, sR, sG, sB);
 
+	if (dstFormat.aBits() == 0) {
+		// Without a destination alpha channel this is a plain blend, which
+		// works fine in integer math.
+		for (int y = 0; y < h; ++y) {
+			ColorType *rDst = (ColorType *)dstPos;
+			const uint8 *src = srcPos;
+
+			for (int x = 0; x < w; ++x) {
+				if (*src == 255) {
+					*rDst = color;
+				} else if (*src) {
+					const uint a = *src, invA = 255 - a;
+
+					uint8 dR, dG, dB;
+					if (transparentColor && *rDst == *transparentColor) {
+						dR = dG = dB = 0;
+					} else {
+						dstFormat.colorToRGB(*rDst, dR, dG, dB);
+					}
+
+					*rDst = dstFormat.RGBToColor((sR * a + dR * invA) / 255,
+					                             (sG * a + dG * invA) / 255,
+					                             (sB * a + dB * invA) / 255);
+				}
+
+				++rDst;
+				++src;
+			}
+
+			dstPos += dstPitch;
+			srcPos += srcPitch;
+		}
+		return;
+	}
+
 	for (int y = 0; y < h; ++y) {
 		ColorType *rDst = (ColorType *)dstPos;
 		const uint8 *src = srcPos;
@@ -714,15 +755,108 @@ void TTFFont::drawAlphaChar(ManagedSurface *dst, uint32 chr, int x, int y, uint3
 	dst->addDirtyRect(charBox);
 }
 
+void TTFFont::drawStrings(Surface *dst, const Common::Array<Common::U32String> &lines, int x, int y, int w, int lineHeight, uint32 color, TextAlign align) const {
+	drawStringsIntern(dst, lines, x, y, w, lineHeight, color, align, nullptr, false, nullptr);
+}
+
+void TTFFont::drawStrings(ManagedSurface *dst, const Common::Array<Common::U32String> &lines, int x, int y, int w, int lineHeight, uint32 color, TextAlign align) const {
+	Common::Array<Common::Rect> dirtyRects;
+
+	if (dst->hasTransparentColor()) {
+		uint32 transColor = dst->getTransparentColor();
+		drawStringsIntern(dst->surfacePtr(), lines, x, y, w, lineHeight, color, align, &transColor, false, &dirtyRects);
+	} else {
+		drawStringsIntern(dst->surfacePtr(), lines, x, y, w, lineHeight, color, align, nullptr, false, &dirtyRects);
+	}
+
+	for (uint i = 0; i < dirtyRects.size(); ++i)
+		dst->addDirtyRect(dirtyRects[i]);
+}
+
+void TTFFont::drawAlphaStrings(Surface *dst, const Common::Array<Common::U32String> &lines, int x, int y, int w, int lineHeight, uint32 color, TextAlign align) const {
+	drawStringsIntern(dst, lines, x, y, w, lineHeight, color, align, nullptr, true, nullptr);
+}
+
+void TTFFont::drawStringsIntern(Surface *dst, const Common::Array<Common::U32String> &lines, int x, int y, int w, int lineHeight,
+		uint32 color, TextAlign align, const uint32 *transparentColor, bool alpha, Common::Array<Common::Rect> *dirtyRects) const {
+	// This follows drawStringImpl, but looks up the glyph of every character
+	// only twice: once to lay out the line and once to draw it.
+	assert(dst != 0);
+
+	const int leftX = x, rightX = x + w + 1;
+
+	// Kerning is applied between the character 0 and the first character,
+	// like getKerningOffset(0, cur) does in drawStringImpl.
+	const Glyph *nullGlyph = _hasKerning ? getGlyph(0) : nullptr;
+	const FT_UInt nullIndex = nullGlyph ? nullGlyph->index : 0;
+
+	Common::Array<int> positions;
+
+	for (uint i = 0; i < lines.size(); ++i, y += lineHeight) {
+		const Common::U32String &line = lines[i];
+		positions.resize(line.size());
+
+		int width = 0;
+		FT_UInt last = nullIndex;
+		for (uint j = 0; j < line.size(); ++j) {
+			const Glyph *glyph = getGlyph(line[j]);
+			const FT_UInt index = glyph ? glyph->index : 0;
+
+			if (_hasKerning && last && index) {
+				FT_Vector kerningVector;
+				FT_Get_Kerning(_face, last, index, FT_KERNING_DEFAULT, &kerningVector);
+				width += kerningVector.x / 64;
+			}
+			last = index;
+
+			positions[j] = width;
+			if (glyph)
+				width += glyph->advance;
+		}
+
+		int lineX = x;
+		if (align == kTextAlignCenter)
+			lineX += (w - width) / 2;
+		else if (align == kTextAlignRight)
+			lineX += w - width;
+
+		Common::Rect lineBox;
+		for (uint j = 0; j < line.size(); ++j) {
+			const Glyph *glyph = getGlyph(line[j]);
+			const int charX = lineX + positions[j];
+			const int charRight = glyph ? glyph->xOffset + glyph->image.w : 0;
+
+			if (charX + charRight > rightX)
+				break;
+
+			if (!glyph || charX + charRight < leftX)
+				continue;
+
+			drawGlyph(dst, *glyph, charX, y, color, transparentColor, alpha);
+
+			if (dirtyRects && glyph->image.w && glyph->image.h) {
+				const Common::Rect charBox(charX + glyph->xOffset, y + glyph->yOffset, charX + charRight, y + glyph->yOffset + glyph->image.h);
+				if (lineBox.isEmpty())
+					lineBox = charBox;
+				else
+					lineBox.extend(charBox);
+			}
+		}
+
+		if (dirtyRects && !lineBox.isEmpty())
+			dirtyRects->push_back(lineBox);
+	}
+}
+
 void TTFFont::drawCharIntern(Surface * dst, uint32 chr, int x, int y, uint32 color,
 		const uint32 *transparentColor, bool alpha) const {
-	assureCached(chr);
-	GlyphCache::const_iterator glyphEntry = _glyphs.find(chr);
-	if (glyphEntry == _glyphs.end())
-		return;
-
-	const Glyph &glyph = glyphEntry->_value;
+	const Glyph *glyph = getGlyph(chr);
+	if (glyph)
+		drawGlyph(dst, *glyph, x, y, color, transparentColor, alpha);
+}
 
+void TTFFont::drawGlyph(Surface *dst, const Glyph &glyph, int x, int y, uint32 color,
+		const uint32 *transparentColor, bool alpha) const {
 	x += glyph.xOffset;
 	y += glyph.yOffset;
 
@@ -800,13 +934,30 @@ void TTFFont::drawCharIntern(Surface * dst, uint32 chr, int x, int y, uint32 col
 	}
 }
 
-bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
-	FT_UInt slot = FT_Get_Char_Index(_face, chr);
+const TTFFont::Glyph *TTFFont::getGlyph(uint32 chr) const {
+	const Glyph *glyph = _glyphs.find(chr);
+	if (glyph)
+		return glyph;
+
+	if (_mapping.empty())
+		cacheGlyph(chr, chr);
+	else if (chr < _mapping.size())
+		cacheGlyph(chr, _mapping[chr]);
+	else
+		return nullptr;
+
+	return _glyphs.find(chr);
+}
+
+bool TTFFont::cacheGlyph(uint32 chr, uint32 unicode) const {
+	// Characters without a glyph are cached as empty glyphs, so that
+	// FreeType is not asked for them again.
+	_glyphs.insert(chr, 0, 0);
+
+	FT_UInt slot = FT_Get_Char_Index(_face, unicode);
 	if (!slot)
 		return false;
 
-	glyph.slot = slot;
-
 	// We use the light target and render mode to improve the looks of the
 	// glyphs. It is most noticeable in FreeSansBold.ttf, where otherwise the
 	// 't' glyph looks like it is cut off on the right side.
@@ -819,10 +970,10 @@ bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
 	if (_face->glyph->format != FT_GLYPH_FORMAT_BITMAP)
 		return false;
 
-	glyph.xOffset = _face->glyph->bitmap_left;
-	glyph.yOffset = _ascent - _face->glyph->bitmap_top;
+	const int xOffset = _face->glyph->bitmap_left;
+	const int yOffset = _ascent - _face->glyph->bitmap_top;
 
-	glyph.advance = ftCeil26_6(_face->glyph->advance.x);
+	int advance = ftCeil26_6(_face->glyph->advance.x);
 
 	const FT_Bitmap *bitmap;
 #if FAKE_BOLD == 1
@@ -832,7 +983,7 @@ bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
 	if (_fakeBold) {
 #if FAKE_BOLD >= 2
 		// Embolden by 1 pixel in x and 0 in y
-		glyph.advance += 1;
+		advance += 1;
 
 		if (FT_GlyphSlot_Own_Bitmap(_face->glyph))
 			return false;
@@ -849,7 +1000,7 @@ bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
 			return false;
 
 		// Embolden by 1 pixel in x and 0 in y
-		glyph.advance += 1;
+		advance += 1;
 
 		// That's 26.6 fixed-point units
 		if (FT_Bitmap_Embolden(_face->glyph->library, &ownBitmap, 1 << 6, 0))
@@ -864,8 +1015,16 @@ bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
 		bitmap = &_face->glyph->bitmap;
 	}
 
+	if (bitmap->pixel_mode != FT_PIXEL_MODE_MONO && bitmap->pixel_mode != FT_PIXEL_MODE_GRAY) {
+		warning("TTFFont::cacheGlyph: Unsupported pixel mode %d", bitmap->pixel_mode);
+		return false;
+	}
 
-	glyph.image.create(bitmap->width, bitmap->rows, PixelFormat::createFormatCLUT8());
+	Glyph *glyph = _glyphs.insert(chr, bitmap->width, bitmap->rows);
+	glyph->xOffset = xOffset;
+	glyph->yOffset = yOffset;
+	glyph->advance = advance;
+	glyph->index = slot;
 
 	const uint8 *src = bitmap->buffer;
 	int srcPitch = bitmap->pitch;
@@ -874,12 +1033,12 @@ bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
 		srcPitch = -srcPitch;
 	}
 
-	uint8 *dst = (uint8 *)glyph.image.getPixels();
+	uint8 *dst = (uint8 *)glyph->image.getPixels();
 
-	switch (bitmap->pixel_mode) {
-	case FT_PIXEL_MODE_MONO:
+	if (bitmap->pixel_mode == FT_PIXEL_MODE_MONO) {
 		for (int y = 0; y < (int)bitmap->rows; ++y) {
 			const uint8 *curSrc = src;
+			uint8 *curDst = dst;
 			uint8 mask = 0;
 
 			for (int x = 0; x < (int)bitmap->width; ++x) {
@@ -887,28 +1046,21 @@ bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
 					mask = *curSrc++;
 
 				if (mask & 0x80)
-					*dst = 255;
+					*curDst = 255;
 
 				mask <<= 1;
-				++dst;
+				++curDst;
 			}
 
+			dst += glyph->image.pitch;
 			src += srcPitch;
 		}
-		break;
-
-	case FT_PIXEL_MODE_GRAY:
+	} else {
 		for (int y = 0; y < (int)bitmap->rows; ++y) {
 			memcpy(dst, src, bitmap->width);
-			dst += glyph.image.pitch;
+			dst += glyph->image.pitch;
 			src += srcPitch;
 		}
-		break;
-
-	default:
-		warning("TTFFont::cacheGlyph: Unsupported pixel mode %d", bitmap->pixel_mode);
-		glyph.image.free();
-		return false;
 	}
 
 #if FAKE_BOLD == 1
@@ -920,17 +1072,6 @@ bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
 	return true;
 }
 
-void TTFFont::assureCached(uint32 chr) const {
-	if (!chr || !_allowLateCaching || _glyphs.contains(chr)) {
-		return;
-	}
-
-	Glyph newGlyph;
-	if (cacheGlyph(newGlyph, chr)) {
-		_glyphs[chr] = newGlyph;
-	}
-}
-
 Font *loadTTFFont(Common::SeekableReadStream *stream, DisposeAfterUse::Flag disposeAfterUse, int size, TTFSizeMode sizeMode, uint xdpi, uint ydpi, TTFRenderMode renderMode, const uint32 *mapping, bool stemDarkening) {
 	TTFFont *font = new TTFFont();
 
@@ -994,7 +1135,8 @@ Font *loadTTFFontFromArchive(const Common::String &filename, int size, TTFSizeMo
 		return nullptr;
 	}
 
-	// HACK: We currently assume that ZipArchive always loads the whole file into memory, so we can delete the archive here.
+	// Members of a ZipArchive keep the zip file open themselves, so FreeType
+	// can go on reading the font after the archive is gone.
 	delete archive;
 	return font;
 }
@@ -17,6 +17,7 @@ MODULE_OBJS := \
 	fonts/consolefont.o \
 	fonts/dosfont.o \
 	fonts/freetype.o \
+	fonts/glyphatlas.o \
 	fonts/macfont.o \
 	fonts/newfont_big.o \
 	fonts/newfont.o \
@@ -148,6 +149,7 @@ MODULE_OBJS += \
 	tinygl/zbuffer.o \
 	tinygl/zline.o \
 	tinygl/zmath.o \
+	tinygl/zspan.o \
 	tinygl/ztriangle.o \
 	tinygl/zblit.o \
 	tinygl/zdirtyrect.o
@@ -211,5 +213,20 @@ MODULE_OBJS += \
 	blit/blit-avx2.o
 endif
 
+ifdef USE_TINYGL
+ifdef SCUMMVM_NEON
+MODULE_OBJS += \
+	tinygl/zspan-neon.o
+endif
+ifdef SCUMMVM_SSE2
+MODULE_OBJS += \
+	tinygl/zspan-sse2.o
+endif
+ifdef SCUMMVM_AVX2
+MODULE_OBJS += \
+	tinygl/zspan-avx2.o
+endif
+endif
+
 # Include common rules
 include $(srcdir)/rules.mk
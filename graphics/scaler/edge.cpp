@@ -3618,6 +3618,8 @@ public:
 
 	bool canDrawCursor() const override { return false; }
 	bool useOldSource() const override { return true; }
+	// The old source buffers and the edge detection scratch state are shared
+	bool canScaleInParallel() const override { return false; }
 	uint extraPixels() const override { return 1; }
 	const char *getName() const override;
 	const char *getPrettyName() const override;
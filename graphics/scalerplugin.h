@@ -199,6 +199,14 @@ public:
 	 */
 	virtual bool useOldSource() const { return false; }
 
+	/**
+	 * Whether one scaler instance may scale several rects of the same
+	 * source at once from different threads, as long as the destination
+	 * rects do not overlap. Scalers which modify their own state while
+	 * scaling must return false.
+	 */
+	virtual bool canScaleInParallel() const { return true; }
+
 protected:
 	Common::Array<uint> _factors;
 };
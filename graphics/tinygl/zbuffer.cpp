@@ -33,6 +33,7 @@
 
 #include "graphics/tinygl/zbuffer.h"
 #include "graphics/tinygl/zgl.h"
+#include "graphics/tinygl/zspan.h"
 
 namespace TinyGL {
 
@@ -56,6 +57,8 @@ FrameBuffer::FrameBuffer(int width, int height, const Graphics::PixelFormat &for
 	_currentTexture = nullptr;
 
 	_clippingEnabled = false;
+
+	SpanKernels::selectKernels();
 }
 
 FrameBuffer::~FrameBuffer() {
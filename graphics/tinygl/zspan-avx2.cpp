@@ -0,0 +1,196 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#include "graphics/tinygl/zspan.h"
+#include "graphics/tinygl/zbuffer.h"
+
+#include <immintrin.h>
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("avx2"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+namespace TinyGL {
+
+static FORCEINLINE __m256i avx2_depthMask(int depthFunc, __m256i zSrc, __m256i zDst) {
+	// AVX2 only has signed comparisons, flip the sign bits to compare unsigned values
+	const __m256i sign = _mm256_set1_epi32((int)0x80000000);
+	const __m256i allOnes = _mm256_set1_epi32(-1);
+	const __m256i src = _mm256_xor_si256(zSrc, sign);
+	const __m256i dst = _mm256_xor_si256(zDst, sign);
+	switch (depthFunc) {
+	case TGL_LESS:
+		return _mm256_cmpgt_epi32(src, dst);
+	case TGL_EQUAL:
+		return _mm256_cmpeq_epi32(zDst, zSrc);
+	case TGL_LEQUAL:
+		return _mm256_xor_si256(_mm256_cmpgt_epi32(dst, src), allOnes);
+	case TGL_GREATER:
+		return _mm256_cmpgt_epi32(dst, src);
+	case TGL_NOTEQUAL:
+		return _mm256_xor_si256(_mm256_cmpeq_epi32(zDst, zSrc), allOnes);
+	case TGL_GEQUAL:
+		return _mm256_xor_si256(_mm256_cmpgt_epi32(src, dst), allOnes);
+	case TGL_ALWAYS:
+		return allOnes;
+	default:
+		return _mm256_setzero_si256();
+	}
+}
+
+static FORCEINLINE __m256i avx2_select(__m256i mask, __m256i a, __m256i b) {
+	return _mm256_or_si256(_mm256_and_si256(mask, a), _mm256_andnot_si256(mask, b));
+}
+
+static FORCEINLINE __m256i avx2_ramp(uint value, uint step) {
+	return _mm256_setr_epi32(value, value + step, value + 2 * step, value + 3 * step,
+	                         value + 4 * step, value + 5 * step, value + 6 * step, value + 7 * step);
+}
+
+static FORCEINLINE __m256i avx2_sat16To8(__m256i x) {
+	x = _mm256_srli_epi32(_mm256_add_epi32(x, _mm256_set1_epi32(128)), 8);
+	const __m256i inRange = _mm256_cmpeq_epi32(_mm256_srli_epi32(x, 8), _mm256_setzero_si256());
+	return avx2_select(inRange, x, _mm256_set1_epi32(0xFF));
+}
+
+static FORCEINLINE __m256i avx2_fpMul(__m256i a, __m256i b) {
+	// Both operands are below 256, so 16 bit multiplications are enough
+	const __m256i r = _mm256_mullo_epi16(a, b);
+	return _mm256_srli_epi32(_mm256_add_epi32(_mm256_add_epi32(r, _mm256_srli_epi32(r, 8)), _mm256_set1_epi32(127)), 8);
+}
+
+void SpanKernels::depthSpanAVX2(DepthSpan &span) {
+	if (!span.depthWrite) {
+		span.z += span.count * (uint)span.dzdx;
+		span.zbuf += span.count;
+		span.count = 0;
+		return;
+	}
+
+	const int count = span.count & ~7;
+	__m256i z = avx2_ramp(span.z, span.dzdx);
+	const __m256i dz = _mm256_set1_epi32((uint)span.dzdx * 8);
+	for (int i = 0; i < count; i += 8) {
+		const __m256i zDst = _mm256_loadu_si256((const __m256i *)(span.zbuf + i));
+		const __m256i mask = avx2_depthMask(span.depthFunc, z, zDst);
+		_mm256_storeu_si256((__m256i *)(span.zbuf + i), avx2_select(mask, z, zDst));
+		z = _mm256_add_epi32(z, dz);
+	}
+
+	span.z += count * (uint)span.dzdx;
+	span.zbuf += count;
+	span.count -= count;
+	depthSpanGeneric(span);
+}
+
+void SpanKernels::colorSpanAVX2(ColorSpan &span) {
+	const int count = span.count & ~7;
+	const __m256i ff = _mm256_set1_epi32(0xFF);
+	const __m128i aLoss = _mm_cvtsi32_si128(span.aLoss);
+	const __m128i aShift = _mm_cvtsi32_si128(span.aShift);
+	const __m128i rShift = _mm_cvtsi32_si128(span.rShift);
+	const __m128i gShift = _mm_cvtsi32_si128(span.gShift);
+	const __m128i bShift = _mm_cvtsi32_si128(span.bShift);
+	const __m256i opaque = _mm256_set1_epi32((0xFF >> span.aLoss) << span.aShift);
+
+	__m256i z = avx2_ramp(span.z, span.dzdx);
+	__m256i r = avx2_ramp(span.r, span.drdx);
+	__m256i g = avx2_ramp(span.g, span.dgdx);
+	__m256i b = avx2_ramp(span.b, span.dbdx);
+	__m256i a = avx2_ramp(span.a, span.dadx);
+	const __m256i dz = _mm256_set1_epi32((uint)span.dzdx * 8);
+	const __m256i dr = _mm256_set1_epi32((uint)span.drdx * 8);
+	const __m256i dg = _mm256_set1_epi32((uint)span.dgdx * 8);
+	const __m256i db = _mm256_set1_epi32((uint)span.dbdx * 8);
+	const __m256i da = _mm256_set1_epi32((uint)span.dadx * 8);
+
+	for (int i = 0; i < count; i += 8) {
+		const __m256i zDst = _mm256_loadu_si256((const __m256i *)(span.zbuf + i));
+		const __m256i mask = avx2_depthMask(span.depthFunc, z, zDst);
+
+		__m256i srcA, srcR, srcG, srcB;
+		if (span.texels) {
+			const __m256i texel = _mm256_loadu_si256((const __m256i *)(span.texels + i));
+			srcA = avx2_fpMul(avx2_sat16To8(a), _mm256_srli_epi32(texel, 24));
+			srcR = avx2_fpMul(avx2_sat16To8(r), _mm256_and_si256(_mm256_srli_epi32(texel, 16), ff));
+			srcG = avx2_fpMul(avx2_sat16To8(g), _mm256_and_si256(_mm256_srli_epi32(texel, 8), ff));
+			srcB = avx2_fpMul(avx2_sat16To8(b), _mm256_and_si256(texel, ff));
+		} else {
+			srcA = _mm256_and_si256(_mm256_srli_epi32(a, ZB_POINT_ALPHA_BITS - 8), ff);
+			srcR = _mm256_and_si256(_mm256_srli_epi32(r, ZB_POINT_RED_BITS - 8), ff);
+			srcG = _mm256_and_si256(_mm256_srli_epi32(g, ZB_POINT_GREEN_BITS - 8), ff);
+			srcB = _mm256_and_si256(_mm256_srli_epi32(b, ZB_POINT_BLUE_BITS - 8), ff);
+		}
+
+		const __m256i dst = _mm256_loadu_si256((const __m256i *)(span.pixels + i));
+		__m256i color;
+		if (!span.blending) {
+			color = _mm256_or_si256(_mm256_sll_epi32(_mm256_srl_epi32(srcA, aLoss), aShift), _mm256_sll_epi32(srcR, rShift));
+			color = _mm256_or_si256(color, _mm256_or_si256(_mm256_sll_epi32(srcG, gShift), _mm256_sll_epi32(srcB, bShift)));
+		} else {
+			const __m256i invA = _mm256_sub_epi32(ff, srcA);
+			const __m256i dstR = _mm256_and_si256(_mm256_srl_epi32(dst, rShift), ff);
+			const __m256i dstG = _mm256_and_si256(_mm256_srl_epi32(dst, gShift), ff);
+			const __m256i dstB = _mm256_and_si256(_mm256_srl_epi32(dst, bShift), ff);
+			const __m256i finalR = _mm256_add_epi32(_mm256_srli_epi32(_mm256_mullo_epi16(srcR, srcA), 8), _mm256_srli_epi32(_mm256_mullo_epi16(dstR, invA), 8));
+			const __m256i finalG = _mm256_add_epi32(_mm256_srli_epi32(_mm256_mullo_epi16(srcG, srcA), 8), _mm256_srli_epi32(_mm256_mullo_epi16(dstG, invA), 8));
+			const __m256i finalB = _mm256_add_epi32(_mm256_srli_epi32(_mm256_mullo_epi16(srcB, srcA), 8), _mm256_srli_epi32(_mm256_mullo_epi16(dstB, invA), 8));
+			color = _mm256_or_si256(opaque, _mm256_sll_epi32(_mm256_min_epi16(finalR, ff), rShift));
+			color = _mm256_or_si256(color, _mm256_sll_epi32(_mm256_min_epi16(finalG, ff), gShift));
+			color = _mm256_or_si256(color, _mm256_sll_epi32(_mm256_min_epi16(finalB, ff), bShift));
+		}
+
+		_mm256_storeu_si256((__m256i *)(span.pixels + i), avx2_select(mask, color, dst));
+		if (span.depthWrite)
+			_mm256_storeu_si256((__m256i *)(span.zbuf + i), avx2_select(mask, z, zDst));
+
+		z = _mm256_add_epi32(z, dz);
+		r = _mm256_add_epi32(r, dr);
+		g = _mm256_add_epi32(g, dg);
+		b = _mm256_add_epi32(b, db);
+		a = _mm256_add_epi32(a, da);
+	}
+
+	span.z += count * (uint)span.dzdx;
+	span.r += count * (uint)span.drdx;
+	span.g += count * (uint)span.dgdx;
+	span.b += count * (uint)span.dbdx;
+	span.a += count * (uint)span.dadx;
+	span.pixels += count;
+	span.zbuf += count;
+	if (span.texels)
+		span.texels += count;
+	span.count -= count;
+	colorSpanGeneric(span);
+}
+
+} // end of namespace TinyGL
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
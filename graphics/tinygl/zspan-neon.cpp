@@ -0,0 +1,196 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#ifdef SCUMMVM_NEON
+
+#include "graphics/tinygl/zspan.h"
+#include "graphics/tinygl/zbuffer.h"
+
+#include <arm_neon.h>
+
+#if !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("neon"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("fpu=neon")
+#endif
+
+#endif // !defined(__aarch64__) && !defined(__ARM_NEON)
+
+namespace TinyGL {
+
+static FORCEINLINE uint32x4_t neon_depthMask(int depthFunc, uint32x4_t zSrc, uint32x4_t zDst) {
+	switch (depthFunc) {
+	case TGL_LESS:
+		return vcltq_u32(zDst, zSrc);
+	case TGL_EQUAL:
+		return vceqq_u32(zDst, zSrc);
+	case TGL_LEQUAL:
+		return vcleq_u32(zDst, zSrc);
+	case TGL_GREATER:
+		return vcgtq_u32(zDst, zSrc);
+	case TGL_NOTEQUAL:
+		return vmvnq_u32(vceqq_u32(zDst, zSrc));
+	case TGL_GEQUAL:
+		return vcgeq_u32(zDst, zSrc);
+	case TGL_ALWAYS:
+		return vdupq_n_u32(0xFFFFFFFF);
+	default:
+		return vdupq_n_u32(0);
+	}
+}
+
+static FORCEINLINE uint32x4_t neon_ramp(uint value, uint step) {
+	const uint32 values[4] = { value, value + step, value + 2 * step, value + 3 * step };
+	return vld1q_u32(values);
+}
+
+static FORCEINLINE uint32x4_t neon_sat16To8(uint32x4_t x) {
+	return vminq_u32(vshrq_n_u32(vaddq_u32(x, vdupq_n_u32(128)), 8), vdupq_n_u32(0xFF));
+}
+
+static FORCEINLINE uint32x4_t neon_fpMul(uint32x4_t a, uint32x4_t b) {
+	const uint32x4_t r = vmulq_u32(a, b);
+	return vshrq_n_u32(vaddq_u32(vaddq_u32(r, vshrq_n_u32(r, 8)), vdupq_n_u32(127)), 8);
+}
+
+void SpanKernels::depthSpanNEON(DepthSpan &span) {
+	if (!span.depthWrite) {
+		span.z += span.count * (uint)span.dzdx;
+		span.zbuf += span.count;
+		span.count = 0;
+		return;
+	}
+
+	const int count = span.count & ~3;
+	uint32x4_t z = neon_ramp(span.z, span.dzdx);
+	const uint32x4_t dz = vdupq_n_u32((uint)span.dzdx * 4);
+	for (int i = 0; i < count; i += 4) {
+		const uint32x4_t zDst = vld1q_u32(span.zbuf + i);
+		const uint32x4_t mask = neon_depthMask(span.depthFunc, z, zDst);
+		vst1q_u32(span.zbuf + i, vbslq_u32(mask, z, zDst));
+		z = vaddq_u32(z, dz);
+	}
+
+	span.z += count * (uint)span.dzdx;
+	span.zbuf += count;
+	span.count -= count;
+	depthSpanGeneric(span);
+}
+
+void SpanKernels::colorSpanNEON(ColorSpan &span) {
+	const int count = span.count & ~3;
+	const uint32x4_t ff = vdupq_n_u32(0xFF);
+	const int32x4_t aLoss = vdupq_n_s32(-span.aLoss);
+	const int32x4_t aShift = vdupq_n_s32(span.aShift);
+	const int32x4_t rShift = vdupq_n_s32(span.rShift);
+	const int32x4_t gShift = vdupq_n_s32(span.gShift);
+	const int32x4_t bShift = vdupq_n_s32(span.bShift);
+	const uint32x4_t opaque = vdupq_n_u32((0xFF >> span.aLoss) << span.aShift);
+
+	uint32x4_t z = neon_ramp(span.z, span.dzdx);
+	uint32x4_t r = neon_ramp(span.r, span.drdx);
+	uint32x4_t g = neon_ramp(span.g, span.dgdx);
+	uint32x4_t b = neon_ramp(span.b, span.dbdx);
+	uint32x4_t a = neon_ramp(span.a, span.dadx);
+	const uint32x4_t dz = vdupq_n_u32((uint)span.dzdx * 4);
+	const uint32x4_t dr = vdupq_n_u32((uint)span.drdx * 4);
+	const uint32x4_t dg = vdupq_n_u32((uint)span.dgdx * 4);
+	const uint32x4_t db = vdupq_n_u32((uint)span.dbdx * 4);
+	const uint32x4_t da = vdupq_n_u32((uint)span.dadx * 4);
+
+	for (int i = 0; i < count; i += 4) {
+		const uint32x4_t zDst = vld1q_u32(span.zbuf + i);
+		const uint32x4_t mask = neon_depthMask(span.depthFunc, z, zDst);
+
+		uint32x4_t srcA, srcR, srcG, srcB;
+		if (span.texels) {
+			const uint32x4_t texel = vld1q_u32(span.texels + i);
+			srcA = neon_fpMul(neon_sat16To8(a), vshrq_n_u32(texel, 24));
+			srcR = neon_fpMul(neon_sat16To8(r), vandq_u32(vshrq_n_u32(texel, 16), ff));
+			srcG = neon_fpMul(neon_sat16To8(g), vandq_u32(vshrq_n_u32(texel, 8), ff));
+			srcB = neon_fpMul(neon_sat16To8(b), vandq_u32(texel, ff));
+		} else {
+			srcA = vandq_u32(vshrq_n_u32(a, ZB_POINT_ALPHA_BITS - 8), ff);
+			srcR = vandq_u32(vshrq_n_u32(r, ZB_POINT_RED_BITS - 8), ff);
+			srcG = vandq_u32(vshrq_n_u32(g, ZB_POINT_GREEN_BITS - 8), ff);
+			srcB = vandq_u32(vshrq_n_u32(b, ZB_POINT_BLUE_BITS - 8), ff);
+		}
+
+		const uint32x4_t dst = vld1q_u32(span.pixels + i);
+		uint32x4_t color;
+		if (!span.blending) {
+			color = vorrq_u32(vshlq_u32(vshlq_u32(srcA, aLoss), aShift), vshlq_u32(srcR, rShift));
+			color = vorrq_u32(color, vorrq_u32(vshlq_u32(srcG, gShift), vshlq_u32(srcB, bShift)));
+		} else {
+			const uint32x4_t invA = vsubq_u32(ff, srcA);
+			const uint32x4_t dstR = vandq_u32(vshlq_u32(dst, vnegq_s32(rShift)), ff);
+			const uint32x4_t dstG = vandq_u32(vshlq_u32(dst, vnegq_s32(gShift)), ff);
+			const uint32x4_t dstB = vandq_u32(vshlq_u32(dst, vnegq_s32(bShift)), ff);
+			const uint32x4_t finalR = vaddq_u32(vshrq_n_u32(vmulq_u32(srcR, srcA), 8), vshrq_n_u32(vmulq_u32(dstR, invA), 8));
+			const uint32x4_t finalG = vaddq_u32(vshrq_n_u32(vmulq_u32(srcG, srcA), 8), vshrq_n_u32(vmulq_u32(dstG, invA), 8));
+			const uint32x4_t finalB = vaddq_u32(vshrq_n_u32(vmulq_u32(srcB, srcA), 8), vshrq_n_u32(vmulq_u32(dstB, invA), 8));
+			color = vorrq_u32(opaque, vshlq_u32(vminq_u32(finalR, ff), rShift));
+			color = vorrq_u32(color, vshlq_u32(vminq_u32(finalG, ff), gShift));
+			color = vorrq_u32(color, vshlq_u32(vminq_u32(finalB, ff), bShift));
+		}
+
+		vst1q_u32(span.pixels + i, vbslq_u32(mask, color, dst));
+		if (span.depthWrite)
+			vst1q_u32(span.zbuf + i, vbslq_u32(mask, z, zDst));
+
+		z = vaddq_u32(z, dz);
+		r = vaddq_u32(r, dr);
+		g = vaddq_u32(g, dg);
+		b = vaddq_u32(b, db);
+		a = vaddq_u32(a, da);
+	}
+
+	span.z += count * (uint)span.dzdx;
+	span.r += count * (uint)span.drdx;
+	span.g += count * (uint)span.dgdx;
+	span.b += count * (uint)span.dbdx;
+	span.a += count * (uint)span.dadx;
+	span.pixels += count;
+	span.zbuf += count;
+	if (span.texels)
+		span.texels += count;
+	span.count -= count;
+	colorSpanGeneric(span);
+}
+
+} // end of namespace TinyGL
+
+#if !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif // !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#endif // SCUMMVM_NEON
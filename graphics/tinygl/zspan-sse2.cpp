@@ -0,0 +1,203 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#include "graphics/tinygl/zspan.h"
+#include "graphics/tinygl/zbuffer.h"
+
+#include <emmintrin.h>
+
+#if !defined(__x86_64__)
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("sse2"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("sse2")
+#endif
+
+#endif // !defined(__x86_64__)
+
+namespace TinyGL {
+
+static FORCEINLINE __m128i sse2_depthMask(int depthFunc, __m128i zSrc, __m128i zDst) {
+	// SSE2 only has signed comparisons, flip the sign bits to compare unsigned values
+	const __m128i sign = _mm_set1_epi32((int)0x80000000);
+	const __m128i allOnes = _mm_set1_epi32(-1);
+	const __m128i src = _mm_xor_si128(zSrc, sign);
+	const __m128i dst = _mm_xor_si128(zDst, sign);
+	switch (depthFunc) {
+	case TGL_LESS:
+		return _mm_cmplt_epi32(dst, src);
+	case TGL_EQUAL:
+		return _mm_cmpeq_epi32(zDst, zSrc);
+	case TGL_LEQUAL:
+		return _mm_xor_si128(_mm_cmpgt_epi32(dst, src), allOnes);
+	case TGL_GREATER:
+		return _mm_cmpgt_epi32(dst, src);
+	case TGL_NOTEQUAL:
+		return _mm_xor_si128(_mm_cmpeq_epi32(zDst, zSrc), allOnes);
+	case TGL_GEQUAL:
+		return _mm_xor_si128(_mm_cmplt_epi32(dst, src), allOnes);
+	case TGL_ALWAYS:
+		return allOnes;
+	default:
+		return _mm_setzero_si128();
+	}
+}
+
+static FORCEINLINE __m128i sse2_select(__m128i mask, __m128i a, __m128i b) {
+	return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+static FORCEINLINE __m128i sse2_ramp(uint value, uint step) {
+	return _mm_setr_epi32(value, value + step, value + 2 * step, value + 3 * step);
+}
+
+static FORCEINLINE __m128i sse2_sat16To8(__m128i x) {
+	x = _mm_srli_epi32(_mm_add_epi32(x, _mm_set1_epi32(128)), 8);
+	const __m128i inRange = _mm_cmpeq_epi32(_mm_srli_epi32(x, 8), _mm_setzero_si128());
+	return sse2_select(inRange, x, _mm_set1_epi32(0xFF));
+}
+
+static FORCEINLINE __m128i sse2_fpMul(__m128i a, __m128i b) {
+	// Both operands are below 256, so 16 bit multiplications are enough
+	const __m128i r = _mm_mullo_epi16(a, b);
+	return _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(r, _mm_srli_epi32(r, 8)), _mm_set1_epi32(127)), 8);
+}
+
+void SpanKernels::depthSpanSSE2(DepthSpan &span) {
+	if (!span.depthWrite) {
+		span.z += span.count * (uint)span.dzdx;
+		span.zbuf += span.count;
+		span.count = 0;
+		return;
+	}
+
+	const int count = span.count & ~3;
+	__m128i z = sse2_ramp(span.z, span.dzdx);
+	const __m128i dz = _mm_set1_epi32((uint)span.dzdx * 4);
+	for (int i = 0; i < count; i += 4) {
+		const __m128i zDst = _mm_loadu_si128((const __m128i *)(span.zbuf + i));
+		const __m128i mask = sse2_depthMask(span.depthFunc, z, zDst);
+		_mm_storeu_si128((__m128i *)(span.zbuf + i), sse2_select(mask, z, zDst));
+		z = _mm_add_epi32(z, dz);
+	}
+
+	span.z += count * (uint)span.dzdx;
+	span.zbuf += count;
+	span.count -= count;
+	depthSpanGeneric(span);
+}
+
+void SpanKernels::colorSpanSSE2(ColorSpan &span) {
+	const int count = span.count & ~3;
+	const __m128i ff = _mm_set1_epi32(0xFF);
+	const __m128i aLoss = _mm_cvtsi32_si128(span.aLoss);
+	const __m128i aShift = _mm_cvtsi32_si128(span.aShift);
+	const __m128i rShift = _mm_cvtsi32_si128(span.rShift);
+	const __m128i gShift = _mm_cvtsi32_si128(span.gShift);
+	const __m128i bShift = _mm_cvtsi32_si128(span.bShift);
+	const __m128i opaque = _mm_set1_epi32((0xFF >> span.aLoss) << span.aShift);
+
+	__m128i z = sse2_ramp(span.z, span.dzdx);
+	__m128i r = sse2_ramp(span.r, span.drdx);
+	__m128i g = sse2_ramp(span.g, span.dgdx);
+	__m128i b = sse2_ramp(span.b, span.dbdx);
+	__m128i a = sse2_ramp(span.a, span.dadx);
+	const __m128i dz = _mm_set1_epi32((uint)span.dzdx * 4);
+	const __m128i dr = _mm_set1_epi32((uint)span.drdx * 4);
+	const __m128i dg = _mm_set1_epi32((uint)span.dgdx * 4);
+	const __m128i db = _mm_set1_epi32((uint)span.dbdx * 4);
+	const __m128i da = _mm_set1_epi32((uint)span.dadx * 4);
+
+	for (int i = 0; i < count; i += 4) {
+		const __m128i zDst = _mm_loadu_si128((const __m128i *)(span.zbuf + i));
+		const __m128i mask = sse2_depthMask(span.depthFunc, z, zDst);
+
+		__m128i srcA, srcR, srcG, srcB;
+		if (span.texels) {
+			const __m128i texel = _mm_loadu_si128((const __m128i *)(span.texels + i));
+			srcA = sse2_fpMul(sse2_sat16To8(a), _mm_srli_epi32(texel, 24));
+			srcR = sse2_fpMul(sse2_sat16To8(r), _mm_and_si128(_mm_srli_epi32(texel, 16), ff));
+			srcG = sse2_fpMul(sse2_sat16To8(g), _mm_and_si128(_mm_srli_epi32(texel, 8), ff));
+			srcB = sse2_fpMul(sse2_sat16To8(b), _mm_and_si128(texel, ff));
+		} else {
+			srcA = _mm_and_si128(_mm_srli_epi32(a, ZB_POINT_ALPHA_BITS - 8), ff);
+			srcR = _mm_and_si128(_mm_srli_epi32(r, ZB_POINT_RED_BITS - 8), ff);
+			srcG = _mm_and_si128(_mm_srli_epi32(g, ZB_POINT_GREEN_BITS - 8), ff);
+			srcB = _mm_and_si128(_mm_srli_epi32(b, ZB_POINT_BLUE_BITS - 8), ff);
+		}
+
+		const __m128i dst = _mm_loadu_si128((const __m128i *)(span.pixels + i));
+		__m128i color;
+		if (!span.blending) {
+			color = _mm_or_si128(_mm_sll_epi32(_mm_srl_epi32(srcA, aLoss), aShift), _mm_sll_epi32(srcR, rShift));
+			color = _mm_or_si128(color, _mm_or_si128(_mm_sll_epi32(srcG, gShift), _mm_sll_epi32(srcB, bShift)));
+		} else {
+			const __m128i invA = _mm_sub_epi32(ff, srcA);
+			const __m128i dstR = _mm_and_si128(_mm_srl_epi32(dst, rShift), ff);
+			const __m128i dstG = _mm_and_si128(_mm_srl_epi32(dst, gShift), ff);
+			const __m128i dstB = _mm_and_si128(_mm_srl_epi32(dst, bShift), ff);
+			const __m128i finalR = _mm_add_epi32(_mm_srli_epi32(_mm_mullo_epi16(srcR, srcA), 8), _mm_srli_epi32(_mm_mullo_epi16(dstR, invA), 8));
+			const __m128i finalG = _mm_add_epi32(_mm_srli_epi32(_mm_mullo_epi16(srcG, srcA), 8), _mm_srli_epi32(_mm_mullo_epi16(dstG, invA), 8));
+			const __m128i finalB = _mm_add_epi32(_mm_srli_epi32(_mm_mullo_epi16(srcB, srcA), 8), _mm_srli_epi32(_mm_mullo_epi16(dstB, invA), 8));
+			color = _mm_or_si128(opaque, _mm_sll_epi32(_mm_min_epi16(finalR, ff), rShift));
+			color = _mm_or_si128(color, _mm_sll_epi32(_mm_min_epi16(finalG, ff), gShift));
+			color = _mm_or_si128(color, _mm_sll_epi32(_mm_min_epi16(finalB, ff), bShift));
+		}
+
+		_mm_storeu_si128((__m128i *)(span.pixels + i), sse2_select(mask, color, dst));
+		if (span.depthWrite)
+			_mm_storeu_si128((__m128i *)(span.zbuf + i), sse2_select(mask, z, zDst));
+
+		z = _mm_add_epi32(z, dz);
+		r = _mm_add_epi32(r, dr);
+		g = _mm_add_epi32(g, dg);
+		b = _mm_add_epi32(b, db);
+		a = _mm_add_epi32(a, da);
+	}
+
+	span.z += count * (uint)span.dzdx;
+	span.r += count * (uint)span.drdx;
+	span.g += count * (uint)span.dgdx;
+	span.b += count * (uint)span.dbdx;
+	span.a += count * (uint)span.dadx;
+	span.pixels += count;
+	span.zbuf += count;
+	if (span.texels)
+		span.texels += count;
+	span.count -= count;
+	colorSpanGeneric(span);
+}
+
+} // end of namespace TinyGL
+
+#if !defined(__x86_64__)
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif // !defined(__x86_64__)
@@ -0,0 +1,144 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/system.h"
+
+#include "graphics/tinygl/zspan.h"
+#include "graphics/tinygl/zbuffer.h"
+
+namespace TinyGL {
+
+SpanKernels::DepthSpanFunc SpanKernels::depthSpanFunc = nullptr;
+SpanKernels::ColorSpanFunc SpanKernels::colorSpanFunc = nullptr;
+
+void SpanKernels::selectKernels() {
+	if (depthSpanFunc && colorSpanFunc)
+		return;
+
+	depthSpanFunc = depthSpanGeneric;
+	colorSpanFunc = colorSpanGeneric;
+	if (!g_system)
+		return;
+#ifdef SCUMMVM_NEON
+	if (g_system->hasFeature(OSystem::kFeatureCpuNEON)) {
+		depthSpanFunc = depthSpanNEON;
+		colorSpanFunc = colorSpanNEON;
+	}
+#endif
+#ifdef SCUMMVM_SSE2
+	if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) {
+		depthSpanFunc = depthSpanSSE2;
+		colorSpanFunc = colorSpanSSE2;
+	}
+#endif
+#ifdef SCUMMVM_AVX2
+	if (g_system->hasFeature(OSystem::kFeatureCpuAVX2)) {
+		depthSpanFunc = depthSpanAVX2;
+		colorSpanFunc = colorSpanAVX2;
+	}
+#endif
+}
+
+// Same semantics as FrameBuffer::compareDepth()
+static FORCEINLINE bool testDepth(int depthFunc, uint zSrc, uint zDst) {
+	switch (depthFunc) {
+	case TGL_LESS:
+		return zDst < zSrc;
+	case TGL_EQUAL:
+		return zDst == zSrc;
+	case TGL_LEQUAL:
+		return zDst <= zSrc;
+	case TGL_GREATER:
+		return zDst > zSrc;
+	case TGL_NOTEQUAL:
+		return zDst != zSrc;
+	case TGL_GEQUAL:
+		return zDst >= zSrc;
+	case TGL_ALWAYS:
+		return true;
+	default:
+		return false;
+	}
+}
+
+static FORCEINLINE byte sat16To8(uint32 x) {
+	x = (x + 128) >> 8;
+	return (byte)(x | -!!(x >> 8));
+}
+
+static FORCEINLINE byte fpMul(byte a, byte b) {
+	uint32 r = a * b;
+	return (byte)((r + (r >> 8) + 127) >> 8);
+}
+
+void SpanKernels::depthSpanGeneric(DepthSpan &span) {
+	for (int i = 0; i < span.count; i++) {
+		if (span.depthWrite && testDepth(span.depthFunc, span.z, span.zbuf[i]))
+			span.zbuf[i] = span.z;
+		span.z += span.dzdx;
+	}
+	span.zbuf += span.count;
+	span.count = 0;
+}
+
+void SpanKernels::colorSpanGeneric(ColorSpan &span) {
+	for (int i = 0; i < span.count; i++) {
+		if (testDepth(span.depthFunc, span.z, span.zbuf[i])) {
+			byte a = span.a >> (ZB_POINT_ALPHA_BITS - 8);
+			byte r = span.r >> (ZB_POINT_RED_BITS - 8);
+			byte g = span.g >> (ZB_POINT_GREEN_BITS - 8);
+			byte b = span.b >> (ZB_POINT_BLUE_BITS - 8);
+			if (span.texels) {
+				const uint32 texel = span.texels[i];
+				a = fpMul(sat16To8(span.a), texel >> 24);
+				r = fpMul(sat16To8(span.r), (texel >> 16) & 0xFF);
+				g = fpMul(sat16To8(span.g), (texel >> 8) & 0xFF);
+				b = fpMul(sat16To8(span.b), texel & 0xFF);
+			}
+
+			if (span.depthWrite)
+				span.zbuf[i] = span.z;
+
+			if (!span.blending) {
+				span.pixels[i] = ((a >> span.aLoss) << span.aShift) | (r << span.rShift) | (g << span.gShift) | (b << span.bShift);
+			} else {
+				const uint32 dst = span.pixels[i];
+				const int finalR = ((r * a) >> 8) + ((((dst >> span.rShift) & 0xFF) * (255 - a)) >> 8);
+				const int finalG = ((g * a) >> 8) + ((((dst >> span.gShift) & 0xFF) * (255 - a)) >> 8);
+				const int finalB = ((b * a) >> 8) + ((((dst >> span.bShift) & 0xFF) * (255 - a)) >> 8);
+				span.pixels[i] = ((0xFF >> span.aLoss) << span.aShift) | (MIN(finalR, 255) << span.rShift) |
+				                 (MIN(finalG, 255) << span.gShift) | (MIN(finalB, 255) << span.bShift);
+			}
+		}
+		span.z += span.dzdx;
+		span.r += span.drdx;
+		span.g += span.dgdx;
+		span.b += span.dbdx;
+		span.a += span.dadx;
+	}
+	span.pixels += span.count;
+	span.zbuf += span.count;
+	if (span.texels)
+		span.texels += span.count;
+	span.count = 0;
+}
+
+} // end of namespace TinyGL
@@ -0,0 +1,102 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef GRAPHICS_TINYGL_ZSPAN_H
+#define GRAPHICS_TINYGL_ZSPAN_H
+
+#include "common/scummsys.h"
+
+namespace TinyGL {
+
+/**
+ * Kernels filling a horizontal run of pixels of a triangle. They cover the
+ * common cases of the rasterizer (no scissor, stencil, stipple, fog or
+ * alpha test, 32 bpp color buffer) and come in SIMD variants selected at
+ * runtime according to the CPU features.
+ *
+ * The kernels produce exactly the same output as the per pixel code in
+ * ztriangle.cpp. They consume the span: pointers and interpolants are
+ * advanced past the last pixel when they return.
+ */
+class SpanKernels {
+public:
+	struct DepthSpan {
+		uint *zbuf;
+		int count;
+
+		uint z;
+		int dzdx;
+
+		int depthFunc;   // TGL_ALWAYS when the depth test is disabled
+		bool depthWrite;
+	};
+
+	struct ColorSpan {
+		uint32 *pixels;
+		uint *zbuf;
+		const uint32 *texels; // 0xAARRGGBB texture colors modulated with the span color, may be nullptr
+		int count;
+
+		uint z;
+		int dzdx;
+		uint r, g, b, a; // same fixed point format as ZBufferPoint
+		int drdx, dgdx, dbdx, dadx;
+
+		int depthFunc;   // TGL_ALWAYS when the depth test is disabled
+		bool depthWrite;
+		bool blending;   // TGL_SRC_ALPHA, TGL_ONE_MINUS_SRC_ALPHA
+
+		// Color buffer format. The red, green and blue components must be 8 bits wide.
+		byte aLoss;
+		byte aShift, rShift, gShift, bShift;
+	};
+
+	typedef void (*DepthSpanFunc)(DepthSpan &span);
+	typedef void (*ColorSpanFunc)(ColorSpan &span);
+
+	static DepthSpanFunc depthSpanFunc;
+	static ColorSpanFunc colorSpanFunc;
+
+	/**
+	 * Select the fastest kernels supported by the CPU, unless they have
+	 * been selected already.
+	 */
+	static void selectKernels();
+
+	static void depthSpanGeneric(DepthSpan &span);
+	static void colorSpanGeneric(ColorSpan &span);
+#ifdef SCUMMVM_NEON
+	static void depthSpanNEON(DepthSpan &span);
+	static void colorSpanNEON(ColorSpan &span);
+#endif
+#ifdef SCUMMVM_SSE2
+	static void depthSpanSSE2(DepthSpan &span);
+	static void colorSpanSSE2(ColorSpan &span);
+#endif
+#ifdef SCUMMVM_AVX2
+	static void depthSpanAVX2(DepthSpan &span);
+	static void colorSpanAVX2(ColorSpan &span);
+#endif
+};
+
+} // end of namespace TinyGL
+
+#endif
@@ -29,6 +29,7 @@
 #include "graphics/tinygl/texelbuffer.h"
 #include "graphics/tinygl/zbuffer.h"
 #include "graphics/tinygl/zgl.h"
+#include "graphics/tinygl/zspan.h"
 
 namespace TinyGL {
 
@@ -45,6 +46,71 @@ static bool applyStipplePattern(int x, int y, const byte *stipple) {
 	return (stipple[byteIndex] & bitmask);
 }
 
+// Clip a span of count pixels starting at (x, y) to the scissor rectangle.
+// Returns the number of leading pixels to skip, and updates count.
+static FORCEINLINE int clipSpan(const Common::Rect *clip, int x, int y, int &count) {
+	if (!clip)
+		return 0;
+	if (y < clip->top || y >= clip->bottom) {
+		count = 0;
+		return 0;
+	}
+	const int skip = MAX<int>(clip->left - x, 0);
+	count = MIN<int>(x + count, clip->right) - x - skip;
+	return skip;
+}
+
+static void fillDepthSpan(SpanKernels::DepthSpan &span, const Common::Rect *clip, int x, int y,
+                          uint *pz, int count, uint z) {
+	const int skip = clipSpan(clip, x, y, count);
+	if (count <= 0)
+		return;
+	span.zbuf = pz + skip;
+	span.count = count;
+	span.z = z + skip * (uint)span.dzdx;
+	SpanKernels::depthSpanFunc(span);
+}
+
+static void fillColorSpan(SpanKernels::ColorSpan &span, const Common::Rect *clip, int x, int y,
+                          uint32 *pixels, uint *pz, const uint32 *texels, int count,
+                          uint z, uint r, uint g, uint b, uint a) {
+	const int skip = clipSpan(clip, x, y, count);
+	if (count <= 0)
+		return;
+	span.pixels = pixels + skip;
+	span.zbuf = pz + skip;
+	span.texels = texels ? texels + skip : nullptr;
+	span.count = count;
+	span.z = z + skip * (uint)span.dzdx;
+	span.r = r + skip * (uint)span.drdx;
+	span.g = g + skip * (uint)span.dgdx;
+	span.b = b + skip * (uint)span.dbdx;
+	span.a = a + skip * (uint)span.dadx;
+	SpanKernels::colorSpanFunc(span);
+}
+
+// Fetch the texels of a span, then let the span kernel modulate and write them.
+static void fillTextureSpan(SpanKernels::ColorSpan &span, const Common::Rect *clip, int x, int y,
+                            const TexelBuffer *texture, uint wrap_s, uint wrap_t,
+                            uint32 *pixels, uint *pz, int count, uint &z, int &s, int &t,
+                            uint &r, uint &g, uint &b, uint &a, int dsdx, int dtdx) {
+	uint32 texels[NB_INTERP];
+	for (int i = 0; i < count; i++) {
+		uint8 c_a, c_r, c_g, c_b;
+		texture->getARGBAt(wrap_s, wrap_t, s, t, c_a, c_r, c_g, c_b);
+		texels[i] = (c_a << 24) | (c_r << 16) | (c_g << 8) | c_b;
+		s += dsdx;
+		t += dtdx;
+	}
+
+	fillColorSpan(span, clip, x, y, pixels, pz, texels, count, z, r, g, b, a);
+	z += count * (uint)span.dzdx;
+	r += count * (uint)span.drdx;
+	g += count * (uint)span.dgdx;
+	b += count * (uint)span.dbdx;
+	a += count * (uint)span.dadx;
+}
+
 template <bool kDepthWrite, bool kSmoothMode, bool kFogMode, bool kEnableAlphaTest, bool kEnableScissor, bool kEnableBlending, bool kStencilEnabled, bool kDepthTestEnabled>
 void FrameBuffer::putPixelNoTexture(int fbOffset, uint *pz, byte *ps, int _a,
                                     int x, int y, uint &z, uint &r, uint &g, uint &b, uint &a,
@@ -349,6 +415,36 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 		polyOffset = -m * _offsetFactor + -_offsetUnits * (1 << 6);
 	}
 
+	// The span kernels handle the common cases on 32 bpp color buffers.
+	const bool useSpanKernels = kInterpZ && !kStencilEnabled;
+	const bool useColorSpanKernels = useSpanKernels && !kFogMode && !kAlphaTestEnabled && !stippleEnabled &&
+		_pbufBpp == 4 && _pbufFormat.rLoss == 0 && _pbufFormat.gLoss == 0 && _pbufFormat.bLoss == 0 &&
+		(!kBlendingEnabled || (_sourceBlendingFactor == TGL_SRC_ALPHA && _destinationBlendingFactor == TGL_ONE_MINUS_SRC_ALPHA));
+	const bool useTextureSpanKernels = useColorSpanKernels && colorMode == ColorMode::Default;
+	const Common::Rect *spanClip = kEnableScissor ? &_clipRectangle : nullptr;
+	SpanKernels::DepthSpan depthSpan;
+	SpanKernels::ColorSpan colorSpan;
+	if (useSpanKernels) {
+		depthSpan.dzdx = dzdx;
+		depthSpan.depthFunc = kDepthTestEnabled ? _depthFunc : TGL_ALWAYS;
+		depthSpan.depthWrite = kDepthWrite;
+	}
+	if (useColorSpanKernels) {
+		colorSpan.dzdx = dzdx;
+		colorSpan.drdx = drdx;
+		colorSpan.dgdx = dgdx;
+		colorSpan.dbdx = dbdx;
+		colorSpan.dadx = dadx;
+		colorSpan.depthFunc = kDepthTestEnabled ? _depthFunc : TGL_ALWAYS;
+		colorSpan.depthWrite = kDepthWrite;
+		colorSpan.blending = kBlendingEnabled;
+		colorSpan.aLoss = _pbufFormat.aLoss;
+		colorSpan.aShift = _pbufFormat.aShift;
+		colorSpan.rShift = _pbufFormat.rShift;
+		colorSpan.gShift = _pbufFormat.gShift;
+		colorSpan.bShift = _pbufFormat.bShift;
+	}
+
 	// screen coordinates
 
 	int pp1 = _pbufWidth * p0->y;
@@ -496,6 +592,10 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 				if (kStencilEnabled) {
 					ps = ps1 + x1;
 				}
+				if (useSpanKernels) {
+					fillDepthSpan(depthSpan, spanClip, x, y, pz, n + 1, z);
+					n = -1;
+				}
 				while (n >= 3) {
 					putPixelDepth<kDepthWrite, kEnableScissor, kStencilEnabled, kDepthTestEnabled>(pz, ps, 0, x, y, z, dzdx, stippleEnabled);
 					putPixelDepth<kDepthWrite, kEnableScissor, kStencilEnabled, kDepthTestEnabled>(pz, ps, 1, x, y, z, dzdx, stippleEnabled);
@@ -542,6 +642,10 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 				if (kStencilEnabled) {
 					ps = ps1 + x1;
 				}
+				if (useColorSpanKernels) {
+					fillColorSpan(colorSpan, spanClip, x, y, (uint32 *)_pbuf + pp, pz, nullptr, n + 1, z, r, g, b, a);
+					n = -1;
+				}
 				while (n >= 3) {
 					putPixelNoTexture<kDepthWrite, kSmoothMode, kFogMode, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled, kStencilEnabled, kDepthTestEnabled>
 					                 (pp, pz, ps, 0, x, y, z, r, g, b, a, dzdx, drdx, dgdx, dbdx, dadx, fog, fog_r, fog_g, fog_b, dfdx, stippleEnabled);
@@ -616,9 +720,13 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 						fz += fndzdx;
 						zinv = (float)(1.0 / fz);
 					}
-					for (int _a = 0; _a < NB_INTERP; _a++) {
-						putPixelTexture<kDepthWrite, kSmoothMode, kFogMode, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled, kStencilEnabled, kDepthTestEnabled>
-						               (pp, texture, colorMode, _wrapS, _wrapT, pz, ps, _a, x, y, z, t, s, r, g, b, a, dzdx, dsdx, dtdx, drdx, dgdx, dbdx, dadx, fog, fog_r, fog_g, fog_b, dfdx);
+					if (useTextureSpanKernels) {
+						fillTextureSpan(colorSpan, spanClip, x, y, texture, _wrapS, _wrapT, (uint32 *)_pbuf + pp, pz, NB_INTERP, z, s, t, r, g, b, a, dsdx, dtdx);
+					} else {
+						for (int _a = 0; _a < NB_INTERP; _a++) {
+							putPixelTexture<kDepthWrite, kSmoothMode, kFogMode, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled, kStencilEnabled, kDepthTestEnabled>
+							               (pp, texture, colorMode, _wrapS, _wrapT, pz, ps, _a, x, y, z, t, s, r, g, b, a, dzdx, dsdx, dtdx, drdx, dgdx, dbdx, dadx, fog, fog_r, fog_g, fog_b, dfdx);
+						}
 					}
 					pp += NB_INTERP;
 					if (kInterpZ) {
@@ -643,6 +751,12 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 					dtdx = (int)((dtzdx - tt * fdzdx) * zinv);
 				}
 
+				if (useTextureSpanKernels) {
+					if (n >= 0)
+						fillTextureSpan(colorSpan, spanClip, x, y, texture, _wrapS, _wrapT, (uint32 *)_pbuf + pp, pz, n + 1, z, s, t, r, g, b, a, dsdx, dtdx);
+					n = -1;
+				}
+
 				while (n >= 0) {
 					putPixelTexture<kDepthWrite, kSmoothMode, kFogMode, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled, kStencilEnabled, kDepthTestEnabled>
 					               (pp, texture, colorMode, _wrapS, _wrapT, pz, ps, 0, x, y, z, t, s, r, g, b, a, dzdx, dsdx, dtdx, drdx, dgdx, dbdx, dadx, fog, fog_r, fog_g, fog_b, dfdx);
@@ -0,0 +1,134 @@
+#include <cxxtest/TestSuite.h>
+#include "test/instrset_detect.h"
+
+#include "common/array.h"
+
+#include "audio/mixbus.h"
+
+// the SIMD kernels must produce exactly the same bus contents and
+// output samples as the generic ones
+
+class MixBusTestSuite : public CxxTest::TestSuite {
+	struct Kernels {
+		const char *name;
+		Audio::MixBus::AccumulateStereoFunc accumulateStereo;
+		Audio::MixBus::AccumulateMonoToStereoFunc accumulateMonoToStereo;
+		Audio::MixBus::AccumulateMonoFunc accumulateMono;
+		Audio::MixBus::PeakFunc peak;
+		Audio::MixBus::OutputFunc output;
+	};
+
+	// Odd, so that the kernels also have to handle a tail
+	static const uint kFrames = 203;
+
+	Common::Array<Kernels> _kernels;
+	uint32 _seed;
+
+	int16 _samples[kFrames * 2];
+	float _bus[kFrames * 2];
+
+	uint32 nextRandom() {
+		_seed = _seed * 1103515245 + 12345;
+		return (_seed >> 16) | (_seed << 16);
+	}
+
+	void randomize() {
+		for (uint i = 0; i < kFrames * 2; i++) {
+			_samples[i] = (int16)nextRandom();
+			// Several loud streams, so the output has to be clipped
+			_bus[i] = (float)((int)(nextRandom() % 200000) - 100000) / 3.0f;
+		}
+		_samples[0] = -32768;
+		_samples[1] = 32767;
+	}
+
+public:
+	void setUp() {
+		_seed = 1;
+		_kernels.clear();
+		const Kernels generic = { "generic",
+			Audio::MixBus::accumulateStereoGeneric, Audio::MixBus::accumulateMonoToStereoGeneric,
+			Audio::MixBus::accumulateMonoGeneric, Audio::MixBus::peakGeneric, Audio::MixBus::outputGeneric };
+		_kernels.push_back(generic);
+#ifdef SCUMMVM_NEON
+		const Kernels neon = { "NEON",
+			Audio::MixBus::accumulateStereoNEON, Audio::MixBus::accumulateMonoToStereoNEON,
+			Audio::MixBus::accumulateMonoNEON, Audio::MixBus::peakNEON, Audio::MixBus::outputNEON };
+		_kernels.push_back(neon);
+#endif
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2) {
+			const Kernels sse2 = { "SSE2",
+				Audio::MixBus::accumulateStereoSSE2, Audio::MixBus::accumulateMonoToStereoSSE2,
+				Audio::MixBus::accumulateMonoSSE2, Audio::MixBus::peakSSE2, Audio::MixBus::outputSSE2 };
+			_kernels.push_back(sse2);
+		}
+#endif
+	}
+
+	void test_accumulate() {
+		// Gains are multiples of 1/256 like the mixer volumes
+		static const float gains[][2] = {
+			{ 1.0f, 1.0f }, { 0.5f, 0.25f }, { 0.0f, 255.0f / 256 }, { 37.0f / 256, 1.0f }
+		};
+
+		for (int round = 0; round < ARRAYSIZE(gains); round++) {
+			const float gainL = gains[round][0], gainR = gains[round][1];
+			randomize();
+
+			float stereoRef[kFrames * 2], monoToStereoRef[kFrames * 2], monoRef[kFrames];
+			memcpy(stereoRef, _bus, sizeof(stereoRef));
+			memcpy(monoToStereoRef, _bus, sizeof(monoToStereoRef));
+			memcpy(monoRef, _bus, sizeof(monoRef));
+			Audio::MixBus::accumulateStereoGeneric(stereoRef, _samples, kFrames, gainL, gainR);
+			Audio::MixBus::accumulateMonoToStereoGeneric(monoToStereoRef, _samples, kFrames, gainL, gainR);
+			Audio::MixBus::accumulateMonoGeneric(monoRef, _samples, kFrames, gainL);
+
+			for (uint k = 1; k < _kernels.size(); k++) {
+				// Also start at an odd sample, to check unaligned access
+				for (uint offset = 0; offset < 2; offset++) {
+					float result[kFrames * 2];
+					memcpy(result, _bus, sizeof(result));
+					_kernels[k].accumulateStereo(result + offset * 2, _samples + offset * 2, kFrames - offset, gainL, gainR);
+					TSM_ASSERT(_kernels[k].name, memcmp(result + offset * 2, stereoRef + offset * 2, (kFrames - offset) * 2 * sizeof(float)) == 0);
+
+					memcpy(result, _bus, sizeof(result));
+					_kernels[k].accumulateMonoToStereo(result + offset * 2, _samples + offset, kFrames - offset, gainL, gainR);
+					TSM_ASSERT(_kernels[k].name, memcmp(result + offset * 2, monoToStereoRef + offset * 2, (kFrames - offset) * 2 * sizeof(float)) == 0);
+
+					memcpy(result, _bus, sizeof(result));
+					_kernels[k].accumulateMono(result + offset, _samples + offset, kFrames - offset, gainL);
+					TSM_ASSERT(_kernels[k].name, memcmp(result + offset, monoRef + offset, (kFrames - offset) * sizeof(float)) == 0);
+				}
+			}
+		}
+	}
+
+	void test_output() {
+		static const float gains[] = { 1.0f, 0.75f, 0.3333f };
+
+		for (int round = 0; round < ARRAYSIZE(gains); round++) {
+			randomize();
+			// Values exactly between two integers round to even
+			_bus[2] = 2.5f;
+			_bus[3] = -3.5f;
+
+			int16 ref[kFrames * 2];
+			Audio::MixBus::outputGeneric(ref, _bus, kFrames * 2, gains[round]);
+			if (gains[round] == 1.0f) {
+				TS_ASSERT_EQUALS(ref[2], 2);
+				TS_ASSERT_EQUALS(ref[3], -4);
+			}
+
+			const float refPeak = Audio::MixBus::peakGeneric(_bus, kFrames * 2);
+			TS_ASSERT(refPeak > 32768.0f);
+
+			for (uint k = 1; k < _kernels.size(); k++) {
+				int16 result[kFrames * 2];
+				_kernels[k].output(result, _bus, kFrames * 2, gains[round]);
+				TSM_ASSERT(_kernels[k].name, memcmp(result, ref, sizeof(result)) == 0);
+				TSM_ASSERT_EQUALS(_kernels[k].name, _kernels[k].peak(_bus + 1, kFrames * 2 - 1), Audio::MixBus::peakGeneric(_bus + 1, kFrames * 2 - 1));
+			}
+		}
+	}
+};
@@ -0,0 +1,431 @@
+#include <cxxtest/TestSuite.h>
+#include "test/instrset_detect.h"
+
+#include "audio/mixer_intern.h"
+#include "audio/mixbus.h"
+#include "audio/sinc.h"
+#include "audio/decoders/raw.h"
+
+#include "common/debug.h"
+#include "common/memstream.h"
+#include "common/system.h"
+#include "common/thread.h"
+
+#include "../system/null_osystem.h"
+
+#if NULL_OSYSTEM_IS_AVAILABLE
+#define BENCHMARK_TIME 1
+#else
+#define BENCHMARK_TIME 0
+#endif
+
+class MixerTestSuite : public CxxTest::TestSuite {
+	enum {
+		kRate = 22050,
+		kFrames = 512
+	};
+
+	int16 _buffer[kFrames * 2];
+
+	// A mono stream of the given length where every sample is 'value'
+	static Audio::AudioStream *createConstStream(int16 value, uint samples) {
+		int16 *data = (int16 *)malloc(samples * sizeof(int16));
+		for (uint i = 0; i < samples; i++)
+			data[i] = value;
+		Common::SeekableReadStream *stream = new Common::MemoryReadStream((const byte *)data, samples * sizeof(int16), DisposeAfterUse::YES);
+		return Audio::makeRawStream(stream, kRate, Audio::FLAG_16BITS | FLAG_NATIVE);
+	}
+
+	// A looping stream of noise, which is 'frames' long
+	static Audio::AudioStream *createNoiseStream(uint rate, bool stereo, uint frames, uint32 seed) {
+		const uint samples = frames * (stereo ? 2 : 1);
+		int16 *data = (int16 *)malloc(samples * sizeof(int16));
+		for (uint i = 0; i < samples; i++) {
+			seed = seed * 1103515245 + 12345;
+			data[i] = (int16)((seed >> 16) & 0x1FFF) - 0x1000;
+		}
+		Common::SeekableReadStream *stream = new Common::MemoryReadStream((const byte *)data, samples * sizeof(int16), DisposeAfterUse::YES);
+		return Audio::makeLoopingAudioStream(Audio::makeRawStream(stream, rate, Audio::FLAG_16BITS | FLAG_NATIVE | (stereo ? Audio::FLAG_STEREO : 0)), 0);
+	}
+
+	int mix(Audio::MixerImpl &mixer) {
+		return mixer.mixCallback((byte *)_buffer, sizeof(_buffer));
+	}
+
+	// The mixer would ask the null OSystem for the CPU features otherwise
+	static void useGenericKernels() {
+		Audio::SincFilter::filter = Audio::SincFilter::filterGeneric;
+		Audio::MixBus::accumulateStereo = Audio::MixBus::accumulateStereoGeneric;
+		Audio::MixBus::accumulateMonoToStereo = Audio::MixBus::accumulateMonoToStereoGeneric;
+		Audio::MixBus::accumulateMono = Audio::MixBus::accumulateMonoGeneric;
+		Audio::MixBus::peak = Audio::MixBus::peakGeneric;
+		Audio::MixBus::output = Audio::MixBus::outputGeneric;
+	}
+
+#ifdef SCUMM_LITTLE_ENDIAN
+	static const byte FLAG_NATIVE = Audio::FLAG_LITTLE_ENDIAN;
+#else
+	static const byte FLAG_NATIVE = 0;
+#endif
+
+public:
+	void setUp() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+#endif
+		useGenericKernels();
+	}
+
+	void tearDown() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::uninstall_null_g_system();
+#endif
+	}
+
+	void test_handle_state() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Audio::MixerImpl impl(kRate);
+		Audio::Mixer &mixer = impl;
+		impl.setReady(true);
+
+		// Sounds can be queried before they were ever mixed
+		Audio::SoundHandle handle;
+		mixer.playStream(Audio::Mixer::kSFXSoundType, &handle, createConstStream(1000, kRate), 5, 100, -20);
+		TS_ASSERT(mixer.isSoundHandleActive(handle));
+		TS_ASSERT(mixer.isSoundIDActive(5));
+		TS_ASSERT_EQUALS(mixer.getSoundID(handle), 5);
+		TS_ASSERT_EQUALS(mixer.getChannelVolume(handle), 100);
+		TS_ASSERT_EQUALS(mixer.getChannelBalance(handle), -20);
+		TS_ASSERT_EQUALS(mixer.getChannelRate(handle), (uint32)kRate);
+		TS_ASSERT(mixer.hasActiveChannelOfType(Audio::Mixer::kSFXSoundType));
+		TS_ASSERT(!mixer.hasActiveChannelOfType(Audio::Mixer::kMusicSoundType));
+
+		mixer.setChannelRate(handle, 11025);
+		TS_ASSERT_EQUALS(mixer.getChannelRate(handle), 11025u);
+		mixer.resetChannelRate(handle);
+		TS_ASSERT_EQUALS(mixer.getChannelRate(handle), (uint32)kRate);
+
+		// A sound with the same id is rejected
+		Audio::SoundHandle duplicate;
+		mixer.playStream(Audio::Mixer::kSFXSoundType, &duplicate, createConstStream(1000, kRate), 5);
+		TS_ASSERT(!mixer.isSoundHandleActive(duplicate));
+
+		TS_ASSERT(mix(impl) > 0);
+		TS_ASSERT(mixer.isSoundHandleActive(handle));
+
+		// Stopping takes effect immediately
+		mixer.stopHandle(handle);
+		TS_ASSERT(!mixer.isSoundHandleActive(handle));
+		TS_ASSERT(!mixer.isSoundIDActive(5));
+		TS_ASSERT_EQUALS(mixer.getChannelVolume(handle), 0);
+		TS_ASSERT_EQUALS(mix(impl), 0);
+#endif
+	}
+
+	void test_finished_sound() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Audio::MixerImpl impl(kRate);
+		Audio::Mixer &mixer = impl;
+		impl.setReady(true);
+
+		Audio::SoundHandle handle;
+		mixer.playStream(Audio::Mixer::kSFXSoundType, &handle, createConstStream(1000, kFrames / 2));
+		TS_ASSERT_EQUALS(mix(impl), kFrames / 2);
+		TS_ASSERT(mixer.isSoundHandleActive(handle));
+
+		// The channel is reaped by the next callback
+		mix(impl);
+		TS_ASSERT(!mixer.isSoundHandleActive(handle));
+
+		// Its slot can be reused, without the old handle coming back
+		Audio::SoundHandle next;
+		mixer.playStream(Audio::Mixer::kSFXSoundType, &next, createConstStream(1000, kRate));
+		TS_ASSERT(mixer.isSoundHandleActive(next));
+		TS_ASSERT(!mixer.isSoundHandleActive(handle));
+#endif
+	}
+
+	void test_channel_changes() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Audio::MixerImpl impl(kRate);
+		Audio::Mixer &mixer = impl;
+		impl.setReady(true);
+
+		Audio::SoundHandle handle;
+		mixer.playStream(Audio::Mixer::kSFXSoundType, &handle, createConstStream(8000, kRate));
+		mix(impl);
+		TS_ASSERT(_buffer[0] != 0);
+
+		mixer.setChannelVolume(handle, 0);
+		mix(impl);
+		TS_ASSERT_EQUALS(_buffer[0], 0);
+
+		mixer.setChannelVolume(handle, Audio::Mixer::kMaxChannelVolume);
+		mixer.muteSoundType(Audio::Mixer::kSFXSoundType, true);
+		mix(impl);
+		TS_ASSERT_EQUALS(_buffer[0], 0);
+
+		mixer.muteSoundType(Audio::Mixer::kSFXSoundType, false);
+		mixer.pauseHandle(handle, true);
+		TS_ASSERT_EQUALS(mix(impl), 0);
+		mixer.pauseHandle(handle, false);
+		mix(impl);
+		TS_ASSERT(_buffer[0] != 0);
+#endif
+	}
+
+	// Game side of test_callback_contention: starts, adjusts and stops
+	// sounds until told to stop
+	struct Churn {
+		Audio::Mixer *mixer;
+		Common::Mutex mutex;
+		bool stop;
+		uint ops;
+	};
+
+	static void churnProc(void *param) {
+		Churn *churn = (Churn *)param;
+		Audio::SoundHandle handles[24];
+		uint32 seed = 1;
+		for (uint ops = 1;; ops++) {
+			seed = seed * 1103515245 + 12345;
+			Audio::SoundHandle &handle = handles[(seed >> 16) % ARRAYSIZE(handles)];
+			switch ((seed >> 8) & 3) {
+			case 0:
+				if (!churn->mixer->isSoundHandleActive(handle))
+					churn->mixer->playStream(Audio::Mixer::kSFXSoundType, &handle, createConstStream(1000, kRate / 4));
+				break;
+			case 1:
+				churn->mixer->stopHandle(handle);
+				break;
+			case 2:
+				churn->mixer->setChannelVolume(handle, seed & 0xFF);
+				break;
+			default:
+				churn->mixer->setChannelBalance(handle, (int8)((seed >> 24) & 0x7F));
+				churn->mixer->setVolumeForSoundType(Audio::Mixer::kSFXSoundType, seed & 0xFF);
+				break;
+			}
+
+			Common::StackLock lock(churn->mutex);
+			churn->ops = ops;
+			if (churn->stop)
+				break;
+		}
+		churn->mixer->stopAll();
+	}
+
+	void test_callback_contention() {
+#if THREADED_NULL_OSYSTEM_IS_AVAILABLE
+#ifdef SLOW_TESTS
+		const uint callbacks = 5000;
+#else
+		const uint callbacks = 200;
+#endif
+		Common::uninstall_null_g_system();
+		Common::install_threaded_null_g_system(2);
+
+		Audio::MixerImpl impl(kRate);
+		impl.setReady(true);
+
+		// The audio callback runs on this thread while another one plays
+		// the game. Both contend for the mixer mutex, so the worst callback
+		// time includes waiting for the game side.
+		Churn churn;
+		churn.mixer = &impl;
+		churn.stop = false;
+		churn.ops = 0;
+		Common::ThreadInternal *thread = g_system->createThread(churnProc, &churn);
+		TS_ASSERT(thread);
+		if (!thread)
+			return;
+
+		uint32 worst = 0, total = 0;
+		for (uint i = 0; i < callbacks; i++) {
+			g_system->delayMillis(1);
+			const uint32 start = g_system->getMillis();
+			mix(impl);
+			const uint32 time = g_system->getMillis() - start;
+			worst = MAX(worst, time);
+			total += time;
+		}
+
+		uint ops;
+		{
+			Common::StackLock lock(churn.mutex);
+			churn.stop = true;
+			ops = churn.ops;
+		}
+		// Waits for the thread to finish
+		delete thread;
+		TS_ASSERT(ops > 0);
+		TS_ASSERT(!impl.hasActiveChannelOfType(Audio::Mixer::kSFXSoundType));
+
+		debug("Mixer callback with a churning game thread: worst %u ms, average %f ms, %u game side calls\n", worst, (double)total / callbacks, ops);
+#endif
+	}
+
+	void test_many_channels() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Audio::MixerImpl impl(kRate);
+		Audio::Mixer &mixer = impl;
+		impl.setReady(true);
+
+		// The slots grow beyond the initial block
+		Audio::SoundHandle handles[100];
+		for (int i = 0; i < ARRAYSIZE(handles); i++)
+			mixer.playStream(Audio::Mixer::kSFXSoundType, &handles[i], createConstStream(10, kRate), i);
+		mix(impl);
+		for (int i = 0; i < ARRAYSIZE(handles); i++) {
+			TS_ASSERT(mixer.isSoundHandleActive(handles[i]));
+			TS_ASSERT_EQUALS(mixer.getSoundID(handles[i]), i);
+			for (int j = 0; j < i; j++)
+				TS_ASSERT(handles[i] != handles[j]);
+		}
+		TS_ASSERT(mixer.isSoundIDActive(99));
+		TS_ASSERT_EQUALS(_buffer[0], 100 * 10);
+
+		mixer.stopID(70);
+		TS_ASSERT(!mixer.isSoundHandleActive(handles[70]));
+		mixer.stopAll();
+		mix(impl);
+		TS_ASSERT_EQUALS(_buffer[0], 0);
+
+		// Sounds beyond the limit are not played
+		impl.setMaxChannels(40);
+		for (int i = 0; i < 50; i++)
+			mixer.playStream(Audio::Mixer::kSFXSoundType, &handles[i], createConstStream(10, kRate));
+		for (int i = 0; i < 50; i++)
+			TS_ASSERT_EQUALS(mixer.isSoundHandleActive(handles[i]), i < 40);
+#endif
+	}
+
+	void test_limiter() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Audio::MixerImpl impl(kRate);
+		Audio::Mixer &mixer = impl;
+		impl.setReady(true);
+
+		// Mixes which do not clip are not changed
+		Audio::SoundHandle quiet, loud;
+		mixer.playStream(Audio::Mixer::kSFXSoundType, &quiet, createConstStream(20000, kRate * 2));
+		mix(impl);
+		TS_ASSERT_EQUALS(_buffer[0], 20000);
+		TS_ASSERT_EQUALS(_buffer[kFrames * 2 - 1], 20000);
+
+		// The gain is lowered instead of clipping
+		mixer.playStream(Audio::Mixer::kSFXSoundType, &loud, createConstStream(-20000, kRate * 2));
+		mixer.playStream(Audio::Mixer::kSFXSoundType, nullptr, createConstStream(20000, kRate * 2));
+		mixer.playStream(Audio::Mixer::kSFXSoundType, nullptr, createConstStream(20000, kRate * 2));
+		mix(impl);
+		TS_ASSERT(_buffer[0] >= 32766);
+		mixer.stopHandle(loud);
+		mix(impl);
+		TS_ASSERT(_buffer[0] >= 32766);
+		TS_ASSERT(_buffer[kFrames * 2 - 1] >= 32766);
+
+		// It recovers slowly once the mix gets quieter
+		mixer.stopAll();
+		mixer.playStream(Audio::Mixer::kSFXSoundType, &quiet, createConstStream(20000, kRate * 2));
+		mix(impl);
+		TS_ASSERT(_buffer[0] < 20000);
+		TS_ASSERT(_buffer[0] <= _buffer[kFrames * 2 - 1]);
+		for (int i = 0; i < 10; i++)
+			mix(impl);
+		TS_ASSERT_EQUALS(_buffer[0], 20000);
+#endif
+	}
+
+	void test_large_callback() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		// The backend said it asks for 256 frames, so a larger request has to
+		// be mixed in several parts
+		Audio::MixerImpl impl(kRate, true, 256);
+		Audio::Mixer &mixer = impl;
+		impl.setReady(true);
+
+		const uint frames = 10000;
+		int16 *buffer = new int16[frames * 2];
+		mixer.playStream(Audio::Mixer::kSFXSoundType, nullptr, createConstStream(1000, frames / 2));
+		TS_ASSERT_EQUALS(impl.mixCallback((byte *)buffer, frames * 2 * sizeof(int16)), (int)frames / 2);
+		TS_ASSERT_EQUALS(buffer[0], 1000);
+		TS_ASSERT_EQUALS(buffer[frames - 1], 1000);
+		TS_ASSERT_EQUALS(buffer[frames], 0);
+		TS_ASSERT_EQUALS(buffer[frames * 2 - 1], 0);
+		delete[] buffer;
+#endif
+	}
+
+	void test_mix_64_streams() {
+#if BENCHMARK_TIME
+#ifdef SLOW_TESTS
+		const uint seconds = 60;
+#else
+		const uint seconds = 5;
+#endif
+		const uint outputRate = 48000;
+		const uint bufferFrames = 1024;
+
+		struct Kernels {
+			const char *name;
+			Audio::MixBus::AccumulateStereoFunc accumulateStereo;
+			Audio::MixBus::AccumulateMonoToStereoFunc accumulateMonoToStereo;
+			Audio::MixBus::AccumulateMonoFunc accumulateMono;
+			Audio::MixBus::PeakFunc peak;
+			Audio::MixBus::OutputFunc output;
+		};
+
+		Common::Array<Kernels> kernels;
+		const Kernels generic = { "generic",
+			Audio::MixBus::accumulateStereoGeneric, Audio::MixBus::accumulateMonoToStereoGeneric,
+			Audio::MixBus::accumulateMonoGeneric, Audio::MixBus::peakGeneric, Audio::MixBus::outputGeneric };
+		kernels.push_back(generic);
+#ifdef SCUMMVM_NEON
+		const Kernels neon = { "NEON",
+			Audio::MixBus::accumulateStereoNEON, Audio::MixBus::accumulateMonoToStereoNEON,
+			Audio::MixBus::accumulateMonoNEON, Audio::MixBus::peakNEON, Audio::MixBus::outputNEON };
+		kernels.push_back(neon);
+#endif
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2) {
+			const Kernels sse2 = { "SSE2",
+				Audio::MixBus::accumulateStereoSSE2, Audio::MixBus::accumulateMonoToStereoSSE2,
+				Audio::MixBus::accumulateMonoSSE2, Audio::MixBus::peakSSE2, Audio::MixBus::outputSSE2 };
+			kernels.push_back(sse2);
+		}
+#endif
+
+		int16 *buffer = new int16[bufferFrames * 2];
+		for (uint k = 0; k < kernels.size(); k++) {
+			Audio::MixBus::accumulateStereo = kernels[k].accumulateStereo;
+			Audio::MixBus::accumulateMonoToStereo = kernels[k].accumulateMonoToStereo;
+			Audio::MixBus::accumulateMono = kernels[k].accumulateMono;
+			Audio::MixBus::peak = kernels[k].peak;
+			Audio::MixBus::output = kernels[k].output;
+
+			Audio::MixerImpl impl(outputRate);
+			Audio::Mixer &mixer = impl;
+			impl.setReady(true);
+
+			// Half of the streams need resampling, the others are mixed
+			// as they are
+			for (int i = 0; i < 64; i++) {
+				Audio::AudioStream *stream = (i & 1) ? createNoiseStream(outputRate, true, outputRate, i) : createNoiseStream(22050, false, 22050, i);
+				mixer.playStream(Audio::Mixer::kSFXSoundType, nullptr, stream, -1, 128 + i, (int8)(i * 4 - 126));
+			}
+
+			const uint32 start = g_system->getMillis();
+			for (uint frames = 0; frames < seconds * outputRate; frames += bufferFrames)
+				impl.mixCallback((byte *)buffer, bufferFrames * 2 * sizeof(int16));
+			const uint32 time = g_system->getMillis() - start;
+
+			mixer.stopAll();
+
+			debug("Mixing 64 streams at 48 kHz with %s kernels: %f ms per second of audio\n", kernels[k].name, (double)time / seconds);
+		}
+		delete[] buffer;
+
+		useGenericKernels();
+#endif
+	}
+};
@@ -0,0 +1,235 @@
+#include <cxxtest/TestSuite.h>
+#include "test/instrset_detect.h"
+
+#include "audio/audiostream.h"
+#include "audio/mixbus.h"
+#include "audio/rate.h"
+#include "audio/sinc.h"
+#include "audio/decoders/raw.h"
+
+#include "common/array.h"
+#include "common/debug.h"
+#include "common/memstream.h"
+#include "common/system.h"
+
+#include "../system/null_osystem.h"
+
+#if NULL_OSYSTEM_IS_AVAILABLE
+#define BENCHMARK_TIME 1
+#else
+#define BENCHMARK_TIME 0
+#endif
+
+class RateConverterTestSuite : public CxxTest::TestSuite {
+	enum {
+		kInRate = 22050,
+		kOutRate = 48000,
+		kAmplitude = 10000
+	};
+
+	struct Kernels {
+		const char *name;
+		Audio::SincFilter::FilterFunc filter;
+	};
+
+	Common::Array<Kernels> _kernels;
+
+#ifdef SCUMM_LITTLE_ENDIAN
+	static const byte FLAG_NATIVE = Audio::FLAG_LITTLE_ENDIAN;
+#else
+	static const byte FLAG_NATIVE = 0;
+#endif
+
+	// A mono sine of the given frequency at kInRate
+	static Audio::SeekableAudioStream *createToneStream(double frequency, uint samples) {
+		int16 *data = (int16 *)malloc(samples * sizeof(int16));
+		for (uint i = 0; i < samples; i++)
+			data[i] = (int16)(sin(2 * M_PI * frequency * i / kInRate) * kAmplitude);
+		Common::SeekableReadStream *stream = new Common::MemoryReadStream((const byte *)data, samples * sizeof(int16), DisposeAfterUse::YES);
+		return Audio::makeRawStream(stream, kInRate, Audio::FLAG_16BITS | FLAG_NATIVE);
+	}
+
+	// Convert the whole stream to stereo at kOutRate, returning the left channel
+	static Common::Array<float> convertStream(Audio::AudioStream *stream, Audio::RateConverterQuality quality) {
+		Audio::RateConverter *converter = Audio::makeRateConverter(kInRate, kOutRate, false, true, false, quality);
+
+		Common::Array<float> result;
+		float buffer[512 * 2];
+		for (;;) {
+			memset(buffer, 0, sizeof(buffer));
+			const int frames = converter->convert(*stream, buffer, 512, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume);
+			for (int i = 0; i < frames; i++)
+				result.push_back(buffer[i * 2]);
+			if (frames < 512 && stream->endOfStream() && !converter->needsDraining())
+				break;
+		}
+
+		delete converter;
+		delete stream;
+		return result;
+	}
+
+	// Amplitude of the given frequency in the output, using a Hann window
+	static double amplitudeAt(const Common::Array<float> &samples, uint start, uint count, double frequency) {
+		double re = 0.0, im = 0.0, windowSum = 0.0;
+		for (uint i = 0; i < count; i++) {
+			const double window = 0.5 - 0.5 * cos(2 * M_PI * i / count);
+			const double arg = 2 * M_PI * frequency * (start + i) / kOutRate;
+			re += samples[start + i] * window * cos(arg);
+			im += samples[start + i] * window * sin(arg);
+			windowSum += window;
+		}
+		return 2 * sqrt(re * re + im * im) / windowSum;
+	}
+
+public:
+	void setUp() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+#endif
+
+		_kernels.clear();
+		const Kernels generic = { "generic", Audio::SincFilter::filterGeneric };
+		_kernels.push_back(generic);
+#ifdef SCUMMVM_NEON
+		const Kernels neon = { "NEON", Audio::SincFilter::filterNEON };
+		_kernels.push_back(neon);
+#endif
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2) {
+			const Kernels sse2 = { "SSE2", Audio::SincFilter::filterSSE2 };
+			_kernels.push_back(sse2);
+		}
+#endif
+
+		// The kernels would be selected according to g_system otherwise
+		Audio::SincFilter::filter = Audio::SincFilter::filterGeneric;
+		Audio::MixBus::accumulateStereo = Audio::MixBus::accumulateStereoGeneric;
+		Audio::MixBus::accumulateMonoToStereo = Audio::MixBus::accumulateMonoToStereoGeneric;
+		Audio::MixBus::accumulateMono = Audio::MixBus::accumulateMonoGeneric;
+		Audio::MixBus::peak = Audio::MixBus::peakGeneric;
+		Audio::MixBus::output = Audio::MixBus::outputGeneric;
+	}
+
+	void tearDown() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::uninstall_null_g_system();
+#endif
+	}
+
+	void test_sinc_kernels() {
+		float src[300];
+		uint32 seed = 1;
+		for (int i = 0; i < ARRAYSIZE(src); i++) {
+			seed = seed * 1103515245 + 12345;
+			src[i] = (float)(int16)(seed >> 16);
+		}
+
+		const uint64 step = ((uint64)kInRate << 32) / kOutRate;
+		float ref[700];
+		uint64 refPos = 0;
+		const uint refCount = Audio::SincFilter::filterGeneric(ref, src, ARRAYSIZE(src), refPos, step, ARRAYSIZE(ref));
+		TS_ASSERT_EQUALS(refCount, (uint)((((uint64)(ARRAYSIZE(src) - Audio::SincFilter::kTaps + 1) << 32) - 1) / step + 1));
+
+		for (uint k = 1; k < _kernels.size(); k++) {
+			// An odd count, so that the kernels also have to handle a tail
+			float result[700];
+			uint64 pos = 0;
+			uint count = _kernels[k].filter(result, src, ARRAYSIZE(src), pos, step, 101);
+			count += _kernels[k].filter(result + count, src, ARRAYSIZE(src), pos, step, ARRAYSIZE(result) - count);
+			TSM_ASSERT_EQUALS(_kernels[k].name, count, refCount);
+			TSM_ASSERT_EQUALS(_kernels[k].name, pos, refPos);
+			for (uint i = 0; i < count; i++)
+				TSM_ASSERT_DELTA(_kernels[k].name, result[i], ref[i], 0.05f);
+		}
+	}
+
+	void test_sinc_suppresses_images() {
+		// A 5 kHz tone creates an image at 17.05 kHz
+		const double tone = 5000.0, image = kInRate - tone;
+
+		const Common::Array<float> linear = convertStream(createToneStream(tone, kInRate), Audio::kRateConverterLinear);
+		const Common::Array<float> sinc = convertStream(createToneStream(tone, kInRate), Audio::kRateConverterSinc);
+
+		// All input samples come out again
+		TS_ASSERT_DELTA(sinc.size(), (uint)kOutRate, 4u);
+		TS_ASSERT_DELTA(linear.size(), (uint)kOutRate, 4u);
+
+		const uint start = kOutRate / 4, count = kOutRate / 2;
+		TS_ASSERT_DELTA(amplitudeAt(sinc, start, count, tone), kAmplitude, kAmplitude * 0.01);
+		TS_ASSERT_DELTA(amplitudeAt(linear, start, count, tone), kAmplitude, kAmplitude * 0.2);
+
+		// The linear interpolation leaves the image at about -24 dB, the
+		// sinc filter must push it below -60 dB
+		TS_ASSERT(amplitudeAt(linear, start, count, image) > kAmplitude * 0.03);
+		TS_ASSERT(amplitudeAt(sinc, start, count, image) < kAmplitude * 0.001);
+	}
+
+	void test_sinc_rate_change() {
+		// Channels may be resampled at a different rate at any time. The
+		// input buffered by the filter must not be skipped when going above
+		// the output rate and back, which would be audible as a click.
+		for (uint k = 0; k < _kernels.size(); k++) {
+			Audio::SincFilter::filter = _kernels[k].filter;
+			Audio::AudioStream *stream = createToneStream(440.0, kInRate);
+			Audio::RateConverter *converter = Audio::makeRateConverter(kInRate, kOutRate, false, true, false, Audio::kRateConverterSinc);
+
+			const Audio::st_rate_t rates[] = { kInRate, kOutRate * 2, kOutRate, kInRate / 2, kInRate };
+			Common::Array<float> result;
+			for (uint i = 0; i < ARRAYSIZE(rates); i++) {
+				converter->setInputRate(rates[i]);
+				float buffer[1000 * 2];
+				memset(buffer, 0, sizeof(buffer));
+				TSM_ASSERT_EQUALS(_kernels[k].name, converter->convert(*stream, buffer, 1000, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume), 1000);
+				for (int j = 0; j < 1000; j++)
+					result.push_back(buffer[j * 2]);
+			}
+
+			// The tone is at most 440 Hz * 96000 / 22050, so the output
+			// changes by less than 2600 per sample. Skipped input would
+			// jump anywhere up to twice the amplitude.
+			float maxStep = 0.0f;
+			for (uint i = 1; i < result.size(); i++)
+				maxStep = MAX(maxStep, fabsf(result[i] - result[i - 1]));
+			TSM_ASSERT_LESS_THAN(_kernels[k].name, maxStep, 3000.0f);
+
+			delete converter;
+			delete stream;
+		}
+		Audio::SincFilter::filter = Audio::SincFilter::filterGeneric;
+	}
+
+	void test_upsampling_cost() {
+#if BENCHMARK_TIME
+#ifdef SLOW_TESTS
+		const uint seconds = 600;
+#else
+		const uint seconds = 20;
+#endif
+		const uint bufferFrames = 1024;
+
+		float *buffer = new float[bufferFrames * 2];
+		for (int pass = -1; pass < (int)_kernels.size(); pass++) {
+			const Audio::RateConverterQuality quality = (pass < 0) ? Audio::kRateConverterLinear : Audio::kRateConverterSinc;
+			if (pass >= 0)
+				Audio::SincFilter::filter = _kernels[pass].filter;
+
+			Audio::AudioStream *stream = Audio::makeLoopingAudioStream(createToneStream(1000.0, kInRate), 0);
+			Audio::RateConverter *converter = Audio::makeRateConverter(kInRate, kOutRate, false, true, false, quality);
+
+			const uint32 start = g_system->getMillis();
+			for (uint frames = 0; frames < seconds * kOutRate; frames += bufferFrames)
+				converter->convert(*stream, buffer, bufferFrames, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume);
+			const uint32 time = g_system->getMillis() - start;
+
+			delete converter;
+			delete stream;
+
+			debug("Upsampling 22 kHz to 48 kHz with %s: %f ms per second of audio\n", (pass < 0) ? "linear interpolation" : _kernels[pass].name, (double)time / seconds);
+		}
+		delete[] buffer;
+
+		Audio::SincFilter::filter = Audio::SincFilter::filterGeneric;
+#endif
+	}
+};
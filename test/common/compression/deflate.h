@@ -0,0 +1,126 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/compression/deflate.h"
+#include "common/memstream.h"
+#include "common/ptr.h"
+
+class DeflateTestSuite : public CxxTest::TestSuite {
+	enum {
+		kDataSize = 2 * 1024 * 1024,
+		kCheckpointInterval = 64 * 1024
+	};
+
+	byte *_data;
+	byte *_compressed;
+	uint32 _compressedSize;
+
+	void generateData() {
+		// Compressible, but not trivially so
+		uint32 seed = 1;
+		for (uint32 i = 0; i < kDataSize; i++) {
+			seed = seed * 1103515245 + 12345;
+			if (i >= 64 && (seed & 0x300000) == 0)
+				_data[i] = _data[i - 1 - ((seed >> 8) & 63)];
+			else
+				_data[i] = (seed >> 16) & 15;
+		}
+	}
+
+	// The write stream produces gzip, strip the header and the trailer to
+	// get raw deflate data.
+	void compressData() {
+		Common::MemoryWriteStreamDynamic *gzipped = new Common::MemoryWriteStreamDynamic(DisposeAfterUse::YES);
+		Common::WriteStream *gz = Common::wrapCompressedWriteStream(gzipped);
+		gz->write(_data, kDataSize);
+		gz->finalize();
+
+		_compressedSize = gzipped->size() - 18;
+		_compressed = new byte[_compressedSize];
+		memcpy(_compressed, gzipped->getData() + 10, _compressedSize);
+
+		// Also deletes gzipped
+		delete gz;
+	}
+
+	Common::SeekableReadStream *createStream() {
+		return Common::wrapSeekableDeflateReadStream(new Common::MemoryReadStream(_compressed, _compressedSize),
+			DisposeAfterUse::YES, kDataSize, kCheckpointInterval);
+	}
+
+	bool readMatches(Common::SeekableReadStream *stream, uint32 offset, uint32 len) {
+		byte buf[4096];
+		assert(len <= sizeof(buf));
+		if (stream->read(buf, len) != len)
+			return false;
+		return memcmp(buf, _data + offset, len) == 0;
+	}
+
+public:
+	void setUp() {
+		_data = new byte[kDataSize];
+		generateData();
+		compressData();
+	}
+
+	void tearDown() {
+		delete[] _data;
+		delete[] _compressed;
+	}
+
+#ifdef USE_ZLIB
+	void test_sequential_read() {
+		Common::ScopedPtr<Common::SeekableReadStream> stream(createStream());
+		TS_ASSERT(stream);
+		TS_ASSERT_EQUALS(stream->size(), (int64)kDataSize);
+
+		for (uint32 offset = 0; offset < kDataSize; offset += 3000) {
+			const uint32 len = MIN<uint32>(3000, kDataSize - offset);
+			TS_ASSERT(readMatches(stream.get(), offset, len));
+		}
+		TS_ASSERT(!stream->eos());
+
+		byte b;
+		TS_ASSERT_EQUALS(stream->read(&b, 1), 0u);
+		TS_ASSERT(stream->eos());
+		TS_ASSERT(!stream->err());
+	}
+
+	void test_random_seek() {
+		Common::ScopedPtr<Common::SeekableReadStream> stream(createStream());
+
+		// Run to the end first so that all checkpoints exist, then bounce
+		// around forwards and backwards.
+		TS_ASSERT(stream->seek(-100, SEEK_END));
+		TS_ASSERT(readMatches(stream.get(), kDataSize - 100, 100));
+
+		uint32 seed = 7;
+		for (int i = 0; i < 200; i++) {
+			seed = seed * 1103515245 + 12345;
+			const uint32 offset = (seed >> 4) % (kDataSize - 1000);
+			TS_ASSERT(stream->seek(offset));
+			TS_ASSERT_EQUALS(stream->pos(), (int64)offset);
+			TS_ASSERT(readMatches(stream.get(), offset, 1000));
+
+			// Short backward seeks are served from the window
+			TS_ASSERT(stream->seek(-500, SEEK_CUR));
+			TS_ASSERT(readMatches(stream.get(), offset + 500, 500));
+		}
+	}
+
+	void test_seek_before_checkpoints() {
+		Common::ScopedPtr<Common::SeekableReadStream> stream(createStream());
+
+		// Forward seeks into data which has not been decoded yet
+		TS_ASSERT(stream->seek(kDataSize / 2));
+		TS_ASSERT(readMatches(stream.get(), kDataSize / 2, 4096));
+		TS_ASSERT(stream->seek(kDataSize / 4));
+		TS_ASSERT(readMatches(stream.get(), kDataSize / 4, 4096));
+		TS_ASSERT(stream->seek(kDataSize - 4096));
+		TS_ASSERT(readMatches(stream.get(), kDataSize - 4096, 4096));
+		TS_ASSERT(stream->seek(0));
+		TS_ASSERT(readMatches(stream.get(), 0, 4096));
+
+		TS_ASSERT(!stream->seek(kDataSize + 1));
+	}
+#endif
+};
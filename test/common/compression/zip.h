@@ -0,0 +1,223 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/archive.h"
+#include "common/crc.h"
+#include "common/memstream.h"
+#include "common/compression/deflate.h"
+#include "common/compression/unzip.h"
+#include "common/system.h"
+#include "common/thread.h"
+
+#include "../../system/null_osystem.h"
+
+class ZipTestSuite : public CxxTest::TestSuite {
+	enum {
+		// Large enough to be streamed from the zip file
+		kDataSize = 3 * 1024 * 1024 / 2
+	};
+
+	byte *_data;
+
+	// A zip file holding the given data as its only member, "member.bin"
+	static Common::SeekableReadStream *createZip(const byte *contents, uint32 contentsSize, uint16 method, uint32 uncompressedSize, uint32 crc) {
+		static const char name[] = "member.bin";
+		const uint16 nameLength = sizeof(name) - 1;
+		Common::MemoryWriteStreamDynamic zip(DisposeAfterUse::NO);
+
+		zip.writeUint32LE(0x04034b50);
+		zip.writeUint16LE(20);
+		zip.writeUint16LE(0);
+		zip.writeUint16LE(method);
+		zip.writeUint32LE(0);
+		zip.writeUint32LE(crc);
+		zip.writeUint32LE(contentsSize);
+		zip.writeUint32LE(uncompressedSize);
+		zip.writeUint16LE(nameLength);
+		zip.writeUint16LE(0);
+		zip.write(name, nameLength);
+		zip.write(contents, contentsSize);
+
+		const uint32 centralDir = zip.pos();
+		zip.writeUint32LE(0x02014b50);
+		zip.writeUint16LE(20);
+		zip.writeUint16LE(20);
+		zip.writeUint16LE(0);
+		zip.writeUint16LE(method);
+		zip.writeUint32LE(0);
+		zip.writeUint32LE(crc);
+		zip.writeUint32LE(contentsSize);
+		zip.writeUint32LE(uncompressedSize);
+		zip.writeUint16LE(nameLength);
+		zip.writeUint16LE(0);
+		zip.writeUint16LE(0);
+		zip.writeUint16LE(0);
+		zip.writeUint16LE(0);
+		zip.writeUint32LE(0);
+		zip.writeUint32LE(0);
+		zip.write(name, nameLength);
+		const uint32 centralDirSize = zip.pos() - centralDir;
+
+		zip.writeUint32LE(0x06054b50);
+		zip.writeUint16LE(0);
+		zip.writeUint16LE(0);
+		zip.writeUint16LE(1);
+		zip.writeUint16LE(1);
+		zip.writeUint32LE(centralDirSize);
+		zip.writeUint32LE(centralDir);
+		zip.writeUint16LE(0);
+
+		return new Common::MemoryReadStream(zip.getData(), zip.size(), DisposeAfterUse::YES);
+	}
+
+	// Sleeps before every read, so that other threads get to seek the
+	// stream in between if they do not wait for the read to finish
+	class SlowReadStream : public Common::SeekableReadStream {
+		Common::ScopedPtr<Common::SeekableReadStream> _parent;
+
+	public:
+		SlowReadStream(Common::SeekableReadStream *parent) : _parent(parent) {}
+
+		uint32 read(void *dataPtr, uint32 dataSize) override {
+			g_system->delayMillis(1);
+			return _parent->read(dataPtr, dataSize);
+		}
+
+		bool eos() const override { return _parent->eos(); }
+		bool err() const override { return _parent->err(); }
+		void clearErr() override { _parent->clearErr(); }
+		int64 pos() const override { return _parent->pos(); }
+		int64 size() const override { return _parent->size(); }
+		bool seek(int64 offset, int whence = SEEK_SET) override { return _parent->seek(offset, whence); }
+	};
+
+	struct MemberReader {
+		Common::SeekableReadStream *member;
+		const byte *data;
+		bool ok;
+	};
+
+	// Read the start of the member in small pieces, so that reads on
+	// different threads interleave
+	static void readMember(void *param) {
+		MemberReader *reader = (MemberReader *)param;
+		const uint32 size = 64 * 1024;
+		byte buf[512];
+		reader->ok = reader->member->size() == kDataSize;
+		for (uint32 pos = 0; reader->ok && pos < size; pos += sizeof(buf)) {
+			const uint32 len = MIN<uint32>(sizeof(buf), size - pos);
+			reader->ok = reader->member->read(buf, len) == len && memcmp(buf, reader->data + pos, len) == 0;
+		}
+	}
+
+	// Open the member, then close the archive before reading all of it
+	bool readAfterClose(Common::SeekableReadStream *zip, bool &err) {
+		Common::Archive *archive = Common::makeZipArchive(zip);
+		if (!archive)
+			return false;
+		Common::SeekableReadStream *member = archive->createReadStreamForMember("member.bin");
+		delete archive;
+		if (!member)
+			return false;
+
+		bool ok = member->size() == kDataSize;
+		byte buf[4096];
+		for (uint32 pos = 0; ok && pos < kDataSize; pos += sizeof(buf)) {
+			const uint32 len = MIN<uint32>(sizeof(buf), kDataSize - pos);
+			ok = member->read(buf, len) == len && memcmp(buf, _data + pos, len) == 0;
+		}
+		err = member->err();
+		delete member;
+		return ok;
+	}
+
+public:
+	void setUp() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		// Streamed members share a mutex with the archive
+		Common::install_null_g_system();
+#endif
+		_data = new byte[kDataSize];
+		uint32 seed = 1;
+		for (uint32 i = 0; i < kDataSize; i++) {
+			seed = seed * 1103515245 + 12345;
+			_data[i] = (seed >> 16) & 31;
+		}
+	}
+
+	void tearDown() {
+		delete[] _data;
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::uninstall_null_g_system();
+#endif
+	}
+
+	void test_stored_member() {
+		const uint32 crc = Common::CRC32().crcFast(_data, kDataSize);
+		bool err = true;
+		TS_ASSERT(readAfterClose(createZip(_data, kDataSize, 0, kDataSize, crc), err));
+		TS_ASSERT(!err);
+
+		// A wrong CRC is reported once all data has been read
+		TS_ASSERT(readAfterClose(createZip(_data, kDataSize, 0, kDataSize, crc ^ 1), err));
+		TS_ASSERT(err);
+	}
+
+	void test_threaded_members() {
+#if THREADED_NULL_OSYSTEM_IS_AVAILABLE
+		Common::uninstall_null_g_system();
+		Common::install_threaded_null_g_system(2);
+
+		const uint32 crc = Common::CRC32().crcFast(_data, kDataSize);
+		Common::Archive *archive = Common::makeZipArchive(new SlowReadStream(createZip(_data, kDataSize, 0, kDataSize, crc)));
+		TS_ASSERT(archive);
+		if (!archive)
+			return;
+
+		// Both members read the zipfile at the same time, one of them on
+		// another thread, while the archive looks up members as well
+		MemberReader readers[2];
+		for (uint i = 0; i < 2; i++) {
+			readers[i].member = archive->createReadStreamForMember("member.bin");
+			readers[i].data = _data;
+			readers[i].ok = false;
+			TS_ASSERT(readers[i].member);
+		}
+		if (readers[0].member && readers[1].member) {
+			Common::ThreadInternal *thread = g_system->createThread(readMember, &readers[1]);
+			TS_ASSERT(thread);
+			readMember(&readers[0]);
+			for (uint i = 0; i < 100; i++)
+				TS_ASSERT(archive->hasFile("member.bin"));
+			// Waits for the thread to finish
+			delete thread;
+			TS_ASSERT(readers[0].ok);
+			TS_ASSERT(readers[1].ok);
+		}
+
+		for (uint i = 0; i < 2; i++)
+			delete readers[i].member;
+		delete archive;
+#endif
+	}
+
+#ifdef USE_ZLIB
+	void test_deflated_member() {
+		// The write stream produces gzip, strip the header and the trailer
+		// to get raw deflate data
+		Common::MemoryWriteStreamDynamic *gzipped = new Common::MemoryWriteStreamDynamic(DisposeAfterUse::YES);
+		Common::WriteStream *gz = Common::wrapCompressedWriteStream(gzipped);
+		gz->write(_data, kDataSize);
+		gz->finalize();
+		const uint32 compressedSize = gzipped->size() - 18;
+		const byte *compressed = gzipped->getData() + 10;
+
+		const uint32 crc = Common::CRC32().crcFast(_data, kDataSize);
+		bool err = true;
+		TS_ASSERT(readAfterClose(createZip(compressed, compressedSize, 8, kDataSize, crc), err));
+		TS_ASSERT(!err);
+
+		// Also deletes gzipped
+		delete gz;
+	}
+#endif
+};
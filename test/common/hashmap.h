@@ -1,7 +1,18 @@
 #include <cxxtest/TestSuite.h>
 
 #include "common/hashmap.h"
+#include "common/flat-hashmap.h"
 #include "common/hash-str.h"
+#include "common/debug.h"
+#include "common/system.h"
+
+#include "../system/null_osystem.h"
+
+#if NULL_OSYSTEM_IS_AVAILABLE
+#define BENCHMARK_TIME 1
+#else
+#define BENCHMARK_TIME 0
+#endif
 
 class HashMapTestSuite : public CxxTest::TestSuite
 {
@@ -232,3 +243,200 @@ class HashMapTestSuite : public CxxTest::TestSuite
 
 	// TODO: Add test cases for iterators, find, ...
 };
+
+class FlatHashMapTestSuite : public CxxTest::TestSuite
+{
+	public:
+	void test_empty_clear() {
+		Common::FlatHashMap<int, int> container;
+		TS_ASSERT(container.empty());
+		container[0] = 17;
+		container[1] = 33;
+		TS_ASSERT(!container.empty());
+		container.clear();
+		TS_ASSERT(container.empty());
+
+		Common::FlatHashMap<Common::String, Common::String, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> container2;
+		TS_ASSERT(container2.empty());
+		container2["foo"] = "bar";
+		container2["quux"] = "blub";
+		TS_ASSERT(!container2.empty());
+		container2.clear(true);
+		TS_ASSERT(container2.empty());
+		container2["FOO"] = "baz";
+		TS_ASSERT_EQUALS(container2["foo"], "baz");
+	}
+
+	void test_add_remove() {
+		Common::FlatHashMap<int, int> container;
+		container[0] = 17;
+		container[1] = 33;
+		container[2] = 45;
+		container[3] = 12;
+		container[4] = 96;
+		TS_ASSERT(container.contains(1));
+		container.erase(1);
+		TS_ASSERT(!container.contains(1));
+		container[1] = 42;
+		TS_ASSERT(container.contains(1));
+		TS_ASSERT_EQUALS(container[1], 42);
+		container.erase(container.find(0));
+		TS_ASSERT(!container.contains(0));
+		TS_ASSERT_EQUALS(container.size(), 4u);
+		container.erase(1);
+		container.erase(2);
+		container.erase(3);
+		TS_ASSERT(!container.empty());
+		container.erase(4);
+		TS_ASSERT(container.empty());
+		TS_ASSERT_EQUALS(container.find(4), container.end());
+	}
+
+	void test_lookup_with_default() {
+		Common::FlatHashMap<int, int> container;
+		container[0] = 17;
+		container[1] = -1;
+
+		const Common::FlatHashMap<int, int> &containerRef = container;
+
+		TS_ASSERT_EQUALS(containerRef.getValOrDefault(0), 17);
+		TS_ASSERT_EQUALS(containerRef.getValOrDefault(17), 0);
+		TS_ASSERT_EQUALS(containerRef.getValOrDefault(1, -10), -1);
+		TS_ASSERT_EQUALS(containerRef.getValOrDefault(17, -10), -10);
+
+		int val = 0;
+		TS_ASSERT(containerRef.tryGetVal(0, val));
+		TS_ASSERT_EQUALS(val, 17);
+		TS_ASSERT(!containerRef.tryGetVal(17, val));
+	}
+
+	void test_copy() {
+		Common::FlatHashMap<int, Common::String> map1, map2;
+		for (int i = 0; i < 100; i++)
+			map1[i * 7] = Common::String::format("%d", i);
+		map2 = map1;
+		Common::FlatHashMap<int, Common::String> map3(map1);
+		map1.clear();
+		TS_ASSERT_EQUALS(map2.size(), 100u);
+		TS_ASSERT_EQUALS(map3.size(), 100u);
+		for (int i = 0; i < 100; i++) {
+			TS_ASSERT_EQUALS(map2[i * 7], Common::String::format("%d", i));
+			TS_ASSERT_EQUALS(map3[i * 7], Common::String::format("%d", i));
+		}
+	}
+
+	void test_matches_hashmap() {
+		// Apply the same pseudo-random sequence of insertions and
+		// removals to both map types and compare the results.
+		Common::HashMap<uint, uint> reference;
+		Common::FlatHashMap<uint, uint> container;
+		uint seed = 1;
+		for (int i = 0; i < 20000; i++) {
+			seed = seed * 1103515245 + 12345;
+			const uint key = (seed >> 16) & 1023;
+			if (seed & 0x400) {
+				reference[key] = i;
+				container[key] = i;
+			} else {
+				reference.erase(key);
+				container.erase(key);
+			}
+			TS_ASSERT_EQUALS(reference.size(), container.size());
+		}
+
+		for (uint key = 0; key < 1024; key++) {
+			TS_ASSERT_EQUALS(reference.contains(key), container.contains(key));
+			TS_ASSERT_EQUALS(reference.getValOrDefault(key), container.getValOrDefault(key));
+		}
+	}
+
+	void test_iterator() {
+		Common::FlatHashMap<int, int> container;
+		for (int i = 0; i < 200; i++)
+			container[i] = i * 2;
+
+		int found = 0;
+		Common::FlatHashMap<int, int>::const_iterator i;
+		for (i = container.begin(); i != container.end(); ++i) {
+			TS_ASSERT_EQUALS(i->_value, i->_key * 2);
+			found++;
+		}
+		TS_ASSERT_EQUALS(found, 200);
+	}
+
+	void test_erase_while_iterating() {
+		Common::FlatHashMap<int, int> container;
+		for (int i = 0; i < 500; i++)
+			container[i * 3] = i;
+
+		// Erasing the current entry must not skip or repeat other entries.
+		int visited = 0;
+		for (Common::FlatHashMap<int, int>::iterator i = container.begin(); i != container.end(); ++i) {
+			visited++;
+			if (i->_value & 1)
+				container.erase(i);
+		}
+		TS_ASSERT_EQUALS(visited, 500);
+		TS_ASSERT_EQUALS(container.size(), 250u);
+		for (int i = 0; i < 500; i++)
+			TS_ASSERT_EQUALS(container.contains(i * 3), !(i & 1));
+	}
+
+	// Times insertion, lookup and erasure of the same keys in both map types
+	void test_speed() {
+#if BENCHMARK_TIME
+		Common::install_null_g_system();
+
+#ifdef SLOW_TESTS
+		const int rounds = 200;
+#else
+		const int rounds = 1;
+#endif
+		const uint count = 20000;
+
+		uint32 hashMapTime[3] = { 0, 0, 0 }, flatTime[3] = { 0, 0, 0 };
+		uint sum = 0;
+		for (int round = 0; round < rounds; round++) {
+			Common::HashMap<uint, uint> hashMap;
+			Common::FlatHashMap<uint, uint> flatMap;
+
+			uint32 start = g_system->getMillis();
+			for (uint i = 0; i < count; i++)
+				hashMap[i * 2654435761U] = i;
+			hashMapTime[0] += g_system->getMillis() - start;
+			start = g_system->getMillis();
+			for (uint i = 0; i < count; i++)
+				flatMap[i * 2654435761U] = i;
+			flatTime[0] += g_system->getMillis() - start;
+
+			// half of the lookups miss
+			start = g_system->getMillis();
+			for (uint i = 0; i < count * 2; i++)
+				sum += hashMap.getValOrDefault(i * 2654435761U);
+			hashMapTime[1] += g_system->getMillis() - start;
+			start = g_system->getMillis();
+			for (uint i = 0; i < count * 2; i++)
+				sum += flatMap.getValOrDefault(i * 2654435761U);
+			flatTime[1] += g_system->getMillis() - start;
+
+			start = g_system->getMillis();
+			for (uint i = 0; i < count; i++)
+				hashMap.erase(i * 2654435761U);
+			hashMapTime[2] += g_system->getMillis() - start;
+			start = g_system->getMillis();
+			for (uint i = 0; i < count; i++)
+				flatMap.erase(i * 2654435761U);
+			flatTime[2] += g_system->getMillis() - start;
+
+			TS_ASSERT(hashMap.empty());
+			TS_ASSERT(flatMap.empty());
+		}
+		TS_ASSERT(sum != 0);
+
+		debug("HashMap insert/lookup/erase of %u keys x %d (in milliseconds): %u %u %u\n", count, rounds, hashMapTime[0], hashMapTime[1], hashMapTime[2]);
+		debug("FlatHashMap insert/lookup/erase of %u keys x %d (in milliseconds): %u %u %u\n", count, rounds, flatTime[0], flatTime[1], flatTime[2]);
+
+		Common::uninstall_null_g_system();
+#endif
+	}
+};
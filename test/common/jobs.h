@@ -0,0 +1,228 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/debug.h"
+#include "common/jobs.h"
+#include "common/system.h"
+#include "../system/null_osystem.h"
+
+#if THREADED_NULL_OSYSTEM_IS_AVAILABLE
+#define BENCHMARK_TIME 1
+#else
+#define BENCHMARK_TIME 0
+#endif
+
+struct SumJob {
+	const uint *values;
+	uint begin;
+	uint end;
+	uint64 sum;
+};
+
+static void sumJobProc(void *param) {
+	SumJob *job = (SumJob *)param;
+	job->sum = 0;
+	for (uint i = job->begin; i < job->end; ++i)
+		job->sum += job->values[i];
+}
+
+static void squareProc(uint begin, uint end, void *param) {
+	uint *values = (uint *)param;
+	for (uint i = begin; i < end; ++i)
+		values[i] = i * i;
+}
+
+struct BarrierJob {
+	Common::Mutex *mutex;
+	uint *arrived;
+	uint count;
+	bool met;
+};
+
+// Wait until all jobs sharing the barrier are running at the same time,
+// which is only possible when they run on different threads
+static void barrierJobProc(void *param) {
+	BarrierJob *job = (BarrierJob *)param;
+	{
+		Common::StackLock lock(*job->mutex);
+		(*job->arrived)++;
+	}
+
+	job->met = false;
+	const uint32 start = g_system->getMillis();
+	while (g_system->getMillis() - start < 5000) {
+		{
+			Common::StackLock lock(*job->mutex);
+			if (*job->arrived == job->count) {
+				job->met = true;
+				return;
+			}
+		}
+		g_system->delayMillis(1);
+	}
+}
+
+static void countJobProc(void *param) {
+	BarrierJob *job = (BarrierJob *)param;
+	Common::StackLock lock(*job->mutex);
+	(*job->arrived)++;
+}
+
+static void workProc(uint begin, uint end, void *param) {
+	uint32 *values = (uint32 *)param;
+	for (uint i = begin; i < end; ++i) {
+		uint32 x = i;
+		for (uint j = 0; j < 64; ++j)
+			x = x * 1103515245 + 12345;
+		values[i] = x;
+	}
+}
+
+class JobSystemTestSuite : public CxxTest::TestSuite
+{
+public:
+	void setUp() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+#endif
+	}
+
+	void tearDown() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::JobSystem::destroy();
+		Common::uninstall_null_g_system();
+#endif
+	}
+
+#if THREADED_NULL_OSYSTEM_IS_AVAILABLE
+	// Replace the system installed by setUp() with one that has threads
+	void installThreadedSystem(uint cpuCount) {
+		Common::JobSystem::destroy();
+		Common::uninstall_null_g_system();
+		Common::install_threaded_null_g_system(cpuCount);
+	}
+#endif
+
+	void test_submit_wait() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::Array<uint> values;
+		for (uint i = 0; i < 10000; ++i)
+			values.push_back(i);
+
+		SumJob jobs[8];
+		Common::JobGroup group;
+		for (uint i = 0; i < 8; ++i) {
+			jobs[i].values = values.data();
+			jobs[i].begin = i * 1250;
+			jobs[i].end = (i + 1) * 1250;
+			JobMan.submit(group, sumJobProc, &jobs[i]);
+		}
+		JobMan.wait(group);
+
+		uint64 sum = 0;
+		for (uint i = 0; i < 8; ++i)
+			sum += jobs[i].sum;
+		TS_ASSERT_EQUALS(sum, (uint64)9999 * 10000 / 2);
+
+		// The group can be reused once waited for
+		JobMan.submit(group, sumJobProc, &jobs[0]);
+		JobMan.wait(group);
+		TS_ASSERT_EQUALS(jobs[0].sum, (uint64)1249 * 1250 / 2);
+#endif
+	}
+
+	void test_parallel_for() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::Array<uint> values;
+		values.resize(1000);
+		JobMan.parallelFor(values.size(), squareProc, values.data(), 16);
+		for (uint i = 0; i < values.size(); ++i)
+			TS_ASSERT_EQUALS(values[i], i * i);
+
+		// Empty ranges must not call the function at all
+		JobMan.parallelFor(0, squareProc, nullptr);
+#endif
+	}
+
+	void test_worker_threads() {
+#if THREADED_NULL_OSYSTEM_IS_AVAILABLE
+		installThreadedSystem(4);
+		TS_ASSERT_EQUALS(JobMan.getWorkerCount(), 3u);
+
+		// One job for every worker and one for the waiting thread
+		Common::Mutex mutex;
+		uint arrived = 0;
+		BarrierJob jobs[4];
+		Common::JobGroup group;
+		for (uint i = 0; i < 4; ++i) {
+			jobs[i].mutex = &mutex;
+			jobs[i].arrived = &arrived;
+			jobs[i].count = 4;
+			JobMan.submit(group, barrierJobProc, &jobs[i]);
+		}
+		JobMan.wait(group);
+		for (uint i = 0; i < 4; ++i)
+			TS_ASSERT(jobs[i].met);
+
+		// Lots of tiny jobs, so that the workers keep stealing from each other
+		arrived = 0;
+		for (uint i = 0; i < 10000; ++i)
+			JobMan.submit(group, countJobProc, &jobs[0]);
+		JobMan.wait(group);
+		TS_ASSERT_EQUALS(arrived, 10000u);
+#endif
+	}
+
+	void test_threaded_parallel_for() {
+#if THREADED_NULL_OSYSTEM_IS_AVAILABLE
+		installThreadedSystem(8);
+
+		Common::Array<uint> values;
+		values.resize(100000);
+		for (uint round = 0; round < 10; ++round) {
+			memset(values.data(), 0, values.size() * sizeof(uint));
+			JobMan.parallelFor(values.size(), squareProc, values.data(), round + 1);
+			for (uint i = 0; i < values.size(); ++i)
+				TS_ASSERT_EQUALS(values[i], i * i);
+		}
+#endif
+	}
+
+	void test_speed() {
+#if BENCHMARK_TIME
+#ifdef SLOW_TESTS
+		const uint rounds = 200;
+#else
+		const uint rounds = 1;
+#endif
+		const uint count = 1 << 16;
+		Common::Array<uint32> values;
+		values.resize(count);
+
+		static const uint cpuCounts[] = { 1, 2, 4, 8 };
+		for (uint c = 0; c < ARRAYSIZE(cpuCounts); ++c) {
+			installThreadedSystem(cpuCounts[c]);
+
+			uint32 start = g_system->getMillis();
+			for (uint round = 0; round < rounds; ++round)
+				JobMan.parallelFor(count, workProc, values.data(), 256);
+			const uint32 parallelTime = g_system->getMillis() - start;
+
+			Common::Mutex mutex;
+			uint finished = 0;
+			BarrierJob job;
+			job.mutex = &mutex;
+			job.arrived = &finished;
+			Common::JobGroup group;
+			start = g_system->getMillis();
+			for (uint round = 0; round < rounds; ++round) {
+				for (uint i = 0; i < 1000; ++i)
+					JobMan.submit(group, countJobProc, &job);
+				JobMan.wait(group);
+			}
+			const uint32 submitTime = g_system->getMillis() - start;
+
+			debug("JobMan with %u workers: parallelFor %u ms, %u tiny jobs %u ms", JobMan.getWorkerCount(), parallelTime, rounds * 1000, submitTime);
+		}
+#endif
+	}
+};
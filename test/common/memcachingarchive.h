@@ -0,0 +1,76 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/archive.h"
+#include "common/stream.h"
+
+/**
+ * An archive whose members are all 1000 bytes filled with the first
+ * character of their name. It counts how often contents are read.
+ */
+class CountingArchive : public Common::MemcachingCaseInsensitiveArchive {
+public:
+	CountingArchive(uint32 cacheBudget) : MemcachingCaseInsensitiveArchive(512, cacheBudget), reads(0) {}
+
+	bool hasFile(const Common::Path &path) const override { return true; }
+	int listMembers(Common::ArchiveMemberList &list) const override { return 0; }
+	const Common::ArchiveMemberPtr getMember(const Common::Path &path) const override { return Common::ArchiveMemberPtr(); }
+
+	Common::SharedArchiveContents readContentsForPath(const Common::Path &translatedPath) const override {
+		reads++;
+		byte *data = new byte[1000];
+		memset(data, translatedPath.toString()[0], 1000);
+		return Common::SharedArchiveContents(data, 1000);
+	}
+
+	// Open and close a member, returning whether the contents were right
+	bool touch(const char *name) {
+		Common::SeekableReadStream *stream = createReadStreamForMember(name);
+		const bool ok = stream && stream->size() == 1000 && stream->readByte() == name[0];
+		delete stream;
+		return ok;
+	}
+
+	mutable int reads;
+};
+
+class MemcachingArchiveTestSuite : public CxxTest::TestSuite {
+public:
+	void test_no_budget() {
+		CountingArchive archive(0);
+		TS_ASSERT(archive.touch("a"));
+		TS_ASSERT(archive.touch("a"));
+		TS_ASSERT_EQUALS(archive.reads, 2);
+
+		// Contents stay shared while a stream is alive
+		Common::SeekableReadStream *stream = archive.createReadStreamForMember("b");
+		TS_ASSERT(archive.touch("b"));
+		delete stream;
+		TS_ASSERT_EQUALS(archive.reads, 3);
+		TS_ASSERT(archive.touch("b"));
+		TS_ASSERT_EQUALS(archive.reads, 4);
+	}
+
+	void test_lru_eviction() {
+		CountingArchive archive(2500);
+		TS_ASSERT(archive.touch("a"));
+		TS_ASSERT(archive.touch("b"));
+		TS_ASSERT(archive.touch("a"));
+		TS_ASSERT_EQUALS(archive.reads, 2);
+
+		// Only two members fit, "b" is the least recently used one
+		TS_ASSERT(archive.touch("c"));
+		TS_ASSERT_EQUALS(archive.reads, 3);
+		TS_ASSERT(archive.touch("a"));
+		TS_ASSERT(archive.touch("c"));
+		TS_ASSERT_EQUALS(archive.reads, 3);
+		TS_ASSERT(archive.touch("b"));
+		TS_ASSERT_EQUALS(archive.reads, 4);
+
+		// Shrinking the budget releases contents right away
+		archive.setCacheBudget(1000);
+		TS_ASSERT(archive.touch("b"));
+		TS_ASSERT_EQUALS(archive.reads, 4);
+		TS_ASSERT(archive.touch("c"));
+		TS_ASSERT_EQUALS(archive.reads, 5);
+	}
+};
@@ -0,0 +1,162 @@
+#include <cxxtest/TestSuite.h>
+#include "test/instrset_detect.h"
+
+#include "common/array.h"
+
+#include "engines/scumm/gfx.h"
+#include "engines/scumm/stripblit.h"
+
+// the SIMD kernels must produce exactly the same pixels as the generic ones
+
+class StripBlitTestSuite : public CxxTest::TestSuite {
+	struct Kernels {
+		const char *name;
+		Scumm::StripBlit::ComposeText8Func composeText8;
+		Scumm::StripBlit::ComposeText16Func composeText16;
+		Scumm::StripBlit::WriteStripFunc writeStrip;
+	};
+
+	enum {
+		kMaxWidth = 120,
+		kHeight = 13,
+		kSrcPitch = kMaxWidth * 2 + 8,
+		kTextPitch = kMaxWidth + 4
+	};
+
+	Common::Array<Kernels> _kernels;
+	uint32 _seed;
+
+	byte _src[kSrcPitch * kHeight];
+	byte _text[kTextPitch * kHeight];
+	uint16 _palette16[256];
+	byte _palette[256];
+
+	uint32 nextRandom() {
+		_seed = _seed * 1103515245 + 12345;
+		return (_seed >> 16) | (_seed << 16);
+	}
+
+	// Text is mostly transparent, with a few runs of glyph pixels
+	void randomize() {
+		for (uint i = 0; i < sizeof(_src); i++)
+			_src[i] = nextRandom();
+		for (uint i = 0; i < sizeof(_text); i++)
+			_text[i] = (nextRandom() % 8) ? CHARSET_MASK_TRANSPARENCY : nextRandom();
+		for (uint i = 0; i < 256; i++) {
+			_palette16[i] = nextRandom();
+			_palette[i] = nextRandom();
+		}
+	}
+
+public:
+	void setUp() {
+		_seed = 1;
+		_kernels.clear();
+		const Kernels generic = { "generic",
+			Scumm::StripBlit::composeText8Generic, Scumm::StripBlit::composeText16Generic,
+			Scumm::StripBlit::writeStripGeneric };
+		_kernels.push_back(generic);
+#ifdef SCUMMVM_NEON
+		const Kernels neon = { "NEON",
+			Scumm::StripBlit::composeText8NEON, Scumm::StripBlit::composeText16NEON,
+			Scumm::StripBlit::writeStripNEON };
+		_kernels.push_back(neon);
+#endif
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2) {
+			const Kernels sse2 = { "SSE2",
+				Scumm::StripBlit::composeText8SSE2, Scumm::StripBlit::composeText16SSE2,
+				Scumm::StripBlit::writeStripSSE2 };
+			_kernels.push_back(sse2);
+		}
+#endif
+#ifdef SCUMMVM_AVX2
+		if (instrset_detect() >= 8) {
+			const Kernels avx2 = { "AVX2",
+				Scumm::StripBlit::composeText8AVX2, Scumm::StripBlit::composeText16AVX2,
+				Scumm::StripBlit::writeStripSSE2 };
+			_kernels.push_back(avx2);
+		}
+#endif
+	}
+
+	void test_compose_text8() {
+		static const int widths[] = { 4, 8, 12, 16, 24, 36, 64, 100, kMaxWidth };
+
+		for (int round = 0; round < ARRAYSIZE(widths); round++) {
+			const int width = widths[round];
+			randomize();
+
+			byte ref[kMaxWidth * kHeight];
+			Scumm::StripBlit::composeText8Generic(ref, _src, kSrcPitch, _text, kTextPitch, width, kHeight);
+			for (int y = 0; y < kHeight; y++) {
+				for (int x = 0; x < width; x++) {
+					const byte text = _text[y * kTextPitch + x];
+					TS_ASSERT_EQUALS(ref[y * width + x], text == CHARSET_MASK_TRANSPARENCY ? _src[y * kSrcPitch + x] : text);
+				}
+			}
+
+			for (uint k = 1; k < _kernels.size(); k++) {
+				byte out[kMaxWidth * kHeight];
+				_kernels[k].composeText8(out, _src, kSrcPitch, _text, kTextPitch, width, kHeight);
+				TSM_ASSERT(_kernels[k].name, memcmp(out, ref, width * kHeight) == 0);
+			}
+		}
+	}
+
+	void test_compose_text16() {
+		static const int widths[] = { 4, 8, 12, 16, 24, 36, 64, 100, kMaxWidth };
+
+		for (int round = 0; round < ARRAYSIZE(widths); round++) {
+			const int width = widths[round];
+			randomize();
+
+			byte ref[kMaxWidth * 2 * kHeight];
+			const bool refDrawn = Scumm::StripBlit::composeText16Generic(ref, _src, kSrcPitch, _text, kTextPitch, _palette16, width, kHeight);
+
+			for (uint k = 1; k < _kernels.size(); k++) {
+				byte out[kMaxWidth * 2 * kHeight];
+				const bool drawn = _kernels[k].composeText16(out, _src, kSrcPitch, _text, kTextPitch, _palette16, width, kHeight);
+				TSM_ASSERT_EQUALS(_kernels[k].name, drawn, refDrawn);
+				TSM_ASSERT(_kernels[k].name, memcmp(out, ref, width * 2 * kHeight) == 0);
+			}
+		}
+
+		// Without any text the graphics are copied and nothing counts as drawn
+		memset(_text, CHARSET_MASK_TRANSPARENCY, sizeof(_text));
+		for (uint k = 0; k < _kernels.size(); k++) {
+			byte out[kMaxWidth * 2 * kHeight];
+			TSM_ASSERT(_kernels[k].name, !_kernels[k].composeText16(out, _src, kSrcPitch, _text, kTextPitch, _palette16, kMaxWidth, kHeight));
+			for (int y = 0; y < kHeight; y++)
+				TSM_ASSERT(_kernels[k].name, memcmp(out + y * kMaxWidth * 2, _src + y * kSrcPitch, kMaxWidth * 2) == 0);
+		}
+	}
+
+	void test_write_strip() {
+		static const int heights[] = { 1, 2, 3, 8, kHeight };
+
+		for (int round = 0; round < ARRAYSIZE(heights) * 4; round++) {
+			const int height = heights[round / 4];
+			const byte *palette = (round & 1) ? _palette : nullptr;
+			const byte paletteMod = (round & 1) ? 3 : 0;
+			const int transparentColor = (round & 2) ? 5 : -1;
+			randomize();
+
+			// Few colors, so that the transparent one shows up often
+			byte colors[8 * kHeight];
+			for (int i = 0; i < 8 * height; i++)
+				colors[i] = nextRandom() % 8;
+
+			byte ref[kSrcPitch * kHeight];
+			memcpy(ref, _src, sizeof(ref));
+			Scumm::StripBlit::writeStripGeneric(ref + 5, kSrcPitch, colors, height, palette, paletteMod, transparentColor);
+
+			for (uint k = 1; k < _kernels.size(); k++) {
+				byte out[kSrcPitch * kHeight];
+				memcpy(out, _src, sizeof(out));
+				_kernels[k].writeStrip(out + 5, kSrcPitch, colors, height, palette, paletteMod, transparentColor);
+				TSM_ASSERT(_kernels[k].name, memcmp(out, ref, sizeof(out)) == 0);
+			}
+		}
+	}
+};
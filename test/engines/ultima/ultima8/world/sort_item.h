@@ -869,4 +869,28 @@ class U8SortItemTestSuite : public CxxTest::TestSuite {
 		TS_ASSERT(!si1.overlap(si2));
 		TS_ASSERT(!si2.overlap(si1));
 	}
+
+	/* Display list order falls back to the order items were added in */
+	void test_list_order() {
+		Ultima::Ultima8::SortItem si1;
+		Ultima::Ultima8::SortItem si2;
+
+		Ultima::Ultima8::Box b1(0, 0, 0, 32, 32, 8);
+		Ultima::Ultima8::Box b2(64, 64, 0, 32, 32, 8);
+		si1.setBoxBounds(b1, 0, 0);
+		si2.setBoxBounds(b2, 0, 0);
+		si1._addOrder = 1;
+		si2._addOrder = 0;
+
+		TS_ASSERT(!si1.listLessThan(si2));
+		TS_ASSERT(!si2.listLessThan(si1));
+		TS_ASSERT(Ultima::Ultima8::SortItem::listOrderLessThan(&si2, &si1));
+		TS_ASSERT(!Ultima::Ultima8::SortItem::listOrderLessThan(&si1, &si2));
+
+		// Lower z still goes first
+		b1 = Ultima::Ultima8::Box(0, 0, -8, 32, 32, 8);
+		si1.setBoxBounds(b1, 0, 0);
+		TS_ASSERT(Ultima::Ultima8::SortItem::listOrderLessThan(&si1, &si2));
+		TS_ASSERT(!Ultima::Ultima8::SortItem::listOrderLessThan(&si2, &si1));
+	}
 };
@@ -0,0 +1,68 @@
+#include <cxxtest/TestSuite.h>
+#include "engines/wintermute/base/gfx/osystem/dirty_region.h"
+
+class DirtyRegionTestSuite : public CxxTest::TestSuite {
+	static bool disjoint(const Wintermute::DirtyRegion &region) {
+		const Common::Array<Common::Rect> &rects = region.getRects();
+		for (uint i = 0; i < rects.size(); ++i) {
+			for (uint j = i + 1; j < rects.size(); ++j) {
+				if (rects[i].intersects(rects[j]))
+					return false;
+			}
+		}
+		return true;
+	}
+
+public:
+	void test_far_apart() {
+		Wintermute::DirtyRegion region;
+		TS_ASSERT(region.isEmpty());
+
+		// A sprite in one corner and the cursor in the other stay apart
+		region.add(Common::Rect(0, 0, 32, 32));
+		region.add(Common::Rect(760, 560, 800, 600));
+		region.add(Common::Rect(10, 10, 20, 20));
+		region.add(Common::Rect(5, 5, 5, 5));
+		TS_ASSERT_EQUALS(region.getRects().size(), 2u);
+		TS_ASSERT(region.getBounds() == Common::Rect(0, 0, 800, 600));
+		TS_ASSERT(region.intersects(Common::Rect(30, 30, 40, 40)));
+		TS_ASSERT(!region.intersects(Common::Rect(400, 300, 410, 310)));
+
+		region.clear();
+		TS_ASSERT(region.isEmpty());
+	}
+
+	void test_merge() {
+		Wintermute::DirtyRegion region;
+
+		// Overlapping rects are merged
+		region.add(Common::Rect(0, 0, 100, 100));
+		region.add(Common::Rect(50, 50, 150, 150));
+		TS_ASSERT_EQUALS(region.getRects().size(), 1u);
+		TS_ASSERT(region.getRects()[0] == Common::Rect(0, 0, 150, 150));
+
+		// So are adjacent ones, which take no more area together
+		region.add(Common::Rect(150, 0, 200, 150));
+		TS_ASSERT_EQUALS(region.getRects().size(), 1u);
+		TS_ASSERT(region.getRects()[0] == Common::Rect(0, 0, 200, 150));
+
+		// A rect bridging two others merges all three
+		region.add(Common::Rect(400, 0, 500, 100));
+		TS_ASSERT_EQUALS(region.getRects().size(), 2u);
+		region.add(Common::Rect(190, 10, 410, 20));
+		TS_ASSERT_EQUALS(region.getRects().size(), 1u);
+		TS_ASSERT(region.getRects()[0] == Common::Rect(0, 0, 500, 150));
+	}
+
+	void test_limit() {
+		Wintermute::DirtyRegion region(4);
+
+		for (int i = 0; i < 20; ++i) {
+			region.add(Common::Rect(i * 40, i * 30, i * 40 + 8, i * 30 + 8));
+			TS_ASSERT(region.getRects().size() <= 4u);
+			TS_ASSERT(disjoint(region));
+		}
+		for (int i = 0; i < 20; ++i)
+			TS_ASSERT(region.intersects(Common::Rect(i * 40, i * 30, i * 40 + 8, i * 30 + 8)));
+	}
+};
@@ -0,0 +1,108 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/fonts/glyphatlas.h"
+
+class GlyphAtlasTestSuite : public CxxTest::TestSuite {
+	enum {
+		kPageBytes = Graphics::GlyphAtlas::kPageSize * Graphics::GlyphAtlas::kPageSize
+	};
+
+	// Insert a glyph whose pixels all hold the low byte of its character
+	static void insertGlyph(Graphics::GlyphAtlas &atlas, uint32 chr, int width, int height) {
+		Graphics::GlyphAtlas::Glyph *glyph = atlas.insert(chr, width, height);
+		glyph->advance = width;
+		for (int y = 0; y < height; ++y)
+			memset(glyph->image.getBasePtr(0, y), chr & 0xFF, width);
+	}
+
+	static bool glyphMatches(Graphics::GlyphAtlas &atlas, uint32 chr, int width, int height) {
+		const Graphics::GlyphAtlas::Glyph *glyph = atlas.find(chr);
+		if (!glyph || glyph->image.w != width || glyph->image.h != height || glyph->advance != width)
+			return false;
+
+		for (int y = 0; y < height; ++y) {
+			const byte *row = (const byte *)glyph->image.getBasePtr(0, y);
+			for (int x = 0; x < width; ++x) {
+				if (row[x] != (chr & 0xFF))
+					return false;
+			}
+		}
+		return true;
+	}
+
+public:
+	void test_insert_find() {
+		Graphics::GlyphAtlas atlas;
+
+		for (uint32 chr = 32; chr < 128; ++chr)
+			insertGlyph(atlas, chr, 5 + chr % 7, 8 + chr % 5);
+		insertGlyph(atlas, ' ', 0, 0);
+
+		TS_ASSERT_EQUALS(atlas.size(), 96u);
+		TS_ASSERT_EQUALS(atlas.getPageMemory(), (uint32)kPageBytes);
+		TS_ASSERT(!atlas.find(128));
+
+		// Neighbouring glyphs must not overwrite each other
+		for (uint32 chr = 33; chr < 128; ++chr)
+			TS_ASSERT(glyphMatches(atlas, chr, 5 + chr % 7, 8 + chr % 5));
+		TS_ASSERT(glyphMatches(atlas, ' ', 0, 0));
+
+		// Glyphs larger than a page get a page of their own
+		insertGlyph(atlas, 0x4E00, 300, 20);
+		TS_ASSERT(glyphMatches(atlas, 0x4E00, 300, 20));
+		TS_ASSERT(glyphMatches(atlas, 'A', 5 + 'A' % 7, 8 + 'A' % 5));
+
+		atlas.clear();
+		TS_ASSERT_EQUALS(atlas.size(), 0u);
+		TS_ASSERT_EQUALS(atlas.getPageMemory(), 0u);
+	}
+
+	void test_budget_eviction() {
+		Graphics::GlyphAtlas atlas(2 * kPageBytes);
+
+		// Glyphs of 128x128 fill a page with four of them
+		for (uint32 chr = 0; chr < 8; ++chr)
+			insertGlyph(atlas, chr, 128, 128);
+		TS_ASSERT_EQUALS(atlas.getPageMemory(), (uint32)(2 * kPageBytes));
+		TS_ASSERT_EQUALS(atlas.size(), 8u);
+
+		// The first page is the least recently used one unless touched
+		TS_ASSERT(atlas.find(1));
+		insertGlyph(atlas, 8, 128, 128);
+		TS_ASSERT_EQUALS(atlas.getPageMemory(), (uint32)(2 * kPageBytes));
+		TS_ASSERT_EQUALS(atlas.size(), 5u);
+		for (uint32 chr = 0; chr < 4; ++chr)
+			TS_ASSERT(glyphMatches(atlas, chr, 128, 128));
+		for (uint32 chr = 4; chr < 8; ++chr)
+			TS_ASSERT(!atlas.find(chr));
+		TS_ASSERT(glyphMatches(atlas, 8, 128, 128));
+
+		// Glyphs without pixels survive any eviction
+		insertGlyph(atlas, ' ', 0, 0);
+		for (uint32 chr = 9; chr < 17; ++chr)
+			insertGlyph(atlas, chr, 128, 128);
+		TS_ASSERT(atlas.find(' '));
+
+		atlas.setBudget(kPageBytes);
+		TS_ASSERT_EQUALS(atlas.getPageMemory(), (uint32)kPageBytes);
+		TS_ASSERT(glyphMatches(atlas, 16, 128, 128));
+	}
+
+	void test_reinsert() {
+		Graphics::GlyphAtlas atlas(2 * kPageBytes);
+
+		for (uint32 chr = 0; chr < 5; ++chr)
+			insertGlyph(atlas, chr, 128, 128);
+
+		// Glyph 0 moves to the second page. Emptying the first page to make
+		// room must not drop it.
+		insertGlyph(atlas, 0, 64, 64);
+		insertGlyph(atlas, 5, 128, 128);
+		insertGlyph(atlas, 6, 128, 128);
+		TS_ASSERT_EQUALS(atlas.getPageMemory(), (uint32)(2 * kPageBytes));
+		TS_ASSERT(!atlas.find(1));
+		TS_ASSERT(glyphMatches(atlas, 0, 64, 64));
+		for (uint32 chr = 4; chr < 7; ++chr)
+			TS_ASSERT(glyphMatches(atlas, chr, 128, 128));
+	}
+};
@@ -0,0 +1,134 @@
+#include <cxxtest/TestSuite.h>
+
+#ifdef USE_TINYGL
+
+#include "graphics/tinygl/tinygl.h"
+
+// renders the same frames with and without dirty rectangles
+// and checks that both framebuffers end up identical
+
+class TinyGLDirtyRectTestSuite : public CxxTest::TestSuite {
+	enum {
+		kWidth = 200,
+		kHeight = 150
+	};
+
+	TinyGL::ContextHandle *_fullContext = nullptr;
+	TinyGL::ContextHandle *_dirtyContext = nullptr;
+
+	struct Quad {
+		float x, y, w, h, z;
+		byte r, g, b, a;
+	};
+
+	static void drawQuad(const Quad &quad) {
+		tglColor4ub(quad.r, quad.g, quad.b, quad.a);
+		tglBegin(TGL_TRIANGLES);
+		tglVertex3f(quad.x, quad.y, quad.z);
+		tglVertex3f(quad.x + quad.w, quad.y, quad.z);
+		tglVertex3f(quad.x + quad.w, quad.y + quad.h, quad.z);
+		tglVertex3f(quad.x, quad.y, quad.z);
+		tglVertex3f(quad.x + quad.w, quad.y + quad.h, quad.z);
+		tglVertex3f(quad.x, quad.y + quad.h, quad.z);
+		tglEnd();
+	}
+
+	static void drawFrame(const Common::Array<Quad> &quads) {
+		tglViewport(0, 0, kWidth, kHeight);
+		tglMatrixMode(TGL_PROJECTION);
+		tglLoadIdentity();
+		tglOrtho(0, kWidth, kHeight, 0, -1, 1);
+		tglMatrixMode(TGL_MODELVIEW);
+		tglLoadIdentity();
+
+		tglClearColor(0.1f, 0.2f, 0.3f, 1.0f);
+		tglClear(TGL_COLOR_BUFFER_BIT | TGL_DEPTH_BUFFER_BIT);
+
+		tglEnable(TGL_DEPTH_TEST);
+		tglDisable(TGL_BLEND);
+		for (uint i = 0; i < quads.size(); i++) {
+			if (quads[i].a == 255)
+				drawQuad(quads[i]);
+		}
+
+		// translucent quads last, without writing depth
+		tglEnable(TGL_BLEND);
+		tglBlendFunc(TGL_SRC_ALPHA, TGL_ONE_MINUS_SRC_ALPHA);
+		tglDepthMask(TGL_FALSE);
+		for (uint i = 0; i < quads.size(); i++) {
+			if (quads[i].a != 255)
+				drawQuad(quads[i]);
+		}
+		tglDepthMask(TGL_TRUE);
+	}
+
+	void renderAndCompare(const Common::Array<Quad> &quads) {
+		TinyGL::setContext(_fullContext);
+		drawFrame(quads);
+		TinyGL::presentBuffer();
+		Graphics::Surface full;
+		TinyGL::getSurfaceRef(full);
+
+		TinyGL::setContext(_dirtyContext);
+		drawFrame(quads);
+		Common::List<Common::Rect> dirtyAreas;
+		TinyGL::presentBuffer(dirtyAreas);
+		Graphics::Surface dirty;
+		TinyGL::getSurfaceRef(dirty);
+
+		uint mismatches = 0;
+		for (int y = 0; y < kHeight; y++) {
+			for (int x = 0; x < kWidth; x++) {
+				if (full.getPixel(x, y) != dirty.getPixel(x, y))
+					mismatches++;
+			}
+		}
+		TS_ASSERT_EQUALS(mismatches, 0u);
+	}
+
+public:
+	void setUp() {
+		_fullContext = TinyGL::createContext(kWidth, kHeight, Graphics::PixelFormat::createFormatARGB32(), 2, false, false);
+		_dirtyContext = TinyGL::createContext(kWidth, kHeight, Graphics::PixelFormat::createFormatARGB32(), 2, false, true);
+	}
+
+	void tearDown() {
+		// contexts can only be destroyed while current
+		TinyGL::setContext(_dirtyContext);
+		TinyGL::destroyContext(_dirtyContext);
+		TinyGL::setContext(_fullContext);
+		TinyGL::destroyContext(_fullContext);
+		_dirtyContext = _fullContext = nullptr;
+	}
+
+	void testMovingQuads() {
+		Common::Array<Quad> quads;
+		const Quad background = { 10.0f, 10.0f, 180.0f, 130.0f, -0.5f, 200, 200, 200, 255 };
+		const Quad sprite = { 20.0f, 20.0f, 40.0f, 30.0f, 0.0f, 255, 0, 0, 255 };
+		const Quad overlay = { 50.0f, 35.0f, 70.0f, 50.0f, 0.5f, 0, 0, 255, 128 };
+		const Quad cursor = { 150.0f, 100.0f, 5.0f, 5.0f, 0.9f, 0, 255, 0, 200 };
+		quads.push_back(background);
+		quads.push_back(sprite);
+		quads.push_back(overlay);
+		quads.push_back(cursor);
+
+		// the first frame draws everything, later ones only what changed
+		for (int frame = 0; frame < 12; frame++) {
+			renderAndCompare(quads);
+
+			// moves by uneven steps, so that edges fall inside tiles
+			quads[1].x += 7.5f;
+			quads[1].y += 3.25f;
+			quads[3].x -= 11.0f;
+			quads[3].y -= 6.5f;
+			if (frame % 3 == 0)
+				quads[2].a = (byte)(quads[2].a + 40);
+		}
+
+		// nothing changed at all
+		renderAndCompare(quads);
+		renderAndCompare(quads);
+	}
+};
+
+#endif
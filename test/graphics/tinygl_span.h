@@ -0,0 +1,377 @@
+#include <cxxtest/TestSuite.h>
+#include "test/instrset_detect.h"
+
+#ifdef USE_TINYGL
+
+#include "common/array.h"
+#include "common/debug.h"
+#include "common/system.h"
+
+#include "graphics/tinygl/tinygl.h"
+#include "graphics/tinygl/zspan.h"
+
+#include "../system/null_osystem.h"
+
+#if NULL_OSYSTEM_IS_AVAILABLE
+#define BENCHMARK_TIME 1
+#else
+#define BENCHMARK_TIME 0
+#endif
+
+// every test runs the same spans through the generic kernels and
+// through all SIMD kernels supported by the CPU and compares the results
+
+class TinyGLSpanTestSuite : public CxxTest::TestSuite {
+	struct Kernels {
+		const char *name;
+		TinyGL::SpanKernels::DepthSpanFunc depthSpan;
+		TinyGL::SpanKernels::ColorSpanFunc colorSpan;
+	};
+
+	static const int kMaxSpan = 45;
+
+	Common::Array<Kernels> _kernels;
+	uint32 _seed;
+
+	uint32 nextRandom() {
+		_seed = _seed * 1103515245 + 12345;
+		return (_seed >> 16) | (_seed << 16);
+	}
+
+	// Depths near the start of the span make equal depths likely
+	void randomDepths(uint *zbuf, uint z, int dzdx) {
+		for (int i = 0; i < kMaxSpan; i++)
+			zbuf[i] = (nextRandom() & 1) ? z + i * (uint)dzdx + nextRandom() % 3 - 1 : nextRandom();
+	}
+
+public:
+	void setUp() {
+		_seed = 1;
+		_kernels.clear();
+		const Kernels generic = { "generic", TinyGL::SpanKernels::depthSpanGeneric, TinyGL::SpanKernels::colorSpanGeneric };
+		_kernels.push_back(generic);
+#ifdef SCUMMVM_NEON
+		const Kernels neon = { "NEON", TinyGL::SpanKernels::depthSpanNEON, TinyGL::SpanKernels::colorSpanNEON };
+		_kernels.push_back(neon);
+#endif
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2) {
+			const Kernels sse2 = { "SSE2", TinyGL::SpanKernels::depthSpanSSE2, TinyGL::SpanKernels::colorSpanSSE2 };
+			_kernels.push_back(sse2);
+		}
+#endif
+#ifdef SCUMMVM_AVX2
+		if (instrset_detect() >= 8) {
+			const Kernels avx2 = { "AVX2", TinyGL::SpanKernels::depthSpanAVX2, TinyGL::SpanKernels::colorSpanAVX2 };
+			_kernels.push_back(avx2);
+		}
+#endif
+	}
+
+	void test_depth_span() {
+		static const int depthFuncs[] = {
+			TGL_NEVER, TGL_LESS, TGL_EQUAL, TGL_LEQUAL, TGL_GREATER, TGL_NOTEQUAL, TGL_GEQUAL, TGL_ALWAYS
+		};
+
+		for (int iteration = 0; iteration < 400; iteration++) {
+			TinyGL::SpanKernels::DepthSpan span;
+			span.count = nextRandom() % kMaxSpan;
+			span.z = nextRandom();
+			span.dzdx = (int)nextRandom() >> (nextRandom() % 32);
+			span.depthFunc = depthFuncs[iteration % ARRAYSIZE(depthFuncs)];
+			span.depthWrite = (iteration % 5) != 0;
+
+			uint initialZbuf[kMaxSpan], refZbuf[kMaxSpan], zbuf[kMaxSpan];
+			randomDepths(initialZbuf, span.z, span.dzdx);
+			memcpy(refZbuf, initialZbuf, sizeof(refZbuf));
+			TinyGL::SpanKernels::DepthSpan refSpan = span;
+			refSpan.zbuf = refZbuf;
+			TinyGL::SpanKernels::depthSpanGeneric(refSpan);
+
+			for (uint k = 1; k < _kernels.size(); k++) {
+				memcpy(zbuf, initialZbuf, sizeof(zbuf));
+				TinyGL::SpanKernels::DepthSpan testSpan = span;
+				testSpan.zbuf = zbuf;
+				_kernels[k].depthSpan(testSpan);
+
+				TS_ASSERT_EQUALS(testSpan.count, 0);
+				TS_ASSERT_EQUALS(testSpan.z, refSpan.z);
+				TS_ASSERT_EQUALS(testSpan.zbuf - zbuf, refSpan.zbuf - refZbuf);
+				TS_ASSERT_SAME_DATA(zbuf, refZbuf, sizeof(zbuf));
+			}
+		}
+	}
+
+	void test_color_span() {
+		static const int depthFuncs[] = { TGL_LESS, TGL_LEQUAL, TGL_GREATER, TGL_ALWAYS };
+		const Graphics::PixelFormat formats[] = {
+			Graphics::PixelFormat::createFormatARGB32(),
+			Graphics::PixelFormat::createFormatRGBA32(),
+			Graphics::PixelFormat(4, 8, 8, 8, 0, 16, 8, 0, 0)
+		};
+
+		for (int iteration = 0; iteration < 1000; iteration++) {
+			const Graphics::PixelFormat &format = formats[iteration % ARRAYSIZE(formats)];
+			TinyGL::SpanKernels::ColorSpan span;
+			span.count = nextRandom() % kMaxSpan;
+			span.z = nextRandom();
+			span.dzdx = (int)nextRandom() >> (nextRandom() % 32);
+			// colors may slightly over- or underflow, as they do in the rasterizer
+			span.r = nextRandom() % 0x10100 - 0x80;
+			span.g = nextRandom() % 0x10100 - 0x80;
+			span.b = nextRandom() % 0x10100 - 0x80;
+			span.a = nextRandom() % 0x10100 - 0x80;
+			span.drdx = (int)(nextRandom() % 0x1000) - 0x800;
+			span.dgdx = (int)(nextRandom() % 0x1000) - 0x800;
+			span.dbdx = (int)(nextRandom() % 0x1000) - 0x800;
+			span.dadx = (int)(nextRandom() % 0x1000) - 0x800;
+			span.depthFunc = depthFuncs[nextRandom() % ARRAYSIZE(depthFuncs)];
+			span.depthWrite = (nextRandom() % 3) != 0;
+			span.blending = (iteration / 3) % 2;
+			span.aLoss = format.aLoss;
+			span.aShift = format.aShift;
+			span.rShift = format.rShift;
+			span.gShift = format.gShift;
+			span.bShift = format.bShift;
+
+			uint32 texels[kMaxSpan];
+			for (int i = 0; i < kMaxSpan; i++)
+				texels[i] = nextRandom();
+			span.texels = (iteration / 6) % 2 ? texels : nullptr;
+
+			uint initialZbuf[kMaxSpan], refZbuf[kMaxSpan], zbuf[kMaxSpan];
+			uint32 initialPixels[kMaxSpan], refPixels[kMaxSpan], pixels[kMaxSpan];
+			randomDepths(initialZbuf, span.z, span.dzdx);
+			for (int i = 0; i < kMaxSpan; i++)
+				initialPixels[i] = nextRandom();
+			memcpy(refZbuf, initialZbuf, sizeof(refZbuf));
+			memcpy(refPixels, initialPixels, sizeof(refPixels));
+			TinyGL::SpanKernels::ColorSpan refSpan = span;
+			refSpan.zbuf = refZbuf;
+			refSpan.pixels = refPixels;
+			TinyGL::SpanKernels::colorSpanGeneric(refSpan);
+
+			for (uint k = 1; k < _kernels.size(); k++) {
+				memcpy(zbuf, initialZbuf, sizeof(zbuf));
+				memcpy(pixels, initialPixels, sizeof(pixels));
+				TinyGL::SpanKernels::ColorSpan testSpan = span;
+				testSpan.zbuf = zbuf;
+				testSpan.pixels = pixels;
+				_kernels[k].colorSpan(testSpan);
+
+				TS_ASSERT_EQUALS(testSpan.count, 0);
+				TS_ASSERT_EQUALS(testSpan.z, refSpan.z);
+				TS_ASSERT_EQUALS(testSpan.r, refSpan.r);
+				TS_ASSERT_EQUALS(testSpan.g, refSpan.g);
+				TS_ASSERT_EQUALS(testSpan.b, refSpan.b);
+				TS_ASSERT_EQUALS(testSpan.a, refSpan.a);
+				TS_ASSERT_EQUALS(testSpan.pixels - pixels, refSpan.pixels - refPixels);
+				TS_ASSERT_SAME_DATA(zbuf, refZbuf, sizeof(zbuf));
+				TS_ASSERT_SAME_DATA(pixels, refPixels, sizeof(pixels));
+			}
+		}
+	}
+
+	// Draws random triangles with random depth, blending, shading and
+	// texturing states. With the stencil test enabled, the rasterizer has
+	// to use the per pixel code, but the stencil test itself always passes.
+	void renderRandomScene(int width, int height, uint32 seed, bool perPixel) {
+		_seed = seed;
+
+		byte texture[16 * 16 * 4];
+		for (int i = 0; i < ARRAYSIZE(texture); i++)
+			texture[i] = nextRandom();
+		TGLuint textureHandle;
+		tglGenTextures(1, &textureHandle);
+		tglBindTexture(TGL_TEXTURE_2D, textureHandle);
+		tglTexImage2D(TGL_TEXTURE_2D, 0, TGL_RGBA, 16, 16, 0, TGL_RGBA, TGL_UNSIGNED_BYTE, texture);
+
+		tglViewport(0, 0, width, height);
+		tglMatrixMode(TGL_PROJECTION);
+		tglLoadIdentity();
+		tglMatrixMode(TGL_MODELVIEW);
+		tglLoadIdentity();
+		tglClearColor(0.25f, 0.5f, 0.75f, 1.0f);
+		tglClearDepth(1.0f);
+		tglClear(TGL_COLOR_BUFFER_BIT | TGL_DEPTH_BUFFER_BIT);
+
+		if (perPixel) {
+			tglEnable(TGL_STENCIL_TEST);
+			tglStencilFunc(TGL_ALWAYS, 0, 0xff);
+			tglStencilOp(TGL_KEEP, TGL_KEEP, TGL_KEEP);
+		}
+
+		static const int depthFuncs[] = {
+			TGL_NEVER, TGL_LESS, TGL_EQUAL, TGL_LEQUAL, TGL_GREATER, TGL_NOTEQUAL, TGL_GEQUAL, TGL_ALWAYS
+		};
+		for (int i = 0; i < 200; i++) {
+			(nextRandom() % 4) ? tglEnable(TGL_DEPTH_TEST) : tglDisable(TGL_DEPTH_TEST);
+			tglDepthFunc(depthFuncs[nextRandom() % ARRAYSIZE(depthFuncs)]);
+			tglDepthMask((nextRandom() % 4) ? TGL_TRUE : TGL_FALSE);
+			(nextRandom() % 2) ? tglEnable(TGL_BLEND) : tglDisable(TGL_BLEND);
+			// the kernels only blend with SRC_ALPHA, ONE_MINUS_SRC_ALPHA
+			if (nextRandom() % 4)
+				tglBlendFunc(TGL_SRC_ALPHA, TGL_ONE_MINUS_SRC_ALPHA);
+			else
+				tglBlendFunc(TGL_ONE, TGL_ONE);
+			tglShadeModel((nextRandom() % 2) ? TGL_SMOOTH : TGL_FLAT);
+			(nextRandom() % 2) ? tglEnable(TGL_TEXTURE_2D) : tglDisable(TGL_TEXTURE_2D);
+			if (nextRandom() % 4) {
+				tglDisable(TGL_SCISSOR_TEST);
+			} else {
+				tglEnable(TGL_SCISSOR_TEST);
+				tglScissor(nextRandom() % width, nextRandom() % height, nextRandom() % width, nextRandom() % height);
+			}
+
+			tglBegin(TGL_TRIANGLES);
+			for (int v = 0; v < 3; v++) {
+				tglColor4ub(nextRandom(), nextRandom(), nextRandom(), nextRandom());
+				tglTexCoord2f((nextRandom() % 1000) / 250.0f, (nextRandom() % 1000) / 250.0f);
+				// vertices may lie outside of the screen and get clipped
+				tglVertex3f((int)(nextRandom() % 2400) / 1000.0f - 1.2f,
+				            (int)(nextRandom() % 2400) / 1000.0f - 1.2f,
+				            (int)(nextRandom() % 2000) / 1000.0f - 1.0f);
+			}
+			tglEnd();
+		}
+
+		tglDeleteTextures(1, &textureHandle);
+	}
+
+	// Every set of kernels must draw exactly what the per pixel code draws.
+	void test_per_pixel_equivalence() {
+		const int width = 97, height = 61;
+
+		for (uint k = 0; k < _kernels.size(); k++) {
+			TinyGL::SpanKernels::depthSpanFunc = _kernels[k].depthSpan;
+			TinyGL::SpanKernels::colorSpanFunc = _kernels[k].colorSpan;
+
+			for (uint32 seed = 1; seed <= 5; seed++) {
+				Graphics::Surface kernelSurface, perPixelSurface;
+				TinyGL::ContextHandle *kernelContext = TinyGL::createContext(width, height, Graphics::PixelFormat::createFormatARGB32(), 16, true, false);
+				TinyGL::setContext(kernelContext);
+				renderRandomScene(width, height, seed, false);
+				TinyGL::presentBuffer();
+				TinyGL::getSurfaceRef(kernelSurface);
+
+				TinyGL::ContextHandle *perPixelContext = TinyGL::createContext(width, height, Graphics::PixelFormat::createFormatARGB32(), 16, true, false);
+				TinyGL::setContext(perPixelContext);
+				renderRandomScene(width, height, seed, true);
+				TinyGL::presentBuffer();
+				TinyGL::getSurfaceRef(perPixelSurface);
+
+				uint mismatches = 0;
+				for (int y = 0; y < height; y++) {
+					for (int x = 0; x < width; x++) {
+						if (kernelSurface.getPixel(x, y) != perPixelSurface.getPixel(x, y))
+							mismatches++;
+					}
+				}
+				TSM_ASSERT_EQUALS(_kernels[k].name, mismatches, 0u);
+
+				TinyGL::destroyContext(perPixelContext);
+				TinyGL::setContext(kernelContext);
+				TinyGL::destroyContext(kernelContext);
+			}
+		}
+
+		TinyGL::SpanKernels::depthSpanFunc = nullptr;
+		TinyGL::SpanKernels::colorSpanFunc = nullptr;
+	}
+
+	// Renders a fixed scene of overlapping gouraud shaded, textured and
+	// blended quads with every set of kernels and reports the fill rate.
+	void test_span_speed() {
+#if BENCHMARK_TIME
+		Common::install_null_g_system();
+
+		const int width = 320, height = 240;
+#ifdef SLOW_TESTS
+		const int frames = 100;
+#else
+		const int frames = 1;
+#endif
+		const int layers = 8;
+
+		byte texture[64 * 64 * 4];
+		for (int i = 0; i < ARRAYSIZE(texture); i++)
+			texture[i] = nextRandom();
+
+		uint32 refHash = 0;
+		for (uint k = 0; k < _kernels.size(); k++) {
+			// the null backend can't report CPU features, so select the kernels first
+			TinyGL::SpanKernels::depthSpanFunc = _kernels[k].depthSpan;
+			TinyGL::SpanKernels::colorSpanFunc = _kernels[k].colorSpan;
+			TinyGL::ContextHandle *context = TinyGL::createContext(width, height, Graphics::PixelFormat::createFormatARGB32(), 256, false, false);
+			TinyGL::setContext(context);
+
+			TGLuint textureHandle;
+			tglGenTextures(1, &textureHandle);
+			tglBindTexture(TGL_TEXTURE_2D, textureHandle);
+			tglTexImage2D(TGL_TEXTURE_2D, 0, TGL_RGBA, 64, 64, 0, TGL_RGBA, TGL_UNSIGNED_BYTE, texture);
+			tglViewport(0, 0, width, height);
+			tglMatrixMode(TGL_PROJECTION);
+			tglLoadIdentity();
+			tglFrustum(-1, 1, -1, 1, 1, 10);
+			tglMatrixMode(TGL_MODELVIEW);
+			tglLoadIdentity();
+			tglEnable(TGL_DEPTH_TEST);
+			tglDepthFunc(TGL_LEQUAL);
+			tglShadeModel(TGL_SMOOTH);
+			tglBlendFunc(TGL_SRC_ALPHA, TGL_ONE_MINUS_SRC_ALPHA);
+
+			uint32 time = 0;
+			for (int frame = 0; frame < frames; frame++) {
+				tglClear(TGL_COLOR_BUFFER_BIT | TGL_DEPTH_BUFFER_BIT);
+				for (int layer = 0; layer < layers; layer++) {
+					const float z = -2.0f - layer * 0.5f;
+					(layer & 1) ? tglEnable(TGL_TEXTURE_2D) : tglDisable(TGL_TEXTURE_2D);
+					(layer & 2) ? tglEnable(TGL_BLEND) : tglDisable(TGL_BLEND);
+					// draw back to front half of the time, so that some layers fail the depth test
+					const float depth = (layer & 4) ? z : -6.5f - z;
+					tglBegin(TGL_QUADS);
+					tglColor4ub(255, 0, 0, 200);
+					tglTexCoord2f(0.0f, 0.0f);
+					tglVertex3f(depth, depth, depth);
+					tglColor4ub(0, 255, 0, 150);
+					tglTexCoord2f(4.0f, 0.0f);
+					tglVertex3f(-depth, depth, depth);
+					tglColor4ub(0, 0, 255, 100);
+					tglTexCoord2f(4.0f, 4.0f);
+					tglVertex3f(-depth, -depth, depth);
+					tglColor4ub(255, 255, 255, 50);
+					tglTexCoord2f(0.0f, 4.0f);
+					tglVertex3f(depth, -depth, depth);
+					tglEnd();
+				}
+				const uint32 start = g_system->getMillis();
+				TinyGL::presentBuffer();
+				time += g_system->getMillis() - start;
+			}
+
+			Graphics::Surface surface;
+			TinyGL::getSurfaceRef(surface);
+			uint32 hash = 0;
+			for (int y = 0; y < surface.h; y++) {
+				for (int x = 0; x < surface.w; x++)
+					hash = hash * 31 + surface.getPixel(x, y);
+			}
+			if (k == 0)
+				refHash = hash;
+			TS_ASSERT_EQUALS(hash, refHash);
+
+			tglDeleteTextures(1, &textureHandle);
+			TinyGL::destroyContext(context);
+
+			const double pixels = (double)frames * layers * width * height;
+			debug("TinyGL %s span kernels: %f Mpixels/s\n", _kernels[k].name, time ? pixels / time / 1000.0 : 0.0);
+		}
+
+		TinyGL::SpanKernels::depthSpanFunc = nullptr;
+		TinyGL::SpanKernels::colorSpanFunc = nullptr;
+		Common::uninstall_null_g_system();
+#endif
+	}
+};
+
+#endif
@@ -0,0 +1,139 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/debug.h"
+#include "common/fs.h"
+#include "common/system.h"
+
+#include "graphics/font.h"
+#include "graphics/surface.h"
+#include "graphics/fonts/ttf.h"
+
+#include "../system/null_osystem.h"
+
+#if NULL_OSYSTEM_IS_AVAILABLE
+#define BENCHMARK_TIME 1
+#else
+#define BENCHMARK_TIME 0
+#endif
+
+class TTFFontTestSuite : public CxxTest::TestSuite {
+	enum {
+		kWidth = 320,
+		kHeight = 200
+	};
+
+	Graphics::Font *_font;
+	Common::Array<Common::U32String> _lines;
+
+	static Graphics::Font *loadFont(int size) {
+		// Copied there by the test makefile
+		Common::FSNode node("test/engine-data/LiberationSans-Regular.ttf");
+		Common::SeekableReadStream *stream = node.createReadStream();
+		if (!stream)
+			return nullptr;
+		return Graphics::loadTTFFont(stream, DisposeAfterUse::YES, size);
+	}
+
+	static bool surfacesMatch(const Graphics::Surface &a, const Graphics::Surface &b) {
+		for (int y = 0; y < kHeight; y++) {
+			if (memcmp(a.getBasePtr(0, y), b.getBasePtr(0, y), kWidth * a.format.bytesPerPixel) != 0)
+				return false;
+		}
+		return true;
+	}
+
+public:
+	void setUp() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+#endif
+		_font = loadFont(16);
+
+		_lines.clear();
+		_lines.push_back(Common::U32String("The quick brown fox jumps over the lazy dog."));
+		_lines.push_back(Common::U32String("AVATAR, To, Ty, WA: pairs with kerning"));
+		_lines.push_back(Common::U32String());
+		_lines.push_back(Common::U32String("A line much too long to fit into the surface, which has to be cut off"));
+	}
+
+	void tearDown() {
+		delete _font;
+		_font = nullptr;
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::uninstall_null_g_system();
+#endif
+	}
+
+	void test_draw_strings() {
+		TS_ASSERT(_font);
+		if (!_font)
+			return;
+
+		const Graphics::TextAlign aligns[] = { Graphics::kTextAlignLeft, Graphics::kTextAlignCenter, Graphics::kTextAlignRight };
+		const Graphics::PixelFormat format = Graphics::PixelFormat::createFormatARGB32();
+		const int lineHeight = _font->getFontHeight() + 2;
+
+		for (int alpha = 0; alpha < 2; alpha++) {
+			for (int i = 0; i < ARRAYSIZE(aligns); i++) {
+				Graphics::Surface single, batched;
+				single.create(kWidth, kHeight, format);
+				batched.create(kWidth, kHeight, format);
+				const uint32 background = format.ARGBToColor(alpha ? 0 : 255, 20, 40, 60);
+				single.fillRect(Common::Rect(kWidth, kHeight), background);
+				batched.fillRect(Common::Rect(kWidth, kHeight), background);
+				const uint32 color = format.RGBToColor(255, 220, 0);
+
+				// Drawn with an offset, so that lines also start outside the surface
+				for (uint j = 0; j < _lines.size(); j++) {
+					if (alpha)
+						_font->drawAlphaString(&single, _lines[j], -4, 3 + j * lineHeight, kWidth, color, aligns[i]);
+					else
+						_font->drawString(&single, _lines[j], -4, 3 + j * lineHeight, kWidth, color, aligns[i]);
+				}
+				if (alpha)
+					_font->drawAlphaStrings(&batched, _lines, -4, 3, kWidth, lineHeight, color, aligns[i]);
+				else
+					_font->drawStrings(&batched, _lines, -4, 3, kWidth, lineHeight, color, aligns[i]);
+
+				TS_ASSERT(surfacesMatch(single, batched));
+
+				single.free();
+				batched.free();
+			}
+		}
+	}
+
+	void test_draw_speed() {
+#if BENCHMARK_TIME
+		if (!_font)
+			return;
+
+#ifdef SLOW_TESTS
+		const uint rounds = 20000;
+#else
+		const uint rounds = 200;
+#endif
+		Graphics::Surface surface;
+		surface.create(kWidth, kHeight, Graphics::PixelFormat::createFormatARGB32());
+		const uint32 color = surface.format.RGBToColor(255, 255, 255);
+		const int lineHeight = _font->getFontHeight() + 2;
+
+		uint32 start = g_system->getMillis();
+		for (uint i = 0; i < rounds; i++) {
+			for (uint j = 0; j < _lines.size(); j++)
+				_font->drawString(&surface, _lines[j], 0, j * lineHeight, kWidth, color, Graphics::kTextAlignCenter);
+		}
+		const uint32 singleTime = MAX<uint32>(g_system->getMillis() - start, 1);
+
+		start = g_system->getMillis();
+		for (uint i = 0; i < rounds; i++)
+			_font->drawStrings(&surface, _lines, 0, 0, kWidth, lineHeight, color, Graphics::kTextAlignCenter);
+		const uint32 batchedTime = MAX<uint32>(g_system->getMillis() - start, 1);
+
+		surface.free();
+
+		const double drawn = (double)rounds * _lines.size();
+		debug("Drawing TTF strings: drawString %f strings/s, drawStrings %f strings/s\n", drawn * 1000 / singleTime, drawn * 1000 / batchedTime);
+#endif
+	}
+};
@@ -8,6 +8,10 @@
 #undef USE_CLOUD
 #endif
 #include "../backends/saves/savefile.cpp"
+#ifdef POSIX
+#include "../backends/mutex/pthread/pthread-mutex.cpp"
+#include "../backends/threads/pthread/pthread-threads.cpp"
+#endif
 
 //#define DISPLAY_ERROR_MESSAGES
 
@@ -22,6 +26,32 @@ void Common::install_null_g_system() {
 	g_system->initBackend();
 }
 
+#ifdef POSIX
+class OSystem_NULL_Threaded : public OSystem_NULL {
+public:
+	OSystem_NULL_Threaded(bool silenceLogs, uint cpuCount) : OSystem_NULL(silenceLogs), _cpuCount(cpuCount) {}
+
+	Common::MutexInternal *createMutex() override { return createPthreadMutexInternal(); }
+	Common::ThreadInternal *createThread(Common::ThreadProc proc, void *param) override { return createPthreadThreadInternal(proc, param); }
+	Common::SemaphoreInternal *createSemaphore(uint initialValue = 0) override { return createPthreadSemaphoreInternal(initialValue); }
+	uint getCPUCount() override { return _cpuCount; }
+
+private:
+	uint _cpuCount;
+};
+
+void Common::install_threaded_null_g_system(uint cpuCount) {
+#ifdef DISPLAY_ERROR_MESSAGES
+	const bool silenceLogs = false;
+#else
+	const bool silenceLogs = true;
+#endif
+
+	g_system = new OSystem_NULL_Threaded(silenceLogs, cpuCount);
+	g_system->initBackend();
+}
+#endif
+
 void Common::uninstall_null_g_system() {
 	g_system->destroy();
 	g_system = nullptr;
@@ -8,5 +8,15 @@ void uninstall_null_g_system();
 #else
 #define NULL_OSYSTEM_IS_AVAILABLE 0
 #endif
+
+// A null system with real mutexes and threads, for testing code running on
+// several threads. The system claims to have @p cpuCount cores regardless of
+// the actual hardware.
+#if defined(POSIX)
+void install_threaded_null_g_system(unsigned int cpuCount);
+#define THREADED_NULL_OSYSTEM_IS_AVAILABLE 1
+#else
+#define THREADED_NULL_OSYSTEM_IS_AVAILABLE 0
+#endif
 }
 #endif